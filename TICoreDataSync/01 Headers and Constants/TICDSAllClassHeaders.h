@@ -74,10 +74,23 @@
 #import "TICDSUtilities.h"
 #import "TICDSLog.h"
 #import "TICDSError.h"
+#import "TICDSAttributeValueDelta.h"
 #import "TICDSChangeIntegrityStoreManager.h"
+#import "TICDSChangedAttributesCodec.h"
+#import "TICDSEntitySyncDescriptor.h"
+#import "TICDSFileTransfer.h"
+#import "TICDSSyncChangeApplier.h"
+#import "TICDSSyncChangeJournal.h"
+#import "TICDSSyncChangeSetReader.h"
+#import "TICDSSyncChangesWriter.h"
+#import "TICDSSynchronizationStateJournal.h"
+#import "TICDSTransferWindow.h"
 
 #pragma mark Encryption
 #import "FZACryptor.h"
+#import "FZACryptoProvider.h"
+#import "FZACryptoProviderCommonCrypto.h"
+#import "FZACryptoProviderOpenSSL.h"
 #import "FZAKeyManager.h"
 #if (TARGET_OS_IPHONE)
 #import "FZAKeyManageriPhone.h"
@@ -90,5 +103,7 @@
 #import "NSObject+TIDelegateCommunications.h"
 #import "TICoreDataFactory.h"
 #import "TIManagedObjectExtensions.h"
+#import "TIDirectoryWatcher.h"
 #import "TIKQDirectoryWatcher.h"
+#import "TIInotifyDirectoryWatcher.h"
 #import "TIUbiquityMonitor.h"
\ No newline at end of file
@@ -69,9 +69,25 @@
 @class TICDSSyncChange;
 @class TICDSSyncChangeSet;
 
+#pragma mark -
+#pragma mark UTILITIES
+@class TICDSAttributeValueDelta;
+@class TICDSChangedAttributesCodec;
+@class TICDSEntitySyncDescriptor;
+@class TICDSFileTransfer;
+@class TICDSSyncChangeApplier;
+@class TICDSSyncChangeJournal;
+@class TICDSSyncChangeSetReader;
+@class TICDSSyncChangesWriter;
+@class TICDSSynchronizationStateJournal;
+@class TICDSTransferWindow;
+
 #pragma mark -
 #pragma mark UTILITIES - ENCRYPTION
 @class FZACryptor;
+@class FZACryptoProvider;
+@class FZACryptoProviderCommonCrypto;
+@class FZACryptoProviderOpenSSL;
 @class FZAKeyManager;
 #if (TARGET_OS_IPHONE)
 @class FZAKeyManagerMac;
@@ -82,7 +98,9 @@
 #pragma mark -
 #pragma mark EXTERNAL CLASSES
 @class TICoreDataFactory;
+@class TIDirectoryWatcher;
 @class TIKQDirectoryWatcher;
+@class TIInotifyDirectoryWatcher;
 
 #pragma mark -
 #pragma mark DELEGATE PROTOCOLS
@@ -19,6 +19,7 @@ extern NSString * const kTICDSErrorUserInfo;
 extern NSString * const kTICDSErrorClassAndMethod;
 extern NSString * const kTICDSErrorDomain;
 extern NSString * const kTICDSStackTrace;
+extern NSString * const kTICDSDropboxSDKErrorDomain;
 
 extern NSString * const FZACryptorErrorDomain;
 extern NSString * const FZAKeyManagerErrorDomain;
@@ -29,6 +30,10 @@ extern NSString * const kTICDSClientDeviceUserInfo;
 extern NSString * const kTICDSClientDeviceIdentifier;
 extern NSString * const kTICDSRegisteredDocumentIdentifiers;
 extern NSString * const kTICDSLastSyncDate;
+extern NSString * const kTICDSSubscribedSyncPartitionNames;
+extern NSString * const kTICDSAppliedSyncChangeSetSequenceNumbers;
+extern NSString * const kTICDSWholeStoreSyncChangeSetSequenceNumbers;
+extern NSString * const kTICDSDefaultSyncPartition;
 extern NSString * const kTICDSUploadedWholeStoreModificationDate;
 extern NSString * const kTICDSDocumentIdentifier;
 extern NSString * const kTICDSDocumentDescription;
@@ -56,13 +61,20 @@ extern NSString * const TICDSIntegrityKeyDirectoryName;
 extern NSString * const TICDSUnappliedSyncChangesDirectoryName;
 extern NSString * const TICDSUnappliedSyncCommandsDirectoryName;
 extern NSString * const TICDSUnsynchronizedSyncChangesStoreName;
+extern NSString * const TICDSUnsynchronizedSyncChangesJournalDirectoryName;
 extern NSString * const TICDSSyncChangesBeingSynchronizedStoreName;
 extern NSString * const TICDSWholeStoreFilename;
 extern NSString * const TICDSAppliedSyncChangeSetsFilename;
 extern NSString * const TICDSUnappliedChangeSetsFilename;
+extern NSString * const TICDSSynchronizationStateFilename;
+extern NSString * const TICDSSyncChangeSetSequenceNumbersFilename;
+extern NSString * const TICDSDocumentCatalogFilename;
+extern NSString * const TICDSClientRegistryFilename;
 extern NSString * const TICDSSyncCommandSetFileExtension;
 extern NSString * const TICDSSyncChangeSetFileExtension;
 extern NSString * const TICDSRecentSyncFileExtension;
+extern NSString * const TICDSSyncChangesJournalSegmentExtension;
+extern NSString * const TICDSSyncChangesJournalSealedSegmentExtension;
 extern NSString * const TICDSDeviceInfoPlistFilenameWithExtension;
 extern NSString * const TICDSDeviceInfoPlistFilename;
 extern NSString * const TICDSDeviceInfoPlistExtension;
@@ -79,12 +91,16 @@ extern NSString * const TICDSSyncChangeDataModelName;
 extern NSString * const TICDSSyncChangeSetDataModelName;
 
 extern NSString * const kTICDSChangedAttributeValue;
+extern NSString * const kTICDSChangedAttributesDigests;
+extern NSString * const kTICDSChangedAttributesEncodingVersion;
+extern NSString * const kTICDSInsertionRelationshipsVersion;
 
 extern NSString * const kTICDSSyncWarningType;
 extern NSString * const kTICDSSyncWarningDescription;
 extern NSString * const kTICDSSyncWarningEntityName;
 extern NSString * const kTICDSSyncWarningAttributes;
 extern NSString * const kTICDSSyncWarningRelatedObjectEntityName;
+extern NSString * const kTICDSSyncWarningRelevantKey;
 
 extern NSString * const TICDSApplicationSyncManagerDidFinishRegisteringNotification;
 extern NSString * const TICDSDocumentSyncManagerDidRegisterSuccessfullyNotification;
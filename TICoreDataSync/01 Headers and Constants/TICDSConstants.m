@@ -33,12 +33,16 @@ NSString * const TICDSSyncWarningTypeNames[] = {
     @"Object with relationships changed locally has already been deleted remotely",
     @"Object with attributes changed remotely has been deleted locally",
     @"Object with relationships changed remotely has been deleted locally",
+    @"Exception arose while applying attribute sync change",
+    @"Local value has changed since remote attribute delta sync change was created",
 };
 
 NSString * const kTICDSErrorUserInfo = @"kTICDSErrorUserInfo";
 NSString * const kTICDSErrorClassAndMethod = @"kTICDSErrorClassAndMethod";
 NSString * const kTICDSErrorDomain = @"com.timisted.ticoredatasync";
 NSString * const kTICDSStackTrace = @"kTICDSStackTrace";
+// Matches DBErrorDomain, without linking the Dropbox SDK into every target
+NSString * const kTICDSDropboxSDKErrorDomain = @"dropbox.com";
 
 NSString * const FZACryptorErrorDomain = @"com.fuzzyaliens.fzacryptor";
 NSString * const FZAKeyManagerErrorDomain = @"com.fuzzyaliens.fzacryptor.keymanager";
@@ -49,6 +53,10 @@ NSString * const kTICDSClientDeviceUserInfo = @"kTICDSClientDeviceUserInfo";
 NSString * const kTICDSClientDeviceIdentifier = @"kTICDSClientDeviceIdentifier";
 NSString * const kTICDSRegisteredDocumentIdentifiers = @"kTICDSRegisteredDocumentIdentifiers";
 NSString * const kTICDSLastSyncDate = @"kTICDSLastSyncDate";
+NSString * const kTICDSSubscribedSyncPartitionNames = @"kTICDSSubscribedSyncPartitionNames";
+NSString * const kTICDSAppliedSyncChangeSetSequenceNumbers = @"kTICDSAppliedSyncChangeSetSequenceNumbers";
+NSString * const kTICDSWholeStoreSyncChangeSetSequenceNumbers = @"kTICDSWholeStoreSyncChangeSetSequenceNumbers";
+NSString * const kTICDSDefaultSyncPartition = @"kTICDSDefaultSyncPartition";
 NSString * const kTICDSUploadedWholeStoreModificationDate = @"kTICDSUploadedWholeStoreModificationDate";
 NSString * const kTICDSDocumentIdentifier = @"kTICDSDocumentIdentifier";
 NSString * const kTICDSDocumentDescription = @"kTICDSDocumentDescription";
@@ -76,13 +84,20 @@ NSString * const TICDSIntegrityKeyDirectoryName = @"IntegrityKey";
 NSString * const TICDSUnappliedSyncChangesDirectoryName = @"UnappliedSyncChanges";
 NSString * const TICDSUnappliedSyncCommandsDirectoryName = @"UnappliedSyncCommands";
 NSString * const TICDSUnsynchronizedSyncChangesStoreName = @"UnsynchronizedSyncChanges.syncchg";
+NSString * const TICDSUnsynchronizedSyncChangesJournalDirectoryName = @"UnsynchronizedSyncChanges";
 NSString * const TICDSSyncChangesBeingSynchronizedStoreName = @"SyncChangesBeingSynchronized.syncchg";
 NSString * const TICDSWholeStoreFilename = @"WholeStore.ticdsync";
 NSString * const TICDSAppliedSyncChangeSetsFilename = @"AppliedSyncChangeSets.ticdsync";
 NSString * const TICDSUnappliedChangeSetsFilename = @"UnappliedSyncChangeSets.ticdsync";
+NSString * const TICDSSynchronizationStateFilename = @"SynchronizationState.plist";
+NSString * const TICDSSyncChangeSetSequenceNumbersFilename = @"SyncChangeSetSequenceNumbers.plist";
+NSString * const TICDSDocumentCatalogFilename = @"DocumentCatalog.plist";
+NSString * const TICDSClientRegistryFilename = @"ClientRegistry.plist";
 NSString * const TICDSSyncCommandSetFileExtension = @"synccmd";
 NSString * const TICDSSyncChangeSetFileExtension = @"syncchg";
 NSString * const TICDSRecentSyncFileExtension = @"recentsync";
+NSString * const TICDSSyncChangesJournalSegmentExtension = @"syncjournal";
+NSString * const TICDSSyncChangesJournalSealedSegmentExtension = @"sealedsyncjournal";
 NSString * const TICDSDeviceInfoPlistFilenameWithExtension = @"deviceInfo.plist";
 NSString * const TICDSDeviceInfoPlistFilename = @"deviceInfo";
 NSString * const TICDSDeviceInfoPlistExtension = @"plist";
@@ -99,12 +114,16 @@ NSString * const TICDSSyncChangeDataModelName = @"TICDSSyncChange";
 NSString * const TICDSSyncChangeSetDataModelName = @"TICDSSyncChangeSet";
 
 NSString * const kTICDSChangedAttributeValue = @"kTICDSChangedAttributeValue";
+NSString * const kTICDSChangedAttributesDigests = @"kTICDSChangedAttributesDigests";
+NSString * const kTICDSChangedAttributesEncodingVersion = @"kTICDSChangedAttributesEncodingVersion";
+NSString * const kTICDSInsertionRelationshipsVersion = @"kTICDSInsertionRelationshipsVersion";
 
 NSString * const kTICDSSyncWarningType = @"kTICDSSyncWarningType";
 NSString * const kTICDSSyncWarningDescription = @"kTICDSSyncWarningDescription";
 NSString * const kTICDSSyncWarningEntityName = @"kTICDSSyncWarningEntityName";
 NSString * const kTICDSSyncWarningAttributes = @"kTICDSSyncWarningAttributes";
 NSString * const kTICDSSyncWarningRelatedObjectEntityName = @"kTICDSSyncWarningRelatedObjectEntityName";
+NSString * const kTICDSSyncWarningRelevantKey = @"kTICDSSyncWarningRelevantKey";
 
 NSString * const TICDSApplicationSyncManagerDidFinishRegisteringNotification = @"TICDSApplicationSyncManagerDidFinishRegisteringNotification";
 NSString * const TICDSDocumentSyncManagerDidRegisterSuccessfullyNotification = @"TICDSDocumentSyncManagerDidRegisterSuccessfullyNotification";
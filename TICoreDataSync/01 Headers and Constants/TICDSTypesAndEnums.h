@@ -110,10 +110,16 @@ typedef enum _TICDSErrorCode {
     TICDSErrorCodeFZACryptorCreatedSaltDataButRespondedThatItWasNotCorrectlyConfiguredForEncryption,
     TICDSErrorCodeSynchronizationFailedBecauseIntegrityKeysDoNotMatch,
     TICDSErrorCodeSynchronizationFailedBecauseIntegrityKeyDirectoryIsMissing,
+    TICDSErrorCodeDocumentCatalogWasRepeatedlyModifiedByAnotherClient,
+    TICDSErrorCodeClientRegistryWasRepeatedlyModifiedByAnotherClient,
+    TICDSErrorCodeUnsupportedChangedAttributesEncoding,
+    TICDSErrorCodeUnsupportedInsertionRelationships,
+    TICDSErrorCodeExceptionRaisedWhileApplyingSyncChanges,
 } TICDSErrorCode;
 
 typedef enum _FZACryptorErrorCode {
     FZACryptorErrorCodeFailedIntegrityCheck = 10000,
+    FZACryptorErrorCodeProviderFailure,
 } FZACryptorErrorCode;
 
 #pragma mark Operation Phases
@@ -128,6 +134,19 @@ typedef enum _TICDSOperationPhaseStatus {
     
 } TICDSOperationPhaseStatus;
 
+#pragma mark File Transfers
+/** @name File Transfers */
+/** The way `TICDSFileTransfer` transferred a file, from cheapest to most expensive
+ */
+typedef enum _TICDSFileTransferMethod {
+    TICDSFileTransferMethodUnknown = 0,
+    TICDSFileTransferMethodHardLink = 1,
+    TICDSFileTransferMethodClone = 2,
+    TICDSFileTransferMethodCopyFileRange = 3,
+    TICDSFileTransferMethodBufferedCopy = 4,
+    TICDSFileTransferMethodFileManagerCopy = 5,
+} TICDSFileTransferMethod;
+
 #pragma mark Sync Changes
 /** @name Sync Changes */
 /** The type of a sync change
@@ -156,6 +175,7 @@ typedef enum _TICDSSyncWarningType {
     TICDSSyncWarningTypeObjectWithAttributesChangedRemotelyNowDeletedByLocalSyncChange = 6,
     TICDSSyncWarningTypeObjectWithRelationshipsChangedRemotelyNowDeletedByLocalSyncChange = 7,
     TICDSSyncWarningTypeObjectExceptionAroseWhileApplyingAttributeSyncChange = 8,
+    TICDSSyncWarningTypeLocalValueChangedSinceRemoteDeltaAttributeSyncChange = 9,
     
 } TICDSSyncWarningType;
 
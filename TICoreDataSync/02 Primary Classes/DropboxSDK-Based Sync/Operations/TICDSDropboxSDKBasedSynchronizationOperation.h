@@ -9,13 +9,14 @@
 #if TARGET_OS_IPHONE
 
 #import "TICDSSynchronizationOperation.h"
+#import "TICDSTransferWindow.h"
 #import <DropboxSDK/DropboxSDK.h>
 
 /**
  `TICDSDropboxSDKBasedSynchronizationOperation` is a synchronization operation designed for use with a `TICDSDropboxSDKBasedDocumentSyncManager`.
  */
 
-@interface TICDSDropboxSDKBasedSynchronizationOperation : TICDSSynchronizationOperation <DBRestClientDelegate> {
+@interface TICDSDropboxSDKBasedSynchronizationOperation : TICDSSynchronizationOperation <DBRestClientDelegate, TICDSTransferWindowDelegate> {
 @private
     DBSession *_dbSession;
     DBRestClient *_restClient;
@@ -29,6 +30,10 @@
     NSString *_thisDocumentRecentSyncsThisClientFilePath;
     
     NSMutableDictionary *_failedDownloadRetryDictionary;
+    
+    TICDSTransferWindow *_transferWindow;
+    NSUInteger _maximumConcurrentTransfers;
+    dispatch_queue_t _decryptionQueue;
 }
 
 /** @name Properties */
@@ -39,6 +44,14 @@
 /** The DropboxSDK `DBRestClient` for use by this operation. */
 @property (nonatomic, readonly) DBRestClient *restClient;
 
+/** The transfer window through which sync change sets are downloaded, oldest first, retrying rate-limited and failed requests with backoff. */
+@property (nonatomic, readonly) TICDSTransferWindow *transferWindow;
+
+/** The maximum number of sync change sets downloaded at the same time; defaults to `4`.
+ 
+ Dropbox rate-limits clients that make too many requests at once, so downloads are paced through the `transferWindow` rather than all being requested up front. */
+@property (nonatomic, assign) NSUInteger maximumConcurrentTransfers;
+
 /** @name Paths */
 
 /** The path to this document's directory. */
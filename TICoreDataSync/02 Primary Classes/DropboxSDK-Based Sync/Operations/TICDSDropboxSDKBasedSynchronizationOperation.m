@@ -29,6 +29,8 @@
 
 - (void)uploadLocalSyncChangeSetFileWithParentRevision:(NSString *)parentRevision;
 - (void)uploadRecentSyncFileWithParentRevision:(NSString *)parentRevision;
+- (NSDate *)creationDateOfSyncChangeSetWithIdentifier:(NSString *)anIdentifier;
+- (void)finishedLoadingSyncChangeSetToPath:(NSString *)aPath;
 
 @end
 
@@ -68,7 +70,35 @@
     
     [[self clientIdentifiersForChangeSetIdentifiers] setValue:aClientIdentifier forKey:aChangeSetIdentifier];
     
-    [[self restClient] loadFile:[self pathToSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientWithIdentifier:aClientIdentifier] intoPath:[aLocation path]];
+    [[self transferWindow] enqueueTransferWithIdentifier:[self pathToSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientWithIdentifier:aClientIdentifier] priorityDate:[self creationDateOfSyncChangeSetWithIdentifier:aChangeSetIdentifier] userInfo:[NSDictionary dictionaryWithObject:[aLocation path] forKey:@"destinationPath"]];
+}
+
+- (void)fetchSyncChangeSetsWithIdentifiersByClientIdentifier:(NSDictionary *)someIdentifiers toDirectoryLocation:(NSURL *)aDirectoryLocation
+{
+    // hold back the downloads until they've all been enqueued, so the oldest start first whichever client they came from
+    [[self transferWindow] setSuspended:YES];
+    
+    [super fetchSyncChangeSetsWithIdentifiersByClientIdentifier:someIdentifiers toDirectoryLocation:aDirectoryLocation];
+    
+    [[self transferWindow] setSuspended:NO];
+}
+
+- (NSDate *)creationDateOfSyncChangeSetWithIdentifier:(NSString *)anIdentifier
+{
+    // sync change set identifiers begin with the reference date time interval at which they were created
+    NSRange separatorRange = [anIdentifier rangeOfString:@"-"];
+    
+    if( separatorRange.location == NSNotFound || separatorRange.location == 0 ) {
+        return [[self changeSetModificationDates] valueForKey:anIdentifier];
+    }
+    
+    return [NSDate dateWithTimeIntervalSinceReferenceDate:[[anIdentifier substringToIndex:separatorRange.location] doubleValue]];
+}
+
+#pragma mark Transfer Window Delegate
+- (void)transferWindow:(TICDSTransferWindow *)aWindow startTransferWithIdentifier:(NSString *)anIdentifier userInfo:(NSDictionary *)someUserInfo
+{
+    [[self restClient] loadFile:anIdentifier intoPath:[someUserInfo valueForKey:@"destinationPath"]];
 }
 
 #pragma mark Uploading Change Sets
@@ -208,70 +238,77 @@
 #pragma mark Loading Files
 - (void)restClient:(DBRestClient*)client loadedFile:(NSString*)destPath
 {
-    NSError *anyError = nil;
-    BOOL success = YES;
-
-    if (destPath != nil) {
-        [self.failedDownloadRetryDictionary removeObjectForKey:destPath];
+    if( ![[[destPath lastPathComponent] pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] ) {
+        return;
     }
-
-    if( [[[destPath lastPathComponent] pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] ) {
+    
+    NSString *changeSetIdentifier = [[destPath lastPathComponent] stringByDeletingPathExtension];
+    NSString *clientIdentifier = [[self clientIdentifiersForChangeSetIdentifiers] valueForKey:changeSetIdentifier];
+    
+    [[self transferWindow] transferDidFinishWithIdentifier:[self pathToSyncChangeSetWithIdentifier:changeSetIdentifier forClientWithIdentifier:clientIdentifier]];
+    
+    if( ![self shouldUseEncryption] ) {
+        [self finishedLoadingSyncChangeSetToPath:destPath];
+        return;
+    }
+    
+    // decrypt on a background queue, so the main thread stays free to handle the other downloads' callbacks
+    dispatch_async(_decryptionQueue, ^{
+        NSFileManager *fileManager = [[NSFileManager alloc] init];
+        NSString *tmpPath = [[self tempFileDirectoryPath] stringByAppendingPathComponent:[destPath lastPathComponent]];
+        NSError *anyError = nil;
+        TICDSErrorCode errorCode = TICDSErrorCodeFileManagerError;
         
-        NSString *changeSetIdentifier = [[destPath lastPathComponent] stringByDeletingPathExtension];
-        NSString *clientIdentifier = [[self clientIdentifiersForChangeSetIdentifiers] valueForKey:changeSetIdentifier];
+        BOOL success = [fileManager moveItemAtPath:destPath toPath:tmpPath error:&anyError];
         
-        if( [self shouldUseEncryption] ) {
-            NSString *tmpPath = [[self tempFileDirectoryPath] stringByAppendingPathComponent:[destPath lastPathComponent]];
-            
-            success = [[self fileManager] moveItemAtPath:destPath toPath:tmpPath error:&anyError];
-            
-            if( !success ) {
-                [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-                [self fetchedSyncChangeSetWithIdentifier:changeSetIdentifier forClientIdentifier:clientIdentifier modificationDate:nil withSuccess:NO];
-                return;
-            }
-            
+        if( success ) {
+            errorCode = TICDSErrorCodeEncryptionError;
             success = [[self cryptor] decryptFileAtLocation:[NSURL fileURLWithPath:tmpPath] writingToLocation:[NSURL fileURLWithPath:destPath] error:&anyError];
-            
-            if( !success ) {
-                [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-            }
         }
         
-        [self fetchedSyncChangeSetWithIdentifier:changeSetIdentifier forClientIdentifier:clientIdentifier modificationDate:[[self changeSetModificationDates] valueForKey:changeSetIdentifier] withSuccess:success];
-        return;
-    }
+        [fileManager release];
+        
+        [anyError retain];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if( success ) {
+                [self finishedLoadingSyncChangeSetToPath:destPath];
+            } else {
+                [self setError:[TICDSError errorWithCode:errorCode underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+                [self fetchedSyncChangeSetWithIdentifier:changeSetIdentifier forClientIdentifier:clientIdentifier modificationDate:nil withSuccess:NO];
+            }
+            [anyError release];
+        });
+    });
+}
+
+- (void)finishedLoadingSyncChangeSetToPath:(NSString *)aPath
+{
+    NSString *changeSetIdentifier = [[aPath lastPathComponent] stringByDeletingPathExtension];
+    NSString *clientIdentifier = [[self clientIdentifiersForChangeSetIdentifiers] valueForKey:changeSetIdentifier];
+    
+    [self fetchedSyncChangeSetWithIdentifier:changeSetIdentifier forClientIdentifier:clientIdentifier modificationDate:[[self changeSetModificationDates] valueForKey:changeSetIdentifier] withSuccess:YES];
 }
 
 - (void)restClient:(DBRestClient *)client loadFileFailedWithError:(NSError *)error
 {
     NSString *path = [[error userInfo] valueForKey:@"path"];
-    NSString *downloadDestination = [[error userInfo] valueForKey:@"destinationPath"];
     
-    if (path != nil && downloadDestination != nil && [[self.failedDownloadRetryDictionary objectForKey:path] integerValue] < 5) {
-        NSInteger retryCount = [[self.failedDownloadRetryDictionary objectForKey:path] integerValue];
-        retryCount++;
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to download %@. Going for try number %d", path, retryCount);
-        [self.failedDownloadRetryDictionary setObject:[NSNumber numberWithInteger:retryCount] forKey:path];
-        [[self restClient] loadFile:path intoPath:downloadDestination];
+    if( ![[[path lastPathComponent] pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] ) {
         return;
     }
     
-    if (path != nil) {
-        [self.failedDownloadRetryDictionary removeObjectForKey:path];
+    if( [[self transferWindow] retryTransferWithIdentifier:path afterError:error] ) {
+        return;
     }
     
-    TICDSLog(TICDSLogVerbosityErrorsOnly, @"Download of %@ has failed after 5 attempts, we're falling through to the error condition.", path);
-
+    TICDSLog(TICDSLogVerbosityErrorsOnly, @"Download of %@ has failed, we're falling through to the error condition.", path);
+    
     [self setError:[TICDSError errorWithCode:TICDSErrorCodeDropboxSDKRestClientError underlyingError:error classAndMethod:__PRETTY_FUNCTION__]];
     
-    if( [[[path lastPathComponent] pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] ) {
-        NSString *changeSetIdentifier = [[path lastPathComponent] stringByDeletingPathExtension];
-        NSString *clientIdentifier = [[self clientIdentifiersForChangeSetIdentifiers] valueForKey:changeSetIdentifier];
-        
-        [self fetchedSyncChangeSetWithIdentifier:changeSetIdentifier forClientIdentifier:clientIdentifier modificationDate:nil withSuccess:NO];
-        return;
-    }
+    NSString *changeSetIdentifier = [[path lastPathComponent] stringByDeletingPathExtension];
+    NSString *clientIdentifier = [[self clientIdentifiersForChangeSetIdentifiers] valueForKey:changeSetIdentifier];
+    
+    [self fetchedSyncChangeSetWithIdentifier:changeSetIdentifier forClientIdentifier:clientIdentifier modificationDate:nil withSuccess:NO];
 }
 
 #pragma mark Revisions
@@ -375,9 +412,28 @@
 
 #pragma mark -
 #pragma mark Initialization and Deallocation
+- (id)initWithDelegate:(NSObject<TICDSOperationDelegate> *)aDelegate
+{
+    self = [super initWithDelegate:aDelegate];
+    if( !self ) {
+        return nil;
+    }
+    
+    _maximumConcurrentTransfers = 4;
+    _decryptionQueue = dispatch_queue_create("com.timisted.ticoredatasync.dropboxdecryption", DISPATCH_QUEUE_SERIAL);
+    
+    return self;
+}
+
 - (void)dealloc
 {
     [_restClient setDelegate:nil];
+    [_transferWindow cancelAllTransfers];
+    [_transferWindow setDelegate:nil];
+    
+    if( _decryptionQueue ) {
+        dispatch_release(_decryptionQueue), _decryptionQueue = NULL;
+    }
 
     [_dbSession release], _dbSession = nil;
     [_restClient release], _restClient = nil;
@@ -387,6 +443,8 @@
     [_thisDocumentSyncChangesDirectoryPath release], _thisDocumentSyncChangesDirectoryPath = nil;
     [_thisDocumentSyncChangesThisClientDirectoryPath release], _thisDocumentSyncChangesThisClientDirectoryPath = nil;
     [_thisDocumentRecentSyncsThisClientFilePath release], _thisDocumentRecentSyncsThisClientFilePath = nil;
+    [_failedDownloadRetryDictionary release], _failedDownloadRetryDictionary = nil;
+    [_transferWindow release], _transferWindow = nil;
 
     [super dealloc];
 }
@@ -403,6 +461,17 @@
     return _restClient;
 }
 
+- (TICDSTransferWindow *)transferWindow
+{
+    if( _transferWindow ) return _transferWindow;
+    
+    _transferWindow = [[TICDSTransferWindow alloc] init];
+    [_transferWindow setDelegate:self];
+    [_transferWindow setMaximumConcurrentTransfers:[self maximumConcurrentTransfers]];
+    
+    return _transferWindow;
+}
+
 - (NSMutableDictionary *)failedDownloadRetryDictionary
 {
     if (_failedDownloadRetryDictionary == nil) {
@@ -416,6 +485,8 @@
 #pragma mark Properties
 @synthesize dbSession = _dbSession;
 @synthesize restClient = _restClient;
+@synthesize transferWindow = _transferWindow;
+@synthesize maximumConcurrentTransfers = _maximumConcurrentTransfers;
 @synthesize clientIdentifiersForChangeSetIdentifiers = _clientIdentifiersForChangeSetIdentifiers;
 @synthesize changeSetModificationDates = _changeSetModificationDates;
 @synthesize thisDocumentDirectoryPath = _thisDocumentDirectoryPath;
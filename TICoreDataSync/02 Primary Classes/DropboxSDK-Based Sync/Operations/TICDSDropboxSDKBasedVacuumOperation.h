@@ -9,6 +9,7 @@
 #if TARGET_OS_IPHONE
 
 #import "TICDSVacuumOperation.h"
+#import "TICDSTransferWindow.h"
 
 #import <DropboxSDK/DropboxSDK.h>
 
@@ -16,7 +17,7 @@
  `TICDSDropboxSDKBasedVacuumOperation` is a vacuum operation designed for use with a `TICDSDropboxSDKBasedDocumentSyncManager`.
  */
 
-@interface TICDSDropboxSDKBasedVacuumOperation : TICDSVacuumOperation <DBRestClientDelegate> {
+@interface TICDSDropboxSDKBasedVacuumOperation : TICDSVacuumOperation <DBRestClientDelegate, TICDSTransferWindowDelegate> {
 @private
     DBSession *_dbSession;
     DBRestClient *_restClient;
@@ -30,6 +31,9 @@
     NSUInteger _numberOfFilesThatFailedToBeDeleted;
     NSUInteger _numberOfFilesDeleted;
     
+    TICDSTransferWindow *_deletionWindow;
+    NSUInteger _maximumConcurrentDeletions;
+    
     NSString *_thisDocumentWholeStoreDirectoryPath;
     NSString *_thisDocumentRecentSyncsDirectoryPath;
     NSString *_thisDocumentSyncChangesThisClientDirectoryPath;
@@ -46,6 +50,14 @@
 /** The Last Modified Date of the oldest WholeStore file. */
 @property (nonatomic, retain) NSDate *oldestStoreDate;
 
+/** The transfer window through which old sync change sets are deleted, oldest first, retrying rate-limited and failed requests with backoff. */
+@property (nonatomic, readonly) TICDSTransferWindow *deletionWindow;
+
+/** The maximum number of sync change sets deleted at the same time; defaults to `8`.
+ 
+ The Dropbox API deletes one path per request, so rather than requesting every deletion up front, which gets the client rate-limited, deletions are paced through the `deletionWindow`. */
+@property (nonatomic, assign) NSUInteger maximumConcurrentDeletions;
+
 /** @name Paths */
 
 /** The path to a given client's `WholeStore.ticdsync` file within this document's `WholeStore` directory.
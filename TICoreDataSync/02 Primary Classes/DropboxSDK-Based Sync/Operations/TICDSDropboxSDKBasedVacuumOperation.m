@@ -10,6 +10,12 @@
 
 #import "TICoreDataSync.h"
 
+@interface TICDSDropboxSDKBasedVacuumOperation ()
+
+- (void)finishedDeletingSyncChangeSetAtPath:(NSString *)aPath;
+- (void)finishRemovingOldSyncChangeSetFilesIfPossible;
+
+@end
 
 @implementation TICDSDropboxSDKBasedVacuumOperation
 
@@ -142,12 +148,14 @@
             return;
         }
         
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Deleting %lu old sync change sets", (unsigned long)_numberOfFilesToDelete);
+        
         for( DBMetadata *eachSubMetadata in [metadata contents] ) {
             if( [eachSubMetadata isDeleted] || [[eachSubMetadata lastModifiedDate] compare:[self earliestDateForFilesToKeep]] == NSOrderedDescending ) {
                 continue;
             }
             
-            [[self restClient] deletePath:[eachSubMetadata path]];
+            [[self deletionWindow] enqueueTransferWithIdentifier:[eachSubMetadata path] priorityDate:[eachSubMetadata lastModifiedDate] userInfo:nil];
         }
     }
 }
@@ -193,36 +201,70 @@
 #pragma mark Deletion
 - (void)restClient:(DBRestClient*)client deletedPath:(NSString *)path
 {
-    if( [[path stringByDeletingLastPathComponent] isEqualToString:[self thisDocumentSyncChangesThisClientDirectoryPath]] ) {
-        _numberOfFilesDeleted++;
-        
-        if( _numberOfFilesDeleted == _numberOfFilesToDelete ) {
-            [self removedOldSyncChangeSetFilesWithSuccess:YES];
-            return;
-        }
-        
-        if( _numberOfFilesDeleted + _numberOfFilesThatFailedToBeDeleted == _numberOfFilesToDelete ) {
-            [self removedOldSyncChangeSetFilesWithSuccess:YES];
-            return;
-        }
-        
+    if( ![[path stringByDeletingLastPathComponent] isEqualToString:[self thisDocumentSyncChangesThisClientDirectoryPath]] ) {
         return;
     }
+    
+    _numberOfFilesDeleted++;
+    
+    if( _numberOfFilesDeleted % 100 == 0 ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Deleted %lu of %lu old sync change sets", (unsigned long)_numberOfFilesDeleted, (unsigned long)_numberOfFilesToDelete);
+    }
+    
+    [self finishedDeletingSyncChangeSetAtPath:path];
 }
 
 - (void)restClient:(DBRestClient*)client deletePathFailedWithError:(NSError*)error
 {
     NSString *path = [[error userInfo] valueForKey:@"path"];
     
+    if( ![[path stringByDeletingLastPathComponent] isEqualToString:[self thisDocumentSyncChangesThisClientDirectoryPath]] ) {
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeDropboxSDKRestClientError underlyingError:error classAndMethod:__PRETTY_FUNCTION__]];
+        return;
+    }
+    
+    if( ![self isCancelled] && [[self deletionWindow] retryTransferWithIdentifier:path afterError:error] ) {
+        return;
+    }
+    
     [self setError:[TICDSError errorWithCode:TICDSErrorCodeDropboxSDKRestClientError underlyingError:error classAndMethod:__PRETTY_FUNCTION__]];
-    if( [[path stringByDeletingLastPathComponent] isEqualToString:[self thisDocumentSyncChangesThisClientDirectoryPath]] ) {
-        _numberOfFilesThatFailedToBeDeleted++;
-        
-        if( _numberOfFilesDeleted + _numberOfFilesThatFailedToBeDeleted == _numberOfFilesToDelete ) {
-            [self removedOldSyncChangeSetFilesWithSuccess:NO];
-            return;
-        }
+    _numberOfFilesThatFailedToBeDeleted++;
+    
+    [self finishedDeletingSyncChangeSetAtPath:path];
+}
+
+- (void)finishedDeletingSyncChangeSetAtPath:(NSString *)aPath
+{
+    if( [self isCancelled] ) {
+        // stop starting new deletions; those already in flight are left to finish
+        [[self deletionWindow] cancelAllTransfers];
+    }
+    
+    [[self deletionWindow] transferDidFinishWithIdentifier:aPath];
+    
+    [self finishRemovingOldSyncChangeSetFilesIfPossible];
+}
+
+- (void)finishRemovingOldSyncChangeSetFilesIfPossible
+{
+    if( [[self deletionWindow] hasUnfinishedTransfers] ) {
+        return;
     }
+    
+    if( _numberOfFilesDeleted + _numberOfFilesThatFailedToBeDeleted < _numberOfFilesToDelete ) {
+        // deletions were cancelled before they all started
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeTaskWasCancelled classAndMethod:__PRETTY_FUNCTION__]];
+        [self removedOldSyncChangeSetFilesWithSuccess:NO];
+        return;
+    }
+    
+    [self removedOldSyncChangeSetFilesWithSuccess:_numberOfFilesThatFailedToBeDeleted < 1];
+}
+
+#pragma mark Transfer Window Delegate
+- (void)transferWindow:(TICDSTransferWindow *)aWindow startTransferWithIdentifier:(NSString *)anIdentifier userInfo:(NSDictionary *)someUserInfo
+{
+    [[self restClient] deletePath:anIdentifier];
 }
 
 #pragma mark -
@@ -234,13 +276,28 @@
 
 #pragma mark -
 #pragma mark Initialization and Deallocation
+- (id)initWithDelegate:(NSObject<TICDSOperationDelegate> *)aDelegate
+{
+    self = [super initWithDelegate:aDelegate];
+    if( !self ) {
+        return nil;
+    }
+    
+    _maximumConcurrentDeletions = 8;
+    
+    return self;
+}
+
 - (void)dealloc
 {
     [_restClient setDelegate:nil];
+    [_deletionWindow cancelAllTransfers];
+    [_deletionWindow setDelegate:nil];
 
     [_dbSession release], _dbSession = nil;
     [_restClient release], _restClient = nil;
     [_oldestStoreDate release], _oldestStoreDate = nil;
+    [_deletionWindow release], _deletionWindow = nil;
     [_thisDocumentWholeStoreDirectoryPath release], _thisDocumentWholeStoreDirectoryPath = nil;
     [_thisDocumentSyncChangesThisClientDirectoryPath release], _thisDocumentSyncChangesThisClientDirectoryPath = nil;
     [_thisDocumentRecentSyncsDirectoryPath release], _thisDocumentRecentSyncsDirectoryPath = nil;
@@ -260,11 +317,24 @@
     return _restClient;
 }
 
+- (TICDSTransferWindow *)deletionWindow
+{
+    if( _deletionWindow ) return _deletionWindow;
+    
+    _deletionWindow = [[TICDSTransferWindow alloc] init];
+    [_deletionWindow setDelegate:self];
+    [_deletionWindow setMaximumConcurrentTransfers:[self maximumConcurrentDeletions]];
+    
+    return _deletionWindow;
+}
+
 #pragma mark -
 #pragma mark Properties
 @synthesize dbSession = _dbSession;
 @synthesize restClient = _restClient;
 @synthesize oldestStoreDate = _oldestStoreDate;
+@synthesize deletionWindow = _deletionWindow;
+@synthesize maximumConcurrentDeletions = _maximumConcurrentDeletions;
 @synthesize thisDocumentWholeStoreDirectoryPath = _thisDocumentWholeStoreDirectoryPath;
 @synthesize thisDocumentRecentSyncsDirectoryPath = _thisDocumentRecentSyncsDirectoryPath;
 @synthesize thisDocumentSyncChangesThisClientDirectoryPath = _thisDocumentSyncChangesThisClientDirectoryPath;
@@ -24,6 +24,8 @@
     DBSession *_dbSession;
     
     NSString *_applicationDirectoryPath;
+    
+    NSUInteger _maximumConcurrentTransfers;
 }
 
 /** @name Properties */
@@ -31,6 +33,11 @@
 /** The DropboxSDK `DBSession` object to use for Dropbox access. If you don't set this property, TICoreDataSync will use the `[DBSession sharedSession]`. */
 @property (nonatomic, retain) DBSession *dbSession;
 
+/** The maximum number of sync change sets downloaded from the Dropbox at the same time during synchronization.
+ 
+ Leave as `0` to use the synchronization operation's default. */
+@property (nonatomic, assign) NSUInteger maximumConcurrentTransfers;
+
 /** @name Paths */
 
 /** The path to the root of the application. This will be set automatically when you register and supply a `TICDSFileManagerBasedApplicationSyncManager`. */
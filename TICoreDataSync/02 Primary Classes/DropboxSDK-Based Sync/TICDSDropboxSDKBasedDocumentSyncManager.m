@@ -84,6 +84,10 @@
     [operation setThisDocumentSyncChangesThisClientDirectoryPath:[self thisDocumentSyncChangesThisClientDirectoryPath]];
     [operation setThisDocumentRecentSyncsThisClientFilePath:[self thisDocumentRecentSyncsThisClientFilePath]];
     
+    if( [self maximumConcurrentTransfers] > 0 ) {
+        [operation setMaximumConcurrentTransfers:[self maximumConcurrentTransfers]];
+    }
+    
     return [operation autorelease];
 }
 
@@ -246,6 +250,7 @@
 #pragma mark Properties
 @synthesize dbSession = _dbSession;
 @synthesize applicationDirectoryPath = _applicationDirectoryPath;
+@synthesize maximumConcurrentTransfers = _maximumConcurrentTransfers;
 
 @end
 
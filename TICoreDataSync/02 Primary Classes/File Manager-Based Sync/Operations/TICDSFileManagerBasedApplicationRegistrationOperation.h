@@ -19,6 +19,7 @@
     NSString *_encryptionDirectoryTestDataFilePath;
     NSString *_clientDevicesDirectoryPath;
     NSString *_clientDevicesThisClientDeviceDirectoryPath;
+    NSString *_clientRegistryFilePath;
 }
 
 /** @name Properties */
@@ -38,4 +39,7 @@
 /** The path to the this client's directory inside the `ClientDevices` directory. */
 @property (retain) NSString *clientDevicesThisClientDeviceDirectoryPath;
 
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory. */
+@property (retain) NSString *clientRegistryFilePath;
+
 @end
@@ -8,6 +8,12 @@
 
 #import "TICoreDataSync.h"
 
+@interface TICDSFileManagerBasedApplicationRegistrationOperation ()
+
+- (void)addDeviceInfoToClientRegistry:(NSDictionary *)aDictionary;
+
+@end
+
 @implementation TICDSFileManagerBasedApplicationRegistrationOperation
 
 #pragma mark -
@@ -191,6 +197,8 @@
         
         if( !success ) {
             [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError classAndMethod:__PRETTY_FUNCTION__]];
+        } else {
+            [self addDeviceInfoToClientRegistry:aDictionary];
         }
         
         [self savedRemoteClientDeviceInfoPlistWithSuccess:success];
@@ -213,11 +221,33 @@
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+    } else {
+        [self addDeviceInfoToClientRegistry:aDictionary];
     }
     
     [self savedRemoteClientDeviceInfoPlistWithSuccess:success];
 }
 
+- (void)addDeviceInfoToClientRegistry:(NSDictionary *)aDictionary
+{
+    if( ![self clientRegistryFilePath] ) {
+        return;
+    }
+    
+    // the registry only saves fetches when listing clients, so failing to update it isn't an error
+    NSError *anyError = nil;
+    BOOL success = [self updateClientRegistryAtPath:[self clientRegistryFilePath] usingBlock:^(NSMutableDictionary *someEntries) {
+        NSMutableDictionary *entry = [NSMutableDictionary dictionaryWithDictionary:aDictionary];
+        NSArray *documentIdentifiers = [[someEntries valueForKey:[self clientIdentifier]] valueForKey:kTICDSRegisteredDocumentIdentifiers];
+        [entry setValue:documentIdentifiers ? documentIdentifiers : [NSArray array] forKey:kTICDSRegisteredDocumentIdentifiers];
+        [someEntries setValue:entry forKey:[self clientIdentifier]];
+    } error:&anyError];
+    
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to add this client to the client registry: %@", anyError);
+    }
+}
+
 #pragma mark -
 #pragma mark Initialization and Deallocation
 - (void)dealloc
@@ -227,6 +257,7 @@
     [_encryptionDirectoryTestDataFilePath release], _encryptionDirectoryTestDataFilePath = nil;
     [_clientDevicesDirectoryPath release], _clientDevicesDirectoryPath = nil;
     [_clientDevicesThisClientDeviceDirectoryPath release], _clientDevicesThisClientDeviceDirectoryPath = nil;
+    [_clientRegistryFilePath release], _clientRegistryFilePath = nil;
     
     [super dealloc];
 }
@@ -238,5 +269,6 @@
 @synthesize encryptionDirectoryTestDataFilePath = _encryptionDirectoryTestDataFilePath;
 @synthesize clientDevicesDirectoryPath = _clientDevicesDirectoryPath;
 @synthesize clientDevicesThisClientDeviceDirectoryPath = _clientDevicesThisClientDeviceDirectoryPath;
+@synthesize clientRegistryFilePath = _clientRegistryFilePath;
 
 @end
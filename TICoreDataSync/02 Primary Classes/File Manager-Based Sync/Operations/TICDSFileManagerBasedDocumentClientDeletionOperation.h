@@ -19,6 +19,7 @@
     NSString *_thisDocumentSyncCommandsDirectoryPath;
     NSString *_thisDocumentRecentSyncsDirectoryPath;
     NSString *_thisDocumentWholeStoreDirectoryPath;
+    NSString *_clientRegistryFilePath;
 }
 
 /** @name Paths */
@@ -41,4 +42,7 @@
 /** The path to the document's `WholeStore` directory. */
 @property (retain) NSString *thisDocumentWholeStoreDirectoryPath;
 
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory. */
+@property (retain) NSString *clientRegistryFilePath;
+
 @end
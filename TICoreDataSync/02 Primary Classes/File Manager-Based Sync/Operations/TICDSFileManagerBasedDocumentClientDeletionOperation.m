@@ -68,10 +68,31 @@
     NSString *directoryPath = [[self thisDocumentSyncChangesDirectoryPath] stringByAppendingPathComponent:[self identifierOfClientToBeDeleted]];
     
     NSError *anyError = nil;
-    BOOL success = [self removeItemAtPath:directoryPath error:&anyError];
+    BOOL success = [self removeDirectoryTreeAtPath:directoryPath error:&anyError];
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+    } else if( [self clientRegistryFilePath] ) {
+        NSString *documentIdentifier = [[[self thisDocumentSyncChangesDirectoryPath] stringByDeletingLastPathComponent] lastPathComponent];
+        
+        BOOL registryUpdated = [self updateClientRegistryAtPath:[self clientRegistryFilePath] usingBlock:^(NSMutableDictionary *someEntries) {
+            NSDictionary *entry = [someEntries valueForKey:[self identifierOfClientToBeDeleted]];
+            
+            if( ![[entry valueForKey:kTICDSRegisteredDocumentIdentifiers] containsObject:documentIdentifier] ) {
+                return;
+            }
+            
+            NSMutableArray *documentIdentifiers = [NSMutableArray arrayWithArray:[entry valueForKey:kTICDSRegisteredDocumentIdentifiers]];
+            [documentIdentifiers removeObject:documentIdentifier];
+            
+            NSMutableDictionary *updatedEntry = [NSMutableDictionary dictionaryWithDictionary:entry];
+            [updatedEntry setValue:documentIdentifiers forKey:kTICDSRegisteredDocumentIdentifiers];
+            [someEntries setValue:updatedEntry forKey:[self identifierOfClientToBeDeleted]];
+        } error:&anyError];
+        
+        if( !registryUpdated ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to remove the document from the deleted client's entry in the client registry: %@", anyError);
+        }
     }
     
     [self deletedClientDirectoryFromDocumentSyncChangesDirectoryWithSuccess:success];
@@ -82,7 +103,7 @@
     NSString *directoryPath = [[self thisDocumentSyncCommandsDirectoryPath] stringByAppendingPathComponent:[self identifierOfClientToBeDeleted]];
     
     NSError *anyError = nil;
-    BOOL success = [self removeItemAtPath:directoryPath error:&anyError];
+    BOOL success = [self removeDirectoryTreeAtPath:directoryPath error:&anyError];
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
@@ -132,7 +153,7 @@
     NSString *directoryPath = [[self thisDocumentWholeStoreDirectoryPath] stringByAppendingPathComponent:[self identifierOfClientToBeDeleted]];
     
     NSError *anyError = nil;
-    BOOL success = [self removeItemAtPath:directoryPath error:&anyError];
+    BOOL success = [self removeDirectoryTreeAtPath:directoryPath error:&anyError];
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
@@ -151,6 +172,7 @@
     [_thisDocumentSyncCommandsDirectoryPath release], _thisDocumentSyncCommandsDirectoryPath = nil;
     [_thisDocumentRecentSyncsDirectoryPath release], _thisDocumentRecentSyncsDirectoryPath = nil;
     [_thisDocumentWholeStoreDirectoryPath release], _thisDocumentWholeStoreDirectoryPath = nil;
+    [_clientRegistryFilePath release], _clientRegistryFilePath = nil;
 
     [super dealloc];
 }
@@ -163,5 +185,6 @@
 @synthesize thisDocumentSyncCommandsDirectoryPath = _thisDocumentSyncCommandsDirectoryPath;
 @synthesize thisDocumentRecentSyncsDirectoryPath = _thisDocumentRecentSyncsDirectoryPath;
 @synthesize thisDocumentWholeStoreDirectoryPath = _thisDocumentWholeStoreDirectoryPath;
+@synthesize clientRegistryFilePath = _clientRegistryFilePath;
 
 @end
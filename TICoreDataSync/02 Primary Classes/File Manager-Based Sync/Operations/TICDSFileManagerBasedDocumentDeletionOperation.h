@@ -17,6 +17,8 @@
     NSString *_documentDirectoryPath;
     NSString *_documentInfoPlistFilePath;
     NSString *_deletedDocumentsDirectoryIdentifierPlistFilePath;
+    NSString *_documentCatalogFilePath;
+    NSString *_clientRegistryFilePath;
 }
 
 /** @name Paths */
@@ -30,4 +32,10 @@
 /** The path to the `identifier.plist` file for this document inside the application's `DeletedDocuments` directory. */
 @property (retain) NSString *deletedDocumentsDirectoryIdentifierPlistFilePath;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory. */
+@property (retain) NSString *documentCatalogFilePath;
+
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory. */
+@property (retain) NSString *clientRegistryFilePath;
+
 @end
@@ -57,10 +57,35 @@
 - (void)deleteDocumentDirectory
 {
     NSError *anyError = nil;
-    BOOL success = [self removeItemAtPath:[self documentDirectoryPath] error:&anyError];
+    BOOL success = [self removeDirectoryTreeAtPath:[self documentDirectoryPath] error:&anyError];
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+    } else if( [self documentCatalogFilePath] && ![self updateDocumentCatalogAtPath:[self documentCatalogFilePath] usingBlock:^(NSMutableDictionary *someEntries) {
+        [someEntries removeObjectForKey:[self documentIdentifier]];
+    } error:&anyError] ) {
+        // listing ignores catalog entries for documents that no longer exist, so this isn't an error
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to remove document from the document catalog: %@", anyError);
+    }
+    
+    if( success && [self clientRegistryFilePath] && ![self updateClientRegistryAtPath:[self clientRegistryFilePath] usingBlock:^(NSMutableDictionary *someEntries) {
+        for( NSString *eachIdentifier in [someEntries allKeys] ) {
+            NSDictionary *entry = [someEntries valueForKey:eachIdentifier];
+            NSMutableArray *documentIdentifiers = [NSMutableArray arrayWithArray:[entry valueForKey:kTICDSRegisteredDocumentIdentifiers]];
+            
+            if( ![documentIdentifiers containsObject:[self documentIdentifier]] ) {
+                continue;
+            }
+            
+            [documentIdentifiers removeObject:[self documentIdentifier]];
+            
+            NSMutableDictionary *updatedEntry = [NSMutableDictionary dictionaryWithDictionary:entry];
+            [updatedEntry setValue:documentIdentifiers forKey:kTICDSRegisteredDocumentIdentifiers];
+            [someEntries setValue:updatedEntry forKey:eachIdentifier];
+        }
+    } error:&anyError] ) {
+        // listing ignores registered documents that no longer exist, so this isn't an error either
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to remove document from the client registry: %@", anyError);
     }
     
     [self deletedDocumentDirectoryWithSuccess:success];
@@ -73,6 +98,8 @@
     [_documentDirectoryPath release], _documentDirectoryPath = nil;
     [_documentInfoPlistFilePath release], _documentInfoPlistFilePath = nil;
     [_deletedDocumentsDirectoryIdentifierPlistFilePath release], _deletedDocumentsDirectoryIdentifierPlistFilePath = nil;
+    [_documentCatalogFilePath release], _documentCatalogFilePath = nil;
+    [_clientRegistryFilePath release], _clientRegistryFilePath = nil;
     
     [super dealloc];
 }
@@ -81,5 +108,7 @@
 @synthesize documentDirectoryPath = _documentDirectoryPath;
 @synthesize documentInfoPlistFilePath = _documentInfoPlistFilePath;
 @synthesize deletedDocumentsDirectoryIdentifierPlistFilePath = _deletedDocumentsDirectoryIdentifierPlistFilePath;
+@synthesize documentCatalogFilePath = _documentCatalogFilePath;
+@synthesize clientRegistryFilePath = _clientRegistryFilePath;
 
 @end
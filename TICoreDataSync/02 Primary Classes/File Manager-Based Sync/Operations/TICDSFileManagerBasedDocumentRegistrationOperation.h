@@ -21,6 +21,8 @@
     NSString *_thisDocumentDirectoryPath;
     NSString *_thisDocumentSyncChangesThisClientDirectoryPath;
     NSString *_thisDocumentSyncCommandsThisClientDirectoryPath;
+    NSString *_documentCatalogFilePath;
+    NSString *_clientRegistryFilePath;
 }
 
 /** @name Paths */
@@ -46,4 +48,10 @@
 /** The path to this client's directory inside this document's `SyncCommands` directory. */
 @property (retain) NSString *thisDocumentSyncCommandsThisClientDirectoryPath;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory. */
+@property (retain) NSString *documentCatalogFilePath;
+
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory. */
+@property (retain) NSString *clientRegistryFilePath;
+
 @end
@@ -8,6 +8,13 @@
 
 #import "TICoreDataSync.h"
 
+@interface TICDSFileManagerBasedDocumentRegistrationOperation ()
+
+- (void)addDocumentInfoToDocumentCatalog:(NSDictionary *)aDictionary;
+- (void)addDocumentToClientRegistry;
+
+@end
+
 @implementation TICDSFileManagerBasedDocumentRegistrationOperation
 
 #pragma mark -
@@ -85,6 +92,8 @@
         
         if( !success ) {
             [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError classAndMethod:__PRETTY_FUNCTION__]];
+        } else {
+            [self addDocumentInfoToDocumentCatalog:aDictionary];
         }
         
         [self savedRemoteDocumentInfoPlistWithSuccess:success];
@@ -107,11 +116,32 @@
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+    } else {
+        [self addDocumentInfoToDocumentCatalog:aDictionary];
     }
     
     [self savedRemoteDocumentInfoPlistWithSuccess:success];
 }
 
+- (void)addDocumentInfoToDocumentCatalog:(NSDictionary *)aDictionary
+{
+    if( ![self documentCatalogFilePath] ) {
+        return;
+    }
+    
+    // the catalog only saves a fetch per document when listing documents, so failing to update it isn't an error
+    NSError *anyError = nil;
+    BOOL success = [self updateDocumentCatalogAtPath:[self documentCatalogFilePath] usingBlock:^(NSMutableDictionary *someEntries) {
+        NSMutableDictionary *entry = [NSMutableDictionary dictionaryWithDictionary:aDictionary];
+        [entry setValue:[[someEntries valueForKey:[self documentIdentifier]] valueForKey:kTICDSLastSyncDate] forKey:kTICDSLastSyncDate];
+        [someEntries setValue:entry forKey:[self documentIdentifier]];
+    } error:&anyError];
+    
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to add document to the document catalog: %@", anyError);
+    }
+}
+
 - (void)saveIntegrityKey:(NSString *)aKey
 {
     NSString *finalPath = [[[self thisDocumentDirectoryPath] stringByAppendingPathComponent:TICDSIntegrityKeyDirectoryName] stringByAppendingPathComponent:aKey];
@@ -247,11 +277,38 @@
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+    } else {
+        [self addDocumentToClientRegistry];
     }
     
     [self createdClientDirectoriesInRemoteDocumentDirectoriesWithSuccess:success];
 }
 
+- (void)addDocumentToClientRegistry
+{
+    if( ![self clientRegistryFilePath] ) {
+        return;
+    }
+    
+    NSError *anyError = nil;
+    BOOL success = [self updateClientRegistryAtPath:[self clientRegistryFilePath] usingBlock:^(NSMutableDictionary *someEntries) {
+        NSDictionary *entry = [someEntries valueForKey:[self clientIdentifier]];
+        
+        // a client missing from the registry is added, with all its documents, the next time registered clients are listed
+        if( !entry || [[entry valueForKey:kTICDSRegisteredDocumentIdentifiers] containsObject:[self documentIdentifier]] ) {
+            return;
+        }
+        
+        NSMutableDictionary *updatedEntry = [NSMutableDictionary dictionaryWithDictionary:entry];
+        [updatedEntry setValue:[[entry valueForKey:kTICDSRegisteredDocumentIdentifiers] arrayByAddingObject:[self documentIdentifier]] forKey:kTICDSRegisteredDocumentIdentifiers];
+        [someEntries setValue:updatedEntry forKey:[self clientIdentifier]];
+    } error:&anyError];
+    
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to add this document to this client's entry in the client registry: %@", anyError);
+    }
+}
+
 #pragma mark -
 #pragma mark Initialization and Deallocation
 - (void)dealloc
@@ -263,6 +320,8 @@
     [_thisDocumentDirectoryPath release], _thisDocumentDirectoryPath = nil;
     [_thisDocumentSyncChangesThisClientDirectoryPath release], _thisDocumentSyncChangesThisClientDirectoryPath = nil;
     [_thisDocumentSyncCommandsThisClientDirectoryPath release], _thisDocumentSyncCommandsThisClientDirectoryPath = nil;
+    [_documentCatalogFilePath release], _documentCatalogFilePath = nil;
+    [_clientRegistryFilePath release], _clientRegistryFilePath = nil;
 
     [super dealloc];
 }
@@ -276,5 +335,7 @@
 @synthesize thisDocumentDirectoryPath = _thisDocumentDirectoryPath;
 @synthesize thisDocumentSyncChangesThisClientDirectoryPath = _thisDocumentSyncChangesThisClientDirectoryPath;
 @synthesize thisDocumentSyncCommandsThisClientDirectoryPath = _thisDocumentSyncCommandsThisClientDirectoryPath;
+@synthesize documentCatalogFilePath = _documentCatalogFilePath;
+@synthesize clientRegistryFilePath = _clientRegistryFilePath;
 
 @end
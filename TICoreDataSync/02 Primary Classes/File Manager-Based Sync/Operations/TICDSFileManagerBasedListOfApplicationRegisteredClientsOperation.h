@@ -16,6 +16,7 @@
 @private
     NSString *_clientDevicesDirectoryPath;
     NSString *_documentsDirectoryPath;
+    NSString *_clientRegistryFilePath;
 }
 
 /** @name Paths */
@@ -26,4 +27,7 @@
 /** The path to the `Documents` directory. */
 @property (retain) NSString *documentsDirectoryPath;
 
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory. */
+@property (retain) NSString *clientRegistryFilePath;
+
 @end
@@ -78,12 +78,55 @@
     [self fetchedArrayOfClients:contents registeredForDocumentWithIdentifier:anIdentifier];
 }
 
+#pragma mark -
+#pragma mark Client Registry
+- (BOOL)supportsClientRegistry
+{
+    return [self clientRegistryFilePath] != nil;
+}
+
+- (void)fetchClientRegistry
+{
+    NSError *anyError = nil;
+    NSDictionary *entries = [self clientRegistryEntriesAtPath:[self clientRegistryFilePath] error:&anyError];
+    
+    if( !entries && anyError ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to read the client registry: %@", anyError);
+    }
+    
+    [self fetchedClientRegistryEntries:entries];
+}
+
+- (void)updateClientRegistryWithEntries:(NSDictionary *)someEntries
+{
+    NSError *anyError = nil;
+    BOOL success = [self updateClientRegistryAtPath:[self clientRegistryFilePath] usingBlock:^(NSMutableDictionary *registryEntries) {
+        for( NSString *eachIdentifier in someEntries ) {
+            NSMutableDictionary *entry = [NSMutableDictionary dictionaryWithDictionary:[someEntries valueForKey:eachIdentifier]];
+            
+            // keep documents registered by the client while its documents were being listed
+            NSMutableSet *documentIdentifiers = [NSMutableSet setWithArray:[entry valueForKey:kTICDSRegisteredDocumentIdentifiers]];
+            [documentIdentifiers addObjectsFromArray:[[registryEntries valueForKey:eachIdentifier] valueForKey:kTICDSRegisteredDocumentIdentifiers]];
+            [entry setValue:[documentIdentifiers allObjects] forKey:kTICDSRegisteredDocumentIdentifiers];
+            
+            [registryEntries setValue:entry forKey:eachIdentifier];
+        }
+    } error:&anyError];
+    
+    if( !success ) {
+        [self setError:anyError];
+    }
+    
+    [self updatedClientRegistryWithSuccess:success];
+}
+
 #pragma mark -
 #pragma mark Initialization and Deallocation
 - (void)dealloc
 {
     [_clientDevicesDirectoryPath release], _clientDevicesDirectoryPath = nil;
     [_documentsDirectoryPath release], _documentsDirectoryPath = nil;
+    [_clientRegistryFilePath release], _clientRegistryFilePath = nil;
 
     [super dealloc];
 }
@@ -92,5 +135,6 @@
 #pragma mark Properties
 @synthesize clientDevicesDirectoryPath = _clientDevicesDirectoryPath;
 @synthesize documentsDirectoryPath = _documentsDirectoryPath;
+@synthesize clientRegistryFilePath = _clientRegistryFilePath;
 
 @end
@@ -17,6 +17,7 @@
     NSString *_clientDevicesDirectoryPath;
     NSString *_thisDocumentRecentSyncsDirectoryPath;
     NSString *_thisDocumentWholeStoreDirectoryPath;
+    NSString *_clientRegistryFilePath;
 }
 
 
@@ -34,6 +35,9 @@
 /** The path to this document's `WholeStore` directory. */
 @property (retain) NSString *thisDocumentWholeStoreDirectoryPath;
 
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory. */
+@property (retain) NSString *clientRegistryFilePath;
+
 /** Return the path to the `deviceInfo.plist` file for a specified client, inside the `ClientDevices` directory.
  
  @param anIdentifier The identifier of the client.
@@ -80,6 +80,25 @@
     [self fetchedModificationDate:[attributes valueForKey:NSFileModificationDate]ofWholeStoreForClientWithIdentifier:anIdentifier];
 }
 
+#pragma mark -
+#pragma mark Client Registry
+- (BOOL)supportsClientRegistry
+{
+    return [self clientRegistryFilePath] != nil;
+}
+
+- (void)fetchClientRegistry
+{
+    NSError *anyError = nil;
+    NSDictionary *entries = [self clientRegistryEntriesAtPath:[self clientRegistryFilePath] error:&anyError];
+    
+    if( !entries && anyError ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to read the client registry: %@", anyError);
+    }
+    
+    [self fetchedClientRegistryEntries:entries];
+}
+
 #pragma mark -
 #pragma mark Relative Paths
 - (NSString *)pathToDeviceInfoPlistForDeviceWithIdentifier:(NSString *)anIdentifier
@@ -100,6 +119,7 @@
     [_clientDevicesDirectoryPath release], _clientDevicesDirectoryPath = nil;
     [_thisDocumentRecentSyncsDirectoryPath release], _thisDocumentRecentSyncsDirectoryPath = nil;
     [_thisDocumentWholeStoreDirectoryPath release], _thisDocumentWholeStoreDirectoryPath = nil;
+    [_clientRegistryFilePath release], _clientRegistryFilePath = nil;
 
     [super dealloc];
 }
@@ -110,5 +130,6 @@
 @synthesize clientDevicesDirectoryPath = _clientDevicesDirectoryPath;
 @synthesize thisDocumentRecentSyncsDirectoryPath = _thisDocumentRecentSyncsDirectoryPath;
 @synthesize thisDocumentWholeStoreDirectoryPath = _thisDocumentWholeStoreDirectoryPath;
+@synthesize clientRegistryFilePath = _clientRegistryFilePath;
 
 @end
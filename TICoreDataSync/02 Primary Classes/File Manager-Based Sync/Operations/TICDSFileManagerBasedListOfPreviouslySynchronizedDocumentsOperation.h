@@ -14,6 +14,7 @@
 @interface TICDSFileManagerBasedListOfPreviouslySynchronizedDocumentsOperation : TICDSListOfPreviouslySynchronizedDocumentsOperation {
 @private
     NSString *_documentsDirectoryPath;
+    NSString *_documentCatalogFilePath;
 }
 
 /** @name Paths */
@@ -21,6 +22,9 @@
 /** The path to the `Documents` directory. */
 @property (retain) NSString *documentsDirectoryPath;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory. */
+@property (retain) NSString *documentCatalogFilePath;
+
 /** Returns the path to the `documentInfo.plist` file for a document with the specified identifier.
  
  @param anIdentifier The identifier of the document.
@@ -76,6 +76,39 @@
     [self fetchedLastSynchronizationDate:[dictionary valueForKey:NSFileModificationDate] forDocumentWithSyncID:aSyncID];
 }
 
+#pragma mark -
+#pragma mark Document Catalog
+- (BOOL)supportsDocumentCatalog
+{
+    return [self documentCatalogFilePath] != nil;
+}
+
+- (void)fetchDocumentCatalog
+{
+    NSError *anyError = nil;
+    NSDictionary *entries = [self documentCatalogEntriesAtPath:[self documentCatalogFilePath] error:&anyError];
+    
+    if( !entries && anyError ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to read the document catalog: %@", anyError);
+    }
+    
+    [self fetchedDocumentCatalogEntries:entries];
+}
+
+- (void)updateDocumentCatalogWithEntries:(NSDictionary *)someEntries
+{
+    NSError *anyError = nil;
+    BOOL success = [self updateDocumentCatalogAtPath:[self documentCatalogFilePath] usingBlock:^(NSMutableDictionary *catalogEntries) {
+        [catalogEntries addEntriesFromDictionary:someEntries];
+    } error:&anyError];
+    
+    if( !success ) {
+        [self setError:anyError];
+    }
+    
+    [self updatedDocumentCatalogWithSuccess:success];
+}
+
 #pragma mark -
 #pragma mark Paths
 - (NSString *)pathToDocumentInfoForDocumentWithIdentifier:(NSString *)anIdentifier
@@ -93,6 +126,7 @@
 - (void)dealloc
 {
     [_documentsDirectoryPath release], _documentsDirectoryPath = nil;
+    [_documentCatalogFilePath release], _documentCatalogFilePath = nil;
 
     [super dealloc];
 }
@@ -100,5 +134,6 @@
 #pragma mark -
 #pragma mark Properties
 @synthesize documentsDirectoryPath = _documentsDirectoryPath;
+@synthesize documentCatalogFilePath = _documentCatalogFilePath;
 
 @end
@@ -21,7 +21,7 @@
         return;
     }
     
-    BOOL success = [self removeItemAtPath:[self applicationDirectoryPath] error:&anyError];
+    BOOL success = [self removeDirectoryTreeAtPath:[self applicationDirectoryPath] error:&anyError];
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
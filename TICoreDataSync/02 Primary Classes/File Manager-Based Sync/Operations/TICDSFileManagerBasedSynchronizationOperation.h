@@ -18,8 +18,29 @@
     NSString *_thisDocumentSyncChangesDirectoryPath;
     NSString *_thisDocumentSyncChangesThisClientDirectoryPath;
     NSString *_thisDocumentRecentSyncsThisClientFilePath;
+    
+    NSArray *_clientIdentifiersWithDetectedChanges;
+    NSUInteger _maximumConcurrentRemoteListings;
+    
+    NSMutableArray *_fetchedSyncChangeSetResults;
+    
+    NSString *_documentCatalogFilePath;
 }
 
+/** @name Change Detection */
+
+/** The identifiers of the clients whose `SyncChanges` directories were reported as changed by the document sync manager's directory watcher.
+ 
+ If set, these clients' directories are listed before the rest. Every client in this document's `SyncChanges` directory is still listed, so change sets that were missed while the watcher wasn't running, or that failed to fetch last time, aren't left behind. */
+@property (retain) NSArray *clientIdentifiersWithDetectedChanges;
+
+/** @name Remote Listing */
+
+/** The maximum number of client `SyncChanges` directories listed at the same time; defaults to `8`.
+ 
+ Listing a directory on a network share can take a noticeable time, so the directories for all clients are listed concurrently, up to this limit. Set to `1` to list them one after another. */
+@property (assign) NSUInteger maximumConcurrentRemoteListings;
+
 /** @name Paths */
 
 /** The path to this document's directory. */
@@ -34,13 +55,24 @@
 /** The path this client's RecentSync file inside this document's `RecentSyncs` directory. */
 @property (retain) NSString *thisDocumentRecentSyncsThisClientFilePath;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory; if set, this document's last sync date in the catalog is updated after each synchronization. */
+@property (retain) NSString *documentCatalogFilePath;
+
 /** The path to a given client's `SyncChanges` directory.
  
  @param anIdentifier The unique sync identifier of the document. */
 - (NSString *)pathToSyncChangesDirectoryForClientWithIdentifier:(NSString *)anIdentifier;
 
+/** The path to a sync partition's directory inside a given client's `SyncChanges` directory.
+ 
+ @param anIdentifier The unique sync identifier of the client.
+ @param aPartitionName The name of the sync partition, or `nil` for the default partition. */
+- (NSString *)pathToSyncChangesDirectoryForClientWithIdentifier:(NSString *)anIdentifier syncPartitionName:(NSString *)aPartitionName;
+
 /** The path to a `SyncChangeSet` uploaded by a given client.
  
+ The sync change set must have been listed during this operation if it is in a sync partition.
+ 
  @param aChangeSetIdentifier The unique identifier of the sync change set.
  @param aClientIdentifier The unique sync identifier of the client. */
 - (NSString *)pathToSyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientWithIdentifier:(NSString *)aClientIdentifier;
@@ -8,6 +8,13 @@
 
 #import "TICoreDataSync.h"
 
+@interface TICDSFileManagerBasedSynchronizationOperation ()
+
+- (NSArray *)syncChangeSetIdentifiersForClientIdentifier:(NSString *)anIdentifier error:(NSError **)outError;
+- (NSArray *)syncChangeSetIdentifiersInDirectoryAtPath:(NSString *)aDirectoryPath error:(NSError **)outError;
+- (BOOL)copySyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientIdentifier:(NSString *)aClientIdentifier toLocation:(NSURL *)aLocation modificationDate:(NSDate **)outModificationDate;
+
+@end
 
 @implementation TICDSFileManagerBasedSynchronizationOperation
 
@@ -50,8 +57,16 @@
     }
     
     NSMutableArray *clientDeviceIdentifiers = [NSMutableArray arrayWithCapacity:[directoryContents count]];
+    
+    // clients with changes detected by the directory watcher are listed first, and every other client after them
+    for( NSString *eachIdentifier in [self clientIdentifiersWithDetectedChanges] ) {
+        if( [directoryContents containsObject:eachIdentifier] ) {
+            [clientDeviceIdentifiers addObject:eachIdentifier];
+        }
+    }
+    
     for( NSString *eachDirectory in directoryContents ) {
-        if( [[eachDirectory substringToIndex:1] isEqualToString:@"."] ) {
+        if( [[eachDirectory substringToIndex:1] isEqualToString:@"."] || [clientDeviceIdentifiers containsObject:eachDirectory] ) {
             continue;
         }
         
@@ -66,43 +81,74 @@
     NSError *anyError = nil;
     BOOL success = YES;
     
-    if( [self shouldUseEncryption] ) {
-        // encrypt file first
-        NSURL *tmpFileLocation = [NSURL fileURLWithPath:[[self tempFileDirectoryPath] stringByAppendingPathComponent:[[aLocation path] lastPathComponent]]];
-        
-        success = [[self cryptor] encryptFileAtLocation:aLocation writingToLocation:tmpFileLocation error:&anyError];
-        if( !success ) {
-            [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-            [self uploadedLocalSyncChangeSetFileSuccessfully:success];
-            return;
-        }
-        
-        aLocation = tmpFileLocation;
+    NSString *partitionName = [self syncPartitionNameForSyncChangeSetIdentifier:[[[aLocation path] lastPathComponent] stringByDeletingPathExtension]];
+    NSString *uploadDirectoryPath = [self thisDocumentSyncChangesThisClientDirectoryPath];
+    if( partitionName ) {
+        uploadDirectoryPath = [uploadDirectoryPath stringByAppendingPathComponent:partitionName];
     }
+    NSString *uploadPath = [uploadDirectoryPath stringByAppendingPathComponent:[[aLocation path] lastPathComponent]];
     
-    NSString *uploadPath = [[self thisDocumentSyncChangesThisClientDirectoryPath] stringByAppendingPathComponent:[[aLocation path] lastPathComponent]];
-    
-    success = [self moveItemAtPath:[aLocation path] toPath:uploadPath error:&anyError];
+    // encrypted change sets are written straight into this client's directory, rather than via a temporary file
+    if( [self shouldUseEncryption] ) {
+        success = [self encryptFileAtPath:[aLocation path] toPath:uploadPath error:&anyError];
+    } else {
+        success = [self moveItemAtPath:[aLocation path] toPath:uploadPath error:&anyError];
+    }
     
     if( !success ) {
         // Check that the directory exists, and try to recover
-        if ( ![self fileExistsAtPath:self.thisDocumentSyncChangesThisClientDirectoryPath] ) {
-            [self createDirectoryAtPath:self.thisDocumentSyncChangesThisClientDirectoryPath withIntermediateDirectories:YES attributes:nil error:NULL];
-            success = [self moveItemAtPath:[aLocation path] toPath:uploadPath error:&anyError];
+        if ( ![self fileExistsAtPath:uploadDirectoryPath] ) {
+            [self createDirectoryAtPath:uploadDirectoryPath withIntermediateDirectories:YES attributes:nil error:NULL];
+            if( [self shouldUseEncryption] ) {
+                success = [self encryptFileAtPath:[aLocation path] toPath:uploadPath error:&anyError];
+            } else {
+                success = [self moveItemAtPath:[aLocation path] toPath:uploadPath error:&anyError];
+            }
         }
-        if ( !success ) [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        if ( !success ) [self setError:[TICDSError errorWithCode:[self shouldUseEncryption] ? TICDSErrorCodeEncryptionError : TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
     }
     
     [self uploadedLocalSyncChangeSetFileSuccessfully:success];
 }
 
-- (void)buildArrayOfSyncChangeSetIdentifiersForClientIdentifier:(NSString *)anIdentifier
+- (NSArray *)syncChangeSetIdentifiersForClientIdentifier:(NSString *)anIdentifier error:(NSError **)outError
 {
-    NSError *anyError = nil;
-    NSArray *contents = [self contentsOfDirectoryAtPath:[self pathToSyncChangesDirectoryForClientWithIdentifier:anIdentifier] error:&anyError];
+    NSArray *identifiers = [self syncChangeSetIdentifiersInDirectoryAtPath:[self pathToSyncChangesDirectoryForClientWithIdentifier:anIdentifier] error:outError];
+    
+    if( !identifiers || [[self syncPartitions] count] < 1 ) {
+        return identifiers;
+    }
+    
+    NSMutableArray *allIdentifiers = [NSMutableArray arrayWithArray:identifiers];
+    for( NSString *eachPartitionName in [self syncPartitionNamesToFetch] ) {
+        NSString *partitionDirectoryPath = [self pathToSyncChangesDirectoryForClientWithIdentifier:anIdentifier syncPartitionName:eachPartitionName];
+        
+        // a client only has a directory for a partition once it has changed something in it
+        if( ![self fileExistsAtPath:partitionDirectoryPath] ) {
+            continue;
+        }
+        
+        identifiers = [self syncChangeSetIdentifiersInDirectoryAtPath:partitionDirectoryPath error:outError];
+        if( !identifiers ) {
+            return nil;
+        }
+        
+        for( NSString *eachIdentifier in identifiers ) {
+            [self setSyncPartitionName:eachPartitionName forSyncChangeSetIdentifier:eachIdentifier];
+        }
+        
+        [allIdentifiers addObjectsFromArray:identifiers];
+    }
+    
+    return allIdentifiers;
+}
+
+- (NSArray *)syncChangeSetIdentifiersInDirectoryAtPath:(NSString *)aDirectoryPath error:(NSError **)outError
+{
+    NSArray *contents = [self contentsOfDirectoryAtPath:aDirectoryPath error:outError];
     
     if( !contents ) {
-        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        return nil;
     }
     
     NSMutableArray *identifiers = [NSMutableArray arrayWithCapacity:[contents count]];
@@ -111,57 +157,172 @@
             continue;
         }
         
+        // skips sync partition directories
+        if( ![[eachIdentifier pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] ) {
+            continue;
+        }
+        
         [identifiers addObject:[eachIdentifier stringByDeletingPathExtension]];
     }
     
-    [self builtArrayOfClientSyncChangeSetIdentifiers:identifiers forClientIdentifier:anIdentifier];
+    return identifiers;
 }
 
-- (void)fetchSyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientIdentifier:(NSString *)aClientIdentifier toLocation:(NSURL *)aLocation
+- (void)buildArrayOfSyncChangeSetIdentifiersForClientIdentifier:(NSString *)anIdentifier
 {
-    NSString *remoteFileToFetch = [self pathToSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientWithIdentifier:aClientIdentifier];
-    
     NSError *anyError = nil;
+    NSArray *identifiers = [self syncChangeSetIdentifiersForClientIdentifier:anIdentifier error:&anyError];
     
-    // Get modification date first
-    NSDate *modificationDate = nil;
-    NSDictionary *attributes = [self attributesOfItemAtPath:remoteFileToFetch error:&anyError];
-    if( !attributes ) {
+    if( !identifiers ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-        [self fetchedSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientIdentifier:aClientIdentifier modificationDate:modificationDate withSuccess:NO];
+    }
+    
+    [self builtArrayOfClientSyncChangeSetIdentifiers:identifiers forClientIdentifier:anIdentifier];
+}
+
+- (void)buildArraysOfSyncChangeSetIdentifiersForClientIdentifiers:(NSArray *)someIdentifiers
+{
+    NSUInteger clientCount = [someIdentifiers count];
+    
+    if( clientCount < 2 || [self maximumConcurrentRemoteListings] < 2 ) {
+        [super buildArraysOfSyncChangeSetIdentifiersForClientIdentifiers:someIdentifiers];
         return;
     }
     
-    modificationDate = [attributes valueForKey:NSFileModificationDate];
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Listing SyncChanges directories for %lu clients, %lu at a time", (unsigned long)clientCount, (unsigned long)[self maximumConcurrentRemoteListings]);
     
-    NSString *destinationPath = [aLocation path];
+    // make sure the file manager exists before it's used from several threads
+    [self fileManager];
     
-    // if we're encrypted, we need to copy to temporary file location first, ready for cryptor to decrypt later...
-    if( [self shouldUseEncryption] ) {
-        destinationPath = [[self tempFileDirectoryPath] stringByAppendingPathComponent:[destinationPath lastPathComponent]];
+    // each listing is written to its own slot, so no locking is needed while the listings run
+    NSArray **results = calloc(clientCount, sizeof(NSArray *));
+    NSError **errors = calloc(clientCount, sizeof(NSError *));
+    
+    dispatch_semaphore_t fanOutSemaphore = dispatch_semaphore_create((long)[self maximumConcurrentRemoteListings]);
+    dispatch_group_t listingGroup = dispatch_group_create();
+    dispatch_queue_t listingQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    
+    for( NSUInteger index = 0; index < clientCount; index++ ) {
+        NSString *eachClientIdentifier = [someIdentifiers objectAtIndex:index];
+        
+        dispatch_semaphore_wait(fanOutSemaphore, DISPATCH_TIME_FOREVER);
+        dispatch_group_async(listingGroup, listingQueue, ^{
+            NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+            
+            NSError *anyError = nil;
+            results[index] = [[self syncChangeSetIdentifiersForClientIdentifier:eachClientIdentifier error:&anyError] retain];
+            errors[index] = [anyError retain];
+            
+            [pool drain];
+            dispatch_semaphore_signal(fanOutSemaphore);
+        });
     }
     
-    BOOL success = [self copyItemAtPath:remoteFileToFetch toPath:destinationPath error:&anyError];
+    dispatch_group_wait(listingGroup, DISPATCH_TIME_FOREVER);
+    dispatch_release(listingGroup);
+    dispatch_release(fanOutSemaphore);
     
-    if( !success ) {
-        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-        [self fetchedSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientIdentifier:aClientIdentifier modificationDate:modificationDate withSuccess:success];
+    // results are handed back one client at a time on this thread, as the superclass expects
+    for( NSUInteger index = 0; index < clientCount; index++ ) {
+        if( !results[index] ) {
+            [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:errors[index] classAndMethod:__PRETTY_FUNCTION__]];
+        }
+        
+        [self builtArrayOfClientSyncChangeSetIdentifiers:results[index] forClientIdentifier:[someIdentifiers objectAtIndex:index]];
+        
+        [results[index] release];
+        [errors[index] release];
+    }
+    
+    free(results);
+    free(errors);
+}
+
+- (void)fetchSyncChangeSetsWithIdentifiersByClientIdentifier:(NSDictionary *)someIdentifiers toDirectoryLocation:(NSURL *)aDirectoryLocation
+{
+    NSMutableArray *remotePaths = [NSMutableArray array];
+    for( NSString *eachClientIdentifier in someIdentifiers ) {
+        for( NSString *eachChangeSetIdentifier in [someIdentifiers valueForKey:eachClientIdentifier] ) {
+            [remotePaths addObject:[self pathToSyncChangeSetWithIdentifier:eachChangeSetIdentifier forClientWithIdentifier:eachClientIdentifier]];
+        }
+    }
+    
+    NSArray *localPaths = [NSArray arrayWithObject:[aDirectoryLocation path]];
+    
+    // one coordinator covers every change set in this phase, rather than one per copy; the results are
+    // collected and only reported once the batch is over, so the rest of the sync doesn't run inside it
+    _fetchedSyncChangeSetResults = [[NSMutableArray alloc] initWithCapacity:[remotePaths count]];
+    
+    NSError *anyError = nil;
+    BOOL coordinated = [self coordinateReadingItemsAtPaths:remotePaths writingItemsAtPaths:localPaths error:&anyError byAccessor:^{
+        [super fetchSyncChangeSetsWithIdentifiersByClientIdentifier:someIdentifiers toDirectoryLocation:aDirectoryLocation];
+    }];
+    
+    NSArray *results = [_fetchedSyncChangeSetResults autorelease];
+    _fetchedSyncChangeSetResults = nil;
+    
+    if( !coordinated ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Failed to coordinate fetch of sync change sets as a batch, so coordinating each one: %@", anyError);
+        [super fetchSyncChangeSetsWithIdentifiersByClientIdentifier:someIdentifiers toDirectoryLocation:aDirectoryLocation];
         return;
     }
     
-    // if unencrypted, we're done
-    if( ![self shouldUseEncryption] ) {
-        [self fetchedSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientIdentifier:aClientIdentifier modificationDate:modificationDate withSuccess:success];
+    for( NSDictionary *eachResult in results ) {
+        [self fetchedSyncChangeSetWithIdentifier:[eachResult valueForKey:@"changeSetIdentifier"] forClientIdentifier:[eachResult valueForKey:@"clientIdentifier"] modificationDate:[eachResult valueForKey:@"modificationDate"] withSuccess:[[eachResult valueForKey:@"success"] boolValue]];
+    }
+}
+
+- (void)fetchSyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientIdentifier:(NSString *)aClientIdentifier toLocation:(NSURL *)aLocation
+{
+    NSDate *modificationDate = nil;
+    BOOL success = [self copySyncChangeSetWithIdentifier:aChangeSetIdentifier forClientIdentifier:aClientIdentifier toLocation:aLocation modificationDate:&modificationDate];
+    
+    if( _fetchedSyncChangeSetResults ) {
+        NSMutableDictionary *result = [NSMutableDictionary dictionaryWithCapacity:4];
+        [result setValue:aChangeSetIdentifier forKey:@"changeSetIdentifier"];
+        [result setValue:aClientIdentifier forKey:@"clientIdentifier"];
+        [result setValue:modificationDate forKey:@"modificationDate"];
+        [result setValue:[NSNumber numberWithBool:success] forKey:@"success"];
+        [_fetchedSyncChangeSetResults addObject:result];
         return;
     }
     
-    success = [[self cryptor] decryptFileAtLocation:[NSURL fileURLWithPath:destinationPath] writingToLocation:aLocation error:&anyError];
+    [self fetchedSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientIdentifier:aClientIdentifier modificationDate:modificationDate withSuccess:success];
+}
+
+- (BOOL)copySyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientIdentifier:(NSString *)aClientIdentifier toLocation:(NSURL *)aLocation modificationDate:(NSDate **)outModificationDate
+{
+    NSString *remoteFileToFetch = [self pathToSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientWithIdentifier:aClientIdentifier];
+    
+    NSError *anyError = nil;
+    
+    // Get modification date first
+    NSDictionary *attributes = [self attributesOfItemAtPath:remoteFileToFetch error:&anyError];
+    if( !attributes ) {
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        return NO;
+    }
+    
+    *outModificationDate = [attributes valueForKey:NSFileModificationDate];
+    
+    // decrypt straight from the remote file, rather than copying the cipher text to a temporary file first
+    if( [self shouldUseEncryption] ) {
+        if( ![self decryptFileAtPath:remoteFileToFetch toPath:[aLocation path] error:&anyError] ) {
+            [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+            return NO;
+        }
+        
+        return YES;
+    }
+    
+    // change sets are never modified once uploaded, so the fetched copy can share the remote file
+    BOOL success = [self copyImmutableItemAtPath:remoteFileToFetch toPath:[aLocation path] error:&anyError];
     
     if( !success ) {
-        [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
     }
     
-    [self fetchedSyncChangeSetWithIdentifier:aChangeSetIdentifier forClientIdentifier:aClientIdentifier modificationDate:modificationDate withSuccess:success];
+    return success;
 }
 
 - (void)uploadRecentSyncFileAtLocation:(NSURL *)aLocation
@@ -185,11 +346,40 @@
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        [self uploadedRecentSyncFileSuccessfully:success];
+        return;
+    }
+    
+    if( [self documentCatalogFilePath] ) {
+        NSString *documentIdentifier = [[self thisDocumentDirectoryPath] lastPathComponent];
+        
+        // only documents already in the catalog are updated, as an entry without the document info would hide it from listings
+        BOOL catalogUpdated = [self updateDocumentCatalogAtPath:[self documentCatalogFilePath] usingBlock:^(NSMutableDictionary *someEntries) {
+            NSDictionary *entry = [someEntries valueForKey:documentIdentifier];
+            if( !entry ) {
+                return;
+            }
+            
+            NSMutableDictionary *updatedEntry = [NSMutableDictionary dictionaryWithDictionary:entry];
+            [updatedEntry setValue:[NSDate date] forKey:kTICDSLastSyncDate];
+            [someEntries setValue:updatedEntry forKey:documentIdentifier];
+        } error:&anyError];
+        
+        if( !catalogUpdated ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to update this document's last sync date in the document catalog: %@", anyError);
+        }
     }
     
     [self uploadedRecentSyncFileSuccessfully:success];
 }
 
+#pragma mark -
+#pragma mark Sync Partitions
+- (BOOL)supportsSyncPartitions
+{
+    return YES;
+}
+
 #pragma mark -
 #pragma mark Initialization and Deallocation
 
@@ -198,6 +388,7 @@
     self = [super initWithDelegate:aDelegate];
     if (self) {
         self.threadPriority = 0.0;
+        _maximumConcurrentRemoteListings = 8;
     }
     return self;
 }
@@ -208,6 +399,9 @@
     [_thisDocumentSyncChangesDirectoryPath release], _thisDocumentSyncChangesDirectoryPath = nil;
     [_thisDocumentSyncChangesThisClientDirectoryPath release], _thisDocumentSyncChangesThisClientDirectoryPath = nil;
     [_thisDocumentRecentSyncsThisClientFilePath release], _thisDocumentRecentSyncsThisClientFilePath = nil;
+    [_clientIdentifiersWithDetectedChanges release], _clientIdentifiersWithDetectedChanges = nil;
+    [_fetchedSyncChangeSetResults release], _fetchedSyncChangeSetResults = nil;
+    [_documentCatalogFilePath release], _documentCatalogFilePath = nil;
 
     [super dealloc];
 }
@@ -219,9 +413,18 @@
     return [[self thisDocumentSyncChangesDirectoryPath] stringByAppendingPathComponent:anIdentifier];
 }
 
+- (NSString *)pathToSyncChangesDirectoryForClientWithIdentifier:(NSString *)anIdentifier syncPartitionName:(NSString *)aPartitionName
+{
+    NSString *path = [self pathToSyncChangesDirectoryForClientWithIdentifier:anIdentifier];
+    
+    return aPartitionName ? [path stringByAppendingPathComponent:aPartitionName] : path;
+}
+
 - (NSString *)pathToSyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientWithIdentifier:(NSString *)aClientIdentifier
 {
-    return [[[self pathToSyncChangesDirectoryForClientWithIdentifier:aClientIdentifier] stringByAppendingPathComponent:aChangeSetIdentifier] stringByAppendingPathExtension:TICDSSyncChangeSetFileExtension];
+    NSString *directoryPath = [self pathToSyncChangesDirectoryForClientWithIdentifier:aClientIdentifier syncPartitionName:[self syncPartitionNameForSyncChangeSetIdentifier:aChangeSetIdentifier]];
+    
+    return [[directoryPath stringByAppendingPathComponent:aChangeSetIdentifier] stringByAppendingPathExtension:TICDSSyncChangeSetFileExtension];
 }
 
 #pragma mark -
@@ -230,5 +433,8 @@
 @synthesize thisDocumentSyncChangesDirectoryPath = _thisDocumentSyncChangesDirectoryPath;
 @synthesize thisDocumentSyncChangesThisClientDirectoryPath = _thisDocumentSyncChangesThisClientDirectoryPath;
 @synthesize thisDocumentRecentSyncsThisClientFilePath = _thisDocumentRecentSyncsThisClientFilePath;
+@synthesize clientIdentifiersWithDetectedChanges = _clientIdentifiersWithDetectedChanges;
+@synthesize maximumConcurrentRemoteListings = _maximumConcurrentRemoteListings;
+@synthesize documentCatalogFilePath = _documentCatalogFilePath;
 
 @end
@@ -8,9 +8,60 @@
 
 #import "TICoreDataSync.h"
 
+@interface TICDSFileManagerBasedVacuumOperation ()
+
+- (BOOL)removeSyncChangeSetFilesInDirectoryAtPath:(NSString *)aDirectoryPath syncPartitionName:(NSString *)aPartitionName error:(NSError **)outError;
+
+@end
 
 @implementation TICDSFileManagerBasedVacuumOperation
 
+- (BOOL)supportsSyncChangeSetSequenceNumbers
+{
+    return YES;
+}
+
+- (void)fetchRecentSyncDictionariesAndWholeStoreClientIdentifiers
+{
+    NSError *anyError = nil;
+    NSArray *fileNames = [self contentsOfDirectoryAtPath:[self thisDocumentRecentSyncsDirectoryPath] error:&anyError];
+    
+    if( !fileNames ) {
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        [self fetchedRecentSyncDictionaries:nil wholeStoreClientIdentifiers:nil];
+        return;
+    }
+    
+    NSMutableDictionary *recentSyncDictionaries = [NSMutableDictionary dictionaryWithCapacity:[fileNames count]];
+    for( NSString *eachFileName in fileNames ) {
+        if( ![[eachFileName pathExtension] isEqualToString:TICDSRecentSyncFileExtension] ) {
+            continue;
+        }
+        
+        NSDictionary *recentSyncDictionary = [NSDictionary dictionaryWithContentsOfFile:[[self thisDocumentRecentSyncsDirectoryPath] stringByAppendingPathComponent:eachFileName]];
+        [recentSyncDictionaries setValue:recentSyncDictionary forKey:[eachFileName stringByDeletingPathExtension]];
+    }
+    
+    NSArray *clientIdentifiers = [self contentsOfDirectoryAtPath:[self thisDocumentWholeStoreDirectoryPath] error:&anyError];
+    
+    if( !clientIdentifiers ) {
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        [self fetchedRecentSyncDictionaries:nil wholeStoreClientIdentifiers:nil];
+        return;
+    }
+    
+    NSMutableArray *wholeStoreClientIdentifiers = [NSMutableArray arrayWithCapacity:[clientIdentifiers count]];
+    for( NSString *eachIdentifier in clientIdentifiers ) {
+        if( [eachIdentifier hasPrefix:@"."] || ![self fileExistsAtPath:[self pathToWholeStoreFileForClientWithIdentifier:eachIdentifier]] ) {
+            continue;
+        }
+        
+        [wholeStoreClientIdentifiers addObject:eachIdentifier];
+    }
+    
+    [self fetchedRecentSyncDictionaries:recentSyncDictionaries wholeStoreClientIdentifiers:wholeStoreClientIdentifiers];
+}
+
 - (void)findOutDateOfOldestWholeStore
 {
     NSError *anyError = nil;
@@ -78,7 +129,13 @@
     
     NSString *filePath = nil;
     NSDate *oldestFileDate = nil;
+    NSDate *eachFileDate = nil;
     NSDictionary *attributes = nil;
+    NSMutableDictionary *oldestFileDatesByPartitionName = nil;
+    
+    if( [[self syncPartitions] count] > 0 ) {
+        oldestFileDatesByPartitionName = [NSMutableDictionary dictionaryWithCapacity:[[self syncPartitions] count]];
+    }
     
     for( NSString *eachFileName in fileNames ) {
         filePath = [[self thisDocumentRecentSyncsDirectoryPath] stringByAppendingPathComponent:eachFileName];
@@ -90,12 +147,39 @@
             return;
         }
         
-        if( !oldestFileDate || [oldestFileDate compare:[attributes valueForKey:NSFileModificationDate]] == NSOrderedDescending ) {
-            oldestFileDate = [attributes valueForKey:NSFileModificationDate];
+        eachFileDate = [attributes valueForKey:NSFileModificationDate];
+        
+        if( !oldestFileDate || [oldestFileDate compare:eachFileDate] == NSOrderedDescending ) {
+            oldestFileDate = eachFileDate;
+        }
+        
+        if( !oldestFileDatesByPartitionName ) {
+            continue;
+        }
+        
+        // Clients that don't list their subscriptions fetch every partition
+        NSArray *subscribedPartitionNames = [[NSDictionary dictionaryWithContentsOfFile:filePath] valueForKey:kTICDSSubscribedSyncPartitionNames];
+        if( !subscribedPartitionNames ) {
+            subscribedPartitionNames = [[self syncPartitions] allKeys];
+        }
+        
+        for( NSString *eachPartitionName in subscribedPartitionNames ) {
+            NSDate *partitionDate = [oldestFileDatesByPartitionName valueForKey:eachPartitionName];
+            
+            if( !partitionDate || [partitionDate compare:eachFileDate] == NSOrderedDescending ) {
+                [oldestFileDatesByPartitionName setValue:eachFileDate forKey:eachPartitionName];
+            }
         }
     }
     
-    [self foundOutLeastRecentClientSyncDate:oldestFileDate];
+    // Partitions no client subscribes to are not needed by anyone, so can be removed up to now
+    for( NSString *eachPartitionName in [self syncPartitions] ) {
+        if( oldestFileDatesByPartitionName && ![oldestFileDatesByPartitionName valueForKey:eachPartitionName] ) {
+            [oldestFileDatesByPartitionName setValue:[NSDate date] forKey:eachPartitionName];
+        }
+    }
+    
+    [self foundOutLeastRecentClientSyncDate:oldestFileDate syncPartitionDates:oldestFileDatesByPartitionName];
 }
 
 - (void)removeOldSyncChangeSetFiles
@@ -110,26 +194,19 @@
         return;
     }
     
-    NSString *filePath = nil;
-    NSDictionary *attributes = nil;
-    BOOL success = YES;
+    BOOL success = [self removeSyncChangeSetFilesInDirectoryAtPath:[self thisDocumentSyncChangesThisClientDirectoryPath] syncPartitionName:nil error:&anyError];
     
     for( NSString *eachFileName in fileNames ) {
-        filePath = [[self thisDocumentSyncChangesThisClientDirectoryPath] stringByAppendingPathComponent:eachFileName];
-        
-        attributes = [self attributesOfItemAtPath:filePath error:&anyError];
-        if( !attributes ) {
-            success = NO;
+        if( !success ) {
             break;
         }
         
-        if( [(NSDate *)[attributes valueForKey:NSFileModificationDate] compare:[self earliestDateForFilesToKeep]] == NSOrderedAscending ) {
-            success = [self removeItemAtPath:filePath error:&anyError];
+        if( [[eachFileName pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] || [eachFileName hasPrefix:@"."] ) {
+            continue;
         }
         
-        if( !success ) {
-            break;
-        }
+        // Anything else in the directory is a sync partition
+        success = [self removeSyncChangeSetFilesInDirectoryAtPath:[[self thisDocumentSyncChangesThisClientDirectoryPath] stringByAppendingPathComponent:eachFileName] syncPartitionName:eachFileName error:&anyError];
     }
     
     if( !success ) {
@@ -139,6 +216,54 @@
     [self removedOldSyncChangeSetFilesWithSuccess:success];
 }
 
+- (BOOL)removeSyncChangeSetFilesInDirectoryAtPath:(NSString *)aDirectoryPath syncPartitionName:(NSString *)aPartitionName error:(NSError **)outError
+{
+    // List the directory once with modification dates, rather than asking for the attributes of each file
+    NSArray *propertyKeys = [NSArray arrayWithObject:NSURLContentModificationDateKey];
+    
+    __block NSArray *fileURLs = nil;
+    __block NSError *listingError = nil;
+    
+    BOOL coordinated = [self coordinateReadingItemsAtPaths:[NSArray arrayWithObject:aDirectoryPath] writingItemsAtPaths:nil error:outError byAccessor:^{
+        fileURLs = [[[self fileManager] contentsOfDirectoryAtURL:[NSURL fileURLWithPath:aDirectoryPath] includingPropertiesForKeys:propertyKeys options:NSDirectoryEnumerationSkipsHiddenFiles error:&listingError] retain];
+        [listingError retain];
+    }];
+    
+    [fileURLs autorelease];
+    [listingError autorelease];
+    
+    if( !coordinated ) {
+        return NO;
+    }
+    
+    if( !fileURLs ) {
+        if( outError ) *outError = listingError;
+        return NO;
+    }
+    
+    NSMutableArray *filePathsToRemove = [NSMutableArray arrayWithCapacity:[fileURLs count]];
+    NSDate *modificationDate = nil;
+    
+    for( NSURL *eachURL in fileURLs ) {
+        if( ![[eachURL pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] ) {
+            continue;
+        }
+        
+        modificationDate = nil;
+        if( ![eachURL getResourceValue:&modificationDate forKey:NSURLContentModificationDateKey error:outError] ) {
+            return NO;
+        }
+        
+        if( [self shouldRemoveSyncChangeSetWithIdentifier:[[eachURL lastPathComponent] stringByDeletingPathExtension] inSyncPartitionNamed:aPartitionName modificationDate:modificationDate] ) {
+            [filePathsToRemove addObject:[eachURL path]];
+        }
+    }
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Removing %lu of %lu sync change sets in %@", (unsigned long)[filePathsToRemove count], (unsigned long)[fileURLs count], [aDirectoryPath lastPathComponent]);
+    
+    return [self removeItemsAtPaths:filePathsToRemove error:outError];
+}
+
 #pragma mark -
 #pragma mark Paths
 - (NSString *)pathToWholeStoreFileForClientWithIdentifier:(NSString *)anIdentifier
@@ -15,6 +15,7 @@
 @private
     NSString *_thisDocumentDirectoryPath;
     NSString *_thisDocumentWholeStoreDirectoryPath;
+    NSString *_thisDocumentRecentSyncsDirectoryPath;
 }
 
 /** @name Paths */
@@ -35,4 +36,7 @@
 /** The path to this document's `WholeStore` directory. */
 @property (retain) NSString *thisDocumentWholeStoreDirectoryPath;
 
+/** The path to this document's `RecentSyncs` directory. */
+@property (retain) NSString *thisDocumentRecentSyncsDirectoryPath;
+
 @end
@@ -161,7 +161,10 @@
     if( ![self shouldUseEncryption] ) {
         // just copy the file straight across
         NSString *localPath = [[self localWholeStoreFileLocation] path];
+        NSDate *copyStartDate = [NSDate date];
+        unsigned long long bytesCopiedBefore = [self numberOfBytesCopied];
         success = [self copyItemAtPath:wholeStorePath toPath:localPath error:&anyError];
+        TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Copied whole store in %.3f seconds, writing %llu bytes", -[copyStartDate timeIntervalSinceNow], [self numberOfBytesCopied] - bytesCopiedBefore);
         if( !success ) {
             [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
             [self downloadedWholeStoreFileWithSuccess:NO];
@@ -191,17 +194,8 @@
         return;
     }
     
-    // otherwise, copy the file to temp location, and decrypt it
-    NSString *tmpStorePath = [[self tempFileDirectoryPath] stringByAppendingPathComponent:[wholeStorePath lastPathComponent]];
-    
-    success = [self copyItemAtPath:wholeStorePath toPath:tmpStorePath error:&anyError];
-    if( !success ) {
-        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-        [self downloadedWholeStoreFileWithSuccess:success];
-        return;
-    }
-    
-    success = [[self cryptor] decryptFileAtLocation:[NSURL fileURLWithPath:wholeStorePath] writingToLocation:[self localWholeStoreFileLocation] error:&anyError];
+    // otherwise, decrypt straight from the remote file
+    success = [self decryptFileAtPath:wholeStorePath toPath:[[self localWholeStoreFileLocation] path] error:&anyError];
     
     if( !success ) {
         [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
@@ -227,6 +221,13 @@
     [self downloadedAppliedSyncChangeSetsFileWithSuccess:success];
 }
 
+- (void)fetchSyncChangeSetSequenceNumbersOfWholeStore
+{
+    NSString *recentSyncFilePath = [[[self thisDocumentRecentSyncsDirectoryPath] stringByAppendingPathComponent:[self requestedWholeStoreClientIdentifier]] stringByAppendingPathExtension:TICDSRecentSyncFileExtension];
+    
+    [self fetchedSyncChangeSetSequenceNumbersOfWholeStore:[[NSDictionary dictionaryWithContentsOfFile:recentSyncFilePath] valueForKey:kTICDSWholeStoreSyncChangeSetSequenceNumbers]];
+}
+
 - (void)fetchRemoteIntegrityKey
 {
     NSString *integrityDirectoryPath = [[self thisDocumentDirectoryPath] stringByAppendingPathComponent:TICDSIntegrityKeyDirectoryName];
@@ -270,6 +271,7 @@
 {
     [_thisDocumentDirectoryPath release], _thisDocumentDirectoryPath = nil;
     [_thisDocumentWholeStoreDirectoryPath release], _thisDocumentWholeStoreDirectoryPath = nil;
+    [_thisDocumentRecentSyncsDirectoryPath release], _thisDocumentRecentSyncsDirectoryPath = nil;
     
     [super dealloc];
 }
@@ -278,5 +280,6 @@
 #pragma mark Properties
 @synthesize thisDocumentDirectoryPath = _thisDocumentDirectoryPath;
 @synthesize thisDocumentWholeStoreDirectoryPath = _thisDocumentWholeStoreDirectoryPath;
+@synthesize thisDocumentRecentSyncsDirectoryPath = _thisDocumentRecentSyncsDirectoryPath;
 
 @end
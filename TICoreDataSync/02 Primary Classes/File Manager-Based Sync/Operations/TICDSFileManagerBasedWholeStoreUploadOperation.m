@@ -118,16 +118,14 @@
         BOOL isDir;
         NSAssert( [self.fileManager fileExistsAtPath:filePath isDirectory:&isDir] && !isDir, @"Encryption not supported when whole store is directory.");
         
-        NSString *tempPath = [[self tempFileDirectoryPath] stringByAppendingPathComponent:[filePath lastPathComponent]];
-        
-        success = [[self cryptor] encryptFileAtLocation:[NSURL fileURLWithPath:filePath] writingToLocation:[NSURL fileURLWithPath:tempPath] error:&anyError];
+        // encrypt straight into the temporary whole store directory, rather than via a local temporary file
+        success = [self encryptFileAtPath:filePath toPath:[self thisDocumentTemporaryWholeStoreThisClientDirectoryWholeStoreFilePath] error:&anyError];
         if( !success ) {
             [self setError:[TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-            [self uploadedWholeStoreFileToThisClientTemporaryWholeStoreDirectoryWithSuccess:NO];
-            return;
         }
         
-        filePath = tempPath;
+        [self uploadedWholeStoreFileToThisClientTemporaryWholeStoreDirectoryWithSuccess:success];
+        return;
     }
     
     success = [self copyLocalWholeStoreAtPath:filePath toTemporaryWholeStoreAtPath:[self thisDocumentTemporaryWholeStoreThisClientDirectoryWholeStoreFilePath] error:&anyError];
@@ -53,6 +53,12 @@ extern NSString * const TICDSApplicationSyncManagerDidRefreshCloudTransferProgre
 /** The path to the `DeletedDocuments` directory inside the `Information` directory at the root of the application. */
 @property (nonatomic, readonly) NSString *deletedDocumentsDirectoryPath;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory at the root of the application. */
+@property (nonatomic, readonly) NSString *documentCatalogFilePath;
+
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory at the root of the application. */
+@property (nonatomic, readonly) NSString *clientRegistryFilePath;
+
 /** The path to the `salt.ticdsync` file inside the `Encryption` directory at the root of the application. */
 @property (nonatomic, readonly) NSString *encryptionDirectorySaltDataFilePath;
 
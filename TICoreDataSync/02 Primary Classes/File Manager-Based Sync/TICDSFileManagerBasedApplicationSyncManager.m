@@ -272,6 +272,7 @@ NSString * const TICDSApplicationSyncManagerDidRefreshCloudTransferProgressNotif
     [operation setEncryptionDirectoryTestDataFilePath:[self encryptionDirectoryTestDataFilePath]];
     [operation setClientDevicesDirectoryPath:[self clientDevicesDirectoryPath]];
     [operation setClientDevicesThisClientDeviceDirectoryPath:[self clientDevicesThisClientDeviceDirectoryPath]];
+    [operation setClientRegistryFilePath:[self clientRegistryFilePath]];
     
     return [operation autorelease];
 }
@@ -281,6 +282,7 @@ NSString * const TICDSApplicationSyncManagerDidRefreshCloudTransferProgressNotif
     TICDSFileManagerBasedListOfPreviouslySynchronizedDocumentsOperation *operation = [[TICDSFileManagerBasedListOfPreviouslySynchronizedDocumentsOperation alloc] initWithDelegate:self];
     
     [operation setDocumentsDirectoryPath:[self documentsDirectoryPath]];
+    [operation setDocumentCatalogFilePath:[self documentCatalogFilePath]];
     
     return [operation autorelease];
 }
@@ -301,6 +303,7 @@ NSString * const TICDSApplicationSyncManagerDidRefreshCloudTransferProgressNotif
     
     [operation setClientDevicesDirectoryPath:[self clientDevicesDirectoryPath]];
     [operation setDocumentsDirectoryPath:[self documentsDirectoryPath]];
+    [operation setClientRegistryFilePath:[self clientRegistryFilePath]];
     return [operation autorelease];
 }
 
@@ -311,6 +314,8 @@ NSString * const TICDSApplicationSyncManagerDidRefreshCloudTransferProgressNotif
     [operation setDocumentDirectoryPath:[[self documentsDirectoryPath] stringByAppendingPathComponent:anIdentifier]];
     [operation setDeletedDocumentsDirectoryIdentifierPlistFilePath:[[self deletedDocumentsDirectoryPath] stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.%@", anIdentifier, TICDSDocumentInfoPlistExtension]]];
     [operation setDocumentInfoPlistFilePath:[[[self documentsDirectoryPath] stringByAppendingPathComponent:anIdentifier] stringByAppendingPathComponent:TICDSDocumentInfoPlistFilenameWithExtension]];
+    [operation setDocumentCatalogFilePath:[self documentCatalogFilePath]];
+    [operation setClientRegistryFilePath:[self clientRegistryFilePath]];
     
     return [operation autorelease];
 }
@@ -336,6 +341,16 @@ NSString * const TICDSApplicationSyncManagerDidRefreshCloudTransferProgressNotif
     return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToInformationDeletedDocumentsDirectory]];
 }
 
+- (NSString *)documentCatalogFilePath
+{
+    return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToInformationDocumentCatalogFile]];
+}
+
+- (NSString *)clientRegistryFilePath
+{
+    return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToInformationClientRegistryFile]];
+}
+
 - (NSString *)encryptionDirectorySaltDataFilePath
 {
     return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToEncryptionDirectorySaltDataFilePath]];
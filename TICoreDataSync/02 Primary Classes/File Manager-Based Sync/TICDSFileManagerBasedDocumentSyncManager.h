@@ -16,13 +16,17 @@
  No FileManagerBased-specific settings are required when you create a `TICDSFileManagerBasedDocumentSyncManager`--the `applicationDirectoryPath` is set automatically when you register (based on the properties set on the `TICDSFileManagerBasedApplicationSyncManager`).
  
  One **additional feature** is provided by an `NSFileManager`-based document sync manager---the ability to trigger a synchronization whenever changes are detected in other clients' `SyncChanges` directories. To make use of this functionality, simply call the `enableAutomaticSynchronizationAfterChangesDetectedFromOtherClients` method once the document has been registered.
+ 
+ Directory activity is coalesced by the watcher, including activity in the clients' sync partition directories. A synchronization triggered this way still lists every client's `SyncChanges` directory, so it picks up change sets missed while the watcher wasn't running, but lists the clients whose changes were detected first.
  */
 @interface TICDSFileManagerBasedDocumentSyncManager : TICDSDocumentSyncManager {
 @private
     NSString *_applicationDirectoryPath;
     
-    TIKQDirectoryWatcher *_directoryWatcher;
+    TIDirectoryWatcher *_directoryWatcher;
     NSMutableArray *_watchedClientDirectoryIdentifiers;
+    NSArray *_clientIdentifiersWithDetectedChanges;
+    NSUInteger _maximumConcurrentRemoteListings;
     
     NSString *_tempDirectoryPath;
 }
@@ -34,8 +38,13 @@
 
 /** @name Properties */
 
-/** A `TIKQDirectoryWatcher` used to watch for changes in the `SyncChanges` directories for this document. */
-@property (nonatomic, readonly) TIKQDirectoryWatcher *directoryWatcher;
+/** The maximum number of other clients' `SyncChanges` directories listed at the same time during synchronization.
+ 
+ Leave as `0` to use the synchronization operation's default. */
+@property (nonatomic, assign) NSUInteger maximumConcurrentRemoteListings;
+
+/** A `TIDirectoryWatcher` used to watch for changes in the `SyncChanges` directories for this document (kqueue-based on Mac OS X and iOS, inotify-based on Linux). */
+@property (nonatomic, readonly) TIDirectoryWatcher *directoryWatcher;
 
 /** A mutable array containing the identifiers of clients currently being watched. */
 @property (nonatomic, readonly) NSMutableArray *watchedClientDirectoryIdentifiers;
@@ -51,6 +60,12 @@
 /** The path to this document's `identifier.plist` file inside the `DeletedDocuments` directory. */
 @property (nonatomic, readonly) NSString *deletedDocumentsThisDocumentIdentifierPlistPath;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory. */
+@property (nonatomic, readonly) NSString *documentCatalogFilePath;
+
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory. */
+@property (nonatomic, readonly) NSString *clientRegistryFilePath;
+
 /** The path to the `Documents` directory. */
 @property (nonatomic, readonly) NSString *documentsDirectoryPath;
 
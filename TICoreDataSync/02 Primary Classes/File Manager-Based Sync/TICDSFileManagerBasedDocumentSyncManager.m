@@ -12,6 +12,11 @@
 - (void)applicationSyncManagerWillRemoveAllRemoteSyncData:(NSNotification *)aNotification;
 @end
 
+@interface TICDSFileManagerBasedDocumentSyncManager ()
+- (void)updateWatchedClientDirectories;
+- (void)watchSyncPartitionDirectoriesOfClientWithIdentifier:(NSString *)anIdentifier;
+@end
+
 
 @implementation TICDSFileManagerBasedDocumentSyncManager
 
@@ -32,6 +37,7 @@
 {
     [super applicationSyncManagerWillRemoveAllRemoteSyncData:aNotification];
     
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:kTIDirectoryWatcherObservedDirectoryActivityNotification object:_directoryWatcher];
     [_directoryWatcher release], _directoryWatcher = nil;
     
     [[NSFileManager defaultManager] removeItemAtPath:_tempDirectoryPath error:NULL];
@@ -46,7 +52,7 @@
         return;
     }
     
-    _directoryWatcher = [[TIKQDirectoryWatcher alloc] init];
+    _directoryWatcher = [[TIDirectoryWatcher directoryWatcher] retain];
     
     NSError *anyError = nil;
     BOOL success = [_directoryWatcher watchDirectory:[self thisDocumentSyncChangesDirectoryPath] error:&anyError];
@@ -59,79 +65,147 @@
     if( _watchedClientDirectoryIdentifiers ) {
         [_watchedClientDirectoryIdentifiers release], _watchedClientDirectoryIdentifiers = nil;
     }
+    _watchedClientDirectoryIdentifiers = [[NSMutableArray alloc] init];
+    
+    [self updateWatchedClientDirectories];
     
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(directoryContentsDidChange:) name:kTIDirectoryWatcherObservedDirectoryActivityNotification object:_directoryWatcher];
+    
+    success = [_directoryWatcher startWatching:&anyError];
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to start the directory watcher");
+        return;
+    }
+}
+
+- (void)updateWatchedClientDirectories
+{
+    NSError *anyError = nil;
     NSArray *clientIdentfiers = [[self fileManager] contentsOfDirectoryAtPath:[self thisDocumentSyncChangesDirectoryPath] error:&anyError];
     if( !clientIdentfiers ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to get contents of document's SyncChanges directory: %@", anyError);
         return;
     }
     
-    _watchedClientDirectoryIdentifiers = [[NSMutableArray alloc] initWithCapacity:[clientIdentfiers count]];
     NSString *eachPath = nil;
     for( NSString *eachIdentifier in clientIdentfiers ) {
         if( [[eachIdentifier substringToIndex:1] isEqualToString:@"."] || [eachIdentifier isEqualToString:[self clientIdentifier]] ) {
             continue;
         }
         
-        [_watchedClientDirectoryIdentifiers addObject:eachIdentifier];
+        if( [[self watchedClientDirectoryIdentifiers] containsObject:eachIdentifier] ) {
+            [self watchSyncPartitionDirectoriesOfClientWithIdentifier:eachIdentifier];
+            continue;
+        }
+        
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Not yet watching %@, so adding a directory watcher", eachIdentifier);
         
         eachPath = [[self thisDocumentSyncChangesDirectoryPath] stringByAppendingPathComponent:eachIdentifier];
         
-        success = [_directoryWatcher watchDirectory:eachPath error:&anyError];
+        BOOL success = [[self directoryWatcher] watchDirectory:eachPath error:&anyError];
         if( !success ) {
             TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to watch client's SyncChanges directory");
-            return;
+        } else {
+            [[self watchedClientDirectoryIdentifiers] addObject:eachIdentifier];
+            [self watchSyncPartitionDirectoriesOfClientWithIdentifier:eachIdentifier];
         }
     }
     
-    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(directoryContentsDidChange:) name:kTIKQDirectoryWatcherObservedDirectoryActivityNotification object:_directoryWatcher];
-    
-    success = [_directoryWatcher scheduleWatcherOnMainRunLoop:&anyError];
-    if( !success ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to schedule directory watcher on the run loop");
-        return;
+    // stop watching clients whose directories have been removed (e.g., deleted clients)
+    for( NSString *eachIdentifier in [[[self watchedClientDirectoryIdentifiers] copy] autorelease] ) {
+        if( [clientIdentfiers containsObject:eachIdentifier] ) {
+            continue;
+        }
+        
+        TICDSLog(TICDSLogVerbosityEveryStep, @"%@ no longer exists, so removing its directory watcher", eachIdentifier);
+        
+        eachPath = [[self thisDocumentSyncChangesDirectoryPath] stringByAppendingPathComponent:eachIdentifier];
+        NSString *partitionPathPrefix = [eachPath stringByAppendingString:@"/"];
+        for( NSString *eachWatchedPath in [[[[self directoryWatcher] watchedDirectories] copy] autorelease] ) {
+            if( [eachWatchedPath hasPrefix:partitionPathPrefix] ) {
+                [[self directoryWatcher] stopWatchingDirectory:eachWatchedPath error:&anyError];
+            }
+        }
+        [[self directoryWatcher] stopWatchingDirectory:eachPath error:&anyError];
+        [[self watchedClientDirectoryIdentifiers] removeObject:eachIdentifier];
     }
 }
 
-- (void)directoryContentsDidChange:(NSNotification *)aNotification
-{    
-    NSString *aPath = [[aNotification userInfo] valueForKey:kTIKQExpandedDirectory];
+- (void)watchSyncPartitionDirectoriesOfClientWithIdentifier:(NSString *)anIdentifier
+{
+    // sync change sets for sync partitions are uploaded to subdirectories of the client's directory, which appear when it first changes something in each partition
+    NSString *clientDirectoryPath = [[self thisDocumentSyncChangesDirectoryPath] stringByAppendingPathComponent:anIdentifier];
     
-    if( ![[aPath lastPathComponent] isEqualToString:TICDSSyncChangesDirectoryName] ) {
-        // another client has synchronized
-        [self initiateSynchronization];
+    NSError *anyError = nil;
+    NSArray *contents = [[self fileManager] contentsOfDirectoryAtPath:clientDirectoryPath error:&anyError];
+    if( !contents ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to get contents of client's SyncChanges directory: %@", anyError);
         return;
     }
     
-    NSError *anyError = nil;
-    // otherwise, go through each identifier to add another watcher
-    NSArray *clientIdentfiers = [[self fileManager] contentsOfDirectoryAtPath:[self thisDocumentSyncChangesDirectoryPath] error:&anyError];
-    if( !clientIdentfiers ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to get contents of document's SyncChanges directory: %@", anyError);
-        return;
+    for( NSString *eachName in contents ) {
+        if( [[eachName substringToIndex:1] isEqualToString:@"."] || [[eachName pathExtension] isEqualToString:TICDSSyncChangeSetFileExtension] ) {
+            continue;
+        }
+        
+        NSString *eachPath = [clientDirectoryPath stringByAppendingPathComponent:eachName];
+        BOOL isDirectory = NO;
+        if( [[[self directoryWatcher] watchedDirectories] containsObject:eachPath] || ![[self fileManager] fileExistsAtPath:eachPath isDirectory:&isDirectory] || !isDirectory ) {
+            continue;
+        }
+        
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Not yet watching sync partition %@ of %@, so adding a directory watcher", eachName, anIdentifier);
+        
+        if( ![[self directoryWatcher] watchDirectory:eachPath error:&anyError] ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to watch client's sync partition directory");
+        }
     }
+}
+
+- (void)directoryContentsDidChange:(NSNotification *)aNotification
+{
+    NSArray *paths = [[aNotification userInfo] valueForKey:kTIDirectoryWatcherExpandedDirectories];
+    NSString *syncChangesDirectoryPath = [[self thisDocumentSyncChangesDirectoryPath] stringByExpandingTildeInPath];
     
-    NSString *eachPath = nil;
-    for( NSString *eachIdentifier in clientIdentfiers ) {
-        if( [[eachIdentifier substringToIndex:1] isEqualToString:@"."] || [eachIdentifier isEqualToString:[self clientIdentifier]] ) {
+    NSMutableArray *changedClientIdentifiers = [NSMutableArray arrayWithCapacity:[paths count]];
+    for( NSString *eachPath in paths ) {
+        if( [eachPath isEqualToString:syncChangesDirectoryPath] ) {
+            // a client has been added or removed
+            [self updateWatchedClientDirectories];
             continue;
         }
         
-        if( [[self watchedClientDirectoryIdentifiers] containsObject:eachIdentifier] ) {
+        if( ![eachPath hasPrefix:[syncChangesDirectoryPath stringByAppendingString:@"/"]] ) {
             continue;
         }
         
-        TICDSLog(TICDSLogVerbosityEveryStep, @"Not yet watching %@, so adding a directory watcher", eachIdentifier);
+        // another client has synchronized, either in its own directory or in one of its sync partition directories
+        NSArray *relativePathComponents = [[eachPath substringFromIndex:[syncChangesDirectoryPath length] + 1] pathComponents];
+        NSString *clientIdentifier = [relativePathComponents objectAtIndex:0];
+        if( ![[self watchedClientDirectoryIdentifiers] containsObject:clientIdentifier] ) {
+            continue;
+        }
         
-        eachPath = [[self thisDocumentSyncChangesDirectoryPath] stringByAppendingPathComponent:eachIdentifier];
+        if( [relativePathComponents count] == 1 ) {
+            // the client may have created a directory for a new sync partition
+            [self watchSyncPartitionDirectoriesOfClientWithIdentifier:clientIdentifier];
+        }
         
-        BOOL success = [[self directoryWatcher] watchDirectory:eachPath error:&anyError];
-        if( !success ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to watch directory");
-        } else {
-            [[self watchedClientDirectoryIdentifiers] addObject:eachIdentifier];
+        if( ![changedClientIdentifiers containsObject:clientIdentifier] ) {
+            [changedClientIdentifiers addObject:clientIdentifier];
         }
     }
+    
+    if( [changedClientIdentifiers count] < 1 ) {
+        return;
+    }
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Detected changes from clients %@", changedClientIdentifiers);
+    
+    // picked up by -synchronizationOperation so the sync lists these clients' directories first
+    _clientIdentifiersWithDetectedChanges = [changedClientIdentifiers retain];
+    [self initiateSynchronization];
+    [_clientIdentifiersWithDetectedChanges release], _clientIdentifiersWithDetectedChanges = nil;
 }
 
 #pragma mark -
@@ -167,6 +241,8 @@
     [operation setThisDocumentDirectoryPath:[self thisDocumentDirectoryPath]];
     [operation setThisDocumentSyncChangesThisClientDirectoryPath:[self thisDocumentSyncChangesThisClientDirectoryPath]];
     [operation setThisDocumentSyncCommandsThisClientDirectoryPath:[self thisDocumentSyncCommandsThisClientDirectoryPath]];
+    [operation setDocumentCatalogFilePath:[self documentCatalogFilePath]];
+    [operation setClientRegistryFilePath:[self clientRegistryFilePath]];
     
     return [operation autorelease];
 }
@@ -189,6 +265,7 @@
     
     [operation setThisDocumentDirectoryPath:[self thisDocumentDirectoryPath]];
     [operation setThisDocumentWholeStoreDirectoryPath:[self thisDocumentWholeStoreDirectoryPath]];
+    [operation setThisDocumentRecentSyncsDirectoryPath:[self thisDocumentRecentSyncsDirectoryPath]];
     
     return [operation autorelease];
 }
@@ -201,6 +278,12 @@
     [operation setThisDocumentSyncChangesDirectoryPath:[self thisDocumentSyncChangesDirectoryPath]];
     [operation setThisDocumentSyncChangesThisClientDirectoryPath:[self thisDocumentSyncChangesThisClientDirectoryPath]];
     [operation setThisDocumentRecentSyncsThisClientFilePath:[self thisDocumentRecentSyncsThisClientFilePath]];
+    [operation setClientIdentifiersWithDetectedChanges:_clientIdentifiersWithDetectedChanges];
+    [operation setDocumentCatalogFilePath:[self documentCatalogFilePath]];
+    
+    if( [self maximumConcurrentRemoteListings] > 0 ) {
+        [operation setMaximumConcurrentRemoteListings:[self maximumConcurrentRemoteListings]];
+    }
     
     return [operation autorelease];
 }
@@ -224,6 +307,7 @@
     [operation setClientDevicesDirectoryPath:[self clientDevicesDirectoryPath]];
     [operation setThisDocumentRecentSyncsDirectoryPath:[self thisDocumentRecentSyncsDirectoryPath]];
     [operation setThisDocumentWholeStoreDirectoryPath:[self thisDocumentWholeStoreDirectoryPath]];
+    [operation setClientRegistryFilePath:[self clientRegistryFilePath]];
     
     return [operation autorelease];
 }
@@ -238,6 +322,7 @@
     [operation setThisDocumentSyncCommandsDirectoryPath:[self thisDocumentSyncCommandsDirectoryPath]];
     [operation setThisDocumentRecentSyncsDirectoryPath:[self thisDocumentRecentSyncsDirectoryPath]];
     [operation setThisDocumentWholeStoreDirectoryPath:[self thisDocumentWholeStoreDirectoryPath]];
+    [operation setClientRegistryFilePath:[self clientRegistryFilePath]];
     
     return [operation autorelease];
 }
@@ -254,6 +339,16 @@
     return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToDeletedDocumentsThisDocumentIdentifierPlistFile]];
 }
 
+- (NSString *)documentCatalogFilePath
+{
+    return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToInformationDocumentCatalogFile]];
+}
+
+- (NSString *)clientRegistryFilePath
+{
+    return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToInformationClientRegistryFile]];
+}
+
 - (NSString *)documentsDirectoryPath
 {
     return [[self applicationDirectoryPath] stringByAppendingPathComponent:[self relativePathToDocumentsDirectory]];
@@ -343,6 +438,7 @@
 - (void)dealloc
 {
     [_applicationDirectoryPath release], _applicationDirectoryPath = nil;
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:kTIDirectoryWatcherObservedDirectoryActivityNotification object:_directoryWatcher];
     [_directoryWatcher release], _directoryWatcher = nil;
     [_watchedClientDirectoryIdentifiers release], _watchedClientDirectoryIdentifiers = nil;
     
@@ -357,5 +453,6 @@
 @synthesize applicationDirectoryPath = _applicationDirectoryPath;
 @synthesize directoryWatcher = _directoryWatcher;
 @synthesize watchedClientDirectoryIdentifiers = _watchedClientDirectoryIdentifiers;
+@synthesize maximumConcurrentRemoteListings = _maximumConcurrentRemoteListings;
 
 @end
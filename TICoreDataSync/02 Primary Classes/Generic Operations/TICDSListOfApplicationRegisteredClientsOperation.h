@@ -13,8 +13,12 @@
  The operation carries out the following tasks:
  
  1. Fetch a list of UUID identifiers of all registered clients from the application's `ClientDevices` directory.
- 2. Fetch the `deviceInfo.plist` file for each registered client.
- 3. Optionally fetch a list of document UUID identifiers and add a `registeredDocuments` key to each device dictionary, with the value being an array of document identifiers, indicating the documents that the client has registered to synchronize.
+ 2. If the subclass supports a client registry (see `supportsClientRegistry`), fetch the registry. If every registered client is in it, take each client's device information and registered documents from the registry, optionally fetch a list of document UUID identifiers to discard documents that have since been deleted, and finish.
+ 3. Otherwise, fetch the `deviceInfo.plist` file for each registered client.
+ 4. Optionally fetch a list of document UUID identifiers and add a `registeredDocuments` key to each device dictionary, with the value being an array of document identifiers, indicating the documents that the client has registered to synchronize.
+ 5. If the client registry is missing any registered client, add every client to it, with the documents each has registered; the documents are fetched for this even if `shouldIncludeRegisteredDocuments` is `NO`.
+ 
+ With an up-to-date registry, listing clients needs at most three remote requests however many clients and documents there are.
  
  Operations are typically created automatically by the relevant sync manager.
  
@@ -36,6 +40,8 @@
     NSUInteger _numberOfDocumentClientArraysThatFailedToFetch;
 
     BOOL _shouldIncludeRegisteredDocuments;
+    BOOL _hasClientRegistryEntryForEachClient;
+    BOOL _shouldUpdateClientRegistry;
 }
 
 #pragma mark - Overridden Methods
@@ -63,6 +69,23 @@
  This method must call `fetchedArrayOfClients:registeredForDocumentWithIdentifier:` when finished. */
 - (void)fetchArrayOfClientsRegisteredForDocumentWithIdentifier:(NSString *)anIdentifier;
 
+/** Indicate whether the subclass keeps a client registry. The default implementation returns `NO`, in which case the information for every client is fetched individually. */
+- (BOOL)supportsClientRegistry;
+
+/** Fetch the entries in the client registry; only called if `supportsClientRegistry` returns `YES`.
+ 
+ This method must call `fetchedClientRegistryEntries:` when finished. */
+- (void)fetchClientRegistry;
+
+/** Add entries to the client registry; only called if `supportsClientRegistry` returns `YES`.
+ 
+ Each entry should replace the device information of any existing entry for the same client, keeping any registered documents not in the new entry.
+ 
+ This method must call `updatedClientRegistryWithSuccess:` when finished.
+ 
+ @param someEntries A dictionary of client entries (a `deviceInfo` dictionary with the `kTICDSRegisteredDocumentIdentifiers` key), keyed by client identifier. */
+- (void)updateClientRegistryWithEntries:(NSDictionary *)someEntries;
+
 #pragma mark - Callbacks
 /** Pass back the assembled `NSArray` of `NSString` client identifiers.
  
@@ -94,6 +117,20 @@
  @param anIdentifier The identifier of the document. */
 - (void)fetchedArrayOfClients:(NSArray *)anArray registeredForDocumentWithIdentifier:(NSString *)anIdentifier;
 
+/** Pass back the entries in the client registry.
+ 
+ If the registry doesn't exist or couldn't be read, specify `nil` for `someEntries`; the information for every client is then fetched individually, and the registry rebuilt.
+ 
+ @param someEntries A dictionary of client entries, keyed by client identifier, or `nil` if there is no registry. */
+- (void)fetchedClientRegistryEntries:(NSDictionary *)someEntries;
+
+/** Indicate whether the client registry was updated. The listing completes successfully either way.
+ 
+ If not, call `setError:` first, then specify `NO` for `success`.
+ 
+ @param success `YES` if the registry was updated, otherwise `NO`. */
+- (void)updatedClientRegistryWithSuccess:(BOOL)success;
+
 #pragma mark - Properties
 /** @name Properties */
 
@@ -11,9 +11,11 @@
 @interface TICDSListOfApplicationRegisteredClientsOperation ()
 
 - (void)beginFetchingArrayOfClientUUIDStrings;
+- (void)beginFetchingClientRegistry;
 - (void)beginFetchingDeviceInfoDictionaries;
 - (void)beginFetchingArrayOfDocumentUUIDStrings;
 - (void)beginFetchingClientIdentifiersRegisteredForEachDocument;
+- (void)finishListingClients;
 
 @end
 
@@ -59,7 +61,11 @@
     
     TICDSLog(TICDSLogVerbosityEveryStep, @"Fetched array of registered client UUIDs");
     
-    [self beginFetchingDeviceInfoDictionaries];
+    if( [self supportsClientRegistry] ) {
+        [self beginFetchingClientRegistry];
+    } else {
+        [self beginFetchingDeviceInfoDictionaries];
+    }
 }
 
 #pragma mark Overridden Method
@@ -69,6 +75,115 @@
     [self fetchedArrayOfClientUUIDStrings:nil];
 }
 
+#pragma mark - Client Registry
+- (void)beginFetchingClientRegistry
+{
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to fetch client registry");
+    
+    [self fetchClientRegistry];
+}
+
+- (void)fetchedClientRegistryEntries:(NSDictionary *)someEntries
+{
+    NSMutableDictionary *deviceInfoDictionaries = [NSMutableDictionary dictionaryWithCapacity:[[self synchronizedClientIdentifiers] count]];
+    
+    for( NSString *eachIdentifier in [self synchronizedClientIdentifiers] ) {
+        NSDictionary *entry = [someEntries valueForKey:eachIdentifier];
+        
+        if( ![entry isKindOfClass:[NSDictionary class]] ) {
+            TICDSLog(TICDSLogVerbosityEveryStep, @"Client %@ isn't in the client registry, so fetching information for each client and repairing the registry", eachIdentifier);
+            
+            _shouldUpdateClientRegistry = YES;
+            [self beginFetchingDeviceInfoDictionaries];
+            return;
+        }
+        
+        NSMutableDictionary *dictionary = [entry mutableCopy];
+        NSMutableArray *documentIdentifiers = [[entry valueForKey:kTICDSRegisteredDocumentIdentifiers] mutableCopy];
+        
+        [dictionary setValue:[documentIdentifiers count] > 0 ? documentIdentifiers : nil forKey:kTICDSRegisteredDocumentIdentifiers];
+        [deviceInfoDictionaries setValue:dictionary forKey:eachIdentifier];
+        
+        [documentIdentifiers release];
+        [dictionary release];
+    }
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Found every registered client in the client registry");
+    
+    _hasClientRegistryEntryForEachClient = YES;
+    
+    [self setTemporaryDeviceInfoDictionaries:deviceInfoDictionaries];
+    [self setDeviceInfoDictionaries:[self temporaryDeviceInfoDictionaries]];
+    
+    if( ![self shouldIncludeRegisteredDocuments] ) {
+        [self finishListingClients];
+        return;
+    }
+    
+    // The registry may still list documents that have since been deleted
+    [self beginFetchingArrayOfDocumentUUIDStrings];
+}
+
+- (void)finishListingClients
+{
+    NSMutableDictionary *registryEntries = nil;
+    
+    if( _shouldUpdateClientRegistry && _numberOfDocumentClientArraysThatFailedToFetch < 1 ) {
+        registryEntries = [NSMutableDictionary dictionaryWithCapacity:[[self temporaryDeviceInfoDictionaries] count]];
+        
+        for( NSString *eachIdentifier in [self temporaryDeviceInfoDictionaries] ) {
+            NSMutableDictionary *entry = [[[[self temporaryDeviceInfoDictionaries] valueForKey:eachIdentifier] mutableCopy] autorelease];
+            
+            if( ![entry valueForKey:kTICDSRegisteredDocumentIdentifiers] ) {
+                [entry setValue:[NSArray array] forKey:kTICDSRegisteredDocumentIdentifiers];
+            }
+            
+            [registryEntries setValue:entry forKey:eachIdentifier];
+        }
+    }
+    
+    if( ![self shouldIncludeRegisteredDocuments] ) {
+        for( NSMutableDictionary *eachDictionary in [[self temporaryDeviceInfoDictionaries] allValues] ) {
+            [eachDictionary removeObjectForKey:kTICDSRegisteredDocumentIdentifiers];
+        }
+    }
+    
+    if( !registryEntries ) {
+        [self operationDidCompleteSuccessfully];
+        return;
+    }
+    
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Adding %lu clients to the client registry", (unsigned long)[registryEntries count]);
+    
+    [self updateClientRegistryWithEntries:registryEntries];
+}
+
+- (void)updatedClientRegistryWithSuccess:(BOOL)success
+{
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to update the client registry, but the registry isn't essential, so continuing...");
+    }
+    
+    [self operationDidCompleteSuccessfully];
+}
+
+#pragma mark Overridden Methods
+- (BOOL)supportsClientRegistry
+{
+    return NO;
+}
+
+- (void)fetchClientRegistry
+{
+    [self fetchedClientRegistryEntries:nil];
+}
+
+- (void)updateClientRegistryWithEntries:(NSDictionary *)someEntries
+{
+    [self setError:[TICDSError errorWithCode:TICDSErrorCodeMethodNotOverriddenBySubclass classAndMethod:__PRETTY_FUNCTION__]];
+    [self updatedClientRegistryWithSuccess:NO];
+}
+
 #pragma mark - Fetching deviceInfo.plist Dictionaries
 - (void)beginFetchingDeviceInfoDictionaries
 {
@@ -102,7 +217,8 @@
         
         [self setDeviceInfoDictionaries:[self temporaryDeviceInfoDictionaries]];
         
-        if( ![self shouldIncludeRegisteredDocuments] ) {
+        // Repairing the client registry needs the documents registered by each client, even if they weren't asked for
+        if( ![self shouldIncludeRegisteredDocuments] && !_shouldUpdateClientRegistry ) {
             [self operationDidCompleteSuccessfully];
             return;
         }
@@ -150,11 +266,25 @@
     
     [self setSynchronizedDocumentIdentifiers:documentIdentifiers];
     
+    if( _hasClientRegistryEntryForEachClient ) {
+        for( NSMutableDictionary *eachDictionary in [[self temporaryDeviceInfoDictionaries] allValues] ) {
+            NSMutableArray *registeredDocumentIdentifiers = [eachDictionary valueForKey:kTICDSRegisteredDocumentIdentifiers];
+            [registeredDocumentIdentifiers filterUsingPredicate:[NSPredicate predicateWithFormat:@"SELF IN %@", documentIdentifiers]];
+            
+            if( [registeredDocumentIdentifiers count] < 1 ) {
+                [eachDictionary removeObjectForKey:kTICDSRegisteredDocumentIdentifiers];
+            }
+        }
+        
+        TICDSLog(TICDSLogVerbosityStartAndEndOfMainOperationPhase, @"Took the documents registered by each client from the client registry");
+        [self finishListingClients];
+        return;
+    }
     
     if( [[self synchronizedDocumentIdentifiers] count] < 1 ) {
         TICDSLog(TICDSLogVerbosityStartAndEndOfMainOperationPhase, @"No documents were found");
         
-        [self operationDidCompleteSuccessfully];
+        [self finishListingClients];
         return;
     }
     
@@ -208,13 +338,13 @@
     
     if( _numberOfDocumentClientArraysFetched == _numberOfDocumentClientArraysToFetch ) {
         TICDSLog(TICDSLogVerbosityStartAndEndOfMainOperationPhase, @"Finished fetching client identifiers registered for each document");
-        [self operationDidCompleteSuccessfully];
+        [self finishListingClients];
         return;
     }
     
     if( _numberOfDocumentClientArraysFetched + _numberOfDocumentClientArraysThatFailedToFetch == _numberOfDocumentClientArraysToFetch ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"One or more registered client arrays failed to fetch, but not fatal so continuing");
-        [self operationDidCompleteSuccessfully];
+        [self finishListingClients];
         return;
     }
 }
@@ -13,9 +13,12 @@
  The operation carries out the following tasks:
  
  1. Fetch a list of UUID identifiers of client directories inside the document's `SyncChanges` directory.
- 2. Fetch the `deviceInfo.plist` file for each registered client.
- 3. Fetch the last modified date of each client's `RecentSync` file, if it exists.
- 3. Fetch the last modified date of each client's `WholeStore` upload, if it exists.
+ 2. If the subclass supports a client registry (see `supportsClientRegistry`), fetch the registry, and take the device information of each listed client from it.
+ 3. Fetch the `deviceInfo.plist` file for each registered client not in the registry.
+ 4. Fetch the last modified date of each client's `RecentSync` file, if it exists.
+ 5. Fetch the last modified date of each client's `WholeStore` upload, if it exists.
+ 
+ This operation only reads the client registry; clients missing from it are added when the application's registered clients are next listed.
  
  Operations are typically created automatically by the relevant sync manager.
  
@@ -26,6 +29,7 @@
     NSArray *_synchronizedClientIdentifiers;
     NSMutableDictionary *_temporaryDeviceInfoDictionaries;
     NSDictionary *_deviceInfoDictionaries;
+    NSArray *_clientIdentifiersToFetch;
     
     NSUInteger _numberOfDeviceInfoDictionariesToFetch;
     NSUInteger _numberOfDeviceInfoDictionariesFetched;
@@ -67,6 +71,14 @@
  @param anIdentifier The UUID synchronization identifier of the client. */
 - (void)fetchModificationDateOfWholeStoreForClientWithIdentifier:(NSString *)anIdentifier;
 
+/** Indicate whether the subclass keeps a client registry. The default implementation returns `NO`, in which case the `deviceInfo.plist` file for every client is fetched individually. */
+- (BOOL)supportsClientRegistry;
+
+/** Fetch the entries in the client registry; only called if `supportsClientRegistry` returns `YES`.
+ 
+ This method must call `fetchedClientRegistryEntries:` when finished. */
+- (void)fetchClientRegistry;
+
 #pragma mark - Callbacks
 /** Pass back the assembled `NSArray` of `NSString` client identifiers.
  
@@ -99,6 +111,13 @@
  @param anIdentifier The UUID synchronization identifier of the client. */
 - (void)fetchedModificationDate:(NSDate *)aDate ofWholeStoreForClientWithIdentifier:(NSString *)anIdentifier;
 
+/** Pass back the entries in the client registry.
+ 
+ If the registry doesn't exist or couldn't be read, specify `nil` for `someEntries`; the `deviceInfo.plist` file for every client is then fetched individually.
+ 
+ @param someEntries A dictionary of client entries, keyed by client identifier, or `nil` if there is no registry. */
+- (void)fetchedClientRegistryEntries:(NSDictionary *)someEntries;
+
 #pragma mark - Properties
 /** @name Properties */
 
@@ -108,6 +127,9 @@
 /** A mutable dictionary used to keep track of the `deviceInfo.plist` dictionaries for each client while the operation is executing. */
 @property (nonatomic, retain) NSMutableDictionary *temporaryDeviceInfoDictionaries;
 
+/** The identifiers of the registered clients that weren't found in the client registry, whose `deviceInfo.plist` files must be fetched individually. */
+@property (nonatomic, retain) NSArray *clientIdentifiersToFetch;
+
 /** The final dictionary of `deviceInfo.plist` dictionaries for each client once the operation has finished. */
 @property (retain) NSDictionary *deviceInfoDictionaries;
 
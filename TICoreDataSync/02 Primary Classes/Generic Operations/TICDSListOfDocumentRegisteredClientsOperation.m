@@ -11,6 +11,7 @@
 @interface TICDSListOfDocumentRegisteredClientsOperation ()
 
 - (void)beginFetchingArrayOfClientUUIDStrings;
+- (void)beginFetchingClientRegistry;
 - (void)beginFetchingDeviceInfoDictionaries;
 - (void)beginFetchingLastSynchronizationDates;
 - (void)beginFetchingUploadedWholeStoreDates;
@@ -59,7 +60,14 @@
     
     TICDSLog(TICDSLogVerbosityEveryStep, @"Fetched array of registered client UUIDs");
     
-    [self beginFetchingDeviceInfoDictionaries];
+    [self setTemporaryDeviceInfoDictionaries:[NSMutableDictionary dictionaryWithCapacity:[[self synchronizedClientIdentifiers] count]]];
+    [self setClientIdentifiersToFetch:[self synchronizedClientIdentifiers]];
+    
+    if( [self supportsClientRegistry] ) {
+        [self beginFetchingClientRegistry];
+    } else {
+        [self beginFetchingDeviceInfoDictionaries];
+    }
 }
 
 #pragma mark Overridden Method
@@ -69,16 +77,63 @@
     [self fetchedArrayOfClientUUIDStrings:nil];
 }
 
+#pragma mark - Client Registry
+- (void)beginFetchingClientRegistry
+{
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to fetch client registry");
+    
+    [self fetchClientRegistry];
+}
+
+- (void)fetchedClientRegistryEntries:(NSDictionary *)someEntries
+{
+    NSMutableArray *clientIdentifiersToFetch = [NSMutableArray array];
+    
+    for( NSString *eachIdentifier in [self synchronizedClientIdentifiers] ) {
+        NSDictionary *entry = [someEntries valueForKey:eachIdentifier];
+        
+        if( ![entry isKindOfClass:[NSDictionary class]] ) {
+            [clientIdentifiersToFetch addObject:eachIdentifier];
+            continue;
+        }
+        
+        NSMutableDictionary *dictionary = [entry mutableCopy];
+        [dictionary removeObjectForKey:kTICDSRegisteredDocumentIdentifiers];
+        [[self temporaryDeviceInfoDictionaries] setValue:dictionary forKey:eachIdentifier];
+        [dictionary release];
+    }
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Found %lu of %lu clients in the client registry", (unsigned long)([[self synchronizedClientIdentifiers] count] - [clientIdentifiersToFetch count]), (unsigned long)[[self synchronizedClientIdentifiers] count]);
+    
+    [self setClientIdentifiersToFetch:clientIdentifiersToFetch];
+    
+    if( [clientIdentifiersToFetch count] < 1 ) {
+        [self beginFetchingLastSynchronizationDates];
+        return;
+    }
+    
+    [self beginFetchingDeviceInfoDictionaries];
+}
+
+#pragma mark Overridden Methods
+- (BOOL)supportsClientRegistry
+{
+    return NO;
+}
+
+- (void)fetchClientRegistry
+{
+    [self fetchedClientRegistryEntries:nil];
+}
+
 #pragma mark - Fetching deviceInfo.plist Dictionaries
 - (void)beginFetchingDeviceInfoDictionaries
 {
     TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to fetch all deviceInfo.plist dictionaries");
     
-    _numberOfDeviceInfoDictionariesToFetch = [[self synchronizedClientIdentifiers] count];
-    
-    [self setTemporaryDeviceInfoDictionaries:[NSMutableDictionary dictionaryWithCapacity:_numberOfDeviceInfoDictionariesToFetch]];
+    _numberOfDeviceInfoDictionariesToFetch = [[self clientIdentifiersToFetch] count];
     
-    for( NSString *eachSyncID in [self synchronizedClientIdentifiers] ) {
+    for( NSString *eachSyncID in [self clientIdentifiersToFetch] ) {
         [self fetchDeviceInfoDictionaryForClientWithIdentifier:eachSyncID];
     }
 }
@@ -201,6 +256,7 @@
     [_synchronizedClientIdentifiers release], _synchronizedClientIdentifiers = nil;
     [_temporaryDeviceInfoDictionaries release], _temporaryDeviceInfoDictionaries = nil;
     [_deviceInfoDictionaries release], _deviceInfoDictionaries = nil;
+    [_clientIdentifiersToFetch release], _clientIdentifiersToFetch = nil;
 
     [super dealloc];
 }
@@ -210,5 +266,6 @@
 @synthesize synchronizedClientIdentifiers = _synchronizedClientIdentifiers;
 @synthesize temporaryDeviceInfoDictionaries = _temporaryDeviceInfoDictionaries;
 @synthesize deviceInfoDictionaries = _deviceInfoDictionaries;
+@synthesize clientIdentifiersToFetch = _clientIdentifiersToFetch;
 
 @end
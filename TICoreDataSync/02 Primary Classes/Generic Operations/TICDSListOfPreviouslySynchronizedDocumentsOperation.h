@@ -13,8 +13,12 @@
  The operation carries out the following tasks:
  
  1. Get a list of document identifiers for available documents.
- 2. Fetch the `documentInfo` dictionary for each document.
- 3. Get the most recent synchronization date for each successfully-fetched document dictionary (the most recently modified file in `RecentSyncs`).
+ 2. If the subclass supports a document catalog (see `supportsDocumentCatalog`), fetch the catalog, and take the `documentInfo` dictionary and last synchronization date of each listed document from it.
+ 3. Fetch the `documentInfo` dictionary for each document not in the catalog.
+ 4. Get the most recent synchronization date for each successfully-fetched document dictionary (the most recently modified file in `RecentSyncs`).
+ 5. Add the documents that weren't in the catalog to it, so the next listing can take them from the catalog too.
+ 
+ With an up-to-date catalog, listing documents needs two remote requests however many documents there are, rather than two for every document.
  
  Operations are typically created automatically by the relevant sync manager.
  
@@ -26,6 +30,8 @@
     NSMutableArray *_availableDocuments;
     
     NSArray *_availableDocumentSyncIDs;
+    NSArray *_documentSyncIDsToFetch;
+    BOOL _shouldUpdateDocumentCatalog;
     
     NSUInteger _numberOfInfoDictionariesToFetch;
     NSUInteger _numberOfInfoDictionariesFetched;
@@ -57,6 +63,21 @@
  Call `fetchedLastSynchronizationDate:forDocumentWithSyncID:` when the date is fetched. */
 - (void)fetchLastSynchronizationDateForDocumentWithSyncID:(NSString *)aSyncID;
 
+/** Indicate whether the subclass keeps a document catalog. The default implementation returns `NO`, in which case the information for every document is fetched individually. */
+- (BOOL)supportsDocumentCatalog;
+
+/** Fetch the entries in the document catalog; only called if `supportsDocumentCatalog` returns `YES`.
+ 
+ Call `fetchedDocumentCatalogEntries:` when the entries are fetched. */
+- (void)fetchDocumentCatalog;
+
+/** Add entries to the document catalog, replacing any existing entries for the same documents; only called if `supportsDocumentCatalog` returns `YES`.
+ 
+ @param someEntries A dictionary of document entries (a `documentInfo` dictionary with the `kTICDSLastSyncDate` key), keyed by document identifier.
+ 
+ Call `updatedDocumentCatalogWithSuccess:` when the catalog has been updated. */
+- (void)updateDocumentCatalogWithEntries:(NSDictionary *)someEntries;
+
 /** @name Callbacks */
 
 /** Pass back the assembled `NSArray` of `NSString` document identifiers.
@@ -82,6 +103,20 @@
  @param aSyncID The unique synchronization identifier of the given document. */
 - (void)fetchedLastSynchronizationDate:(NSDate *)aDate forDocumentWithSyncID:(NSString *)aSyncID;
 
+/** Pass back the entries in the document catalog.
+ 
+ If the catalog doesn't exist or couldn't be read, specify `nil` for `someEntries`; the information for every document is then fetched individually.
+ 
+ @param someEntries A dictionary of document entries, keyed by document identifier, or `nil` if there is no catalog. */
+- (void)fetchedDocumentCatalogEntries:(NSDictionary *)someEntries;
+
+/** Indicate whether the document catalog was updated. The listing completes successfully either way.
+ 
+ If not, call `setError:` first, then specify `NO` for `success`.
+ 
+ @param success `YES` if the catalog was updated, otherwise `NO`. */
+- (void)updatedDocumentCatalogWithSuccess:(BOOL)success;
+
 /** @name Properties */
 
 /** An array of documents, built as information comes in. */
@@ -90,6 +125,9 @@
 /** An array used internally by the operation to keep track of the available document sync identifiers. */
 @property (nonatomic, retain) NSArray *availableDocumentSyncIDs;
 
+/** The sync identifiers of the available documents that weren't found in the document catalog, whose information must be fetched individually. */
+@property (nonatomic, retain) NSArray *documentSyncIDsToFetch;
+
 /** @name Completion */
 
 /** The total number of info dictionaries that need to be fetched. */
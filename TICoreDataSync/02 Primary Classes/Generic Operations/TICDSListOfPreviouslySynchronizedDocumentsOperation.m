@@ -11,6 +11,7 @@
 @interface TICDSListOfPreviouslySynchronizedDocumentsOperation ()
 
 - (void)beginFetchOfListOfDocumentSyncIDs;
+- (void)beginFetchOfDocumentCatalog;
 - (void)beginFetchOfDocumentInfoDictionaries;
 - (void)beginFetchOfLastSynchronizationDates;
 - (void)increaseNumberOfInfoDictionariesToFetch;
@@ -19,6 +20,7 @@
 - (void)increaseNumberOfLastSynchronizationDatesToFetch;
 - (void)increaseNumberOfLastSynchronizationDatesFetched;
 - (void)increaseNumberOfLastSynchronizationDatesThatFailedToFetch;
+- (void)finishListingDocuments;
 
 @end
 
@@ -55,7 +57,14 @@
     TICDSLog(TICDSLogVerbosityEveryStep, @"Fetched list of document sync identifiers successfully");
     
     [self setAvailableDocumentSyncIDs:anArray];
-    [self beginFetchOfDocumentInfoDictionaries];
+    [self setAvailableDocuments:[NSMutableArray arrayWithCapacity:[anArray count]]];
+    [self setDocumentSyncIDsToFetch:anArray];
+    
+    if( [self supportsDocumentCatalog] ) {
+        [self beginFetchOfDocumentCatalog];
+    } else {
+        [self beginFetchOfDocumentInfoDictionaries];
+    }
 }
 
 #pragma mark Overridden Method
@@ -65,16 +74,109 @@
     [self builtArrayOfDocumentIdentifiers:nil];
 }
 
+#pragma mark - Document Catalog
+- (void)beginFetchOfDocumentCatalog
+{
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to fetch document catalog");
+    
+    [self fetchDocumentCatalog];
+}
+
+- (void)fetchedDocumentCatalogEntries:(NSDictionary *)someEntries
+{
+    if( !someEntries ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"No document catalog, so fetching information for each document");
+    }
+    
+    NSMutableArray *syncIDsToFetch = [NSMutableArray array];
+    
+    for( NSString *eachSyncID in [self availableDocumentSyncIDs] ) {
+        NSDictionary *entry = [someEntries valueForKey:eachSyncID];
+        
+        if( ![entry isKindOfClass:[NSDictionary class]] ) {
+            [syncIDsToFetch addObject:eachSyncID];
+            continue;
+        }
+        
+        NSMutableDictionary *dictionary = [entry mutableCopy];
+        [dictionary setValue:eachSyncID forKey:kTICDSDocumentIdentifier];
+        [[self availableDocuments] addObject:dictionary];
+        [dictionary release];
+    }
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Found %lu of %lu documents in the document catalog", (unsigned long)([[self availableDocumentSyncIDs] count] - [syncIDsToFetch count]), (unsigned long)[[self availableDocumentSyncIDs] count]);
+    
+    [self setDocumentSyncIDsToFetch:syncIDsToFetch];
+    
+    if( [syncIDsToFetch count] < 1 ) {
+        [self operationDidCompleteSuccessfully];
+        return;
+    }
+    
+    _shouldUpdateDocumentCatalog = YES;
+    
+    [self beginFetchOfDocumentInfoDictionaries];
+}
+
+- (void)finishListingDocuments
+{
+    if( !_shouldUpdateDocumentCatalog ) {
+        [self operationDidCompleteSuccessfully];
+        return;
+    }
+    
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Adding %lu documents to the document catalog", (unsigned long)[[self documentSyncIDsToFetch] count]);
+    
+    NSMutableDictionary *entries = [NSMutableDictionary dictionaryWithCapacity:[[self documentSyncIDsToFetch] count]];
+    for( NSDictionary *eachDocument in [self availableDocuments] ) {
+        NSString *syncID = [eachDocument valueForKey:kTICDSDocumentIdentifier];
+        
+        if( ![[self documentSyncIDsToFetch] containsObject:syncID] ) {
+            continue;
+        }
+        
+        NSMutableDictionary *entry = [[eachDocument mutableCopy] autorelease];
+        [entry removeObjectForKey:kTICDSDocumentIdentifier];
+        [entries setValue:entry forKey:syncID];
+    }
+    
+    [self updateDocumentCatalogWithEntries:entries];
+}
+
+- (void)updatedDocumentCatalogWithSuccess:(BOOL)success
+{
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to update the document catalog, but the catalog isn't essential, so continuing...");
+    }
+    
+    [self operationDidCompleteSuccessfully];
+}
+
+#pragma mark Overridden Methods
+- (BOOL)supportsDocumentCatalog
+{
+    return NO;
+}
+
+- (void)fetchDocumentCatalog
+{
+    [self fetchedDocumentCatalogEntries:nil];
+}
+
+- (void)updateDocumentCatalogWithEntries:(NSDictionary *)someEntries
+{
+    [self setError:[TICDSError errorWithCode:TICDSErrorCodeMethodNotOverriddenBySubclass classAndMethod:__PRETTY_FUNCTION__]];
+    [self updatedDocumentCatalogWithSuccess:NO];
+}
+
 #pragma mark - Document Info Dictionaries
 - (void)beginFetchOfDocumentInfoDictionaries
 {
     TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to fetch sync ids for each document sync identifier");
     
-    [self setAvailableDocuments:[NSMutableArray arrayWithCapacity:[[self availableDocumentSyncIDs] count]]];
-        
-    [self setNumberOfInfoDictionariesToFetch:[[self availableDocumentSyncIDs] count]];
+    [self setNumberOfInfoDictionariesToFetch:[[self documentSyncIDsToFetch] count]];
     
-    for( NSString *eachSyncID in [self availableDocumentSyncIDs] ) {
+    for( NSString *eachSyncID in [self documentSyncIDsToFetch] ) {
         [self fetchInfoDictionaryForDocumentWithSyncID:eachSyncID];
     }
 }
@@ -117,9 +219,9 @@
 {
     TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to fetch last sync dates for each document sync identifier");
     
-    [self setNumberOfLastSynchronizationDatesToFetch:[[self availableDocumentSyncIDs] count]];
+    [self setNumberOfLastSynchronizationDatesToFetch:[[self documentSyncIDsToFetch] count]];
     
-    for( NSString *eachSyncID in [self availableDocumentSyncIDs] ) {
+    for( NSString *eachSyncID in [self documentSyncIDsToFetch] ) {
         [self fetchLastSynchronizationDateForDocumentWithSyncID:eachSyncID];
     }
 }
@@ -144,11 +246,11 @@
     
     if( [self numberOfLastSynchronizationDatesToFetch] == [self numberOfLastSynchronizationDatesFetched] ) {
         TICDSLog(TICDSLogVerbosityStartAndEndOfMainOperationPhase, @"Fetched all last synchronization dates, so operation complete");
-        [self operationDidCompleteSuccessfully];
+        [self finishListingDocuments];
         return;
     } else if( [self numberOfLastSynchronizationDatesToFetch] == [self numberOfLastSynchronizationDatesFetched] + [self numberOfLastSynchronizationDatesThatFailedToFetch] ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"An error occurred fetching one or more last synchronization dates, but last sync dates aren't essential, so continuing...");
-        [self operationDidCompleteSuccessfully];
+        [self finishListingDocuments];
         return;
     }
 }
@@ -198,6 +300,7 @@
 {
     [_availableDocuments release], _availableDocuments = nil;
     [_availableDocumentSyncIDs release], _availableDocumentSyncIDs = nil;
+    [_documentSyncIDsToFetch release], _documentSyncIDsToFetch = nil;
     
     [super dealloc];
 }
@@ -206,6 +309,7 @@
 #pragma mark Properties
 @synthesize availableDocuments = _availableDocuments;
 @synthesize availableDocumentSyncIDs = _availableDocumentSyncIDs;
+@synthesize documentSyncIDsToFetch = _documentSyncIDsToFetch;
 @synthesize numberOfInfoDictionariesToFetch = _numberOfInfoDictionariesToFetch;
 @synthesize numberOfInfoDictionariesFetched = _numberOfInfoDictionariesFetched;
 @synthesize numberOfInfoDictionariesThatFailedToFetch = _numberOfInfoDictionariesThatFailedToFetch;
@@ -40,6 +40,13 @@
     NSFileManager *_fileManager;
     NSString *_tempFileDirectoryPath;
     
+    BOOL _alwaysCoordinatesFileAccess;
+    unsigned long long _numberOfBytesCopied;
+    NSUInteger _maximumConcurrentRemovals;
+    NSUInteger _numberOfItemsRemoved;
+    NSFileCoordinator *_batchFileCoordinator;
+    NSMutableDictionary *_fileCoordinationRequirementsByDirectoryPath;
+    
     NSString *_clientIdentifier;
 }
 
@@ -71,15 +78,78 @@
 
 /** @name Coordinated I/O */
 
-/** Copy a file or directory using coordinated reads/writes. **/
+/** Coordinate access to a whole set of items with a single file coordinator, typically once per operation phase.
+ 
+ The accessor block is called synchronously once the items have been prepared for reading and writing. Any of the coordinated I/O methods below that are called inside the block reuse the same coordinator, rather than each creating their own coordinator and timeout.
+ 
+ If none of the items need coordination (see `shouldCoordinateAccessToItemAtPath:`), or a batch is already in progress, the block is simply called straight away.
+ 
+ @param readPaths The paths of the items that will be read inside the block.
+ @param writePaths The paths of the items that will be written inside the block.
+ @param error If coordination fails or times out, upon return contains an error describing the problem.
+ @param accessor The block that performs the file operations.
+ 
+ @return `YES` if the accessor block was called, otherwise `NO`; callers may then fall back to coordinating each item individually. */
+- (BOOL)coordinateReadingItemsAtPaths:(NSArray *)readPaths writingItemsAtPaths:(NSArray *)writePaths error:(NSError **)error byAccessor:(void (^)(void))accessor;
+
+/** Coordinate access to a whole set of items with a single file coordinator, as `coordinateReadingItemsAtPaths:writingItemsAtPaths:error:byAccessor:` does, but with the given options for the items that will be written.
+ 
+ @param readPaths The paths of the items that will be read inside the block.
+ @param writePaths The paths of the items that will be written inside the block.
+ @param writingOptions The options with which the written items are prepared, e.g. `NSFileCoordinatorWritingForDeleting`.
+ @param error If coordination fails or times out, upon return contains an error describing the problem.
+ @param accessor The block that performs the file operations.
+ 
+ @return `YES` if the accessor block was called, otherwise `NO`. */
+- (BOOL)coordinateReadingItemsAtPaths:(NSArray *)readPaths writingItemsAtPaths:(NSArray *)writePaths writingOptions:(NSFileCoordinatorWritingOptions)writingOptions error:(NSError **)error byAccessor:(void (^)(void))accessor;
+
+/** Indicates whether access to the item at a path needs to be coordinated.
+ 
+ Coordination is skipped for items on local volumes that are not ubiquitous, as long as no file presenters are registered in this process and `alwaysCoordinatesFileAccess` is `NO`. The answer is cached for each directory.
+ 
+ @param aPath The path of the item.
+ 
+ @return `YES` if a file coordinator should be used to access the item. */
+- (BOOL)shouldCoordinateAccessToItemAtPath:(NSString *)aPath;
+
+/** Copy a file or directory using coordinated reads/writes. Files are cloned rather than copied where the file system supports it (see `TICDSFileTransfer`). **/
 - (BOOL)copyItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath error:(NSError **)error;
 
+/** Copy a file or directory that will never be modified in place (such as a sync change set) using coordinated reads/writes. The copy may be a hard link to the original. **/
+- (BOOL)copyImmutableItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath error:(NSError **)error;
+
+/** Encrypt a file straight into its destination using coordinated reads/writes, without staging the cipher text in a temporary file. **/
+- (BOOL)encryptFileAtPath:(NSString *)plainTextPath toPath:(NSString *)cipherTextPath error:(NSError **)error;
+
+/** Decrypt a file straight from its source using coordinated reads/writes, without copying the cipher text to a temporary file first. **/
+- (BOOL)decryptFileAtPath:(NSString *)cipherTextPath toPath:(NSString *)plainTextPath error:(NSError **)error;
+
 /** Move a file or directory using coordinated reads/writes. **/
 - (BOOL)moveItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath error:(NSError **)error;
 
 /** Remove a file or directory using coordinated reads/writes. **/
 - (BOOL)removeItemAtPath:(NSString *)fromPath error:(NSError **)error;
 
+/** Remove a set of files or directories, with up to `maximumConcurrentRemovals` removals in progress at once.
+ 
+ The items are prepared for deletion with a single file coordinator, and each removal is then coordinated with that coordinator, rather than each creating its own coordinator and timeout. Items that no longer exist count as removed. Removal stops early if the operation is cancelled, in which case the error has the `TICDSErrorCodeTaskWasCancelled` code.
+ 
+ @param somePaths The paths of the items to remove.
+ @param outError If any item could not be removed, upon return contains an error describing the first problem.
+ 
+ @return `YES` if every item was removed, otherwise `NO`. */
+- (BOOL)removeItemsAtPaths:(NSArray *)somePaths error:(NSError **)outError;
+
+/** Remove a directory and everything inside it, removing the files inside it concurrently with `removeItemsAtPaths:error:` before removing the directory itself.
+ 
+ A directory that doesn't exist counts as removed.
+ 
+ @param aPath The path of the directory.
+ @param outError If the directory could not be removed, upon return contains an error describing the problem.
+ 
+ @return `YES` if the directory was removed, otherwise `NO`. */
+- (BOOL)removeDirectoryTreeAtPath:(NSString *)aPath error:(NSError **)outError;
+
 /** Create directory using coordinated write **/
 - (BOOL)createDirectoryAtPath:(NSString *)path withIntermediateDirectories:(BOOL)createIntermediates attributes:(NSDictionary *)attributes error:(NSError **)error;
 
@@ -104,6 +174,54 @@
 /** Read data in a coordinated way **/
 -(id)readObjectFromFile:(NSString *)path;
 
+/** @name Document Catalog */
+
+/** Read the document catalog, decrypting it if `shouldUseEncryption` is `YES`.
+ 
+ The catalog is a property list in the application's `Information` directory containing the `documentInfo` dictionary and last synchronization date of each document, so that previously-synchronized documents can be listed without fetching files for each one.
+ 
+ @param aPath The path to the `DocumentCatalog.plist` file.
+ @param outError If the catalog exists but could not be read, upon return contains an error describing the problem.
+ 
+ @return A dictionary of document entries, keyed by document identifier, or `nil` if the catalog doesn't exist or could not be read. */
+- (NSDictionary *)documentCatalogEntriesAtPath:(NSString *)aPath error:(NSError **)outError;
+
+/** Update the document catalog.
+ 
+ The block is given the current entries to modify. The updated catalog is written alongside the existing one, and only renamed into place if the catalog hasn't been changed by another client in the meantime; otherwise the update is attempted again with the newer entries.
+ 
+ The check and the rename aren't atomic across clients, and a file sync service may deliver a concurrent update from another machine after the check, so an update can still be lost. The catalog is therefore only advisory: the `documentInfo` and `RecentSyncs` files of each document remain authoritative, and documents missing from the catalog are fetched from them and added back.
+ 
+ @param aPath The path to the `DocumentCatalog.plist` file.
+ @param aBlock A block that modifies the entries, keyed by document identifier; it may be called more than once.
+ @param outError If the catalog could not be updated, upon return contains an error describing the problem.
+ 
+ @return `YES` if the catalog was updated, otherwise `NO`. */
+- (BOOL)updateDocumentCatalogAtPath:(NSString *)aPath usingBlock:(void (^)(NSMutableDictionary *someEntries))aBlock error:(NSError **)outError;
+
+/** @name Client Registry */
+
+/** Read the client registry, decrypting it if `shouldUseEncryption` is `YES`.
+ 
+ The registry is a property list in the application's `Information` directory containing the `deviceInfo` dictionary of each client, along with a `kTICDSRegisteredDocumentIdentifiers` array of the documents it has registered, so that registered clients can be listed without fetching files for each one. It is read and updated in the same way as the document catalog.
+ 
+ @param aPath The path to the `ClientRegistry.plist` file.
+ @param outError If the registry exists but could not be read, upon return contains an error describing the problem.
+ 
+ @return A dictionary of client entries, keyed by client identifier, or `nil` if the registry doesn't exist or could not be read. */
+- (NSDictionary *)clientRegistryEntriesAtPath:(NSString *)aPath error:(NSError **)outError;
+
+/** Update the client registry, in the same way as the document catalog.
+ 
+ Like the catalog, the registry is only advisory, because concurrent updates from other machines can still be lost; each client's `deviceInfo` file remains authoritative.
+ 
+ @param aPath The path to the `ClientRegistry.plist` file.
+ @param aBlock A block that modifies the entries, keyed by client identifier; it may be called more than once.
+ @param outError If the registry could not be updated, upon return contains an error describing the problem.
+ 
+ @return `YES` if the registry was updated, otherwise `NO`. */
+- (BOOL)updateClientRegistryAtPath:(NSString *)aPath usingBlock:(void (^)(NSMutableDictionary *someEntries))aBlock error:(NSError **)outError;
+
 /** @name Properties */
 
 /** Used to indicate whether the operation should encrypt files stored on the remote. */
@@ -139,4 +257,16 @@
 /** The identifier of the client application (not set automatically, but may be used whenever necessary by subclasses). */
 @property (retain) NSString *clientIdentifier;
 
+/** Used to indicate whether every file access should be coordinated, even for plain local files with no file presenters; defaults to `NO`. */
+@property (assign) BOOL alwaysCoordinatesFileAccess;
+
+/** The number of bytes copied by this operation's `copyItemAtPath:toPath:error:` calls; cloned and hard linked files don't count. */
+@property (readonly) unsigned long long numberOfBytesCopied;
+
+/** The maximum number of items removed at the same time by `removeItemsAtPaths:error:`; defaults to `8`. Set to `1` to remove items one after another. */
+@property (assign) NSUInteger maximumConcurrentRemovals;
+
+/** The number of items removed so far by this operation's `removeItemsAtPaths:error:` calls. */
+@property (readonly) NSUInteger numberOfItemsRemoved;
+
 @end
@@ -8,6 +8,17 @@
 
 #import "TICoreDataSync.h"
 
+@interface TICDSOperation ()
+
+- (void)scheduleFileCoordinatorTimeoutBlock:(void(^)(void))block;
+- (NSFileCoordinator *)fileCoordinatorForCurrentPhase;
+- (BOOL)copyItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath allowingHardLink:(BOOL)allowHardLink error:(NSError **)error;
+- (BOOL)transferItemAtURL:(NSURL *)fromURL toURL:(NSURL *)toURL allowingHardLink:(BOOL)allowHardLink error:(NSError **)error;
+- (BOOL)cryptFileAtPath:(NSString *)fromPath toPath:(NSString *)toPath encrypting:(BOOL)shouldEncrypt error:(NSError **)error;
+
+@property (nonatomic, readonly) NSMutableDictionary *fileCoordinationRequirementsByDirectoryPath;
+
+@end
 
 @implementation TICDSOperation
 
@@ -158,6 +169,8 @@
     _isExecuting = NO;
     _isFinished = NO;
     
+    _maximumConcurrentRemovals = 8;
+    
     return self;
 }
 
@@ -171,12 +184,25 @@
     [_clientIdentifier release], _clientIdentifier = nil;
     [_fileManager release], _fileManager = nil;
     [_tempFileDirectoryPath release], _tempFileDirectoryPath = nil;
+    [_batchFileCoordinator release], _batchFileCoordinator = nil;
+    [_fileCoordinationRequirementsByDirectoryPath release], _fileCoordinationRequirementsByDirectoryPath = nil;
 
     [super dealloc];
 }
 
 #pragma mark -
 #pragma mark Lazy Accessors
+- (NSMutableDictionary *)fileCoordinationRequirementsByDirectoryPath
+{
+    if( _fileCoordinationRequirementsByDirectoryPath ) {
+        return _fileCoordinationRequirementsByDirectoryPath;
+    }
+    
+    _fileCoordinationRequirementsByDirectoryPath = [[NSMutableDictionary alloc] init];
+    
+    return _fileCoordinationRequirementsByDirectoryPath;
+}
+
 - (NSString *)tempFileDirectoryPath
 {
     if( _tempFileDirectoryPath ) {
@@ -220,8 +246,149 @@
     dispatch_after(popTime, [self fileCoordinationDispatchQueue], block);
 }
 
+- (void)scheduleFileCoordinatorTimeoutBlock:(void(^)(void))block
+{
+    // items accessed during a batch were prepared, and timed, by the batch's coordinator
+    if( _batchFileCoordinator ) {
+        return;
+    }
+    
+    [self.class scheduleFileCoordinatorTimeoutBlock:block];
+}
+
+- (NSFileCoordinator *)fileCoordinatorForCurrentPhase
+{
+    if( _batchFileCoordinator ) {
+        return _batchFileCoordinator;
+    }
+    
+    return [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
+}
+
+- (BOOL)shouldCoordinateAccessToItemAtPath:(NSString *)aPath
+{
+    if( [self alwaysCoordinatesFileAccess] || [[NSFileCoordinator filePresenters] count] > 0 ) {
+        return YES;
+    }
+    
+    NSString *directoryPath = [aPath stringByDeletingLastPathComponent];
+    
+    @synchronized(self) {
+        NSNumber *requirement = [[self fileCoordinationRequirementsByDirectoryPath] objectForKey:directoryPath];
+        if( requirement ) {
+            return [requirement boolValue];
+        }
+    }
+    
+    // the item itself may not exist yet, so check the nearest directory that does
+    NSURL *existingURL = [NSURL fileURLWithPath:directoryPath];
+    while( [[existingURL path] length] > 1 && ![[self fileManager] fileExistsAtPath:[existingURL path]] ) {
+        existingURL = [existingURL URLByDeletingLastPathComponent];
+    }
+    
+    NSNumber *isLocalVolume = nil;
+    NSNumber *isUbiquitousItem = nil;
+    [existingURL getResourceValue:&isLocalVolume forKey:NSURLVolumeIsLocalKey error:NULL];
+    [existingURL getResourceValue:&isUbiquitousItem forKey:NSURLIsUbiquitousItemKey error:NULL];
+    
+    BOOL shouldCoordinate = !isLocalVolume || ![isLocalVolume boolValue] || [isUbiquitousItem boolValue];
+    
+    @synchronized(self) {
+        [[self fileCoordinationRequirementsByDirectoryPath] setObject:[NSNumber numberWithBool:shouldCoordinate] forKey:directoryPath];
+    }
+    
+    return shouldCoordinate;
+}
+
+- (BOOL)coordinateReadingItemsAtPaths:(NSArray *)readPaths writingItemsAtPaths:(NSArray *)writePaths error:(NSError **)error byAccessor:(void (^)(void))accessor
+{
+    return [self coordinateReadingItemsAtPaths:readPaths writingItemsAtPaths:writePaths writingOptions:NSFileCoordinatorWritingForReplacing error:error byAccessor:accessor];
+}
+
+- (BOOL)coordinateReadingItemsAtPaths:(NSArray *)readPaths writingItemsAtPaths:(NSArray *)writePaths writingOptions:(NSFileCoordinatorWritingOptions)writingOptions error:(NSError **)error byAccessor:(void (^)(void))accessor
+{
+    BOOL needsCoordination = NO;
+    if( !_batchFileCoordinator ) {
+        for( NSString *eachPath in [readPaths arrayByAddingObjectsFromArray:writePaths] ) {
+            if( [self shouldCoordinateAccessToItemAtPath:eachPath] ) {
+                needsCoordination = YES;
+                break;
+            }
+        }
+    }
+    
+    if( !needsCoordination ) {
+        accessor();
+        return YES;
+    }
+    
+    NSMutableArray *readURLs = [NSMutableArray arrayWithCapacity:[readPaths count]];
+    for( NSString *eachPath in readPaths ) {
+        [readURLs addObject:[NSURL fileURLWithPath:eachPath]];
+    }
+    
+    NSMutableArray *writeURLs = [NSMutableArray arrayWithCapacity:[writePaths count]];
+    for( NSString *eachPath in writePaths ) {
+        [writeURLs addObject:[NSURL fileURLWithPath:eachPath]];
+    }
+    
+    NSError *anyError = nil;
+    __block BOOL accessorCalled = NO;
+    
+    __block BOOL beganFileOperation = NO;
+    __block BOOL cancelled = NO;
+    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
+    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+        if ( !beganFileOperation ) {
+            [fileCoordinator cancel];
+            cancelled = YES;
+        }
+    }];
+    
+    [fileCoordinator prepareForReadingItemsAtURLs:readURLs options:0 writingItemsAtURLs:writeURLs options:writingOptions error:&anyError byAccessor:^(void (^completionHandler)(void)) {
+        dispatch_sync([self.class fileCoordinationDispatchQueue], ^{ beganFileOperation = YES; });
+        if ( !cancelled ) {
+            _batchFileCoordinator = [fileCoordinator retain];
+            accessor();
+            [_batchFileCoordinator release], _batchFileCoordinator = nil;
+            accessorCalled = YES;
+        }
+        completionHandler();
+    }];
+    
+    if ( error ) *error = anyError;
+    return accessorCalled;
+}
+
 - (BOOL)copyItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath error:(NSError **)error
 {
+    return [self copyItemAtPath:fromPath toPath:toPath allowingHardLink:NO error:error];
+}
+
+- (BOOL)copyImmutableItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath error:(NSError **)error
+{
+    return [self copyItemAtPath:fromPath toPath:toPath allowingHardLink:YES error:error];
+}
+
+- (BOOL)transferItemAtURL:(NSURL *)fromURL toURL:(NSURL *)toURL allowingHardLink:(BOOL)allowHardLink error:(NSError **)error
+{
+    unsigned long long bytesCopied = 0;
+    BOOL success = [TICDSFileTransfer transferItemAtPath:[fromURL path] toPath:[toURL path] allowingHardLink:allowHardLink method:NULL bytesCopied:&bytesCopied error:error];
+    
+    @synchronized(self) {
+        _numberOfBytesCopied += bytesCopied;
+    }
+    
+    return success;
+}
+
+- (BOOL)copyItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath allowingHardLink:(BOOL)allowHardLink error:(NSError **)error
+{
+    if( ![self shouldCoordinateAccessToItemAtPath:fromPath] && ![self shouldCoordinateAccessToItemAtPath:toPath] ) {
+        [[self fileManager] removeItemAtPath:toPath error:NULL];
+        return [self transferItemAtURL:[NSURL fileURLWithPath:fromPath] toURL:[NSURL fileURLWithPath:toPath] allowingHardLink:allowHardLink error:error];
+    }
+    
     __block NSError *anyError = nil;
     __block BOOL success = NO;
     
@@ -230,8 +397,8 @@
     
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -242,22 +409,78 @@
         dispatch_sync([self.class fileCoordinationDispatchQueue], ^{ beganFileOperation = YES; });
         if ( cancelled ) return;
         [[self fileManager] removeItemAtURL:newWritingURL error:NULL];
-        success = [[self fileManager] copyItemAtURL:newReadingURL toURL:newWritingURL error:&anyError];
+        success = [self transferItemAtURL:newReadingURL toURL:newWritingURL allowingHardLink:allowHardLink error:&anyError];
     }];
     
     if ( !success && !cancelled ) {
         // Force it
         anyError = nil;
         [[self fileManager] removeItemAtURL:writeURL error:NULL];
-        success = [[self fileManager] copyItemAtURL:readURL toURL:writeURL error:&anyError];
+        success = [self transferItemAtURL:readURL toURL:writeURL allowingHardLink:allowHardLink error:&anyError];
     }
 
     if ( error ) *error = anyError;
     return success;
 }
 
+- (BOOL)encryptFileAtPath:(NSString *)plainTextPath toPath:(NSString *)cipherTextPath error:(NSError **)error
+{
+    return [self cryptFileAtPath:plainTextPath toPath:cipherTextPath encrypting:YES error:error];
+}
+
+- (BOOL)decryptFileAtPath:(NSString *)cipherTextPath toPath:(NSString *)plainTextPath error:(NSError **)error
+{
+    return [self cryptFileAtPath:cipherTextPath toPath:plainTextPath encrypting:NO error:error];
+}
+
+- (BOOL)cryptFileAtPath:(NSString *)fromPath toPath:(NSString *)toPath encrypting:(BOOL)shouldEncrypt error:(NSError **)error
+{
+    NSURL *readURL = [NSURL fileURLWithPath:fromPath];
+    NSURL *writeURL = [NSURL fileURLWithPath:toPath];
+    
+    // the cryptor writes alongside the destination and renames into place, so the destination is replaced atomically
+    if( ![self shouldCoordinateAccessToItemAtPath:fromPath] && ![self shouldCoordinateAccessToItemAtPath:toPath] ) {
+        if( shouldEncrypt ) {
+            return [[self cryptor] encryptFileAtLocation:readURL writingToLocation:writeURL error:error];
+        }
+        return [[self cryptor] decryptFileAtLocation:readURL writingToLocation:writeURL error:error];
+    }
+    
+    __block NSError *anyError = nil;
+    __block BOOL success = NO;
+    
+    __block BOOL beganFileOperation = NO;
+    __block BOOL cancelled = NO;
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
+        if ( !beganFileOperation ) {
+            [fileCoordinator cancel];
+            cancelled = YES;
+        }
+    }];
+    
+    [fileCoordinator coordinateReadingItemAtURL:readURL options:0 writingItemAtURL:writeURL options:NSFileCoordinatorWritingForReplacing error:&anyError byAccessor:^(NSURL *newReadingURL, NSURL *newWritingURL) {
+        dispatch_sync([self.class fileCoordinationDispatchQueue], ^{ beganFileOperation = YES; });
+        if ( cancelled ) return;
+        if ( shouldEncrypt ) {
+            success = [[self cryptor] encryptFileAtLocation:newReadingURL writingToLocation:newWritingURL error:&anyError];
+        } else {
+            success = [[self cryptor] decryptFileAtLocation:newReadingURL writingToLocation:newWritingURL error:&anyError];
+        }
+        [anyError retain];
+    }];
+    [anyError autorelease];
+    
+    if ( error ) *error = anyError;
+    return success;
+}
+
 - (BOOL)moveItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath error:(NSError **)error
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:fromPath] && ![self shouldCoordinateAccessToItemAtPath:toPath] ) {
+        return [[self fileManager] moveItemAtPath:fromPath toPath:toPath error:error];
+    }
+    
     __block NSError *anyError = nil;
     NSURL *fromURL = [NSURL fileURLWithPath:fromPath];
     NSURL *toURL = [NSURL fileURLWithPath:toPath];
@@ -265,8 +488,8 @@
     
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -286,14 +509,18 @@
 
 - (BOOL)removeItemAtPath:(NSString *)fromPath error:(NSError **)error
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:fromPath] ) {
+        return [[self fileManager] removeItemAtPath:fromPath error:error];
+    }
+    
     NSURL *fromURL = [NSURL fileURLWithPath:fromPath];
     __block BOOL success = NO;
     __block NSError *anyError = nil;
     
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -311,16 +538,135 @@
     return success;
 }
 
+- (BOOL)removeItemsAtPaths:(NSArray *)somePaths error:(NSError **)outError
+{
+    if( [somePaths count] < 1 ) {
+        return YES;
+    }
+    
+    // make sure the file manager exists before it's used from several threads
+    [self fileManager];
+    
+    __block NSError *firstError = nil;
+    
+    void (^removeItems)(void) = ^{
+        dispatch_semaphore_t fanOutSemaphore = dispatch_semaphore_create((long)MAX([self maximumConcurrentRemovals], (NSUInteger)1));
+        dispatch_group_t removalGroup = dispatch_group_create();
+        dispatch_queue_t removalQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+        
+        for( NSString *eachPath in somePaths ) {
+            dispatch_semaphore_wait(fanOutSemaphore, DISPATCH_TIME_FOREVER);
+            
+            BOOL shouldStop = NO;
+            @synchronized(self) {
+                if( !firstError && [self isCancelled] ) {
+                    firstError = [[TICDSError errorWithCode:TICDSErrorCodeTaskWasCancelled classAndMethod:__PRETTY_FUNCTION__] retain];
+                }
+                
+                shouldStop = firstError != nil;
+            }
+            
+            if( shouldStop ) {
+                dispatch_semaphore_signal(fanOutSemaphore);
+                break;
+            }
+            
+            dispatch_group_async(removalGroup, removalQueue, ^{
+                NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+                
+                // inside the batch, each removal is coordinated for deleting with the batch's coordinator
+                NSError *anyError = nil;
+                BOOL success = [self removeItemAtPath:eachPath error:&anyError];
+                
+                if( !success && [[anyError domain] isEqualToString:NSCocoaErrorDomain] && [anyError code] == NSFileNoSuchFileError ) {
+                    success = YES;
+                }
+                
+                @synchronized(self) {
+                    if( success ) {
+                        _numberOfItemsRemoved++;
+                        
+                        if( _numberOfItemsRemoved % 1000 == 0 ) {
+                            TICDSLog(TICDSLogVerbosityEveryStep, @"Removed %lu items", (unsigned long)_numberOfItemsRemoved);
+                        }
+                    } else if( !firstError ) {
+                        firstError = [anyError retain];
+                    }
+                }
+                
+                [pool drain];
+                dispatch_semaphore_signal(fanOutSemaphore);
+            });
+        }
+        
+        dispatch_group_wait(removalGroup, DISPATCH_TIME_FOREVER);
+        dispatch_release(removalGroup);
+        dispatch_release(fanOutSemaphore);
+    };
+    
+    NSError *anyError = nil;
+    if( ![self coordinateReadingItemsAtPaths:nil writingItemsAtPaths:somePaths writingOptions:NSFileCoordinatorWritingForDeleting error:&anyError byAccessor:removeItems] ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Failed to coordinate removal of %lu items together, so coordinating each removal: %@", (unsigned long)[somePaths count], anyError);
+        
+        removeItems();
+    }
+    
+    if( outError ) *outError = [firstError autorelease];
+    else [firstError release];
+    
+    return firstError == nil;
+}
+
+- (BOOL)removeDirectoryTreeAtPath:(NSString *)aPath error:(NSError **)outError
+{
+    if( ![self fileExistsAtPath:aPath] ) {
+        return YES;
+    }
+    
+    // gather every file in the tree, so removal isn't held up by one large directory
+    __block NSMutableArray *filePaths = [NSMutableArray array];
+    
+    void (^gatherFilePaths)(void) = ^{
+        NSDirectoryEnumerator *enumerator = [[self fileManager] enumeratorAtURL:[NSURL fileURLWithPath:aPath] includingPropertiesForKeys:[NSArray arrayWithObject:NSURLIsDirectoryKey] options:0 errorHandler:nil];
+        
+        for( NSURL *eachURL in enumerator ) {
+            NSNumber *isDirectory = nil;
+            [eachURL getResourceValue:&isDirectory forKey:NSURLIsDirectoryKey error:NULL];
+            
+            if( ![isDirectory boolValue] ) {
+                [filePaths addObject:[eachURL path]];
+            }
+        }
+    };
+    
+    if( ![self coordinateReadingItemsAtPaths:[NSArray arrayWithObject:aPath] writingItemsAtPaths:nil error:NULL byAccessor:gatherFilePaths] ) {
+        gatherFilePaths();
+    }
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Removing %lu files from %@", (unsigned long)[filePaths count], [aPath lastPathComponent]);
+    
+    if( ![self removeItemsAtPaths:filePaths error:outError] ) {
+        return NO;
+    }
+    
+    // only empty directories are left
+    return [self removeItemAtPath:aPath error:outError];
+}
+
 - (BOOL)fileExistsAtPath:(NSString *)fromPath
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:fromPath] ) {
+        return [[self fileManager] fileExistsAtPath:fromPath];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:fromPath];
     __block NSError *anyError = nil;
     __block BOOL result = NO;
     
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -342,14 +688,18 @@
 
 - (BOOL)createDirectoryAtPath:(NSString *)path withIntermediateDirectories:(BOOL)createIntermediates attributes:(NSDictionary *)attributes error:(NSError **)error
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:path] ) {
+        return [[self fileManager] createDirectoryAtPath:path withIntermediateDirectories:createIntermediates attributes:attributes error:error];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:path];
     __block BOOL success = NO;
     __block NSError *anyError = nil;
 
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -368,6 +718,10 @@
 
 - (NSArray *)contentsOfDirectoryAtPath:(NSString *)path error:(NSError **)error
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:path] ) {
+        return [[self fileManager] contentsOfDirectoryAtPath:path error:error];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:path];
     NSError *fileCoordError = nil;
     __block NSError *fileManagerError = nil;
@@ -375,8 +729,8 @@
 
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -400,14 +754,18 @@
 
 - (NSDictionary *)attributesOfItemAtPath:(NSString *)path error:(NSError **)error
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:path] ) {
+        return [[self fileManager] attributesOfItemAtPath:path error:error];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:path];
     __block NSError *anyError = nil;
     __block NSDictionary *result = nil;
 
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -426,14 +784,18 @@
 
 -(BOOL)writeData:(NSData *)data toFile:(NSString *)path error:(NSError **)error
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:path] ) {
+        return [data writeToFile:path options:0 error:error];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:path];
     __block BOOL success = NO;
     __block NSError *anyError = nil;
 
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -452,14 +814,18 @@
 
 -(BOOL)writeObject:(id)object toFile:(NSString *)path
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:path] ) {
+        return [object writeToFile:path atomically:NO];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:path];
     __block BOOL success = NO;
     __block NSError *anyError = nil;
 
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -477,14 +843,18 @@
 
 -(NSData *)dataWithContentsOfFile:(NSString *)path error:(NSError **)error
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:path] ) {
+        return [NSData dataWithContentsOfFile:path options:0 error:error];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:path];
     __block NSError *anyError;
     __block NSData *result = nil;
 
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -503,14 +873,19 @@
 
 -(id)readObjectFromFile:(NSString *)path
 {
+    if( ![self shouldCoordinateAccessToItemAtPath:path] ) {
+        NSInputStream *stream = [NSInputStream inputStreamWithFileAtPath:path];
+        return [NSPropertyListSerialization propertyListWithStream:stream options:0 format:0 error:NULL];
+    }
+    
     NSURL *url = [NSURL fileURLWithPath:path];
     __block NSError *anyError;
     __block id result = nil;
 
     __block BOOL beganFileOperation = NO;
     __block BOOL cancelled = NO;
-    NSFileCoordinator *fileCoordinator = [[[NSFileCoordinator alloc] initWithFilePresenter:nil] autorelease];
-    [self.class scheduleFileCoordinatorTimeoutBlock:^{
+    NSFileCoordinator *fileCoordinator = [self fileCoordinatorForCurrentPhase];
+    [self scheduleFileCoordinatorTimeoutBlock:^{
         if ( !beganFileOperation ) {
             [fileCoordinator cancel];
             cancelled = YES;
@@ -527,6 +902,143 @@
     return result;
 }
 
+#pragma mark -
+#pragma mark Revisioned Property Lists
+static NSString * const kTICDSRevisionedPropertyListRevision = @"revision";
+static NSString * const kTICDSRevisionedPropertyListEntries = @"entries";
+static NSUInteger const kTICDSRevisionedPropertyListMaximumUpdateAttempts = 5;
+
+- (NSDictionary *)revisionedPropertyListAtPath:(NSString *)aPath error:(NSError **)outError
+{
+    if( ![self fileExistsAtPath:aPath] ) {
+        return nil;
+    }
+    
+    NSString *plainTextPath = aPath;
+    NSError *anyError = nil;
+    
+    if( [self shouldUseEncryption] ) {
+        plainTextPath = [[self tempFileDirectoryPath] stringByAppendingPathComponent:[NSString stringWithFormat:@"%@-%@", [TICDSUtilities uuidString], [aPath lastPathComponent]]];
+        
+        if( ![self decryptFileAtPath:aPath toPath:plainTextPath error:&anyError] ) {
+            if( outError ) *outError = [TICDSError errorWithCode:TICDSErrorCodeEncryptionError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__];
+            return nil;
+        }
+    }
+    
+    NSData *data = [self dataWithContentsOfFile:plainTextPath error:&anyError];
+    
+    if( plainTextPath != aPath ) {
+        [[self fileManager] removeItemAtPath:plainTextPath error:NULL];
+    }
+    
+    NSDictionary *propertyList = data ? [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:&anyError] : nil;
+    
+    if( ![propertyList isKindOfClass:[NSDictionary class]] || ![[propertyList valueForKey:kTICDSRevisionedPropertyListEntries] isKindOfClass:[NSDictionary class]] ) {
+        if( outError ) *outError = [TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__];
+        return nil;
+    }
+    
+    return propertyList;
+}
+
+- (BOOL)updateEntriesOfRevisionedPropertyListAtPath:(NSString *)aPath usingBlock:(void (^)(NSMutableDictionary *someEntries))aBlock repeatedModificationErrorCode:(TICDSErrorCode)anErrorCode error:(NSError **)outError
+{
+    NSString *stagingPath = [[aPath stringByDeletingLastPathComponent] stringByAppendingPathComponent:[NSString stringWithFormat:@".%@-%@", [TICDSUtilities uuidString], [aPath lastPathComponent]]];
+    NSString *plainTextPath = [[self tempFileDirectoryPath] stringByAppendingPathComponent:[stagingPath lastPathComponent]];
+    
+    for( NSUInteger attempt = 0; attempt < kTICDSRevisionedPropertyListMaximumUpdateAttempts; attempt++ ) {
+        NSError *anyError = nil;
+        NSDictionary *propertyList = [self revisionedPropertyListAtPath:aPath error:&anyError];
+        
+        if( !propertyList && anyError ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"%@ could not be read, so replacing it: %@", [aPath lastPathComponent], anyError);
+        }
+        
+        NSString *revision = [propertyList valueForKey:kTICDSRevisionedPropertyListRevision];
+        
+        NSMutableDictionary *entries = [NSMutableDictionary dictionaryWithDictionary:[propertyList valueForKey:kTICDSRevisionedPropertyListEntries]];
+        aBlock(entries);
+        
+        NSDictionary *updatedPropertyList = [NSDictionary dictionaryWithObjectsAndKeys:[TICDSUtilities uuidString], kTICDSRevisionedPropertyListRevision, entries, kTICDSRevisionedPropertyListEntries, nil];
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:updatedPropertyList format:NSPropertyListBinaryFormat_v1_0 options:0 error:&anyError];
+        
+        BOOL success = data != nil;
+        
+        if( success && [self shouldUseEncryption] ) {
+            success = [data writeToFile:plainTextPath options:0 error:&anyError] && [self encryptFileAtPath:plainTextPath toPath:stagingPath error:&anyError];
+            [[self fileManager] removeItemAtPath:plainTextPath error:NULL];
+        } else if( success ) {
+            success = [self writeData:data toFile:stagingPath error:&anyError];
+        }
+        
+        if( !success ) {
+            if( outError ) *outError = [TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__];
+            [[self fileManager] removeItemAtPath:stagingPath error:NULL];
+            return NO;
+        }
+        
+        // Only replace the file if no other client has replaced it since it was read; this narrows, but can't close, the window
+        // in which an update made on another machine is lost, so revisioned property lists only ever hold advisory information
+        NSString *currentRevision = [[self revisionedPropertyListAtPath:aPath error:NULL] valueForKey:kTICDSRevisionedPropertyListRevision];
+        
+        if( currentRevision != revision && ![currentRevision isEqualToString:revision] ) {
+            TICDSLog(TICDSLogVerbosityEveryStep, @"%@ was modified by another client, so trying again", [aPath lastPathComponent]);
+            [[self fileManager] removeItemAtPath:stagingPath error:NULL];
+            continue;
+        }
+        
+        __block int renameError = 0;
+        void (^replaceFile)(void) = ^{
+            renameError = rename([stagingPath fileSystemRepresentation], [aPath fileSystemRepresentation]) == 0 ? 0 : errno;
+        };
+        
+        if( ![self coordinateReadingItemsAtPaths:nil writingItemsAtPaths:[NSArray arrayWithObjects:stagingPath, aPath, nil] error:NULL byAccessor:replaceFile] ) {
+            replaceFile();
+        }
+        
+        if( renameError != 0 ) {
+            if( outError ) *outError = [TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:[NSError errorWithDomain:NSPOSIXErrorDomain code:renameError userInfo:nil] classAndMethod:__PRETTY_FUNCTION__];
+            [[self fileManager] removeItemAtPath:stagingPath error:NULL];
+            return NO;
+        }
+        
+        return YES;
+    }
+    
+    if( outError ) *outError = [TICDSError errorWithCode:anErrorCode classAndMethod:__PRETTY_FUNCTION__];
+    
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Document Catalog
+- (NSDictionary *)documentCatalogEntriesAtPath:(NSString *)aPath error:(NSError **)outError
+{
+    if( outError ) *outError = nil;
+    
+    return [[self revisionedPropertyListAtPath:aPath error:outError] valueForKey:kTICDSRevisionedPropertyListEntries];
+}
+
+- (BOOL)updateDocumentCatalogAtPath:(NSString *)aPath usingBlock:(void (^)(NSMutableDictionary *someEntries))aBlock error:(NSError **)outError
+{
+    return [self updateEntriesOfRevisionedPropertyListAtPath:aPath usingBlock:aBlock repeatedModificationErrorCode:TICDSErrorCodeDocumentCatalogWasRepeatedlyModifiedByAnotherClient error:outError];
+}
+
+#pragma mark -
+#pragma mark Client Registry
+- (NSDictionary *)clientRegistryEntriesAtPath:(NSString *)aPath error:(NSError **)outError
+{
+    if( outError ) *outError = nil;
+    
+    return [[self revisionedPropertyListAtPath:aPath error:outError] valueForKey:kTICDSRevisionedPropertyListEntries];
+}
+
+- (BOOL)updateClientRegistryAtPath:(NSString *)aPath usingBlock:(void (^)(NSMutableDictionary *someEntries))aBlock error:(NSError **)outError
+{
+    return [self updateEntriesOfRevisionedPropertyListAtPath:aPath usingBlock:aBlock repeatedModificationErrorCode:TICDSErrorCodeClientRegistryWasRepeatedlyModifiedByAnotherClient error:outError];
+}
+
 #pragma mark -
 #pragma mark Properties
 @synthesize shouldUseEncryption = _shouldUseEncryption;
@@ -539,5 +1051,9 @@
 @synthesize fileManager = _fileManager;
 @synthesize tempFileDirectoryPath = _tempFileDirectoryPath;
 @synthesize clientIdentifier = _clientIdentifier;
+@synthesize alwaysCoordinatesFileAccess = _alwaysCoordinatesFileAccess;
+@synthesize numberOfBytesCopied = _numberOfBytesCopied;
+@synthesize maximumConcurrentRemovals = _maximumConcurrentRemovals;
+@synthesize numberOfItemsRemoved = _numberOfItemsRemoved;
 
 @end
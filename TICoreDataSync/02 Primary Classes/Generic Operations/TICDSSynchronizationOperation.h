@@ -14,6 +14,7 @@
  
  In full, the operation carries out the following tasks: (Sync Command tasks are included below, although not yet implemented)
  
+ 0. Import any sealed segments of the local `UnsynchronizedSyncChanges` journal into `SyncChangesBeingSynchronized.syncchg`.
  1. Fetch an array containing UUID strings for each client device that has synchronized this document.
  2. For each client device that isn't the current device:
      1. Fetch an array containing UUID strings for each available `SyncCommandSet`.
@@ -23,18 +24,21 @@
      1. Carry out the command, determining whether synchronization can continue, or whether e.g. the entire store needs to be downloaded.
      2. Add the UUID of the set to the list of `AppliedSyncCommands.ticdsync`.
  5. If synchronization can continue, then for each client device that isn't the current device:
-     1. Fetch an array containing UUID strings for each available `SyncChangeSet`.
+     1. Fetch an array containing UUID strings for each available `SyncChangeSet` in the default partition and in each subscribed sync partition.
      2. Determine which `SyncChangeSet`s haven't yet been applied locally.
      3. If any `SyncChangeSet`s haven't yet been applied, fetch them to the `UnappliedSyncChangeSets` helper file directory.
  6. Go through each `SyncChangeSet` and:
      1. Check for conflicts against local changes made since the last synchronization.
      2. Fix any conflicts, and build an array of conflict warnings for issues that cannot be resolved.
-     3. Apply each `SyncChange` in the set to the local `WholeStore`.
+     3. Apply each `SyncChange` in the set to the local `WholeStore`. If `maximumConcurrentSyncChangeApplications` is more than `1`, the insertions and attribute changes in a large set are split into groups of changes to unrelated objects, each applied on its own context at the same time, and saved in turn. A relationship change whose object, or related object, hasn't been inserted yet is deferred until a later set inserts it; any still waiting once every set has been applied produce warnings.
      4. Add the UUID of the set to the list of `AppliedSyncChangeSets.ticdsync`.
+     5. Every `syncChangeSetsPerCheckpoint` sets, or once `changedObjectsPerCheckpoint` objects have changed, save the `WholeStore` and the applied and unapplied sets, and record any deferred relationship changes, then reset the contexts to free memory.
  7. If there are local `SyncCommand`s, rename `UnsynchronizedSyncCommands.ticdsync` to `UUID.synccmd` and push the file to the remote.
- 8. If there are local `SyncChange`s, rename `UnsynchronizedSyncChanges.syncchg` to `UUID.syncchd` and push the file to the remote.
+ 8. If there are local `SyncChange`s, rename `SyncChangesBeingSynchronized.syncchg` to `UUID.syncchd` and push the file to the remote. If the document uses sync partitions, the file is instead split into one `UUID.syncchg` per partition, and each is pushed to that partition. Each identifier includes the next sequence number for its partition (see `syncChangeSetSequenceNumbersFileLocation`).
  9. Save this client's file in the `RecentSyncs` directory for this document.
  
+ The progress of steps 5 and 6 is recorded in the `SynchronizationState.plist` journal (see `TICDSSynchronizationStateJournal`). If a synchronization is interrupted, the next one reuses the recorded list of sync change sets rather than listing them again, and any sync change sets that were fetched in full rather than fetching them again. The journal is removed once a synchronization completes.
+ 
  Operations are typically created automatically by the relevant sync manager.
  
  @warning You must use one of the subclasses of `TICDSSynchronizationOperation`. */
@@ -49,6 +53,7 @@
     NSMutableArray *_synchronizationWarnings;
     
     NSURL *_localSyncChangesToMergeLocation;
+    NSArray *_localSyncChangesJournalSegmentLocations;
     NSURL *_appliedSyncChangeSetsFileLocation;
     NSURL *_unappliedSyncChangesDirectoryLocation;
     NSURL *_unappliedSyncChangeSetsFileLocation;
@@ -60,7 +65,7 @@
     TICoreDataFactory *_unappliedSyncChangeSetsCoreDataFactory;
     NSManagedObjectContext *_unappliedSyncChangeSetsContext;
     
-    TICoreDataFactory *_unappliedSyncChangesCoreDataFactory;
+    TICDSSyncChangeSetReader *_syncChangeSetReader;
     NSManagedObjectContext *_unappliedSyncChangesContext;
     
     TICoreDataFactory *_localSyncChangesToMergeCoreDataFactory;
@@ -68,6 +73,7 @@
     
     NSPersistentStoreCoordinator *_primaryPersistentStoreCoordinator;
     TICDSSynchronizationOperationManagedObjectContext *_backgroundApplicationContext;
+    TICDSSyncChangeApplier *_syncChangeApplier;
     
     NSUInteger _numberOfSyncChangeSetIDArraysToFetch;
     NSUInteger _numberOfSyncChangeSetIDArraysFetched;
@@ -81,7 +87,23 @@
 	NSString *_changeSetProgressString;
 	NSNumberFormatter *_uuidPrefixFormatter;
     
-    NSMutableDictionary *_applicationObjectsBySyncIDByEntity;
+    NSDictionary *_syncPartitions;
+    NSSet *_subscribedSyncPartitionNames;
+    NSMutableDictionary *_syncPartitionNamesByEntityName;
+    NSMutableDictionary *_syncPartitionNamesBySyncChangeSetIdentifier;
+    NSMutableArray *_localSyncChangeSetFileLocationsToUpload;
+    
+    NSUInteger _syncChangeSetsPerCheckpoint;
+    NSUInteger _changedObjectsPerCheckpoint;
+    NSUInteger _maximumConcurrentSyncChangeApplications;
+    NSUInteger _changedAttributesEncodingVersion;
+    
+    NSURL *_synchronizationStateFileLocation;
+    TICDSSynchronizationStateJournal *_synchronizationStateJournal;
+    NSMutableArray *_syncChangeSetIdentifiersAppliedSinceCheckpoint;
+    NSURL *_syncChangeSetSequenceNumbersFileLocation;
+    NSMutableDictionary *_syncChangeSetSequenceNumbers;
+    NSMutableDictionary *_listedSyncChangeSetSequenceNumbers;
 }
 
 #pragma mark Designated Initializer
@@ -114,6 +136,13 @@
  @param anIdentifier The unique identifier of the client. */
 - (void)buildArrayOfSyncChangeSetIdentifiersForClientIdentifier:(NSString *)anIdentifier;
 
+/** Build arrays of `SyncChangeSet` identifiers for each of the given client devices.
+ 
+ The default implementation calls `buildArrayOfSyncChangeSetIdentifiersForClientIdentifier:` for each client in turn. Subclasses that can list several clients at once may override this method, but must still call `builtArrayOfClientSyncChangeSetIdentifiers:forClientIdentifier:` once for each client, on the operation's thread.
+ 
+ @param someIdentifiers The unique identifiers of the clients. */
+- (void)buildArraysOfSyncChangeSetIdentifiersForClientIdentifiers:(NSArray *)someIdentifiers;
+
 /** Fetch a `SyncChangeSet` with a given identifier from a client's `SyncChanges` directory.
  
  This method must call `fetchedSyncChangeSetsWithIdentifier:forClientIdentifier:withSuccess:` when finished. 
@@ -123,8 +152,18 @@
  @param aLocation The location of the file to upload. */
 - (void)fetchSyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientIdentifier:(NSString *)aClientIdentifier toLocation:(NSURL *)aLocation;
 
+/** Fetch all the unapplied `SyncChangeSet`s into a local directory.
+ 
+ The default implementation removes any stale copy of each file, then calls `fetchSyncChangeSetWithIdentifier:forClientIdentifier:toLocation:` for each sync change set in turn. Subclasses may override this method to wrap the whole fetch, for example to coordinate access to all the files at once, and call `super`.
+ 
+ @param someIdentifiers A dictionary of arrays of sync change set identifiers, keyed by client identifier.
+ @param aDirectoryLocation The location of the directory into which to fetch the sync change sets. */
+- (void)fetchSyncChangeSetsWithIdentifiersByClientIdentifier:(NSDictionary *)someIdentifiers toDirectoryLocation:(NSURL *)aDirectoryLocation;
+
 /** Upload the specified sync changes file to the client device's directory inside the document's `SyncChanges` directory.
  
+ If the document uses sync partitions, this method is called once for each partition with changes; use `syncPartitionNameForSyncChangeSetIdentifier:` to find out which partition the file belongs to.
+ 
  This method must call `uploadedLocalSyncChangeSetFileSuccessfully:` to indicate whether the creation was successful.
  @param aLocation The location of the file to upload. */
 - (void)uploadLocalSyncChangeSetFileAtLocation:(NSURL *)aLocation;
@@ -136,6 +175,13 @@
  @param aLocation The location of the file to upload. */
 - (void)uploadRecentSyncFileAtLocation:(NSURL *)aLocation;
 
+/** Indicate whether this operation can list, fetch and upload sync change sets in sync partitions.
+ 
+ The default implementation returns `NO`, in which case all sync changes are uploaded to and fetched from the default partition.
+ 
+ @return `YES` if sync partitions are supported, otherwise `NO`. */
+- (BOOL)supportsSyncPartitions;
+
 #pragma mark Callbacks
 /** @name Callbacks */
 
@@ -188,13 +234,44 @@
 - (void)uploadedRecentSyncFileSuccessfully:(BOOL)success;
 
 #pragma mark Helper Methods
-/** Releases any existing `unappliedSyncChangesContext` and `unappliedSyncChangesCoreDataFactory` and sets new ones, linked to the set of sync changes specified in the given sync change set.
+/** Opens the set of sync changes specified in the given sync change set with the `syncChangeSetReader`, closing any set opened previously, and sets the `unappliedSyncChangesContext`.
  
  @param aChangeSet The `TICDSSyncChangeSet` object specifying the set of changes to use.
  
- @return A managed object context to access the sync changes. */
+ @return A managed object context to access the sync changes, or `nil` if the sync change set file could not be opened. */
 - (NSManagedObjectContext *)contextForSyncChangesInUnappliedSyncChangeSet:(TICDSSyncChangeSet *)aChangeSet;
 
+/** @name Sync Partitions */
+
+/** The names of the sync partitions whose sync change sets should be listed and fetched, in addition to the default partition.
+ 
+ @return The names of the subscribed partitions that exist in `syncPartitions`. */
+- (NSSet *)syncPartitionNamesToFetch;
+
+/** The sync partition containing the given entity.
+ 
+ @param anEntityName The name of the entity.
+ 
+ @return The name of the partition, or `nil` if the entity is in the default partition. */
+- (NSString *)syncPartitionNameForEntityName:(NSString *)anEntityName;
+
+/** The sync partition a sync change set belongs to, as recorded while listing or creating sync change sets during this operation.
+ 
+ This method may be called from any thread.
+ 
+ @param anIdentifier The identifier of the sync change set.
+ 
+ @return The name of the partition, or `nil` if the sync change set is in the default partition. */
+- (NSString *)syncPartitionNameForSyncChangeSetIdentifier:(NSString *)anIdentifier;
+
+/** Record the sync partition a sync change set belongs to.
+ 
+ Subclasses call this method while listing sync change sets; it may be called from any thread.
+ 
+ @param aPartitionName The name of the partition.
+ @param anIdentifier The identifier of the sync change set. */
+- (void)setSyncPartitionName:(NSString *)aPartitionName forSyncChangeSetIdentifier:(NSString *)anIdentifier;
+
 #pragma mark Configuration
 /** Configure a background context (for applying sync changes) using the same persistent store coordinator as the main application context.
  
@@ -225,11 +302,38 @@
 /** The integrity key provided either by the client to check existing data matches integrity, or set during registration for new documents. */
 @property (retain) NSString *integrityKey;
 
+/** The document's sync partitions, as set on the document sync manager; keys are partition names, values are collections of entity names. */
+@property (retain) NSDictionary *syncPartitions;
+
+/** The names of the sync partitions this client subscribes to, or `nil` to subscribe to every partition. */
+@property (retain) NSSet *subscribedSyncPartitionNames;
+
+/** The number of sync change sets applied between saves of the application context and the applied sync change sets, or `0` to only save once every set has been applied. Defaults to `100`. */
+@property (assign) NSUInteger syncChangeSetsPerCheckpoint;
+
+/** The number of changed objects in the application context after which it is saved, along with the applied sync change sets, once the current set has been applied, or `0` for no limit. Defaults to `10000`. */
+@property (assign) NSUInteger changedObjectsPerCheckpoint;
+
+/** The maximum number of managed object contexts on which the insertions and attribute changes in a sync change set are applied at once. Defaults to `1`, applying every change on the `backgroundApplicationContext`.
+ 
+ When more than `1`, a set with enough insertions and attribute changes is split into groups that change unrelated objects (see `+[TICDSSyncChangeApplier independentGroupsOfSyncChanges:maximumGroupCount:]`). Each group is applied on its own context, sharing the `primaryPersistentStoreCoordinator`, and the contexts are saved one after another in a repeatable order. Relationship changes and deletions are then applied on the `backgroundApplicationContext`, as they can affect objects that aren't named by the changes. */
+@property (assign) NSUInteger maximumConcurrentSyncChangeApplications;
+
+/** The version of `TICDSChangedAttributesCodec` with which to encode the `changedAttributes` of local sync changes, or `0` (the default) to store them as keyed archives. Version `2` or later lets attribute changes carry deltas (see `+[TICDSSynchronizedManagedObject keysForWhichSyncChangesWillCarryDeltas]`).
+ 
+ The version is recorded in each sync change set, and a client refuses to apply a set encoded with a version newer than it supports. Changes left over from a previous synchronization keep the encoding they were first saved with. */
+@property (assign) NSUInteger changedAttributesEncodingVersion;
+
 /** @name File Locations */
 
 /** The location of the `SyncChangesBeingSynchronized.syncchg` file for this synchronization operation. */
 @property (retain) NSURL *localSyncChangesToMergeLocation;
 
+/** The locations of the sealed `UnsynchronizedSyncChanges` journal segments to import into the `SyncChangesBeingSynchronized.syncchg` file before synchronizing.
+ 
+ Each segment is deleted once its sync changes have been saved into that file. */
+@property (retain) NSArray *localSyncChangesJournalSegmentLocations;
+
 /** The location of this document's `AppliedSyncChangeSets.ticdsync` file. */
 @property (retain) NSURL *appliedSyncChangeSetsFileLocation;
 
@@ -239,9 +343,19 @@
 /** The location of this document's `UnappliedSyncChangeSets.ticdsync` file. */
 @property (retain) NSURL *unappliedSyncChangeSetsFileLocation;
 
-/** The location of the local RecentSync file to upload at the end of the synchronization process. */
+/** The location of the local RecentSync file to upload at the end of the synchronization process.
+ 
+ As well as the sync date, the file records, under `kTICDSAppliedSyncChangeSetSequenceNumbers`, the highest sequence number this client has applied from each other client in each sync partition (see `+[TICDSSyncChangeSet sequenceNumberOfSyncChangeSetWithIdentifier:]`), keyed by client identifier then by partition name, or `kTICDSDefaultSyncPartition`. A sequence number is only recorded once every lower one has been applied too, so the vacuum can remove that client's sync change sets up to it without comparing modification dates. */
 @property (retain) NSURL *localRecentSyncFileLocation;
 
+/** The location of this document's `SyncChangeSetSequenceNumbers.plist` file, which records the sequence number of the last sync change set this client uploaded to each sync partition.
+ 
+ The number is recorded before the upload, and put back if the upload fails, so the sync change sets this client uploads to a partition are numbered without gaps. */
+@property (retain) NSURL *syncChangeSetSequenceNumbersFileLocation;
+
+/** The location of this document's `SynchronizationState.plist` journal, or `nil` not to record progress. */
+@property (retain) NSURL *synchronizationStateFileLocation;
+
 /** @name Managed Object Contexts and Factories */
 
 /** A `TICoreDataFactory` to access the contents of the `AppliedSyncChangeSets.ticdsync` file. */
@@ -256,8 +370,8 @@
 /** The managed object context for the `UnappliedSyncChangeSets.ticdsync` file. */
 @property (nonatomic, retain) NSManagedObjectContext *unappliedSyncChangeSetsContext;
 
-/** A `TICoreDataFactory` to access the contents of a single, unapplied `SyncChangeSet` file. */
-@property (nonatomic, retain) TICoreDataFactory *unappliedSyncChangesCoreDataFactory;
+/** A `TICDSSyncChangeSetReader` used to open each unapplied `SyncChangeSet` file in turn. */
+@property (nonatomic, readonly) TICDSSyncChangeSetReader *syncChangeSetReader;
 
 /** The managed object context for the changes in a single, unapplied `SyncChangeSet` file. */
 @property (nonatomic, retain) NSManagedObjectContext *unappliedSyncChangesContext;
@@ -274,6 +388,12 @@
 /** The managed object context (tied to the application's persistent store coordinator) in which `SyncChanges` are applied. */
 @property (nonatomic, retain) TICDSSynchronizationOperationManagedObjectContext *backgroundApplicationContext;
 
+/** The `TICDSSyncChangeApplier` that applies sync changes in the `backgroundApplicationContext`. */
+@property (nonatomic, readonly) TICDSSyncChangeApplier *syncChangeApplier;
+
+/** The journal recording the progress of this synchronization, created lazily from `synchronizationStateFileLocation`. */
+@property (nonatomic, readonly) TICDSSynchronizationStateJournal *synchronizationStateJournal;
+
 #pragma mark Completion
 /** @name Completion */
 
@@ -13,9 +13,14 @@
 @property (nonatomic, retain) NSString *changeSetProgressString;
 @property (nonatomic, readonly) NSNumberFormatter *uuidPrefixFormatter;
 
+- (BOOL)importLocalSyncChangesJournalSegments;
 - (void)beginCheckWhetherRemoteIntegrityKeyMatchesLocalKey;
 
 - (void)beginFetchOfListOfClientDeviceIdentifiers;
+- (void)resumeFromListedSyncChangeSetIdentifiers:(NSDictionary *)someIdentifiers;
+- (void)recordListedSyncChangeSetIdentifiers;
+- (void)recordListedSyncChangeSetSequenceNumbersForClientIdentifier:(NSString *)aClientIdentifier fromSyncChangeSetIdentifiers:(NSArray *)someIdentifiers;
+- (void)saveSynchronizationStateJournal;
 - (void)beginFetchOfListOfSyncCommandSetIdentifiers;
 
 - (void)increaseNumberOfSyncChangeSetIdentifierArraysToFetch;
@@ -29,11 +34,17 @@
 - (void)increaseNumberOfUnappliedSyncChangeSetsFetched;
 - (void)increaseNumberOfUnappliedSyncChangeSetsThatFailedToFetch;
 - (void)beginFetchOfUnappliedSyncChanges;
+- (NSDictionary *)syncChangeSetIdentifiersToFetchAfterReusingVerifiedFiles:(NSDictionary *)someIdentifiers;
+- (NSString *)pathToUnappliedSyncChangeSetFileWithIdentifier:(NSString *)anIdentifier;
+- (void)finishFetchOfUnappliedSyncChanges;
 
 - (BOOL)addUnappliedSyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientWithIdentifier:(NSString *)aClientIdentifier modificationDate:(NSDate *)aDate;
 
 - (void)beginApplyingUnappliedSyncChangeSets;
 - (BOOL)applyUnappliedSyncChangeSets:(NSArray *)syncChangeSets;
+- (BOOL)shouldSaveApplyCheckpointAfterApplyingChangeSets:(NSUInteger)changeSetsSinceCheckpoint;
+- (BOOL)saveApplyCheckpoint;
+- (void)resetContextsAfterApplyCheckpoint;
 - (BOOL)addSyncChangeSetToAppliedSyncChangeSets:(TICDSSyncChangeSet *)aChangeSet;
 - (BOOL)removeSyncChangeSetFileForSyncChangeSet:(TICDSSyncChangeSet *)aChangeSet;
 - (void)continueAfterApplyingUnappliedSyncChangeSetsSuccessfully;
@@ -44,28 +55,118 @@
 - (NSArray *)remoteSyncChangesForObjectWithIdentifier:(NSString *)identifier afterCheckingForConflictsInRemoteSyncChanges:(NSArray *)remoteSyncChanges withLocalSyncChanges:(NSArray *)localSyncChanges;
 - (void)addWarningsForRemoteDeletionWithLocalChanges:(NSArray *)localChanges;
 - (void)addWarningsForRemoteChangesWithLocalDeletion:(NSArray *)remoteChanges;
+- (id)localValueOfAttributeChangedBySyncChange:(TICDSSyncChange *)aChange;
+- (BOOL)getFullValue:(id *)outValue ofLocalAttributeSyncChange:(TICDSSyncChange *)aChange;
+- (BOOL)getFullValue:(id *)outValue ofRemoteAttributeSyncChange:(TICDSSyncChange *)aChange;
 - (TICDSSyncConflictResolutionType)resolutionTypeForConflict:(TICDSSyncConflict *)aConflict;
-- (void)applyObjectInsertedSyncChange:(TICDSSyncChange *)aSyncChange;
-- (void)applyAttributeChangeSyncChange:(TICDSSyncChange *)aSyncChange;
-- (void)applyObjectDeletedSyncChange:(TICDSSyncChange *)aSyncChange;
-- (void)applyToOneRelationshipSyncChange:(TICDSSyncChange *)aSyncChange;
-- (void)applyToManyRelationshipSyncChange:(TICDSSyncChange *)aSyncChange;
+- (BOOL)applySyncChangesConcurrently:(NSArray *)syncChanges outOfTotalChangeCount:(NSUInteger)aCount;
 
 - (void)beginUploadOfLocalSyncCommands;
 - (void)beginUploadOfLocalSyncChanges;
+- (NSString *)uniqueSyncChangeSetIdentifierInSyncPartitionNamed:(NSString *)aPartitionName;
+- (NSMutableDictionary *)syncChangeSetSequenceNumbers;
+- (BOOL)saveSyncChangeSetSequenceNumbers;
+- (void)restoreSyncChangeSetSequenceNumbers:(NSDictionary *)someSequenceNumbers;
+- (void)releaseSyncChangeSetSequenceNumbersOfSyncChangeSetFilesAtLocations:(NSArray *)someLocations;
+- (NSArray *)syncChangeSetFileLocationsByRenamingLocalSyncChanges;
+- (NSArray *)syncChangeSetFileLocationsBySplittingLocalSyncChangesIntoSyncPartitions;
+- (void)uploadNextLocalSyncChangeSetFile;
 - (void)beginUploadOfRecentSyncFile;
 
 @end
 
+// Splitting a sync change set into groups, and saving a context for each, only pays off for large sets
+static NSUInteger const kTICDSMinimumSyncChangesToApplyConcurrently = 1000;
+
 @implementation TICDSSynchronizationOperation
 
 - (void)main
 {
-    _applicationObjectsBySyncIDByEntity = [[NSMutableDictionary alloc] init];
+    if( ![self importLocalSyncChangesJournalSegments] ) {
+        [self operationDidFailToComplete];
+        return;
+    }
     
     [self beginCheckWhetherRemoteIntegrityKeyMatchesLocalKey];
 }
 
+#pragma mark - LOCAL SYNC CHANGES JOURNAL
+- (BOOL)importLocalSyncChangesJournalSegments
+{
+    if( [[self localSyncChangesJournalSegmentLocations] count] < 1 ) {
+        return YES;
+    }
+    
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Importing %lu local sync change journal segments", (unsigned long)[[self localSyncChangesJournalSegmentLocations] count]);
+    
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    
+    // any changes left over from a previous failed sync are already in the store, so the newest changes are simply added
+    BOOL storeExisted = [[self fileManager] fileExistsAtPath:[[self localSyncChangesToMergeLocation] path]];
+    NSManagedObjectContext *context = [self localSyncChangesToMergeContext];
+    NSError *anyError = nil;
+    
+    NSMutableArray *importedSyncChanges = [NSMutableArray array];
+    
+    for( NSURL *eachLocation in [self localSyncChangesJournalSegmentLocations] ) {
+        // a segment is handed to every synchronization until it has been imported, so an earlier synchronization queued alongside this one may already have imported it
+        if( ![[self fileManager] fileExistsAtPath:[eachLocation path]] ) {
+            continue;
+        }
+        
+        NSArray *representations = [TICDSSyncChangeJournal syncChangeRepresentationsInSegmentAtPath:[eachLocation path] error:&anyError];
+        
+        if( !representations ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to read local sync change journal segment %@: %@", [[eachLocation path] lastPathComponent], anyError);
+            [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+            [pool drain];
+            return NO;
+        }
+        
+        for( NSDictionary *eachRepresentation in representations ) {
+            [importedSyncChanges addObject:[TICDSSyncChange syncChangeWithDictionaryRepresentation:eachRepresentation inManagedObjectContext:context]];
+        }
+    }
+    
+    // the values are already unarchived here, so digest them now rather than unarchiving them again to check for conflicts
+    if( ![TICDSSyncChange recordChangedAttributesDigestsOfSyncChanges:importedSyncChanges error:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to record digests of local sync changes imported from the journal: %@", anyError);
+        [self setError:anyError];
+        [pool drain];
+        return NO;
+    }
+    
+    // every change in the store must use the same encoding, so changes left over from a previous sync decide it
+    NSPersistentStore *store = [[[context persistentStoreCoordinator] persistentStores] lastObject];
+    NSUInteger encodingVersion = ( storeExisted ? [TICDSSyncChange changedAttributesEncodingVersionOfPersistentStore:store] : [self changedAttributesEncodingVersion] );
+    [TICDSSyncChange encodeChangedAttributesOfSyncChanges:importedSyncChanges withVersion:encodingVersion inPersistentStore:store managedObjectModel:[[self primaryPersistentStoreCoordinator] managedObjectModel]];
+    [TICDSSyncChange recordInsertionRelationshipsOfSyncChanges:importedSyncChanges inPersistentStore:store];
+    
+    if( ![context save:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save local sync changes imported from the journal: %@", anyError);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        [pool drain];
+        return NO;
+    }
+    
+    // the segments are only removed once their changes are safely in SyncChangesBeingSynchronized.syncchg; until then, the journal hands them to every synchronization
+    for( NSURL *eachLocation in [self localSyncChangesJournalSegmentLocations] ) {
+        if( [[self fileManager] fileExistsAtPath:[eachLocation path]] && ![[self fileManager] removeItemAtPath:[eachLocation path] error:&anyError] ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to remove imported journal segment %@: %@", [[eachLocation path] lastPathComponent], anyError);
+        }
+    }
+    
+    // the context is used from other threads later in the operation, so let it be created again there
+    [self setLocalSyncChangesToMergeContext:nil];
+    [self setLocalSyncChangesToMergeCoreDataFactory:nil];
+    
+    [pool drain];
+    
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Finished importing local sync change journal segments");
+    
+    return YES;
+}
+
 #pragma mark - INTEGRITY KEY
 - (void)beginCheckWhetherRemoteIntegrityKeyMatchesLocalKey
 {
@@ -97,6 +198,13 @@
     }
     
     TICDSLog(TICDSLogVerbosityStartAndEndOfMainOperationPhase, @"Integrity keys match, so continuing synchronization");
+    
+    NSDictionary *listedIdentifiers = [[self synchronizationStateJournal] listedSyncChangeSetIdentifiers];
+    if( listedIdentifiers ) {
+        [self resumeFromListedSyncChangeSetIdentifiers:listedIdentifiers];
+        return;
+    }
+    
     [self beginFetchOfListOfClientDeviceIdentifiers];
 }
 
@@ -170,7 +278,12 @@
     
     [self setOtherSynchronizedClientDeviceSyncChangeSetIdentifiers:[NSMutableDictionary dictionaryWithCapacity:[[self otherSynchronizedClientDeviceIdentifiers] count]]];
     
-    for( NSString *eachClientIdentifier in [self otherSynchronizedClientDeviceIdentifiers] ) {
+    [self buildArraysOfSyncChangeSetIdentifiersForClientIdentifiers:[self otherSynchronizedClientDeviceIdentifiers]];
+}
+
+- (void)buildArraysOfSyncChangeSetIdentifiersForClientIdentifiers:(NSArray *)someIdentifiers
+{
+    for( NSString *eachClientIdentifier in someIdentifiers ) {
         [self buildArrayOfSyncChangeSetIdentifiersForClientIdentifier:eachClientIdentifier];
     }
 }
@@ -183,6 +296,7 @@
     } else {
         TICDSLog(TICDSLogVerbosityEveryStep, @"Fetched an array of client sync change set identifiers");
         [self increaseNumberOfSyncChangeSetIdentifierArraysFetched];
+        [self recordListedSyncChangeSetSequenceNumbersForClientIdentifier:aClientIdentifier fromSyncChangeSetIdentifiers:anArray];
         anArray = [self unappliedSyncChangeSetIdentifiersFromAvailableSyncChangeSetIdentifiers:anArray];
     }
     
@@ -193,6 +307,7 @@
     if( [self numberOfSyncChangeSetIDArraysToFetch] == [self numberOfSyncChangeSetIDArraysFetched] ) {
         TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Finished fetching client sync change set IDs");
         
+        [self recordListedSyncChangeSetIdentifiers];
         [self beginFetchOfUnappliedSyncChanges];
     } else if( [self numberOfSyncChangeSetIDArraysToFetch] == [self numberOfSyncChangeSetIDArraysFetched] + [self numberOfSyncChangeSetIDArraysThatFailedToFetch] ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"One or more sync change set IDs failed to fetch");
@@ -215,6 +330,42 @@
     return addedIdentifiers;
 }
 
+- (void)recordListedSyncChangeSetSequenceNumbersForClientIdentifier:(NSString *)aClientIdentifier fromSyncChangeSetIdentifiers:(NSArray *)someIdentifiers
+{
+    @synchronized(self) {
+        if( !_listedSyncChangeSetSequenceNumbers ) {
+            _listedSyncChangeSetSequenceNumbers = [[NSMutableDictionary alloc] init];
+        }
+        
+        NSMutableDictionary *sequenceNumbersByPartition = [_listedSyncChangeSetSequenceNumbers valueForKey:aClientIdentifier];
+        if( !sequenceNumbersByPartition ) {
+            sequenceNumbersByPartition = [NSMutableDictionary dictionary];
+            [_listedSyncChangeSetSequenceNumbers setValue:sequenceNumbersByPartition forKey:aClientIdentifier];
+        }
+        
+        for( NSString *eachIdentifier in someIdentifiers ) {
+            NSUInteger sequenceNumber = [TICDSSyncChangeSet sequenceNumberOfSyncChangeSetWithIdentifier:eachIdentifier];
+            if( sequenceNumber == NSNotFound ) {
+                continue;
+            }
+            
+            // each partition is numbered separately
+            NSString *partitionName = [self syncPartitionNameForSyncChangeSetIdentifier:eachIdentifier];
+            if( !partitionName ) {
+                partitionName = kTICDSDefaultSyncPartition;
+            }
+            
+            NSMutableIndexSet *sequenceNumbers = [sequenceNumbersByPartition valueForKey:partitionName];
+            if( !sequenceNumbers ) {
+                sequenceNumbers = [NSMutableIndexSet indexSet];
+                [sequenceNumbersByPartition setValue:sequenceNumbers forKey:partitionName];
+            }
+            
+            [sequenceNumbers addIndex:sequenceNumber];
+        }
+    }
+}
+
 - (BOOL)syncChangeSetHasBeenAppliedWithIdentifier:(NSString *)anIdentifier
 {
     return [TICDSSyncChangeSet hasSyncChangeSetWithIdentifer:anIdentifier alreadyBeenAppliedInManagedObjectContext:[self appliedSyncChangeSetsContext]];
@@ -227,6 +378,56 @@
     [self builtArrayOfClientSyncChangeSetIdentifiers:nil forClientIdentifier:anIdentifier];
 }
 
+#pragma mark Resuming
+- (void)recordListedSyncChangeSetIdentifiers
+{
+    if( ![self synchronizationStateJournal] ) {
+        return;
+    }
+    
+    NSDictionary *partitionNames = nil;
+    @synchronized(self) {
+        partitionNames = [[_syncPartitionNamesBySyncChangeSetIdentifier copy] autorelease];
+    }
+    
+    [[self synchronizationStateJournal] recordListedSyncChangeSetIdentifiers:[[[self otherSynchronizedClientDeviceSyncChangeSetIdentifiers] copy] autorelease] syncPartitionNames:partitionNames];
+    [self saveSynchronizationStateJournal];
+}
+
+- (void)resumeFromListedSyncChangeSetIdentifiers:(NSDictionary *)someIdentifiers
+{
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Resuming an interrupted synchronization using its recorded list of SyncChangeSet identifiers");
+    
+    NSDictionary *partitionNames = [[self synchronizationStateJournal] listedSyncPartitionNames];
+    for( NSString *eachIdentifier in partitionNames ) {
+        [self setSyncPartitionName:[partitionNames valueForKey:eachIdentifier] forSyncChangeSetIdentifier:eachIdentifier];
+    }
+    
+    // any sets applied before the interruption are already in AppliedSyncChangeSets.ticdsync, so are skipped
+    [self setOtherSynchronizedClientDeviceSyncChangeSetIdentifiers:[NSMutableDictionary dictionaryWithCapacity:[someIdentifiers count]]];
+    for( NSString *eachClientIdentifier in someIdentifiers ) {
+        // only the unapplied sets were recorded, so the sequence numbers may not advance as far as they would have
+        [self recordListedSyncChangeSetSequenceNumbersForClientIdentifier:eachClientIdentifier fromSyncChangeSetIdentifiers:[someIdentifiers valueForKey:eachClientIdentifier]];
+        
+        NSArray *identifiers = [self unappliedSyncChangeSetIdentifiersFromAvailableSyncChangeSetIdentifiers:[someIdentifiers valueForKey:eachClientIdentifier]];
+        
+        if( [identifiers count] > 0 ) {
+            [[self otherSynchronizedClientDeviceSyncChangeSetIdentifiers] setValue:identifiers forKey:eachClientIdentifier];
+        }
+    }
+    
+    [self beginFetchOfUnappliedSyncChanges];
+}
+
+- (void)saveSynchronizationStateJournal
+{
+    NSError *anyError = nil;
+    
+    if( [self synchronizationStateJournal] && ![[self synchronizationStateJournal] save:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save synchronization state journal, but not fatal so continuing: %@", anyError);
+    }
+}
+
 #pragma mark - FETCH OF UNAPPLIED SYNC CHANGE SETS
 - (void)beginFetchOfUnappliedSyncChanges
 {
@@ -239,18 +440,70 @@
         return;
     }
     
-    NSString *unappliedSyncChangesPath = [[self unappliedSyncChangesDirectoryLocation] path];
+    NSDictionary *identifiersToFetch = [self syncChangeSetIdentifiersToFetchAfterReusingVerifiedFiles:[self otherSynchronizedClientDeviceSyncChangeSetIdentifiers]];
     
-    for( NSString *eachClientIdentifier in [self otherSynchronizedClientDeviceSyncChangeSetIdentifiers] ) {
-        NSArray *syncChangeSets = [[self otherSynchronizedClientDeviceSyncChangeSetIdentifiers] valueForKey:eachClientIdentifier];
+    for( NSString *eachClientIdentifier in identifiersToFetch ) {
+        NSArray *syncChangeSets = [identifiersToFetch valueForKey:eachClientIdentifier];
         
         [self setNumberOfUnappliedSyncChangeSetsToFetch:[self numberOfUnappliedSyncChangeSetsToFetch] + [syncChangeSets count]];
     }
     
+    if( [self numberOfUnappliedSyncChangeSetsToFetch] < 1 ) {
+        [self finishFetchOfUnappliedSyncChanges];
+        return;
+    }
+    
+    [self fetchSyncChangeSetsWithIdentifiersByClientIdentifier:identifiersToFetch toDirectoryLocation:[self unappliedSyncChangesDirectoryLocation]];
+}
+
+- (NSDictionary *)syncChangeSetIdentifiersToFetchAfterReusingVerifiedFiles:(NSDictionary *)someIdentifiers
+{
+    if( ![self synchronizationStateJournal] ) {
+        return someIdentifiers;
+    }
+    
+    NSMutableDictionary *identifiersToFetch = [NSMutableDictionary dictionaryWithCapacity:[someIdentifiers count]];
+    NSUInteger reusedCount = 0;
+    
+    for( NSString *eachClientIdentifier in someIdentifiers ) {
+        NSMutableArray *clientIdentifiersToFetch = [NSMutableArray array];
+        
+        for( NSString *eachIdentifier in [someIdentifiers valueForKey:eachClientIdentifier] ) {
+            NSDate *modificationDate = [[self synchronizationStateJournal] modificationDateOfVerifiedSyncChangeSetWithIdentifier:eachIdentifier atPath:[self pathToUnappliedSyncChangeSetFileWithIdentifier:eachIdentifier]];
+            
+            if( modificationDate && [self addUnappliedSyncChangeSetWithIdentifier:eachIdentifier forClientWithIdentifier:eachClientIdentifier modificationDate:modificationDate] ) {
+                reusedCount++;
+                continue;
+            }
+            
+            [clientIdentifiersToFetch addObject:eachIdentifier];
+        }
+        
+        if( [clientIdentifiersToFetch count] > 0 ) {
+            [identifiersToFetch setValue:clientIdentifiersToFetch forKey:eachClientIdentifier];
+        }
+    }
+    
+    if( reusedCount > 0 ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Reusing %lu sync change sets fetched by an interrupted synchronization", (unsigned long)reusedCount);
+    }
+    
+    return identifiersToFetch;
+}
+
+- (NSString *)pathToUnappliedSyncChangeSetFileWithIdentifier:(NSString *)anIdentifier
+{
+    return [[[[self unappliedSyncChangesDirectoryLocation] path] stringByAppendingPathComponent:anIdentifier] stringByAppendingPathExtension:TICDSSyncChangeSetFileExtension];
+}
+
+- (void)fetchSyncChangeSetsWithIdentifiersByClientIdentifier:(NSDictionary *)someIdentifiers toDirectoryLocation:(NSURL *)aDirectoryLocation
+{
+    NSString *unappliedSyncChangesPath = [aDirectoryLocation path];
+    
     NSString *fileLocation = nil;
     NSError *anyError = nil;
-    for( NSString *eachClientIdentifier in [self otherSynchronizedClientDeviceSyncChangeSetIdentifiers] ) {
-        NSArray *syncChangeSets = [[self otherSynchronizedClientDeviceSyncChangeSetIdentifiers] valueForKey:eachClientIdentifier];
+    for( NSString *eachClientIdentifier in someIdentifiers ) {
+        NSArray *syncChangeSets = [someIdentifiers valueForKey:eachClientIdentifier];
         
         for( NSString *eachSyncChangeSetIdentifier in syncChangeSets ) {
             fileLocation = [unappliedSyncChangesPath stringByAppendingPathComponent:eachSyncChangeSetIdentifier];
@@ -274,25 +527,40 @@
     if( success ) {
         TICDSLog(TICDSLogVerbosityEveryStep, @"Fetched an unapplied sync change set");
         [self increaseNumberOfUnappliedSyncChangeSetsFetched];
+        
+        [[self synchronizationStateJournal] recordFetchedSyncChangeSetWithIdentifier:aChangeSetIdentifier clientIdentifier:aClientIdentifier modificationDate:aDate atPath:[self pathToUnappliedSyncChangeSetFileWithIdentifier:aChangeSetIdentifier]];
+        
+        // saved every so often, so a long fetch that's interrupted doesn't have to start again
+        if( [self numberOfUnappliedSyncChangeSetsFetched] % 50 == 0 ) {
+            [self saveSynchronizationStateJournal];
+        }
     } else {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to fetch an unapplied sync change set");
         [self increaseNumberOfUnappliedSyncChangeSetsThatFailedToFetch];
     }
     
     if( [self numberOfUnappliedSyncChangeSetsToFetch] == [self numberOfUnappliedSyncChangeSetsFetched] ) {
-        TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Finished fetching unapplied sync change sets");
-        NSError *anyError = nil;
-        BOOL saveSuccess = [[self unappliedSyncChangeSetsContext] save:&anyError];
-        if( !saveSuccess ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save UnappliedSyncChanges.ticdsync file: %@", anyError);
-        }
-        [self beginApplyingUnappliedSyncChangeSets];
+        [self finishFetchOfUnappliedSyncChanges];
     } else if( [self numberOfUnappliedSyncChangeSetsToFetch] == [self numberOfUnappliedSyncChangeSetsFetched] + [self numberOfUnappliedSyncChangeSetsThatFailedToFetch] ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"One of more sync change sets failed to be fetched");
         [self operationDidFailToComplete];
     }
 }
 
+- (void)finishFetchOfUnappliedSyncChanges
+{
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Finished fetching unapplied sync change sets");
+    NSError *anyError = nil;
+    BOOL saveSuccess = [[self unappliedSyncChangeSetsContext] save:&anyError];
+    if( !saveSuccess ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save UnappliedSyncChanges.ticdsync file: %@", anyError);
+    }
+    
+    [self saveSynchronizationStateJournal];
+    
+    [self beginApplyingUnappliedSyncChangeSets];
+}
+
 - (BOOL)addUnappliedSyncChangeSetWithIdentifier:(NSString *)aChangeSetIdentifier forClientWithIdentifier:(NSString *)aClientIdentifier modificationDate:(NSDate *)aDate
 {
     // Check whether it already exists
@@ -364,59 +632,27 @@
     
     [self setSynchronizationWarnings:[NSMutableArray arrayWithCapacity:20]];
     
+    // Relationship changes still waiting for their objects when an interrupted synchronization saved its last checkpoint
+    if( [[[self synchronizationStateJournal] deferredSyncChanges] count] > 0 ) {
+        [[self syncChangeApplier] restoreDeferredSyncChanges:[[self synchronizationStateJournal] deferredSyncChanges]];
+    }
+    
     BOOL shouldContinue = [self applyUnappliedSyncChangeSets:syncChangeSetsToApply];
     
     if( shouldContinue ) {
-        anyError = nil;
-        
-        // Tell delegate about save, which could be expensive
-        NSManagedObjectContext *bc = self.backgroundApplicationContext;
-        NSUInteger changedObjectCount = bc.insertedObjects.count + bc.deletedObjects.count + bc.updatedObjects.count;
-        [self ti_alertDelegateOnMainThreadWithSelector:@selector(synchronizationOperation:willSaveSyncChangesWithCount:) waitUntilDone:YES, [NSNumber numberWithUnsignedInteger:changedObjectCount]];
-        
-        // Save Background Context (changes made to objects in application's context)
-        BOOL success = [[self backgroundApplicationContext] save:&anyError];
-        if( !success ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save background context: %@", anyError);
-            [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-            [pool drain];
-            [self continueAfterApplyingUnappliedSyncChangeSetsUnsuccessfully];
-            return;
-        }
-        
-        // Save UnsynchronizedSyncChanges context (UnsynchronizedSyncChanges.syncchg file)
-        if( [self localSyncChangesToMergeContext] && ![[self localSyncChangesToMergeContext] save:&anyError] ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save unsynchroinzed sync changes context, after saving background context: %@", anyError);
-            [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-            [pool drain];
-            [self continueAfterApplyingUnappliedSyncChangeSetsUnsuccessfully];
-            return;
-        }
-        
-        // Save Applied Sync Change Sets context (AppliedSyncChangeSets.ticdsync file)
-        success = [[self appliedSyncChangeSetsContext] save:&anyError];
-        if( !success ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save applied sync change sets context, after saving background context: %@", anyError);
-            [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-            [pool drain];
-            [self continueAfterApplyingUnappliedSyncChangeSetsUnsuccessfully];
-            return;
-        }
+        // Any relationship changes whose objects weren't inserted by any of the sync change sets can't be applied
+        [[self syncChangeApplier] finishDeferredSyncChanges];
+        [[self synchronizationWarnings] addObjectsFromArray:[[self syncChangeApplier] synchronizationWarnings]];
+        [[[self syncChangeApplier] synchronizationWarnings] removeAllObjects];
         
-        // Save Unapplied Sync Change Sets context (UnappliedSYncChangeSets.ticdsync file)
-        success = [[self unappliedSyncChangeSetsContext] save:&anyError];
-        if( !success ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save unapplied sync change sets context, after saving applied sync change sets context: %@", anyError);
-            [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-            [pool drain];
-            [self continueAfterApplyingUnappliedSyncChangeSetsUnsuccessfully];
-            return;
-        }
-        
-        [pool drain];
+        shouldContinue = [self saveApplyCheckpoint];
+    }
+    
+    [pool drain];
+    
+    if( shouldContinue ) {
         [self continueAfterApplyingUnappliedSyncChangeSetsSuccessfully];
     } else {
-        [pool drain];
         [self continueAfterApplyingUnappliedSyncChangeSetsUnsuccessfully];
     }
 }
@@ -424,32 +660,136 @@
 - (BOOL)applyUnappliedSyncChangeSets:(NSArray *)syncChangeSets
 {
     BOOL shouldContinue = YES;
+    NSUInteger changeSetsSinceCheckpoint = 0;
+    
+    [_syncChangeSetIdentifiersAppliedSinceCheckpoint release];
+    _syncChangeSetIdentifiersAppliedSinceCheckpoint = [[NSMutableArray alloc] init];
     
     NSInteger changeSetCount = 1;
     for( TICDSSyncChangeSet *eachChangeSet in syncChangeSets ) {
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
         self.changeSetProgressString = [NSString stringWithFormat:@"Change set %ld of %ld", (long)changeSetCount++, (long)[syncChangeSets count]];
         shouldContinue = [self beginApplyingSyncChangesInChangeSet:eachChangeSet];
-        if( !shouldContinue ) {
-            break;
+        
+        if( shouldContinue ) {
+            shouldContinue = [self addSyncChangeSetToAppliedSyncChangeSets:eachChangeSet];
         }
         
-        shouldContinue = [self addSyncChangeSetToAppliedSyncChangeSets:eachChangeSet];
-        if( !shouldContinue ) {
-            break;
+        if( shouldContinue ) {
+            shouldContinue = [self removeSyncChangeSetFileForSyncChangeSet:eachChangeSet];
+        }
+        
+        if( shouldContinue ) {
+            // Finally, remove the change set from the UnappliedSyncChangeSets context;
+            [_syncChangeSetIdentifiersAppliedSinceCheckpoint addObject:[eachChangeSet syncChangeSetIdentifier]];
+            [[self unappliedSyncChangeSetsContext] deleteObject:eachChangeSet];
+            changeSetsSinceCheckpoint++;
+        }
+        
+        if( shouldContinue && [self shouldSaveApplyCheckpointAfterApplyingChangeSets:changeSetsSinceCheckpoint] ) {
+            shouldContinue = [self saveApplyCheckpoint];
+            
+            if( shouldContinue ) {
+                [self resetContextsAfterApplyCheckpoint];
+                changeSetsSinceCheckpoint = 0;
+            }
         }
         
-        shouldContinue = [self removeSyncChangeSetFileForSyncChangeSet:eachChangeSet];
+        [pool drain];
+        
         if( !shouldContinue ) {
             break;
         }
-        
-        // Finally, remove the change set from the UnappliedSyncChangeSets context;
-        [[self unappliedSyncChangeSetsContext] deleteObject:eachChangeSet];
     }
     
     return shouldContinue;
 }
 
+#pragma mark Checkpoints
+- (BOOL)shouldSaveApplyCheckpointAfterApplyingChangeSets:(NSUInteger)changeSetsSinceCheckpoint
+{
+    if( [self syncChangeSetsPerCheckpoint] > 0 && changeSetsSinceCheckpoint >= [self syncChangeSetsPerCheckpoint] ) {
+        return YES;
+    }
+    
+    NSManagedObjectContext *bc = [self backgroundApplicationContext];
+    NSUInteger changedObjectCount = bc.insertedObjects.count + bc.deletedObjects.count + bc.updatedObjects.count;
+    
+    return [self changedObjectsPerCheckpoint] > 0 && changedObjectCount >= [self changedObjectsPerCheckpoint];
+}
+
+- (BOOL)saveApplyCheckpoint
+{
+    NSError *anyError = nil;
+    
+    // Tell delegate about save, which could be expensive
+    NSManagedObjectContext *bc = self.backgroundApplicationContext;
+    NSUInteger changedObjectCount = bc.insertedObjects.count + bc.deletedObjects.count + bc.updatedObjects.count;
+    [self ti_alertDelegateOnMainThreadWithSelector:@selector(synchronizationOperation:willSaveSyncChangesWithCount:) waitUntilDone:YES, [NSNumber numberWithUnsignedInteger:changedObjectCount]];
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Saving %lu changed objects, and the change sets applied so far", (unsigned long)changedObjectCount);
+    
+    // The application's changes are saved before the bookkeeping, so a crash in between only means some change sets are applied again on the next sync
+    
+    // Save Background Context (changes made to objects in application's context)
+    BOOL success = [[self backgroundApplicationContext] save:&anyError];
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save background context: %@", anyError);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        return NO;
+    }
+    
+    // Save UnsynchronizedSyncChanges context (UnsynchronizedSyncChanges.syncchg file)
+    if( [self localSyncChangesToMergeContext] && ![[self localSyncChangesToMergeContext] save:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save unsynchroinzed sync changes context, after saving background context: %@", anyError);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        return NO;
+    }
+    
+    // Save Applied Sync Change Sets context (AppliedSyncChangeSets.ticdsync file)
+    success = [[self appliedSyncChangeSetsContext] save:&anyError];
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save applied sync change sets context, after saving background context: %@", anyError);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        return NO;
+    }
+    
+    // Save Unapplied Sync Change Sets context (UnappliedSYncChangeSets.ticdsync file)
+    success = [[self unappliedSyncChangeSetsContext] save:&anyError];
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save unapplied sync change sets context, after saving applied sync change sets context: %@", anyError);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        return NO;
+    }
+    
+    // the applied sets' files have been removed, so there's nothing left to reuse
+    if( [_syncChangeSetIdentifiersAppliedSinceCheckpoint count] > 0 ) {
+        for( NSString *eachIdentifier in _syncChangeSetIdentifiersAppliedSinceCheckpoint ) {
+            [[self synchronizationStateJournal] forgetFetchedSyncChangeSetWithIdentifier:eachIdentifier];
+        }
+        
+        [[self synchronizationStateJournal] setLastAppliedSyncChangeSetIdentifier:[_syncChangeSetIdentifiersAppliedSinceCheckpoint lastObject]];
+        [[self synchronizationStateJournal] setDeferredSyncChanges:[[self syncChangeApplier] deferredSyncChanges]];
+        [_syncChangeSetIdentifiersAppliedSinceCheckpoint removeAllObjects];
+        
+        [self saveSynchronizationStateJournal];
+    }
+    
+    return YES;
+}
+
+- (void)resetContextsAfterApplyCheckpoint
+{
+    // the cached objects belong to the background context, so are refetched as needed once it has been reset
+    [[self syncChangeApplier] forgetCachedObjects];
+    [[self backgroundApplicationContext] reset];
+    [[self localSyncChangesToMergeContext] reset];
+    [[self appliedSyncChangeSetsContext] reset];
+    
+    // the unapplied sync change sets context isn't reset, as the sync change sets still to apply are in it
+}
+
 - (BOOL)addSyncChangeSetToAppliedSyncChangeSets:(TICDSSyncChangeSet *)aChangeSet
 {
     TICDSSyncChangeSet *appliedSyncChangeSet = [TICDSSyncChangeSet changeSetWithIdentifier:[aChangeSet syncChangeSetIdentifier] inManagedObjectContext:[self appliedSyncChangeSetsContext]];
@@ -518,6 +858,11 @@
     
     NSManagedObjectContext *syncChangesContext = [self contextForSyncChangesInUnappliedSyncChangeSet:aChangeSet];
     
+    if( !syncChangesContext ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to open change set %@", [aChangeSet syncChangeSetIdentifier]);
+        return NO;
+    }
+    
     NSError *anyError = nil;
     NSArray *syncChanges = [TICDSSyncChange ti_allObjectsInManagedObjectContext:syncChangesContext sortedWithDescriptors:[self syncChangeSortDescriptors] error:&anyError];
     
@@ -528,73 +873,205 @@
     syncChanges = [syncChanges sortedArrayUsingDescriptors:[NSArray arrayWithObject:sequenceSort]];
     [sequenceSort release], sequenceSort = nil;
     
+    NSUInteger changeCount = [syncChanges count];
+    
+    // Insertions and attribute changes, sorted first, only affect the objects they name, so can be split into groups of unrelated objects
+    NSUInteger concurrentChangeCount = 0;
+    if( [self maximumConcurrentSyncChangeApplications] > 1 ) {
+        while( concurrentChangeCount < changeCount && [[[syncChanges objectAtIndex:concurrentChangeCount] changeType] unsignedIntegerValue] <= TICDSSyncChangeTypeAttributeChanged ) {
+            concurrentChangeCount++;
+        }
+        
+        if( concurrentChangeCount < kTICDSMinimumSyncChangesToApplyConcurrently ) {
+            concurrentChangeCount = 0;
+        }
+    }
+    
     @try {
-        NSInteger changeCount = 1;
-        // Apply each object's changes in turn
-        for( TICDSSyncChange *eachChange in syncChanges ) {
-            @autoreleasepool {
-                switch( [[eachChange changeType] unsignedIntegerValue] ) {
-                    case TICDSSyncChangeTypeObjectInserted:
-                        [self applyObjectInsertedSyncChange:eachChange];
-                        [[self backgroundApplicationContext] processPendingChanges];
-                        break;
-                        
-                    case TICDSSyncChangeTypeAttributeChanged:
-                        [self applyAttributeChangeSyncChange:eachChange];
-                        break;
-                        
-                    case TICDSSyncChangeTypeToOneRelationshipChanged:
-                        [self applyToOneRelationshipSyncChange:eachChange];
-                        break;
-                        
-                    case TICDSSyncChangeTypeToManyRelationshipChangedByAddingObject:
-                    case TICDSSyncChangeTypeToManyRelationshipChangedByRemovingObject:
-                        [self applyToManyRelationshipSyncChange:eachChange];
-                        break;
-                        
-                    case TICDSSyncChangeTypeObjectDeleted:
-                        [self applyObjectDeletedSyncChange:eachChange];
-                        break;
-                }
-                
-                [[eachChange managedObjectContext] refreshObject:eachChange mergeChanges:NO]; // Keep memory low
-                
-                [self ti_alertDelegateOnMainThreadWithSelector:@selector(synchronizationOperation:processedChangeNumber:outOfTotalChangeCount:fromClientNamed:) waitUntilDone:NO, [NSNumber numberWithInteger:changeCount++], [NSNumber numberWithInteger:[syncChanges count]], self.changeSetProgressString];
-            }
+        if( concurrentChangeCount > 0 && ![self applySyncChangesConcurrently:[syncChanges subarrayWithRange:NSMakeRange(0, concurrentChangeCount)] outOfTotalChangeCount:changeCount] ) {
+            return NO;
         }
         
-        [[self backgroundApplicationContext] processPendingChanges];
+        TICDSSyncChangeApplier *applier = [self syncChangeApplier];
+        [applier applySyncChanges:[syncChanges subarrayWithRange:NSMakeRange(concurrentChangeCount, changeCount - concurrentChangeCount)] progressBlock:^(NSUInteger changeNumber) {
+            [self ti_alertDelegateOnMainThreadWithSelector:@selector(synchronizationOperation:processedChangeNumber:outOfTotalChangeCount:fromClientNamed:) waitUntilDone:NO, [NSNumber numberWithInteger:concurrentChangeCount + changeNumber], [NSNumber numberWithInteger:changeCount], self.changeSetProgressString];
+        }];
+        
+        [[self synchronizationWarnings] addObjectsFromArray:[applier synchronizationWarnings]];
+        [[applier synchronizationWarnings] removeAllObjects];
     }
     @catch ( NSException *exception ) {
         return NO;
     }
+    @finally {
+        // Close the sync change set before its file is removed
+        [self setUnappliedSyncChangesContext:nil];
+        [[self syncChangeSetReader] closeSyncChangeSet];
+    }
     
     return YES;
 }
 
-- (NSManagedObjectContext *)contextForSyncChangesInUnappliedSyncChangeSet:(TICDSSyncChangeSet *)aChangeSet
+- (BOOL)applySyncChangesConcurrently:(NSArray *)syncChanges outOfTotalChangeCount:(NSUInteger)aCount
 {
-    [self setUnappliedSyncChangesContext:nil];
-    [self setUnappliedSyncChangesCoreDataFactory:nil];
+    // The sync changes belong to the sync change set reader's context, which can only be used on this thread
+    NSMutableArray *changeRepresentations = [NSMutableArray arrayWithCapacity:[syncChanges count]];
+    for( TICDSSyncChange *eachChange in syncChanges ) {
+        [changeRepresentations addObject:[eachChange dictionaryRepresentation]];
+        [[eachChange managedObjectContext] refreshObject:eachChange mergeChanges:NO];
+    }
     
-    TICoreDataFactory *factory = [[TICoreDataFactory alloc] initWithMomdName:TICDSSyncChangeDataModelName];
-    [factory setDelegate:self];
-    [factory setPersistentStoreType:TICDSSyncChangesCoreDataPersistentStoreType];
-    [factory setPersistentStoreDataPath:[[[self unappliedSyncChangesDirectoryLocation] path] stringByAppendingPathComponent:[aChangeSet fileName]]];
+    NSArray *groups = [TICDSSyncChangeApplier independentGroupsOfSyncChanges:changeRepresentations maximumGroupCount:[self maximumConcurrentSyncChangeApplications]];
+    NSUInteger groupCount = [groups count];
     
-    [self setUnappliedSyncChangesCoreDataFactory:factory];
+    if( groupCount < 2 ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"The changes all affect related objects, so applying them on the background context");
+        [[self syncChangeApplier] applySyncChanges:changeRepresentations progressBlock:nil];
+        return YES;
+    }
     
-    [self setUnappliedSyncChangesContext:[factory managedObjectContext]];
+    // Each group's context saves straight to the persistent store, so changes applied to the background context since the last checkpoint must be saved first
+    if( [[self backgroundApplicationContext] hasChanges] && ![self saveApplyCheckpoint] ) {
+        return NO;
+    }
     
-    [factory release];
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying %lu changes in %lu groups of unrelated objects", (unsigned long)[changeRepresentations count], (unsigned long)groupCount);
     
-    return [self unappliedSyncChangesContext];
-}
-
-#pragma mark Conflicts
-- (NSArray *)syncChangesAfterCheckingForConflicts:(NSArray *)syncChanges
-{
-    NSArray *identifiersOfAffectedObjects = [syncChanges valueForKeyPath:@"@distinctUnionOfObjects.objectSyncID"];
+    NSMutableArray *appliers = [NSMutableArray arrayWithCapacity:groupCount];
+    for( NSUInteger groupIndex = 0; groupIndex < groupCount; groupIndex++ ) {
+        TICDSSynchronizationOperationManagedObjectContext *context = [[TICDSSynchronizationOperationManagedObjectContext alloc] init];
+        [context setPersistentStoreCoordinator:[self primaryPersistentStoreCoordinator]];
+        [context setUndoManager:nil];
+        [context setMergePolicy:NSMergeByPropertyObjectTrumpMergePolicy];
+        
+        TICDSSyncChangeApplier *applier = [[TICDSSyncChangeApplier alloc] initWithManagedObjectContext:context];
+        [appliers addObject:applier];
+        
+        [applier release];
+        [context release];
+    }
+    
+    __block NSString *groupExceptionDescription = nil;
+    dispatch_group_t applicationGroup = dispatch_group_create();
+    dispatch_queue_t applicationQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    
+    for( NSUInteger groupIndex = 0; groupIndex < groupCount; groupIndex++ ) {
+        NSArray *groupChanges = [groups objectAtIndex:groupIndex];
+        TICDSSyncChangeApplier *applier = [appliers objectAtIndex:groupIndex];
+        
+        dispatch_group_async(applicationGroup, applicationQueue, ^{
+            NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+            
+            @try {
+                [applier applySyncChanges:groupChanges progressBlock:nil];
+            }
+            @catch ( NSException *exception ) {
+                TICDSLog(TICDSLogVerbosityErrorsOnly, @"Exception thrown while applying a group of sync changes: %@", exception);
+                @synchronized(self) {
+                    if( !groupExceptionDescription ) {
+                        groupExceptionDescription = [[exception description] copy];
+                    }
+                }
+            }
+            
+            [pool drain];
+        });
+    }
+    
+    dispatch_group_wait(applicationGroup, DISPATCH_TIME_FOREVER);
+    dispatch_release(applicationGroup);
+    
+    if( groupExceptionDescription ) {
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeExceptionRaisedWhileApplyingSyncChanges underlyingError:nil userInfo:groupExceptionDescription classAndMethod:__PRETTY_FUNCTION__]];
+        [groupExceptionDescription release];
+        return NO;
+    }
+    
+    // Save the groups in order, telling the delegate about each save as if it were the background context's
+    NSUInteger changesSaved = 0;
+    for( NSUInteger groupIndex = 0; groupIndex < groupCount; groupIndex++ ) {
+        TICDSSyncChangeApplier *applier = [appliers objectAtIndex:groupIndex];
+        NSManagedObjectContext *context = [applier managedObjectContext];
+        
+        [[NSNotificationCenter defaultCenter] addObserver:[self delegate] selector:@selector(backgroundManagedObjectContextDidSave:) name:NSManagedObjectContextDidSaveNotification object:context];
+        
+        NSError *anyError = nil;
+        BOOL success = [context save:&anyError];
+        
+        [[NSNotificationCenter defaultCenter] removeObserver:[self delegate] name:NSManagedObjectContextDidSaveNotification object:context];
+        
+        if( !success ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save context for group %lu of sync changes: %@", (unsigned long)groupIndex, anyError);
+            [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+            return NO;
+        }
+        
+        [[self synchronizationWarnings] addObjectsFromArray:[applier synchronizationWarnings]];
+        
+        changesSaved += [[groups objectAtIndex:groupIndex] count];
+        [self ti_alertDelegateOnMainThreadWithSelector:@selector(synchronizationOperation:processedChangeNumber:outOfTotalChangeCount:fromClientNamed:) waitUntilDone:NO, [NSNumber numberWithInteger:changesSaved], [NSNumber numberWithInteger:aCount], self.changeSetProgressString];
+    }
+    
+    // The background context doesn't know about the objects the groups inserted, and any it has fetched are now stale
+    [[self backgroundApplicationContext] reset];
+    [[self syncChangeApplier] forgetCachedObjects];
+    
+    // Relationship changes a group deferred may be waiting for an object another group inserted, or one still to come
+    for( TICDSSyncChangeApplier *eachApplier in appliers ) {
+        [[self syncChangeApplier] restoreDeferredSyncChanges:[eachApplier deferredSyncChanges]];
+    }
+    
+    NSMutableArray *insertedSyncIDs = [NSMutableArray array];
+    for( NSDictionary *eachChange in changeRepresentations ) {
+        if( [[eachChange valueForKey:@"changeType"] unsignedIntegerValue] == TICDSSyncChangeTypeObjectInserted && [[eachChange valueForKey:@"objectSyncID"] isKindOfClass:[NSString class]] ) {
+            [insertedSyncIDs addObject:[eachChange valueForKey:@"objectSyncID"]];
+        }
+    }
+    [[self syncChangeApplier] retryDeferredSyncChangesWaitingForSyncIDs:insertedSyncIDs];
+    
+    return YES;
+}
+
+- (NSManagedObjectContext *)contextForSyncChangesInUnappliedSyncChangeSet:(TICDSSyncChangeSet *)aChangeSet
+{
+    [self setUnappliedSyncChangesContext:nil];
+    
+    NSURL *fileLocation = [[self unappliedSyncChangesDirectoryLocation] URLByAppendingPathComponent:[aChangeSet fileName]];
+    
+    NSError *anyError = nil;
+    NSManagedObjectContext *context = [[self syncChangeSetReader] managedObjectContextForSyncChangeSetAtLocation:fileLocation error:&anyError];
+    
+    if( !context ) {
+        [self setError:anyError];
+    }
+    
+    // a set encoded by a newer client can't be applied until this client is updated, so fail rather than misread its values
+    NSUInteger encodingVersion = [TICDSSyncChange changedAttributesEncodingVersionOfPersistentStore:[[[context persistentStoreCoordinator] persistentStores] lastObject]];
+    if( context && encodingVersion > [TICDSChangedAttributesCodec currentVersion] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Sync change set %@ was encoded with unsupported version %lu", [aChangeSet syncChangeSetIdentifier], (unsigned long)encodingVersion);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeUnsupportedChangedAttributesEncoding classAndMethod:__PRETTY_FUNCTION__]];
+        [[self syncChangeSetReader] closeSyncChangeSet];
+        context = nil;
+    }
+    
+    // likewise a set whose insertions carry relationships in a newer form, which would otherwise be inserted without them
+    NSUInteger insertionRelationshipsVersion = [TICDSSyncChange insertionRelationshipsVersionOfPersistentStore:[[[context persistentStoreCoordinator] persistentStores] lastObject]];
+    if( context && insertionRelationshipsVersion > [TICDSSyncChange currentInsertionRelationshipsVersion] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Sync change set %@ carries insertion relationships with unsupported version %lu", [aChangeSet syncChangeSetIdentifier], (unsigned long)insertionRelationshipsVersion);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeUnsupportedInsertionRelationships classAndMethod:__PRETTY_FUNCTION__]];
+        [[self syncChangeSetReader] closeSyncChangeSet];
+        context = nil;
+    }
+    
+    [self setUnappliedSyncChangesContext:context];
+    
+    return [self unappliedSyncChangesContext];
+}
+
+#pragma mark Conflicts
+- (NSArray *)syncChangesAfterCheckingForConflicts:(NSArray *)syncChanges
+{
+    NSArray *identifiersOfAffectedObjects = [syncChanges valueForKeyPath:@"@distinctUnionOfObjects.objectSyncID"];
     TICDSLog(TICDSLogVerbosityEveryStep, @"Affected Object identifiers: %@", [identifiersOfAffectedObjects componentsJoinedByString:@", "]);
     
     if( ![self localSyncChangesToMergeContext] ) {
@@ -686,16 +1163,40 @@
                 continue;
             }
             
-            if( [[eachLocalChange changedAttributes] isEqual:[eachRemoteChange changedAttributes]] ) {
+            // compare digests first, so values that are the same needn't be unarchived at all
+            NSData *localDigest = [eachLocalChange changedAttributesDigest];
+            if( localDigest && [localDigest isEqualToData:[eachRemoteChange changedAttributesDigest]] ) {
                 // both changes changed the value to the same thing so remove the local, unpushed sync change
                 [[self localSyncChangesToMergeContext] deleteObject:eachLocalChange];
                 continue;
             }
             
+            // deltas are decoded to the values they produce, so they can be compared and handed to the delegate
+            id localValue = nil;
+            BOOL hasLocalValue = [self getFullValue:&localValue ofLocalAttributeSyncChange:eachLocalChange];
+            if( !hasLocalValue && [[localAttributeChanges filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"relevantKey == %@", [eachLocalChange relevantKey]]] count] > 1 ) {
+                // the delta has been superseded by a later local change to the same attribute, which carries the local value, so isn't needed
+                [[self localSyncChangesToMergeContext] deleteObject:eachLocalChange];
+                continue;
+            }
+            
+            id remoteValue = nil;
+            BOOL hasRemoteValue = [self getFullValue:&remoteValue ofRemoteAttributeSyncChange:eachRemoteChange];
+            
+            // values with different digests are only unarchived once, and may still be equal if either has no digest, or isn't digested from its contents
+            if( hasLocalValue && hasRemoteValue && (localValue == remoteValue || [localValue isEqual:remoteValue]) ) {
+                [[self localSyncChangesToMergeContext] deleteObject:eachLocalChange];
+                continue;
+            }
+            
+            if( !hasLocalValue || !hasRemoteValue ) {
+                TICDSLog(TICDSLogVerbosityErrorsOnly, @"A delta in the conflicting changes to %@ can't be decoded, so its value is passed to the delegate as NSNull", [eachLocalChange relevantKey]);
+            }
+            
             // if we get here, we have a conflict between eachRemoteChange and eachLocalChange
             TICDSSyncConflict *conflict = [TICDSSyncConflict syncConflictOfType:TICDSSyncConflictRemoteAttributeChangedAndLocalAttributeChanged forEntityName:[eachLocalChange objectEntityName] key:[eachLocalChange relevantKey] objectSyncID:[eachLocalChange objectSyncID]];
-            [conflict setLocalInformation:[NSDictionary dictionaryWithObject:([eachLocalChange changedAttributes] ? : [NSNull null]) forKey:kTICDSChangedAttributeValue]];
-            [conflict setRemoteInformation:[NSDictionary dictionaryWithObject:([eachRemoteChange changedAttributes] ? : [NSNull null]) forKey:kTICDSChangedAttributeValue]];
+            [conflict setLocalInformation:[NSDictionary dictionaryWithObject:(localValue ? : [NSNull null]) forKey:kTICDSChangedAttributeValue]];
+            [conflict setRemoteInformation:[NSDictionary dictionaryWithObject:(remoteValue ? : [NSNull null]) forKey:kTICDSChangedAttributeValue]];
             TICDSSyncConflictResolutionType resolutionType = [self resolutionTypeForConflict:conflict];
             
             if( [self isCancelled] ) {
@@ -706,10 +1207,16 @@
             if( resolutionType == TICDSSyncConflictResolutionTypeRemoteWins ) {
                 // just delete the local sync change so the remote change wins
                 [[self localSyncChangesToMergeContext] deleteObject:eachLocalChange];
+                continue;
             } else if( resolutionType == TICDSSyncConflictResolutionTypeLocalWins ) {
                 // remove the remote sync change so it's not applied
                 [remoteSyncChangesToReturn removeObject:eachRemoteChange];
             }
+            
+            // other clients may have applied the remote change by the time they receive the local one, so it mustn't depend on the value they had before
+            if( hasLocalValue && [[eachLocalChange changedAttributes] isKindOfClass:[TICDSAttributeValueDelta class]] ) {
+                [eachLocalChange replaceChangedAttributesDeltaWithValue:localValue managedObjectModel:[[self primaryPersistentStoreCoordinator] managedObjectModel]];
+            }
         }
     }
     
@@ -719,9 +1226,12 @@
 - (void)addWarningsForRemoteDeletionWithLocalChanges:(NSArray *)localChanges
 {
     for( TICDSSyncChange *eachLocalChange in localChanges ) {
+        id localValue = nil;
+        
         switch( [[eachLocalChange changeType] unsignedIntegerValue] ) {
             case TICDSSyncChangeTypeAttributeChanged:
-                [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectWithAttributesChangedLocallyAlreadyDeletedByRemoteSyncChange entityName:[eachLocalChange objectEntityName] relatedObjectEntityName:nil attributes:[eachLocalChange changedAttributes]]];
+                [self getFullValue:&localValue ofLocalAttributeSyncChange:eachLocalChange];
+                [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectWithAttributesChangedLocallyAlreadyDeletedByRemoteSyncChange entityName:[eachLocalChange objectEntityName] relatedObjectEntityName:nil attributes:localValue]];
                 break;
         }
     }
@@ -730,9 +1240,12 @@
 - (void)addWarningsForRemoteChangesWithLocalDeletion:(NSArray *)remoteChanges
 {
     for( TICDSSyncChange *eachRemoteChange in remoteChanges ) {
+        id remoteValue = nil;
+        
         switch( [[eachRemoteChange changeType] unsignedIntegerValue] ) {
             case TICDSSyncChangeTypeAttributeChanged:
-                [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectWithAttributesChangedRemotelyNowDeletedByLocalSyncChange entityName:[eachRemoteChange objectEntityName] relatedObjectEntityName:nil attributes:[eachRemoteChange changedAttributes]]];
+                [self getFullValue:&remoteValue ofRemoteAttributeSyncChange:eachRemoteChange];
+                [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectWithAttributesChangedRemotelyNowDeletedByLocalSyncChange entityName:[eachRemoteChange objectEntityName] relatedObjectEntityName:nil attributes:remoteValue]];
                 break;
                 
             case TICDSSyncChangeTypeToOneRelationshipChanged:
@@ -744,6 +1257,53 @@
     }
 }
 
+#pragma mark Attribute Value Deltas
+- (id)localValueOfAttributeChangedBySyncChange:(TICDSSyncChange *)aChange
+{
+    TICDSSynchronizedManagedObject *object = (id)[[self syncChangeApplier] objectForEntityName:[aChange objectEntityName] syncIdentifier:[aChange objectSyncID]];
+    if( ![object isKindOfClass:[TICDSSynchronizedManagedObject class]] ) {
+        return nil;
+    }
+    
+    return [object transformedValueOfAttribute:[aChange relevantKey]];
+}
+
+- (BOOL)getFullValue:(id *)outValue ofLocalAttributeSyncChange:(TICDSSyncChange *)aChange
+{
+    id value = [aChange changedAttributes];
+    if( ![value isKindOfClass:[TICDSAttributeValueDelta class]] ) {
+        *outValue = value;
+        return YES;
+    }
+    
+    // the application's store already holds the value a local delta produces, unless a later local change to the attribute has replaced it
+    id localValue = [self localValueOfAttributeChangedBySyncChange:aChange];
+    if( ![[TICDSSyncChange digestOfChangedAttributes:localValue] isEqualToData:[value valueDigest]] ) {
+        return NO;
+    }
+    
+    *outValue = localValue;
+    return YES;
+}
+
+- (BOOL)getFullValue:(id *)outValue ofRemoteAttributeSyncChange:(TICDSSyncChange *)aChange
+{
+    id value = [aChange changedAttributes];
+    if( ![value isKindOfClass:[TICDSAttributeValueDelta class]] ) {
+        *outValue = value;
+        return YES;
+    }
+    
+    // a remote delta can only be decoded if this client still has the value it was created from
+    id fullValue = [value valueByApplyingToBaseValue:[self localValueOfAttributeChangedBySyncChange:aChange]];
+    if( !fullValue ) {
+        return NO;
+    }
+    
+    *outValue = fullValue;
+    return YES;
+}
+
 - (TICDSSyncConflictResolutionType)resolutionTypeForConflict:(TICDSSyncConflict *)aConflict
 {
     [self setPaused:YES];
@@ -759,235 +1319,321 @@
     return [self mostRecentConflictResolutionType];
 }
 
-#pragma mark Fetching Affected Objects
-- (NSManagedObject *)backgroundApplicationContextObjectForEntityName:(NSString *)entityName syncIdentifier:(NSString *)aSyncIdentifier
+#pragma mark - UPLOAD OF LOCAL SYNC COMMANDS
+- (void)beginUploadOfLocalSyncCommands
 {
-    NSDictionary *objectsBySyncID = [_applicationObjectsBySyncIDByEntity objectForKey:entityName];
-    if ( !objectsBySyncID ) {
-        NSError *anyError = nil;
-        NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
-        [fetchRequest setEntity:[NSEntityDescription entityForName:entityName inManagedObjectContext:[self backgroundApplicationContext]]];
-        [fetchRequest setPropertiesToFetch:[NSArray arrayWithObject:TICDSSyncIDAttributeName]];
-        NSArray *objects = [[self backgroundApplicationContext] executeFetchRequest:fetchRequest error:&anyError];
-        if( !objects ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Error fetching objects: %@", anyError);
-        }
-        else {
-            objectsBySyncID = [NSMutableDictionary dictionaryWithObjects:objects forKeys:[objects valueForKeyPath:TICDSSyncIDAttributeName]];
-            [_applicationObjectsBySyncIDByEntity setObject:objectsBySyncID forKey:entityName];
-        }
-        [fetchRequest release];
-    }
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to upload local sync commands");
+    
+    // TODO: Upload of Local Sync Commands
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"***Not yet implemented*** so 'finished' local sync commands");
     
-    return [objectsBySyncID objectForKey:aSyncIdentifier];
+    [self beginUploadOfLocalSyncChanges];
 }
 
-#pragma mark Applying Changes
-- (void)applyObjectInsertedSyncChange:(TICDSSyncChange *)aSyncChange
+#pragma mark - UPLOAD OF LOCAL SYNC CHANGES
+
+- (void)beginUploadOfLocalSyncChanges
 {
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Insertion sync change");
+    if( ![[self fileManager] fileExistsAtPath:[[self localSyncChangesToMergeLocation] path]] ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"No local sync changes file to push on this sync");
+        [self beginUploadOfRecentSyncFile];
+        return;
+    }
     
-    NSString *entityName = [aSyncChange objectEntityName];
-    NSString *ticdsSyncID = aSyncChange.objectSyncID;
-    TICDSSynchronizedManagedObject *object = (id)[self backgroundApplicationContextObjectForEntityName:entityName syncIdentifier:ticdsSyncID];
+    NSArray *fileLocations = nil;
     
-    if ( !object ) {
-        object = [NSEntityDescription insertNewObjectForEntityForName:entityName inManagedObjectContext:[self backgroundApplicationContext]];
-        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Inserted object: %@", object);
-        
-        // Add to object cache
-        NSMutableDictionary *objectsBySyncID = [_applicationObjectsBySyncIDByEntity objectForKey:entityName];
-        [objectsBySyncID setObject:object forKey:ticdsSyncID];
+    if( [[self syncPartitions] count] > 0 && [self supportsSyncPartitions] ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Splitting sync changes file into sync partitions ready for upload");
+        fileLocations = [self syncChangeSetFileLocationsBySplittingLocalSyncChangesIntoSyncPartitions];
     } else {
-        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Attempted to insert an object that already existed, updating existing object instead.: %@", object);
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Renaming sync changes file ready for upload");
+        fileLocations = [self syncChangeSetFileLocationsByRenamingLocalSyncChanges];
     }
     
-    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, entityName);
-
-    NSArray *changedAttributeKeys = [[aSyncChange changedAttributes] allKeys];
-    for (id key in changedAttributeKeys) {
-        [object willChangeValueForKey:key];
-        id transformedValue = [[aSyncChange changedAttributes] valueForKey:key];
-        transformedValue = [object reverseTransformedValueOfAttribute:key withValue:transformedValue];
-        [object setPrimitiveValue:transformedValue forKey:key];
-        [object didChangeValueForKey:key];
+    if( !fileLocations ) {
+        [self operationDidFailToComplete];
+        return;
     }
     
-    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Updated object: %@", object);
-}
-
-- (void)applyAttributeChangeSyncChange:(TICDSSyncChange *)aSyncChange
-{
-    @try {
-        TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Attribute Change sync change");
-        
-        TICDSSynchronizedManagedObject *object = (id)[self backgroundApplicationContextObjectForEntityName:[aSyncChange objectEntityName] syncIdentifier:[aSyncChange objectSyncID]];
+    if( [fileLocations count] < 1 ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Local sync changes file was empty, so nothing to push on this sync");
+        [self beginUploadOfRecentSyncFile];
+        return;
+    }
+    
+    NSDate *date = [NSDate date];
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Adding local sync change sets into AppliedSyncChanges");
+    for( NSURL *eachLocation in fileLocations ) {
+        NSString *identifier = [[[eachLocation path] lastPathComponent] stringByDeletingPathExtension];
+        TICDSSyncChangeSet *appliedSyncChangeSet = [TICDSSyncChangeSet syncChangeSetWithIdentifier:identifier fromClient:[self clientIdentifier] creationDate:date inManagedObjectContext:[self appliedSyncChangeSetsContext]];
         
-        if( !object || object.managedObjectContext == nil || object.isDeleted ) {
-            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Object not found locally for attribute change [%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-            [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectNotFoundLocallyForRemoteAttributeSyncChange entityName:[aSyncChange objectEntityName] relatedObjectEntityName:nil attributes:[aSyncChange changedAttributes]]];
+        if( !appliedSyncChangeSet ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Unable to create sync change set in applied sync change sets context");
+            [self setError:[TICDSError errorWithCode:TICDSErrorCodeObjectCreationError classAndMethod:__PRETTY_FUNCTION__]];
+            [self releaseSyncChangeSetSequenceNumbersOfSyncChangeSetFilesAtLocations:fileLocations];
+            [self operationDidFailToComplete];
             return;
         }
         
-        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-        
-        [object willChangeValueForKey:[aSyncChange relevantKey]];
-        id transformedValue = [aSyncChange changedAttributes];
-        transformedValue = [object reverseTransformedValueOfAttribute:[aSyncChange relevantKey] withValue:transformedValue];
-        [object setPrimitiveValue:transformedValue forKey:[aSyncChange relevantKey]];
-        [object didChangeValueForKey:[aSyncChange relevantKey]];
-        
-        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Changed attribute on object: %@", object);
+        [appliedSyncChangeSet setLocalDateOfApplication:date];
     }
-    @catch ( NSException *exception ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Exception thrown while applying attribute change [%@] %@: %@", aSyncChange, [aSyncChange objectEntityName], exception);
-        [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectExceptionAroseWhileApplyingAttributeSyncChange entityName:[aSyncChange objectEntityName] relatedObjectEntityName:nil attributes:[aSyncChange changedAttributes]]];
-    }
-}
-
-- (void)applyToOneRelationshipSyncChange:(TICDSSyncChange *)aSyncChange
-{
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Relationship Change sync change");
-    
-    NSManagedObject *object = [self backgroundApplicationContextObjectForEntityName:[aSyncChange objectEntityName] syncIdentifier:[aSyncChange objectSyncID]];
     
-    if( !object ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Object not found locally for attribute change [%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-        [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectNotFoundLocallyForRemoteRelationshipSyncChange entityName:[aSyncChange objectEntityName] relatedObjectEntityName:[aSyncChange relatedObjectEntityName] attributes:[aSyncChange changedAttributes]]];
+    // Save Applied Sync Change Sets context (AppliedSyncChangeSets.ticdsync file)
+    NSError *anyError = nil;
+    BOOL success = [[self appliedSyncChangeSetsContext] save:&anyError];
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save applied sync change sets context, after adding local merged changes: %@", anyError);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        [self releaseSyncChangeSetSequenceNumbersOfSyncChangeSetFilesAtLocations:fileLocations];
+        [self operationDidFailToComplete];
         return;
     }
     
-    NSManagedObject *relatedObject = [self backgroundApplicationContextObjectForEntityName:[aSyncChange relatedObjectEntityName] syncIdentifier:[aSyncChange changedRelationships]];
-        
-    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-    [object willChangeValueForKey:[aSyncChange relevantKey]];
-    [object setPrimitiveValue:relatedObject forKey:[aSyncChange relevantKey]];
-    [object didChangeValueForKey:[aSyncChange relevantKey]];
-
-    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Changed to-one relationship on object: %@", object);
+    [_localSyncChangeSetFileLocationsToUpload release];
+    _localSyncChangeSetFileLocationsToUpload = [fileLocations mutableCopy];
+    
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to upload local sync changes");
+    [self uploadNextLocalSyncChangeSetFile];
 }
 
-- (void)applyToManyRelationshipSyncChange:(TICDSSyncChange *)aSyncChange
+- (NSString *)uniqueSyncChangeSetIdentifierInSyncPartitionNamed:(NSString *)aPartitionName
 {
-    NSManagedObject *object = [self backgroundApplicationContextObjectForEntityName:[aSyncChange objectEntityName] syncIdentifier:[aSyncChange objectSyncID]];
+    NSString *partitionName = aPartitionName ? aPartitionName : kTICDSDefaultSyncPartition;
+    NSUInteger sequenceNumber = [[[self syncChangeSetSequenceNumbers] valueForKey:partitionName] unsignedIntegerValue] + 1;
+    [[self syncChangeSetSequenceNumbers] setValue:[NSNumber numberWithUnsignedInteger:sequenceNumber] forKey:partitionName];
     
-    if( !object ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Object not found locally for attribute change [%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-        [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectNotFoundLocallyForRemoteRelationshipSyncChange entityName:[aSyncChange objectEntityName] relatedObjectEntityName:[aSyncChange relatedObjectEntityName] attributes:[aSyncChange changedAttributes]]];
-        return;
+    return [NSString stringWithFormat:@"%@-%010lu-%@", [self.uuidPrefixFormatter stringFromNumber:[NSNumber numberWithDouble:CFAbsoluteTimeGetCurrent()]], (unsigned long)sequenceNumber, [TICDSUtilities uuidString]];
+}
+
+#pragma mark Sequence Numbers
+- (NSMutableDictionary *)syncChangeSetSequenceNumbers
+{
+    if( _syncChangeSetSequenceNumbers ) {
+        return _syncChangeSetSequenceNumbers;
     }
     
-    NSManagedObject *relatedObject = [self backgroundApplicationContextObjectForEntityName:[aSyncChange relatedObjectEntityName] syncIdentifier:[aSyncChange changedRelationships]];
-    if (!relatedObject) return;
-    
-    NSMutableSet *set = [object mutableSetValueForKey:aSyncChange.relevantKey];
-    if( [[aSyncChange changeType] unsignedIntegerValue] == TICDSSyncChangeTypeToManyRelationshipChangedByAddingObject ) {
-        [set addObject:relatedObject];
-    } else {
-        [set removeObject:relatedObject];
+    _syncChangeSetSequenceNumbers = [[NSMutableDictionary alloc] init];
+    if( [self syncChangeSetSequenceNumbersFileLocation] ) {
+        [_syncChangeSetSequenceNumbers addEntriesFromDictionary:[NSDictionary dictionaryWithContentsOfURL:[self syncChangeSetSequenceNumbersFileLocation]]];
     }
     
-    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Changed to-many relationships on object: %@", object);
+    return _syncChangeSetSequenceNumbers;
 }
 
-- (void)applyObjectDeletedSyncChange:(TICDSSyncChange *)aSyncChange
+- (BOOL)saveSyncChangeSetSequenceNumbers
 {
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Deletion sync change");
-    
-    NSManagedObject *object = [self backgroundApplicationContextObjectForEntityName:[aSyncChange objectEntityName] syncIdentifier:[aSyncChange objectSyncID]];
-    
-    if( !object ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Object not found locally for deletion sync change [%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-        [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectNotFoundLocallyForRemoteDeletionSyncChange entityName:[aSyncChange objectEntityName] relatedObjectEntityName:nil attributes:nil]];
-        return;
+    if( ![self syncChangeSetSequenceNumbersFileLocation] ) {
+        return YES;
     }
     
-    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, [aSyncChange objectEntityName]);
-
-    [[self backgroundApplicationContext] deleteObject:object];
+    if( ![[self syncChangeSetSequenceNumbers] writeToURL:[self syncChangeSetSequenceNumbersFileLocation] atomically:YES] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save sync change set sequence numbers");
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError classAndMethod:__PRETTY_FUNCTION__]];
+        return NO;
+    }
     
-    // Remove from object cache
-    NSMutableDictionary *objectsBySyncID = [_applicationObjectsBySyncIDByEntity objectForKey:[aSyncChange objectEntityName]];
-    [objectsBySyncID removeObjectForKey:[aSyncChange objectSyncID] ? : [NSNull null]];
+    return YES;
 }
 
-#pragma mark - UPLOAD OF LOCAL SYNC COMMANDS
-- (void)beginUploadOfLocalSyncCommands
+- (void)restoreSyncChangeSetSequenceNumbers:(NSDictionary *)someSequenceNumbers
 {
-    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to upload local sync commands");
-    
-    // TODO: Upload of Local Sync Commands
-    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"***Not yet implemented*** so 'finished' local sync commands");
+    [[self syncChangeSetSequenceNumbers] setDictionary:someSequenceNumbers];
     
-    [self beginUploadOfLocalSyncChanges];
+    // the operation is already failing, and leaving the numbers raised only leaves a gap that stops the vacuum removing later sets
+    [self saveSyncChangeSetSequenceNumbers];
 }
 
-#pragma mark - UPLOAD OF LOCAL SYNC CHANGES
-
-- (void)beginUploadOfLocalSyncChanges
+- (void)releaseSyncChangeSetSequenceNumbersOfSyncChangeSetFilesAtLocations:(NSArray *)someLocations
 {
-    if( ![[self fileManager] fileExistsAtPath:[[self localSyncChangesToMergeLocation] path]] ) {
-        TICDSLog(TICDSLogVerbosityEveryStep, @"No local sync changes file to push on this sync");
-        [self beginUploadOfRecentSyncFile];
-        return;
+    // each partition gets at most one sync change set per synchronization, so it's always the last number handed out
+    for( NSURL *eachLocation in someLocations ) {
+        NSString *identifier = [[[eachLocation path] lastPathComponent] stringByDeletingPathExtension];
+        NSUInteger sequenceNumber = [TICDSSyncChangeSet sequenceNumberOfSyncChangeSetWithIdentifier:identifier];
+        NSString *partitionName = [self syncPartitionNameForSyncChangeSetIdentifier:identifier];
+        if( !partitionName ) {
+            partitionName = kTICDSDefaultSyncPartition;
+        }
+        
+        if( sequenceNumber == NSNotFound || [[[self syncChangeSetSequenceNumbers] valueForKey:partitionName] unsignedIntegerValue] != sequenceNumber ) {
+            continue;
+        }
+        
+        [[self syncChangeSetSequenceNumbers] setValue:[NSNumber numberWithUnsignedInteger:sequenceNumber - 1] forKey:partitionName];
     }
     
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Renaming sync changes file ready for upload");
-    
-    NSString *identifier = [NSString stringWithFormat:@"%@-%@", [self.uuidPrefixFormatter stringFromNumber:[NSNumber numberWithDouble:CFAbsoluteTimeGetCurrent()]], [TICDSUtilities uuidString]];
+    [self saveSyncChangeSetSequenceNumbers];
+}
+
+#pragma mark Preparing Sync Change Set Files
+- (NSArray *)syncChangeSetFileLocationsByRenamingLocalSyncChanges
+{
+    NSDictionary *previousSequenceNumbers = [[[self syncChangeSetSequenceNumbers] copy] autorelease];
     
     NSString *filePath = [[self localSyncChangesToMergeLocation] path];
     filePath = [filePath stringByDeletingLastPathComponent];
-    filePath = [filePath stringByAppendingPathComponent:identifier];
+    filePath = [filePath stringByAppendingPathComponent:[self uniqueSyncChangeSetIdentifierInSyncPartitionNamed:nil]];
     filePath = [filePath stringByAppendingPathExtension:TICDSSyncChangeSetFileExtension];
     
+    // record the number before the file exists, so it's never reused
+    if( ![self saveSyncChangeSetSequenceNumbers] ) {
+        return nil;
+    }
+    
     NSError *anyError = nil;
     BOOL success = [[self fileManager] moveItemAtPath:[[self localSyncChangesToMergeLocation] path] toPath:filePath error:&anyError];
     
     if( !success ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to move local sync changes to merge file");
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        [self restoreSyncChangeSetSequenceNumbers:previousSequenceNumbers];
+        return nil;
+    }
+    
+    return [NSArray arrayWithObject:[NSURL fileURLWithPath:filePath]];
+}
+
+- (NSArray *)syncChangeSetFileLocationsBySplittingLocalSyncChangesIntoSyncPartitions
+{
+    NSError *anyError = nil;
+    NSArray *syncChanges = [TICDSSyncChange ti_allObjectsInManagedObjectContext:[self localSyncChangesToMergeContext] error:&anyError];
+    
+    if( !syncChanges ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to fetch local sync changes to split into sync partitions: %@", anyError);
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataFetchError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        return nil;
+    }
+    
+    // the partition files use the same encoding as the original file, which may contain deltas
+    NSUInteger encodingVersion = [TICDSSyncChange changedAttributesEncodingVersionOfPersistentStore:[[[[self localSyncChangesToMergeContext] persistentStoreCoordinator] persistentStores] lastObject]];
+    
+    // sync changes for entities that aren't in a partition are grouped under NSNull, and uploaded to the default partition
+    NSMutableDictionary *representationsByPartitionName = [NSMutableDictionary dictionary];
+    for( TICDSSyncChange *eachSyncChange in syncChanges ) {
+        id partitionName = [self syncPartitionNameForEntityName:[eachSyncChange objectEntityName]];
+        if( !partitionName ) {
+            partitionName = [NSNull null];
+        }
         
-        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];        
-        [self operationDidFailToComplete];
-        return;
+        NSMutableArray *representations = [representationsByPartitionName objectForKey:partitionName];
+        if( !representations ) {
+            representations = [NSMutableArray array];
+            [representationsByPartitionName setObject:representations forKey:partitionName];
+        }
+        
+        [representations addObject:[eachSyncChange dictionaryRepresentation]];
     }
     
-    NSDate *date = [NSDate date];
+    // the original file is removed below, so let go of it first
+    [self setLocalSyncChangesToMergeContext:nil];
+    [self setLocalSyncChangesToMergeCoreDataFactory:nil];
     
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Adding local sync change set into AppliedSyncChanges");
-    TICDSSyncChangeSet *appliedSyncChangeSet = [TICDSSyncChangeSet syncChangeSetWithIdentifier:identifier fromClient:[self clientIdentifier] creationDate:date inManagedObjectContext:[self appliedSyncChangeSetsContext]];
+    // record the numbers before the files exist, so they're never reused
+    NSDictionary *previousSequenceNumbers = [[[self syncChangeSetSequenceNumbers] copy] autorelease];
+    NSMutableDictionary *identifiersByPartitionName = [NSMutableDictionary dictionaryWithCapacity:[representationsByPartitionName count]];
+    for( id eachPartitionName in representationsByPartitionName ) {
+        [identifiersByPartitionName setObject:[self uniqueSyncChangeSetIdentifierInSyncPartitionNamed:eachPartitionName != [NSNull null] ? eachPartitionName : nil] forKey:eachPartitionName];
+    }
     
-    if( !appliedSyncChangeSet ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Unable to create sync change set in applied sync change sets context");
-        [self setError:[TICDSError errorWithCode:TICDSErrorCodeObjectCreationError classAndMethod:__PRETTY_FUNCTION__]];
-        [self operationDidFailToComplete];
-        return;
+    if( ![self saveSyncChangeSetSequenceNumbers] ) {
+        return nil;
     }
     
-    [appliedSyncChangeSet setLocalDateOfApplication:date];
+    NSString *directoryPath = [[[self localSyncChangesToMergeLocation] path] stringByDeletingLastPathComponent];
+    NSMutableArray *fileLocations = [NSMutableArray arrayWithCapacity:[representationsByPartitionName count]];
+    BOOL success = YES;
+    
+    for( id eachPartitionName in representationsByPartitionName ) {
+        NSString *identifier = [identifiersByPartitionName objectForKey:eachPartitionName];
+        NSString *filePath = [[directoryPath stringByAppendingPathComponent:identifier] stringByAppendingPathExtension:TICDSSyncChangeSetFileExtension];
+        
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        TICoreDataFactory *factory = [[TICoreDataFactory alloc] initWithMomdName:TICDSSyncChangeDataModelName];
+        [factory setDelegate:self];
+        [factory setPersistentStoreType:TICDSSyncChangesCoreDataPersistentStoreType];
+        [factory setPersistentStoreDataPath:filePath];
+        
+        NSManagedObjectContext *context = [factory managedObjectContext];
+        [context setUndoManager:nil];
+        
+        NSMutableArray *partitionSyncChanges = [NSMutableArray array];
+        for( NSDictionary *eachRepresentation in [representationsByPartitionName objectForKey:eachPartitionName] ) {
+            [partitionSyncChanges addObject:[TICDSSyncChange syncChangeWithDictionaryRepresentation:eachRepresentation inManagedObjectContext:context]];
+        }
+        
+        success = [TICDSSyncChange recordChangedAttributesDigestsOfSyncChanges:partitionSyncChanges error:&anyError];
+        if( success ) {
+            [TICDSSyncChange encodeChangedAttributesOfSyncChanges:partitionSyncChanges withVersion:encodingVersion inPersistentStore:[[[context persistentStoreCoordinator] persistentStores] lastObject] managedObjectModel:[[self primaryPersistentStoreCoordinator] managedObjectModel]];
+            [TICDSSyncChange recordInsertionRelationshipsOfSyncChanges:partitionSyncChanges inPersistentStore:[[[context persistentStoreCoordinator] persistentStores] lastObject]];
+            success = [context save:&anyError];
+        }
+        [anyError retain];
+        [factory release];
+        [pool drain];
+        [anyError autorelease];
+        
+        if( !success ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save sync changes for sync partition %@: %@", eachPartitionName, anyError);
+            [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+            break;
+        }
+        
+        if( eachPartitionName != [NSNull null] ) {
+            [self setSyncPartitionName:eachPartitionName forSyncChangeSetIdentifier:identifier];
+        }
+        
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Wrote %lu sync changes to %@ for sync partition %@", (unsigned long)[[representationsByPartitionName objectForKey:eachPartitionName] count], identifier, eachPartitionName);
+        [fileLocations addObject:[NSURL fileURLWithPath:filePath]];
+    }
     
-    // Save Applied Sync Change Sets context (AppliedSyncChangeSets.ticdsync file)
-    success = [[self appliedSyncChangeSetsContext] save:&anyError];
     if( !success ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to save applied sync change sets context, after adding local merged changes: %@", anyError);
-        [self setError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-        [self operationDidFailToComplete];
-        return;
+        // the original file is still intact, so the changes will be pushed on the next sync
+        for( NSURL *eachLocation in fileLocations ) {
+            [[self fileManager] removeItemAtPath:[eachLocation path] error:NULL];
+        }
+        
+        [self restoreSyncChangeSetSequenceNumbers:previousSequenceNumbers];
+        return nil;
     }
     
-    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Starting to upload local sync changes");
-    [self uploadLocalSyncChangeSetFileAtLocation:[NSURL fileURLWithPath:filePath]];
+    if( ![[self fileManager] removeItemAtPath:[[self localSyncChangesToMergeLocation] path] error:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to remove local sync changes file after splitting it into sync partitions");
+        [self setError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+        
+        for( NSURL *eachLocation in fileLocations ) {
+            [[self fileManager] removeItemAtPath:[eachLocation path] error:NULL];
+        }
+        
+        [self restoreSyncChangeSetSequenceNumbers:previousSequenceNumbers];
+        return nil;
+    }
+    
+    return fileLocations;
+}
+
+- (void)uploadNextLocalSyncChangeSetFile
+{
+    // stays in the list until it has been uploaded, so a failed upload can give back its sequence number
+    [self uploadLocalSyncChangeSetFileAtLocation:[_localSyncChangeSetFileLocationsToUpload objectAtIndex:0]];
 }
 
 - (void)uploadedLocalSyncChangeSetFileSuccessfully:(BOOL)success
 {
     if( !success ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to upload local sync changes files");
+        [self releaseSyncChangeSetSequenceNumbersOfSyncChangeSetFilesAtLocations:_localSyncChangeSetFileLocationsToUpload];
         [self operationDidFailToComplete];
         return;
     }
     
+    [_localSyncChangeSetFileLocationsToUpload removeObjectAtIndex:0];
+    
+    if( [_localSyncChangeSetFileLocationsToUpload count] > 0 ) {
+        [self uploadNextLocalSyncChangeSetFile];
+        return;
+    }
+    
     TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Uploaded local sync changes file");
         
     [self beginUploadOfRecentSyncFile];
@@ -1006,7 +1652,44 @@
 {
     NSString *recentSyncFilePath = [[self localRecentSyncFileLocation] path];
     
-    NSDictionary *recentSyncDictionary = [NSDictionary dictionaryWithObject:[NSDate date] forKey:kTICDSLastSyncDate];
+    NSMutableDictionary *recentSyncDictionary = [NSMutableDictionary dictionaryWithObject:[NSDate date] forKey:kTICDSLastSyncDate];
+    
+    // every listed sync change set has now been applied, so each sequence number advances over the listed numbers that directly follow it
+    NSDictionary *previousRecentSyncDictionary = [NSDictionary dictionaryWithContentsOfFile:recentSyncFilePath];
+    NSMutableDictionary *appliedSequenceNumbers = [NSMutableDictionary dictionaryWithDictionary:[previousRecentSyncDictionary valueForKey:kTICDSAppliedSyncChangeSetSequenceNumbers]];
+    
+    @synchronized(self) {
+        for( NSString *eachClientIdentifier in _listedSyncChangeSetSequenceNumbers ) {
+            NSDictionary *listedSequenceNumbersByPartition = [_listedSyncChangeSetSequenceNumbers valueForKey:eachClientIdentifier];
+            NSMutableDictionary *sequenceNumbersByPartition = [NSMutableDictionary dictionaryWithDictionary:[appliedSequenceNumbers valueForKey:eachClientIdentifier]];
+            
+            for( NSString *eachPartitionName in listedSequenceNumbersByPartition ) {
+                NSIndexSet *listedSequenceNumbers = [listedSequenceNumbersByPartition valueForKey:eachPartitionName];
+                NSUInteger sequenceNumber = [[sequenceNumbersByPartition valueForKey:eachPartitionName] unsignedIntegerValue];
+                
+                // stop at the first gap, as a set listed after it may have arrived before an earlier one
+                while( [listedSequenceNumbers containsIndex:sequenceNumber + 1] ) {
+                    sequenceNumber++;
+                }
+                
+                if( sequenceNumber > 0 ) {
+                    [sequenceNumbersByPartition setValue:[NSNumber numberWithUnsignedInteger:sequenceNumber] forKey:eachPartitionName];
+                }
+            }
+            
+            [appliedSequenceNumbers setValue:sequenceNumbersByPartition forKey:eachClientIdentifier];
+        }
+    }
+    
+    [recentSyncDictionary setValue:appliedSequenceNumbers forKey:kTICDSAppliedSyncChangeSetSequenceNumbers];
+    
+    // recorded by the last whole store upload
+    [recentSyncDictionary setValue:[previousRecentSyncDictionary valueForKey:kTICDSWholeStoreSyncChangeSetSequenceNumbers] forKey:kTICDSWholeStoreSyncChangeSetSequenceNumbers];
+    
+    // lets the vacuum keep each partition's change sets only until its subscribers have synchronized
+    if( [[self syncPartitions] count] > 0 && [self subscribedSyncPartitionNames] ) {
+        [recentSyncDictionary setValue:[[self subscribedSyncPartitionNames] allObjects] forKey:kTICDSSubscribedSyncPartitionNames];
+    }
     
     BOOL success = [recentSyncDictionary writeToFile:recentSyncFilePath atomically:YES];
     
@@ -1065,6 +1748,78 @@
     [self setNumberOfUnappliedSyncChangeSetsThatFailedToFetch:[self numberOfUnappliedSyncChangeSetsThatFailedToFetch] + 1];
 }
 
+#pragma mark -
+#pragma mark Completion
+- (void)operationDidCompleteSuccessfully
+{
+    NSError *anyError = nil;
+    
+    if( [self synchronizationStateJournal] && ![[self synchronizationStateJournal] removeJournal:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to remove synchronization state journal: %@", anyError);
+    }
+    
+    [super operationDidCompleteSuccessfully];
+}
+
+- (void)operationDidFailToComplete
+{
+    // keeps whatever progress was made, for the next synchronization to resume from
+    [self saveSynchronizationStateJournal];
+    
+    [super operationDidFailToComplete];
+}
+
+#pragma mark -
+#pragma mark Sync Partitions
+- (BOOL)supportsSyncPartitions
+{
+    return NO;
+}
+
+- (NSSet *)syncPartitionNamesToFetch
+{
+    NSMutableSet *partitionNames = [NSMutableSet setWithArray:[[self syncPartitions] allKeys]];
+    
+    if( [self subscribedSyncPartitionNames] ) {
+        [partitionNames intersectSet:[self subscribedSyncPartitionNames]];
+    }
+    
+    return partitionNames;
+}
+
+- (NSString *)syncPartitionNameForEntityName:(NSString *)anEntityName
+{
+    if( !_syncPartitionNamesByEntityName ) {
+        _syncPartitionNamesByEntityName = [[NSMutableDictionary alloc] init];
+        
+        for( NSString *eachPartitionName in [self syncPartitions] ) {
+            for( NSString *eachEntityName in [[self syncPartitions] valueForKey:eachPartitionName] ) {
+                [_syncPartitionNamesByEntityName setValue:eachPartitionName forKey:eachEntityName];
+            }
+        }
+    }
+    
+    return [_syncPartitionNamesByEntityName valueForKey:anEntityName];
+}
+
+- (NSString *)syncPartitionNameForSyncChangeSetIdentifier:(NSString *)anIdentifier
+{
+    @synchronized(self) {
+        return [[[_syncPartitionNamesBySyncChangeSetIdentifier valueForKey:anIdentifier] retain] autorelease];
+    }
+}
+
+- (void)setSyncPartitionName:(NSString *)aPartitionName forSyncChangeSetIdentifier:(NSString *)anIdentifier
+{
+    @synchronized(self) {
+        if( !_syncPartitionNamesBySyncChangeSetIdentifier ) {
+            _syncPartitionNamesBySyncChangeSetIdentifier = [[NSMutableDictionary alloc] init];
+        }
+        
+        [_syncPartitionNamesBySyncChangeSetIdentifier setValue:aPartitionName forKey:anIdentifier];
+    }
+}
+
 #pragma mark -
 #pragma mark TICoreDataFactory Delegate
 - (void)coreDataFactory:(TICoreDataFactory *)aFactory encounteredError:(NSError *)anError
@@ -1083,7 +1838,16 @@
 #pragma mark Initialization and Deallocation
 - (id)initWithDelegate:(NSObject<TICDSSynchronizationOperationDelegate> *)aDelegate
 {
-    return [super initWithDelegate:aDelegate];
+    self = [super initWithDelegate:aDelegate];
+    if( !self ) {
+        return nil;
+    }
+    
+    _syncChangeSetsPerCheckpoint = 100;
+    _changedObjectsPerCheckpoint = 10000;
+    _maximumConcurrentSyncChangeApplications = 1;
+    
+    return self;
 }
 
 - (void)dealloc
@@ -1094,6 +1858,7 @@
     [_synchronizationWarnings release], _synchronizationWarnings = nil;
 
     [_localSyncChangesToMergeLocation release], _localSyncChangesToMergeLocation = nil;
+    [_localSyncChangesJournalSegmentLocations release], _localSyncChangesJournalSegmentLocations = nil;
     [_appliedSyncChangeSetsFileLocation release], _appliedSyncChangeSetsFileLocation = nil;
     [_unappliedSyncChangesDirectoryLocation release], _unappliedSyncChangesDirectoryLocation = nil;
     [_unappliedSyncChangeSetsFileLocation release], _unappliedSyncChangeSetsFileLocation = nil;
@@ -1103,14 +1868,25 @@
     [_appliedSyncChangeSetsContext release], _appliedSyncChangeSetsContext = nil;
     [_unappliedSyncChangeSetsCoreDataFactory release], _unappliedSyncChangeSetsCoreDataFactory = nil;
     [_unappliedSyncChangeSetsContext release], _unappliedSyncChangeSetsContext = nil;
-    [_unappliedSyncChangesCoreDataFactory release], _unappliedSyncChangesCoreDataFactory = nil;
+    [_syncChangeSetReader release], _syncChangeSetReader = nil;
     [_unappliedSyncChangesContext release], _unappliedSyncChangesContext = nil;
     [_localSyncChangesToMergeCoreDataFactory release], _localSyncChangesToMergeCoreDataFactory = nil;
     [_localSyncChangesToMergeContext release], _localSyncChangesToMergeContext = nil;
     [_primaryPersistentStoreCoordinator release], _primaryPersistentStoreCoordinator = nil;
     [_backgroundApplicationContext release], _backgroundApplicationContext = nil;
-    
-    [_applicationObjectsBySyncIDByEntity release], _applicationObjectsBySyncIDByEntity = nil;
+    [_syncChangeApplier release], _syncChangeApplier = nil;
+    
+    [_syncPartitions release], _syncPartitions = nil;
+    [_subscribedSyncPartitionNames release], _subscribedSyncPartitionNames = nil;
+    [_syncPartitionNamesByEntityName release], _syncPartitionNamesByEntityName = nil;
+    [_syncPartitionNamesBySyncChangeSetIdentifier release], _syncPartitionNamesBySyncChangeSetIdentifier = nil;
+    [_localSyncChangeSetFileLocationsToUpload release], _localSyncChangeSetFileLocationsToUpload = nil;
+    [_synchronizationStateFileLocation release], _synchronizationStateFileLocation = nil;
+    [_synchronizationStateJournal release], _synchronizationStateJournal = nil;
+    [_syncChangeSetIdentifiersAppliedSinceCheckpoint release], _syncChangeSetIdentifiersAppliedSinceCheckpoint = nil;
+    [_syncChangeSetSequenceNumbersFileLocation release], _syncChangeSetSequenceNumbersFileLocation = nil;
+    [_syncChangeSetSequenceNumbers release], _syncChangeSetSequenceNumbers = nil;
+    [_listedSyncChangeSetSequenceNumbers release], _listedSyncChangeSetSequenceNumbers = nil;
     
     [super dealloc];
 }
@@ -1131,6 +1907,17 @@
     return _syncChangeSortDescriptors;
 }
 
+- (TICDSSyncChangeSetReader *)syncChangeSetReader
+{
+    if( _syncChangeSetReader ) {
+        return _syncChangeSetReader;
+    }
+    
+    _syncChangeSetReader = [[TICDSSyncChangeSetReader alloc] init];
+    
+    return _syncChangeSetReader;
+}
+
 - (NSManagedObjectContext *)appliedSyncChangeSetsContext
 {
     if( _appliedSyncChangeSetsContext ) {
@@ -1231,6 +2018,28 @@
     return _backgroundApplicationContext;
 }
 
+- (TICDSSyncChangeApplier *)syncChangeApplier
+{
+    if( _syncChangeApplier ) {
+        return _syncChangeApplier;
+    }
+    
+    _syncChangeApplier = [[TICDSSyncChangeApplier alloc] initWithManagedObjectContext:[self backgroundApplicationContext]];
+    
+    return _syncChangeApplier;
+}
+
+- (TICDSSynchronizationStateJournal *)synchronizationStateJournal
+{
+    if( _synchronizationStateJournal || ![self synchronizationStateFileLocation] ) {
+        return _synchronizationStateJournal;
+    }
+    
+    _synchronizationStateJournal = [[TICDSSynchronizationStateJournal alloc] initWithPath:[[self synchronizationStateFileLocation] path] integrityKey:[self integrityKey] syncPartitionNames:[self syncPartitionNamesToFetch]];
+    
+    return _synchronizationStateJournal;
+}
+
 - (NSNumberFormatter *)uuidPrefixFormatter
 {
     if (_uuidPrefixFormatter == nil) {
@@ -1251,21 +2060,25 @@
 @synthesize synchronizationWarnings = _synchronizationWarnings;
 
 @synthesize localSyncChangesToMergeLocation = _localSyncChangesToMergeLocation;
+@synthesize localSyncChangesJournalSegmentLocations = _localSyncChangesJournalSegmentLocations;
 @synthesize appliedSyncChangeSetsFileLocation = _appliedSyncChangeSetsFileLocation;
 @synthesize unappliedSyncChangesDirectoryLocation = _unappliedSyncChangesDirectoryLocation;
 @synthesize unappliedSyncChangeSetsFileLocation = _unappliedSyncChangeSetsFileLocation;
 @synthesize localRecentSyncFileLocation = _localRecentSyncFileLocation;
+@synthesize syncChangeSetSequenceNumbersFileLocation = _syncChangeSetSequenceNumbersFileLocation;
+@synthesize synchronizationStateFileLocation = _synchronizationStateFileLocation;
 
 @synthesize appliedSyncChangeSetsCoreDataFactory = _appliedSyncChangeSetsCoreDataFactory;
 @synthesize appliedSyncChangeSetsContext = _appliedSyncChangeSetsContext;
 @synthesize unappliedSyncChangeSetsCoreDataFactory = _unappliedSyncChangeSetsCoreDataFactory;
 @synthesize unappliedSyncChangeSetsContext = _unappliedSyncChangeSetsContext;
-@synthesize unappliedSyncChangesCoreDataFactory = _unappliedSyncChangesCoreDataFactory;
+@synthesize syncChangeSetReader = _syncChangeSetReader;
 @synthesize unappliedSyncChangesContext = _unappliedSyncChangesContext;
 @synthesize localSyncChangesToMergeCoreDataFactory = _localSyncChangesToMergeCoreDataFactory;
 @synthesize localSyncChangesToMergeContext = _localSyncChangesToMergeContext;
 @synthesize primaryPersistentStoreCoordinator = _primaryPersistentStoreCoordinator;
 @synthesize backgroundApplicationContext = _backgroundApplicationContext;
+@synthesize syncChangeApplier = _syncChangeApplier;
 
 @synthesize numberOfSyncChangeSetIDArraysToFetch = _numberOfSyncChangeSetIDArraysToFetch;
 @synthesize numberOfSyncChangeSetIDArraysFetched = _numberOfSyncChangeSetIDArraysFetched;
@@ -1275,6 +2088,12 @@
 @synthesize numberOfUnappliedSyncChangeSetsThatFailedToFetch = _numberOfUnappliedSyncChangeSetsThatFailedToFetch;
 
 @synthesize integrityKey = _integrityKey;
+@synthesize syncChangeSetsPerCheckpoint = _syncChangeSetsPerCheckpoint;
+@synthesize changedObjectsPerCheckpoint = _changedObjectsPerCheckpoint;
+@synthesize maximumConcurrentSyncChangeApplications = _maximumConcurrentSyncChangeApplications;
+@synthesize changedAttributesEncodingVersion = _changedAttributesEncodingVersion;
+@synthesize syncPartitions = _syncPartitions;
+@synthesize subscribedSyncPartitionNames = _subscribedSyncPartitionNames;
 @synthesize changeSetProgressString = _changeSetProgressString;
 @synthesize uuidPrefixFormatter = _uuidPrefixFormatter;
 
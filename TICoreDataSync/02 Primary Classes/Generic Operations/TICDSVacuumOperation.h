@@ -12,9 +12,14 @@
  
  The operation carries out the following tasks:
  
- 1. Find out the date of the oldest `WholeStore`.
- 2. Find out the date of the least recent client sync.
- 3. Remove all `SyncChangeSet` files older than whichever date is earlier.
+ 1. If the subclass supports sync change set sequence numbers (see `supportsSyncChangeSetSequenceNumbers`), fetch every client's RecentSync file, and find out the highest sequence number of this client's `SyncChangeSet` files in each sync partition that every client, and every `WholeStore`, has applied.
+ 2. Find out the date of the oldest `WholeStore`.
+ 3. Find out the date of the least recent client sync.
+ 4. Remove each `SyncChangeSet` file whose sequence number is no higher than the one found in step 1 for its partition. Remove files without a sequence number, or in a partition without one, if they're older than whichever date is earlier.
+ 
+ Each client numbers the sync change sets it uploads to each partition without gaps, and only records a sequence number as applied once every lower one has been applied too (see `+[TICDSSyncChangeSet sequenceNumberOfSyncChangeSetWithIdentifier:]`). Removing by sequence number therefore doesn't rely on clocks agreeing between clients, or on files arriving in order. A partition falls back to modification dates if any client or `WholeStore` that needs it hasn't recorded a sequence number for it, e.g. because it uses an older version of the framework.
+ 
+ If the document uses sync partitions, step 3 also determines the least recent sync date of the clients subscribed to each partition, and the `SyncChangeSet` files in each partition are removed using that partition's date (or the oldest `WholeStore` date, if earlier).
  
  Currently unimplemented, it also needs to carry out the following:
  1. Create sync commands to remove the ids of these sync change sets from each client's `AppliedSyncChangeSets.ticdsync` file.
@@ -28,10 +33,26 @@
 @interface TICDSVacuumOperation : TICDSOperation {
 @private
     NSDate *_earliestDateForFilesToKeep;
+    NSDictionary *_earliestDatesForFilesToKeepBySyncPartitionName;
+    NSDictionary *_syncPartitions;
+    
+    NSDictionary *_syncChangeSetSequenceNumbersBySyncPartitionName;
 }
 
 /** @name Methods Overridden by Subclasses */
 
+/** Indicate whether the subclass implements `fetchRecentSyncDictionariesAndWholeStoreClientIdentifiers`.
+ 
+ The default implementation returns `NO`, in which case old files are always found using modification dates.
+ 
+ @return `YES` if sync change set sequence numbers are supported, otherwise `NO`. */
+- (BOOL)supportsSyncChangeSetSequenceNumbers;
+
+/** Fetch the contents of every client's RecentSync file, and the identifiers of the clients that have uploaded a `WholeStore`.
+ 
+ This method must call `fetchedRecentSyncDictionaries:wholeStoreClientIdentifiers:` when finished. */
+- (void)fetchRecentSyncDictionariesAndWholeStoreClientIdentifiers;
+
 /** Determine the modification date of the oldest `WholeStore` file uploaded by any client.
  
  This method must call `foundOutDateOfOldestWholeStoreFile:` when finished. */
@@ -39,16 +60,24 @@
 
 /** Determine the date on which the least-recently-synchronized client last performed a sync.
  
- This method must call `foundOutLeastRecentClientSyncDate:` when finished. */
+ This method must call `foundOutLeastRecentClientSyncDate:` or `foundOutLeastRecentClientSyncDate:syncPartitionDates:` when finished. */
 - (void)findOutLeastRecentClientSyncDate;
 
-/** Remove all `SyncChangeSet` files uploaded by this client which are older than `earliestDateForFilesToKeep`.
+/** Remove all `SyncChangeSet` files uploaded by this client for which `shouldRemoveSyncChangeSetWithIdentifier:inSyncPartitionNamed:modificationDate:` returns `YES`.
  
  This method must call `removedOldSyncChangeSetFilesWithSuccess:` when finished. */
 - (void)removeOldSyncChangeSetFiles;
 
 /** @name Callbacks */
 
+/** Pass back the contents of every client's RecentSync file, and the clients that have uploaded a `WholeStore`.
+ 
+ If an error occurs, call `setError:` first, then specify `nil` for both parameters; the operation then falls back to modification dates.
+ 
+ @param someDictionaries The contents of each RecentSync file, including this client's, keyed by client identifier.
+ @param someIdentifiers The identifiers of the clients that have uploaded a `WholeStore`. */
+- (void)fetchedRecentSyncDictionaries:(NSDictionary *)someDictionaries wholeStoreClientIdentifiers:(NSArray *)someIdentifiers;
+
 /** Indicate the date of the oldest `WholeStore` file.
  
  If an error occurs, call `setError:` first, then specify `nil` for `aDate`. If no client has uploaded a `WholeStore`, specify `[NSDate date]`.
@@ -63,6 +92,36 @@
  @param aDate The date of the least recent sync. */
 - (void)foundOutLeastRecentClientSyncDate:(NSDate *)aDate;
 
+/** Indicate the date of the least recent sync, along with the least recent sync date of the clients subscribed to each sync partition.
+ 
+ If an error occurs, call `setError:` first, then specify `nil` for `aDate`.
+ 
+ @param aDate The date of the least recent sync.
+ @param partitionDates A dictionary of least recent sync dates, keyed by sync partition name, or `nil` if the document isn't partitioned. Partitions without a date use `aDate`. */
+- (void)foundOutLeastRecentClientSyncDate:(NSDate *)aDate syncPartitionDates:(NSDictionary *)partitionDates;
+
+/** @name Sync Partitions */
+
+/** The earliest modification date after which files in a given sync partition must be kept.
+ 
+ @param aPartitionName The name of the sync partition.
+ 
+ @return The date for the partition, or `earliestDateForFilesToKeep` if there is no separate date for that partition. */
+- (NSDate *)earliestDateForFilesToKeepInSyncPartitionNamed:(NSString *)aPartitionName;
+
+/** @name Removing Sync Change Sets */
+
+/** Determine whether one of this client's `SyncChangeSet` files is no longer needed by any client, so can be removed.
+ 
+ The file is removed if its sequence number is no higher than the partition's value in `syncChangeSetSequenceNumbersBySyncPartitionName`. If the identifier has no sequence number, or the partition has no value, it is removed if it is older than the partition's earliest date for files to keep.
+ 
+ @param anIdentifier The identifier of the sync change set.
+ @param aPartitionName The name of the sync partition containing the sync change set, or `nil` if it isn't in a partition.
+ @param aDate The modification date of the sync change set file.
+ 
+ @return `YES` if the sync change set can be removed, otherwise `NO`. */
+- (BOOL)shouldRemoveSyncChangeSetWithIdentifier:(NSString *)anIdentifier inSyncPartitionNamed:(NSString *)aPartitionName modificationDate:(NSDate *)aDate;
+
 /** Indicate whether the removal of old `SyncChangeSet` files was successful.
  
  If not, call `setError:` first, then specify `NO` for `success`.
@@ -75,4 +134,13 @@
 /** The earliest modification date after which files must be kept. */
 @property (nonatomic, retain ) NSDate *earliestDateForFilesToKeep;
 
+/** The earliest modification dates after which files must be kept in each sync partition, keyed by partition name. */
+@property (nonatomic, retain) NSDictionary *earliestDatesForFilesToKeepBySyncPartitionName;
+
+/** The document's sync partitions, as set on the document sync manager. */
+@property (nonatomic, retain) NSDictionary *syncPartitions;
+
+/** The highest sequence number of this client's `SyncChangeSet` files in each sync partition that every client and `WholeStore` needing them has applied, keyed by partition name, or `kTICDSDefaultSyncPartition` for files that aren't in a partition. Partitions without a value fall back to modification dates. */
+@property (nonatomic, retain) NSDictionary *syncChangeSetSequenceNumbersBySyncPartitionName;
+
 @end
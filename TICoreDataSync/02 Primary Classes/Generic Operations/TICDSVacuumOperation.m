@@ -10,6 +10,8 @@
 
 @interface TICDSVacuumOperation ()
 
+- (void)beginFetchingRecentSyncDictionariesAndWholeStoreClientIdentifiers;
+- (void)addSyncChangeSetSequenceNumbers:(NSDictionary *)someSequenceNumbers forSyncPartitionNames:(NSArray *)somePartitionNames toNeededSyncChangeSetSequenceNumbers:(NSDictionary *)neededSequenceNumbers;
 - (void)beginFindingOutDateOfOldestWholeStoreFile;
 - (void)beginFindingOutLeastRecentClientSyncDate;
 - (void)beginRemovingOldSyncChangeSetFiles;
@@ -20,9 +22,113 @@
 
 - (void)main
 {
+    if( [self supportsSyncChangeSetSequenceNumbers] ) {
+        [self beginFetchingRecentSyncDictionariesAndWholeStoreClientIdentifiers];
+        return;
+    }
+    
     [self beginFindingOutDateOfOldestWholeStoreFile];
 }
 
+#pragma mark - Fetching Sync Change Set Sequence Numbers
+- (void)beginFetchingRecentSyncDictionariesAndWholeStoreClientIdentifiers
+{
+    TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Fetching RecentSync files to find out which SyncChangeSet files every client has applied");
+    
+    [self fetchRecentSyncDictionariesAndWholeStoreClientIdentifiers];
+}
+
+- (void)fetchedRecentSyncDictionaries:(NSDictionary *)someDictionaries wholeStoreClientIdentifiers:(NSArray *)someIdentifiers
+{
+    if( !someDictionaries || !someIdentifiers ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to fetch RecentSync files, so falling back to modification dates: %@", [self error]);
+        [self beginFindingOutDateOfOldestWholeStoreFile];
+        return;
+    }
+    
+    NSMutableArray *partitionNames = [NSMutableArray arrayWithObject:kTICDSDefaultSyncPartition];
+    [partitionNames addObjectsFromArray:[[self syncPartitions] allKeys]];
+    
+    // the sequence numbers needed by each client and whole store, keyed by partition name, with NSNull for any that hasn't recorded one
+    NSMutableDictionary *neededSequenceNumbers = [NSMutableDictionary dictionaryWithCapacity:[partitionNames count]];
+    for( NSString *eachPartitionName in partitionNames ) {
+        [neededSequenceNumbers setValue:[NSMutableArray array] forKey:eachPartitionName];
+    }
+    
+    // a client registering later may download any whole store, including this client's own, whichever partitions it subscribes to
+    for( NSString *eachClientIdentifier in someIdentifiers ) {
+        NSDictionary *wholeStoreSequenceNumbers = [[[someDictionaries valueForKey:eachClientIdentifier] valueForKey:kTICDSWholeStoreSyncChangeSetSequenceNumbers] valueForKey:[self clientIdentifier]];
+        
+        [self addSyncChangeSetSequenceNumbers:wholeStoreSequenceNumbers forSyncPartitionNames:partitionNames toNeededSyncChangeSetSequenceNumbers:neededSequenceNumbers];
+    }
+    
+    for( NSString *eachClientIdentifier in someDictionaries ) {
+        if( [eachClientIdentifier isEqualToString:[self clientIdentifier]] ) {
+            continue;
+        }
+        
+        NSDictionary *recentSyncDictionary = [someDictionaries valueForKey:eachClientIdentifier];
+        NSDictionary *appliedSequenceNumbers = [[recentSyncDictionary valueForKey:kTICDSAppliedSyncChangeSetSequenceNumbers] valueForKey:[self clientIdentifier]];
+        
+        // Clients that don't list their subscriptions fetch every partition
+        NSArray *subscribedPartitionNames = [recentSyncDictionary valueForKey:kTICDSSubscribedSyncPartitionNames];
+        NSMutableArray *neededPartitionNames = [NSMutableArray arrayWithCapacity:[partitionNames count]];
+        for( NSString *eachPartitionName in partitionNames ) {
+            if( subscribedPartitionNames && ![eachPartitionName isEqualToString:kTICDSDefaultSyncPartition] && ![subscribedPartitionNames containsObject:eachPartitionName] ) {
+                continue;
+            }
+            
+            [neededPartitionNames addObject:eachPartitionName];
+        }
+        
+        [self addSyncChangeSetSequenceNumbers:appliedSequenceNumbers forSyncPartitionNames:neededPartitionNames toNeededSyncChangeSetSequenceNumbers:neededSequenceNumbers];
+    }
+    
+    NSMutableDictionary *sequenceNumbersByPartitionName = [NSMutableDictionary dictionaryWithCapacity:[partitionNames count]];
+    for( NSString *eachPartitionName in partitionNames ) {
+        NSArray *eachNeededSequenceNumbers = [neededSequenceNumbers valueForKey:eachPartitionName];
+        
+        if( [eachNeededSequenceNumbers count] < 1 || [eachNeededSequenceNumbers containsObject:[NSNull null]] ) {
+            TICDSLog(TICDSLogVerbosityEveryStep, @"Not every client has recorded the sync change sets it has applied in sync partition %@, so falling back to modification dates", eachPartitionName);
+            continue;
+        }
+        
+        NSNumber *lowestSequenceNumber = [eachNeededSequenceNumbers valueForKeyPath:@"@min.self"];
+        
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Highest sequence number of sync change sets to remove in sync partition %@ identified as %@", eachPartitionName, lowestSequenceNumber);
+        [sequenceNumbersByPartitionName setValue:lowestSequenceNumber forKey:eachPartitionName];
+    }
+    [self setSyncChangeSetSequenceNumbersBySyncPartitionName:sequenceNumbersByPartitionName];
+    
+    // files without sequence numbers, and partitions without a sequence number, still need dates
+    [self beginFindingOutDateOfOldestWholeStoreFile];
+}
+
+- (void)addSyncChangeSetSequenceNumbers:(NSDictionary *)someSequenceNumbers forSyncPartitionNames:(NSArray *)somePartitionNames toNeededSyncChangeSetSequenceNumbers:(NSDictionary *)neededSequenceNumbers
+{
+    for( NSString *eachPartitionName in somePartitionNames ) {
+        id sequenceNumber = [someSequenceNumbers valueForKey:eachPartitionName];
+        
+        if( ![sequenceNumber isKindOfClass:[NSNumber class]] ) {
+            sequenceNumber = [NSNull null];
+        }
+        
+        [[neededSequenceNumbers valueForKey:eachPartitionName] addObject:sequenceNumber];
+    }
+}
+
+#pragma mark Overridden Methods
+- (BOOL)supportsSyncChangeSetSequenceNumbers
+{
+    return NO;
+}
+
+- (void)fetchRecentSyncDictionariesAndWholeStoreClientIdentifiers
+{
+    [self setError:[TICDSError errorWithCode:TICDSErrorCodeMethodNotOverriddenBySubclass classAndMethod:__PRETTY_FUNCTION__]];
+    [self fetchedRecentSyncDictionaries:nil wholeStoreClientIdentifiers:nil];
+}
+
 #pragma mark - Checking Oldest WholeStore File Date
 - (void)beginFindingOutDateOfOldestWholeStoreFile
 {
@@ -61,6 +167,11 @@
 }
 
 - (void)foundOutLeastRecentClientSyncDate:(NSDate *)aDate
+{
+    [self foundOutLeastRecentClientSyncDate:aDate syncPartitionDates:nil];
+}
+
+- (void)foundOutLeastRecentClientSyncDate:(NSDate *)aDate syncPartitionDates:(NSDictionary *)partitionDates
 {
     if( !aDate ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to determine the least recent client sync date");
@@ -70,13 +181,38 @@
     
     TICDSLog(TICDSLogVerbosityEveryStep, @"Least recent client sync date identified as %@", aDate);
     
-    if( [[self earliestDateForFilesToKeep] compare:aDate] == NSOrderedDescending ) {
+    NSDate *oldestWholeStoreDate = [self earliestDateForFilesToKeep];
+    
+    if( [oldestWholeStoreDate compare:aDate] == NSOrderedDescending ) {
         [self setEarliestDateForFilesToKeep:aDate];
     }
     
+    if( [partitionDates count] > 0 ) {
+        NSMutableDictionary *datesByPartitionName = [NSMutableDictionary dictionaryWithCapacity:[partitionDates count]];
+        for( NSString *eachPartitionName in partitionDates ) {
+            NSDate *eachDate = [partitionDates valueForKey:eachPartitionName];
+            
+            if( [oldestWholeStoreDate compare:eachDate] == NSOrderedAscending ) {
+                eachDate = oldestWholeStoreDate;
+            }
+            
+            TICDSLog(TICDSLogVerbosityEveryStep, @"Earliest date for files to keep in sync partition %@ identified as %@", eachPartitionName, eachDate);
+            [datesByPartitionName setValue:eachDate forKey:eachPartitionName];
+        }
+        [self setEarliestDatesForFilesToKeepBySyncPartitionName:datesByPartitionName];
+    }
+    
     [self beginRemovingOldSyncChangeSetFiles];
 }
 
+#pragma mark Sync Partitions
+- (NSDate *)earliestDateForFilesToKeepInSyncPartitionNamed:(NSString *)aPartitionName
+{
+    NSDate *date = [[self earliestDatesForFilesToKeepBySyncPartitionName] valueForKey:aPartitionName];
+    
+    return date ? date : [self earliestDateForFilesToKeep];
+}
+
 #pragma mark Overridden Method
 - (void)findOutLeastRecentClientSyncDate
 {
@@ -85,6 +221,20 @@
 }
 
 #pragma mark - Remove Old Sync Change Set Files
+- (BOOL)shouldRemoveSyncChangeSetWithIdentifier:(NSString *)anIdentifier inSyncPartitionNamed:(NSString *)aPartitionName modificationDate:(NSDate *)aDate
+{
+    NSNumber *highestSequenceNumberToRemove = [[self syncChangeSetSequenceNumbersBySyncPartitionName] valueForKey:aPartitionName ? aPartitionName : kTICDSDefaultSyncPartition];
+    NSUInteger sequenceNumber = [TICDSSyncChangeSet sequenceNumberOfSyncChangeSetWithIdentifier:anIdentifier];
+    
+    if( highestSequenceNumberToRemove && sequenceNumber != NSNotFound ) {
+        return sequenceNumber <= [highestSequenceNumberToRemove unsignedIntegerValue];
+    }
+    
+    NSDate *earliestDateForFilesToKeep = aPartitionName ? [self earliestDateForFilesToKeepInSyncPartitionNamed:aPartitionName] : [self earliestDateForFilesToKeep];
+    
+    return [aDate compare:earliestDateForFilesToKeep] == NSOrderedAscending;
+}
+
 - (void)beginRemovingOldSyncChangeSetFiles
 {
     TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Removing unneeded SyncChangeSet files uploaded by this client");
@@ -94,6 +244,11 @@
 
 - (void)removedOldSyncChangeSetFilesWithSuccess:(BOOL)success
 {
+    if( !success && [self isCancelled] ) {
+        [self operationWasCancelled];
+        return;
+    }
+    
     if( !success ) {
         TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to remove old sync change set files");
         [self operationDidFailToComplete];
@@ -115,11 +270,17 @@
 - (void)dealloc
 {
     [_earliestDateForFilesToKeep release], _earliestDateForFilesToKeep = nil;
+    [_earliestDatesForFilesToKeepBySyncPartitionName release], _earliestDatesForFilesToKeepBySyncPartitionName = nil;
+    [_syncPartitions release], _syncPartitions = nil;
+    [_syncChangeSetSequenceNumbersBySyncPartitionName release], _syncChangeSetSequenceNumbersBySyncPartitionName = nil;
     
     [super dealloc];
 }
 
 #pragma mark - Properties
 @synthesize earliestDateForFilesToKeep = _earliestDateForFilesToKeep;
+@synthesize earliestDatesForFilesToKeepBySyncPartitionName = _earliestDatesForFilesToKeepBySyncPartitionName;
+@synthesize syncPartitions = _syncPartitions;
+@synthesize syncChangeSetSequenceNumbersBySyncPartitionName = _syncChangeSetSequenceNumbersBySyncPartitionName;
 
 @end
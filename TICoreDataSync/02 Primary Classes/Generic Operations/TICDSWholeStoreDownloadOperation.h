@@ -15,6 +15,7 @@
  1. If `requestedWholeStoreClientIdentifier` is not set, determine which client uploaded a store most recently, and set `requestedWholeStoreClientIdentifier`.
  1. Download the whole store file from the `requestedWholeStoreClientIdentifier`'s directory.
  2. Download the applied sync change sets file that goes with this whole store.
+ 3. Fetch the sync change set sequence numbers recorded when this whole store was uploaded, which the sync manager then uses as the sequence numbers this client has applied.
  
  Operations are typically created automatically by the relevant sync manager.
  
@@ -26,6 +27,7 @@
     
     NSURL *_localWholeStoreFileLocation;
     NSURL *_localAppliedSyncChangeSetsFileLocation;
+    NSDictionary *_syncChangeSetSequenceNumbers;
     
     NSString *_integrityKey;
 }
@@ -47,6 +49,13 @@
  This method must call `downloadedAppliedSyncChangeSetsFileWithSuccess:` when finished. */
 - (void)downloadAppliedSyncChangeSetsFile;
 
+/** Fetch the sync change set sequence numbers that the `requestedWholeStoreClientIdentifier`'s RecentSync file records under `kTICDSWholeStoreSyncChangeSetSequenceNumbers`.
+ 
+ The default implementation passes back `nil`, for sync managers whose vacuum doesn't use sequence numbers.
+ 
+ This method must call `fetchedSyncChangeSetSequenceNumbersOfWholeStore:` when finished. */
+- (void)fetchSyncChangeSetSequenceNumbersOfWholeStore;
+
 /** Fetch the integrity key for this document.
  
  This method must call `fetchedRemoteIntegrityKey:` to provide the key. */
@@ -75,6 +84,11 @@
  @param success `YES` if the applied sync change sets file was downloaded, otherwise `NO`. */
 - (void)downloadedAppliedSyncChangeSetsFileWithSuccess:(BOOL)success;
 
+/** Pass back the sync change set sequence numbers recorded when the whole store was uploaded.
+ 
+ @param someSequenceNumbers The sequence numbers, or `nil` if none were recorded or they couldn't be fetched. */
+- (void)fetchedSyncChangeSetSequenceNumbersOfWholeStore:(NSDictionary *)someSequenceNumbers;
+
 /** Pass back the remote integrity key for this document.
  
  If an error occurred, call `setError:` first, then specify `nil` for `aKey`.
@@ -93,6 +107,9 @@
 /** The destination for the applied sync change sets file. */
 @property (retain) NSURL *localAppliedSyncChangeSetsFileLocation;
 
+/** The sync change set sequence numbers covered by the downloaded applied sync change sets file, or `nil` if none were recorded. */
+@property (retain) NSDictionary *syncChangeSetSequenceNumbers;
+
 /** The integrity key of the newly-downloaded store. */
 @property (retain) NSString *integrityKey;
 
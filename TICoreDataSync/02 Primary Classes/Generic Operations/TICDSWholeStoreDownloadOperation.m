@@ -13,6 +13,7 @@
 - (void)beginCheckForMostRecentClientWholeStore;
 - (void)beginDownloadOfWholeStoreFile;
 - (void)beginDownloadOfAppliedSyncChangeSetsFile;
+- (void)beginFetchOfSyncChangeSetSequenceNumbersOfWholeStore;
 - (void)beginDownloadOfIntegrityKey;
 
 @end
@@ -121,7 +122,7 @@
     }
     
     TICDSLog(TICDSLogVerbosityStartAndEndOfEachOperationPhase, @"Successfully downloaded applied sync change sets file");
-    [self beginDownloadOfIntegrityKey];
+    [self beginFetchOfSyncChangeSetSequenceNumbersOfWholeStore];
 }
 
 #pragma mark Overridden Method
@@ -131,6 +132,32 @@
     [self downloadedAppliedSyncChangeSetsFileWithSuccess:NO];
 }
 
+#pragma mark - Sync Change Set Sequence Numbers
+- (void)beginFetchOfSyncChangeSetSequenceNumbersOfWholeStore
+{
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Fetching the sync change set sequence numbers recorded with the whole store");
+    
+    [self fetchSyncChangeSetSequenceNumbersOfWholeStore];
+}
+
+- (void)fetchedSyncChangeSetSequenceNumbersOfWholeStore:(NSDictionary *)someSequenceNumbers
+{
+    // without them, this client's sequence numbers start again from the sets it lists, and other clients' vacuums fall back to modification dates until they advance
+    if( !someSequenceNumbers ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"No sync change set sequence numbers were recorded with the whole store");
+    }
+    
+    [self setSyncChangeSetSequenceNumbers:someSequenceNumbers];
+    
+    [self beginDownloadOfIntegrityKey];
+}
+
+#pragma mark Overridden Method
+- (void)fetchSyncChangeSetSequenceNumbersOfWholeStore
+{
+    [self fetchedSyncChangeSetSequenceNumbersOfWholeStore:nil];
+}
+
 #pragma mark - Integrity Key
 - (void)beginDownloadOfIntegrityKey
 {
@@ -161,6 +188,7 @@
     [_requestedWholeStoreClientIdentifier release], _requestedWholeStoreClientIdentifier = nil;
     [_localWholeStoreFileLocation release], _localWholeStoreFileLocation = nil;
     [_localAppliedSyncChangeSetsFileLocation release], _localAppliedSyncChangeSetsFileLocation = nil;
+    [_syncChangeSetSequenceNumbers release], _syncChangeSetSequenceNumbers = nil;
     [_integrityKey release], _integrityKey = nil;
 
     [super dealloc];
@@ -171,6 +199,7 @@
 @synthesize requestedWholeStoreClientIdentifier = _requestedWholeStoreClientIdentifier;
 @synthesize localWholeStoreFileLocation = _localWholeStoreFileLocation;
 @synthesize localAppliedSyncChangeSetsFileLocation = _localAppliedSyncChangeSetsFileLocation;
+@synthesize syncChangeSetSequenceNumbers = _syncChangeSetSequenceNumbers;
 @synthesize integrityKey = _integrityKey;
 
 @end
@@ -22,6 +22,7 @@
  8. Check whether a directory exists for this client inside the document's `WholeStore` directory.
  9. If so, delete it.
  10. Copy the temporary directory the non-temporary location.
+ 11. Record the sync change set sequence numbers covered by the uploaded whole store, both this client's own and those it has applied from other clients, in the local RecentSync file, to be uploaded by the next synchronization.
  
  Operations are typically created automatically by the relevant sync manager.
  
@@ -31,6 +32,9 @@
 @private
     NSURL *_localWholeStoreFileLocation;
     NSURL *_localAppliedSyncChangeSetsFileLocation;
+    NSURL *_localRecentSyncFileLocation;
+    NSURL *_syncChangeSetSequenceNumbersFileLocation;
+    NSDictionary *_syncChangeSetSequenceNumbers;
     
     NSPersistentStoreCoordinator *_primaryPersistentStoreCoordinator;
     NSManagedObjectContext *_backgroundApplicationContext;
@@ -154,6 +158,19 @@
 /** The location of the applied sync change sets file to upload. */
 @property (retain) NSURL *localAppliedSyncChangeSetsFileLocation;
 
+/** The location of this client's local RecentSync file.
+ 
+ The sync change set sequence numbers in this file when the operation starts are all covered by the applied sync change sets file uploaded with the whole store, so once the upload has finished they are recorded in the file under `kTICDSWholeStoreSyncChangeSetSequenceNumbers`. */
+@property (retain) NSURL *localRecentSyncFileLocation;
+
+/** The location of the file holding the sequence numbers this client last gave its sync change sets in each sync partition.
+ 
+ The whole store contains every sync change set this client has created, so these are recorded under this client's identifier alongside the sequence numbers from `localRecentSyncFileLocation`. */
+@property (retain) NSURL *syncChangeSetSequenceNumbersFileLocation;
+
+/** The sync change set sequence numbers covered by the whole store, keyed by the identifier of the client that created the sync change sets, read when the operation started. */
+@property (retain) NSDictionary *syncChangeSetSequenceNumbers;
+
 /** The persistent store coordinator to use when creating the background context. */
 @property (retain) NSPersistentStoreCoordinator *primaryPersistentStoreCoordinator;
 
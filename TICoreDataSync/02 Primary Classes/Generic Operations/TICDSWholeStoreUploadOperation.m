@@ -20,6 +20,7 @@
 - (void)beginCheckForThisClientWholeStoreDirectory;
 - (void)beginDeletingThisClientWholeStoreDirectory;
 - (void)beginCopyingThisClientTemporaryWholeStoreDirectoryToThisClientWholeStoreDirectory;
+- (void)recordSyncChangeSetSequenceNumbersOfUploadedWholeStore;
 
 @end
 
@@ -27,6 +28,19 @@
 
 - (void)main
 {
+    // read before the applied sync change sets file is uploaded, so that file contains at least these sync change sets
+    if( [self localRecentSyncFileLocation] ) {
+        NSMutableDictionary *sequenceNumbers = [NSMutableDictionary dictionaryWithDictionary:[[NSDictionary dictionaryWithContentsOfURL:[self localRecentSyncFileLocation]] valueForKey:kTICDSAppliedSyncChangeSetSequenceNumbers]];
+        
+        // the whole store also contains every sync change set this client has created
+        NSDictionary *ownSequenceNumbers = [self syncChangeSetSequenceNumbersFileLocation] ? [NSDictionary dictionaryWithContentsOfURL:[self syncChangeSetSequenceNumbersFileLocation]] : nil;
+        if( [ownSequenceNumbers count] > 0 && [self clientIdentifier] ) {
+            [sequenceNumbers setValue:ownSequenceNumbers forKey:[self clientIdentifier]];
+        }
+        
+        [self setSyncChangeSetSequenceNumbers:sequenceNumbers];
+    }
+    
     [self beginCheckForMissingSyncIDAttributes];
 }
 
@@ -355,9 +369,30 @@
     
     TICDSLog(TICDSLogVerbosityStartAndEndOfMainOperationPhase, @"Finished copying WholeStore directory");
     
+    [self recordSyncChangeSetSequenceNumbersOfUploadedWholeStore];
+    
     [self operationDidCompleteSuccessfully];
 }
 
+- (void)recordSyncChangeSetSequenceNumbersOfUploadedWholeStore
+{
+    if( ![self syncChangeSetSequenceNumbers] ) {
+        return;
+    }
+    
+    NSMutableDictionary *recentSyncDictionary = [NSMutableDictionary dictionaryWithContentsOfURL:[self localRecentSyncFileLocation]];
+    if( !recentSyncDictionary ) {
+        recentSyncDictionary = [NSMutableDictionary dictionary];
+    }
+    
+    [recentSyncDictionary setValue:[self syncChangeSetSequenceNumbers] forKey:kTICDSWholeStoreSyncChangeSetSequenceNumbers];
+    
+    if( ![recentSyncDictionary writeToURL:[self localRecentSyncFileLocation] atomically:YES] ) {
+        // other clients' vacuums fall back to modification dates until this is recorded, so this isn't fatal
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to record the sync change set sequence numbers of the uploaded whole store");
+    }
+}
+
 #pragma mark Overridden Method
 - (void)copyThisClientTemporaryWholeStoreDirectoryToThisClientWholeStoreDirectory
 {
@@ -387,6 +422,9 @@
 {
     [_localWholeStoreFileLocation release], _localWholeStoreFileLocation = nil;
     [_localAppliedSyncChangeSetsFileLocation release], _localAppliedSyncChangeSetsFileLocation = nil;
+    [_localRecentSyncFileLocation release], _localRecentSyncFileLocation = nil;
+    [_syncChangeSetSequenceNumbersFileLocation release], _syncChangeSetSequenceNumbersFileLocation = nil;
+    [_syncChangeSetSequenceNumbers release], _syncChangeSetSequenceNumbers = nil;
     [_primaryPersistentStoreCoordinator release], _primaryPersistentStoreCoordinator = nil;
     [_backgroundApplicationContext release], _backgroundApplicationContext = nil;
 
@@ -412,6 +450,9 @@
 #pragma mark Properties
 @synthesize localWholeStoreFileLocation = _localWholeStoreFileLocation;
 @synthesize localAppliedSyncChangeSetsFileLocation = _localAppliedSyncChangeSetsFileLocation;
+@synthesize localRecentSyncFileLocation = _localRecentSyncFileLocation;
+@synthesize syncChangeSetSequenceNumbersFileLocation = _syncChangeSetSequenceNumbersFileLocation;
+@synthesize syncChangeSetSequenceNumbers = _syncChangeSetSequenceNumbers;
 @synthesize primaryPersistentStoreCoordinator = _primaryPersistentStoreCoordinator;
 @synthesize backgroundApplicationContext = _backgroundApplicationContext;
 
@@ -283,6 +283,12 @@
 /** The path to the `DeletedDocuments` directory inside the `Information` directory, relative ot the root of the remote file structure. */
 @property (nonatomic, readonly) NSString *relativePathToInformationDeletedDocumentsDirectory;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory, relative to the root of the remote file structure. */
+@property (nonatomic, readonly) NSString *relativePathToInformationDocumentCatalogFile;
+
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory, relative to the root of the remote file structure. */
+@property (nonatomic, readonly) NSString *relativePathToInformationClientRegistryFile;
+
 /** The path to the `Encryption` directory, relative to the root of the remote file structure. */
 @property (nonatomic, readonly) NSString *relativePathToEncryptionDirectory;
 
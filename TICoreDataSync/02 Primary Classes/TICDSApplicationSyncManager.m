@@ -836,6 +836,16 @@ id gTICDSDefaultApplicationSyncManager = nil;
     return [[self relativePathToInformationDirectory] stringByAppendingPathComponent:TICDSDeletedDocumentsDirectoryName];
 }
 
+- (NSString *)relativePathToInformationDocumentCatalogFile
+{
+    return [[self relativePathToInformationDirectory] stringByAppendingPathComponent:TICDSDocumentCatalogFilename];
+}
+
+- (NSString *)relativePathToInformationClientRegistryFile
+{
+    return [[self relativePathToInformationDirectory] stringByAppendingPathComponent:TICDSClientRegistryFilename];
+}
+
 - (NSString *)relativePathToDocumentsDirectory
 {
     return TICDSDocumentsDirectoryName;
@@ -26,6 +26,15 @@
     
     BOOL _shouldUseEncryption;
     
+    NSDictionary *_syncPartitions;
+    NSSet *_subscribedSyncPartitionNames;
+    
+    NSUInteger _syncChangeSetsPerApplyCheckpoint;
+    NSUInteger _changedObjectsPerApplyCheckpoint;
+    NSUInteger _maximumConcurrentSyncChangeApplications;
+    NSUInteger _changedAttributesEncodingVersion;
+    BOOL _carriesRelationshipsInInsertionSyncChanges;
+    
     BOOL _mustUploadStoreAfterRegistration;
     
     id <TICDSDocumentSyncManagerDelegate> _delegate;
@@ -42,6 +51,7 @@
     TICDSSynchronizedManagedObjectContext *_primaryDocumentMOC;
     TICoreDataFactory *_coreDataFactory;
     NSMutableDictionary *_syncChangesMOCs;
+    TICDSSyncChangesWriter *_syncChangesWriter;
     
     NSOperationQueue *_registrationQueue;
     NSOperationQueue *_synchronizationQueue;
@@ -261,6 +271,8 @@
  
  This method is called automatically by `TICDSSynchronizedManagedObjectContext` when it has successfully completed a `save:`.
  
+ The sync changes created during the save are captured as immutable dictionaries and handed to the `syncChangesWriter`, so they are written to the `UnsynchronizedSyncChanges` journal in the background rather than on the saving thread.
+ 
  @param aMoc The synchronized managed object context.
  */
 - (void)synchronizedMOCDidSave:(TICDSSynchronizedManagedObjectContext *)aMoc;
@@ -290,6 +302,47 @@
  This value is set automatically by the application sync manager. */
 @property (nonatomic, assign) BOOL shouldUseEncryption;
 
+/** The document's sync partitions, used to let clients download only the sync changes for the entities they use.
+ 
+ Keys are partition names, values are `NSSet`s or `NSArray`s of the names of the entities in each partition. Sync changes for each partition are uploaded as separate change sets, in a subdirectory of the client's `SyncChanges` directory named after the partition. Sync changes for entities not in any partition (the default partition) are uploaded as before.
+ 
+ Every client synchronizing a document must use the same partitions. Relationships between entities in different partitions are only set on clients that subscribe to both partitions.
+ 
+ Set this before synchronizing; `nil` (the default) turns partitioning off. Partitions are currently only supported by the file manager-based sync managers; other sync managers upload all sync changes to the default partition. */
+@property (nonatomic, retain) NSDictionary *syncPartitions;
+
+/** The names of the sync partitions this client fetches and applies sync changes for, or `nil` (the default) to fetch every partition.
+ 
+ Sync changes in the default partition are always fetched. */
+@property (nonatomic, retain) NSSet *subscribedSyncPartitionNames;
+
+/** The number of sync change sets applied during synchronization before the changes made so far are saved, and memory freed.
+ 
+ Leave as `0` to use the synchronization operation's default. */
+@property (nonatomic, assign) NSUInteger syncChangeSetsPerApplyCheckpoint;
+
+/** The number of objects changed during synchronization before the changes made so far are saved, and memory freed; checked after applying each sync change set.
+ 
+ Leave as `0` to use the synchronization operation's default. */
+@property (nonatomic, assign) NSUInteger changedObjectsPerApplyCheckpoint;
+
+/** The maximum number of managed object contexts on which the insertions and attribute changes in a large sync change set are applied at once, after being split into groups of changes to unrelated objects.
+ 
+ Leave as `0` to use the synchronization operation's default, which applies every change on a single context. */
+@property (nonatomic, assign) NSUInteger maximumConcurrentSyncChangeApplications;
+
+/** The version of `TICDSChangedAttributesCodec` with which to encode the changed values in this client's sync change sets, which are smaller and faster to read and write than the keyed archives used by default.
+ 
+ Version `2` also lets changes to the attributes returned by `+[TICDSSynchronizedManagedObject keysForWhichSyncChangesWillCarryDeltas]` carry a delta against the previous value, rather than the whole new value; sets without deltas are still readable by clients that support version `1`.
+ 
+ Each sync change set records its encoding, but clients that predate the codec can't read encoded sets, and clients refuse to apply sets encoded with a newer version than they support; only set this once every client synchronizing the document supports the version. Leave as `0` (the default) to use keyed archives. */
+@property (nonatomic, assign) NSUInteger changedAttributesEncodingVersion;
+
+/** Whether the insertion sync changes created for this document carry the inserted objects' relationships, rather than creating a separate relationship sync change for each related object.
+ 
+ Sync change sets containing such insertions record it in their metadata, and clients refuse to apply sets that use a newer form of inline relationships than they support. Clients that predate inline relationships apply the insertions without their relationships, however, so only set this once every client synchronizing the document supports them. Defaults to `NO`. */
+@property (nonatomic, assign) BOOL carriesRelationshipsInInsertionSyncChanges;
+
 /** Used internally to indicate whether the document sync manager must upload the store after registration has completed.
  
  This will be `YES` if this is the first time this document has been registered. */
@@ -348,6 +401,9 @@
 /** The `TICoreDataFactory` object used for SyncChange managed object contexts. */
 @property (nonatomic, retain) TICoreDataFactory *coreDataFactory;
 
+/** The `TICDSSyncChangesWriter` used to append sync changes to the `UnsynchronizedSyncChanges` journal on a background queue. */
+@property (nonatomic, retain) TICDSSyncChangesWriter *syncChangesWriter;
+
 #pragma mark - Operation Queues
 /** @name Operation Queues */
 
@@ -377,6 +433,12 @@
 /** The path to the `DeletedDocuments` directory inside the `Information` directory, relative to the root of the remote file structure. */
 @property (nonatomic, readonly) NSString * relativePathToInformationDeletedDocumentsDirectory;
 
+/** The path to the `DocumentCatalog.plist` file inside the `Information` directory, relative to the root of the remote file structure. */
+@property (nonatomic, readonly) NSString *relativePathToInformationDocumentCatalogFile;
+
+/** The path to the `ClientRegistry.plist` file inside the `Information` directory, relative to the root of the remote file structure. */
+@property (nonatomic, readonly) NSString *relativePathToInformationClientRegistryFile;
+
 /** The path to this document's `identifier.plist` file inside the `DeletedDocuments` directory, relative to the root of the remote file structure. */
 @property (nonatomic, readonly) NSString *relativePathToDeletedDocumentsThisDocumentIdentifierPlistFile;
 
@@ -441,9 +503,14 @@
 /** The path to the `SyncChangesBeingSynchronized.syncchg` file, located in the `helperFileDirectoryLocation`. */
 @property (nonatomic, readonly) NSString *syncChangesBeingSynchronizedStorePath;
 
-/** The path to the `UnsynchronizedSyncChanges.syncchg` file, located in the `helperFileDirectoryLocation`. */
+/** The path to the `UnsynchronizedSyncChanges.syncchg` file, located in the `helperFileDirectoryLocation`.
+ 
+ This store is no longer written; if one is left over from an earlier version of the framework, it is synchronized in place of `SyncChangesBeingSynchronized.syncchg`. */
 @property (nonatomic, readonly) NSString *unsynchronizedSyncChangesStorePath;
 
+/** The path to the `UnsynchronizedSyncChanges` journal directory, located in the `helperFileDirectoryLocation`. */
+@property (nonatomic, readonly) NSString *unsynchronizedSyncChangesJournalDirectoryPath;
+
 /** The integrity key used to check whether the synchronization data matches what's expected. */
 @property (nonatomic, retain) NSString *integrityKey;
 
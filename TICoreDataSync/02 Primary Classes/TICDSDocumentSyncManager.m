@@ -20,7 +20,7 @@
 
 - (void)startSynchronizationProcess;
 - (void)bailFromSynchronizationProcessWithError:(NSError *)anError;
-- (void)moveUnsynchronizedSyncChangesToMergeLocation;
+- (NSArray *)sealUnsynchronizedSyncChanges;
 
 - (void)startVacuumProcess;
 - (void)bailFromVacuumProcessWithError:(NSError *)anError;
@@ -526,15 +526,7 @@
     [self ti_alertDelegateWithSelector:@selector(documentSyncManagerDidBeginUploadingWholeStore:)];
     
     TICDSLog(TICDSLogVerbosityEveryStep, @"Checking to see if there are unsynchronized SyncChanges");
-    NSError *anyError = nil;
-    NSUInteger count = [TICDSSyncChange ti_numberOfObjectsInManagedObjectContext:[self syncChangesMocForDocumentMoc:[self primaryDocumentMOC]] error:&anyError];
-    if( anyError ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to count number of SyncChange objects: %@", anyError);
-        [self bailFromUploadProcessWithError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataFetchError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-        return;
-    }
-    
-    if( count > 0 ) {
+    if( [[self syncChangesWriter] hasUnsynchronizedSyncChanges] ) {
         TICDSLog(TICDSLogVerbosityEveryStep, @"There are unsynchronized local Sync Changes so cannot upload whole store");
         [self bailFromUploadProcessWithError:[TICDSError errorWithCode:TICDSErrorCodeWholeStoreCannotBeUploadedWhileThereAreUnsynchronizedSyncChanges classAndMethod:__PRETTY_FUNCTION__]];
         return;
@@ -558,6 +550,7 @@
     }
     
     [operation setShouldUseEncryption:[self shouldUseEncryption]];
+    [operation setClientIdentifier:[self clientIdentifier]];
     [operation setLocalWholeStoreFileLocation:storeURL];
     
     [operation configureBackgroundApplicationContextForPersistentStoreCoordinator:[[self primaryDocumentMOC] persistentStoreCoordinator]];
@@ -566,6 +559,8 @@
     appliedSyncChangeSetsFilePath = [appliedSyncChangeSetsFilePath stringByAppendingPathComponent:TICDSAppliedSyncChangeSetsFilename];
     
     [operation setLocalAppliedSyncChangeSetsFileLocation:[NSURL fileURLWithPath:appliedSyncChangeSetsFilePath]];
+    [operation setLocalRecentSyncFileLocation:[NSURL fileURLWithPath:[[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:[self clientIdentifier]] stringByAppendingPathExtension:TICDSRecentSyncFileExtension]]];
+    [operation setSyncChangeSetSequenceNumbersFileLocation:[NSURL fileURLWithPath:[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSSyncChangeSetSequenceNumbersFilename]]];
     
     [[self otherTasksQueue] addOperation:operation];
 }
@@ -713,6 +708,24 @@
         return;
     }
     
+    // The applied sequence numbers must describe the new AppliedSyncChanges, or the vacuum could remove sets this store hasn't got
+    NSString *recentSyncFilePath = [[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:[self clientIdentifier]] stringByAppendingPathExtension:TICDSRecentSyncFileExtension];
+    NSMutableDictionary *recentSyncDictionary = [NSMutableDictionary dictionaryWithContentsOfFile:recentSyncFilePath];
+    if( !recentSyncDictionary ) {
+        recentSyncDictionary = [NSMutableDictionary dictionary];
+    }
+    
+    [recentSyncDictionary setValue:[anOperation syncChangeSetSequenceNumbers] forKey:kTICDSAppliedSyncChangeSetSequenceNumbers];
+    
+    if( ![recentSyncDictionary writeToFile:recentSyncFilePath atomically:YES] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to record the sync change set sequence numbers of the downloaded store, so removing the local RecentSync file");
+        
+        if( [[self fileManager] fileExistsAtPath:recentSyncFilePath] && ![[self fileManager] removeItemAtPath:recentSyncFilePath error:&anyError] ) {
+            [self bailFromDownloadPostProcessingWithFileManagerError:anyError];
+            return;
+        }
+    }
+    
     [self ti_alertDelegateWithSelector:@selector(documentSyncManager:didReplaceStoreWithDownloadedStoreAtURL:), finalWholeStoreLocation];
     
     TICDSLog(TICDSLogVerbosityEveryStep, @"Updating local integrity key to match newly-downloaded store");
@@ -762,7 +775,10 @@
     [self postIncreaseActivityNotification];
     [self ti_alertDelegateWithSelector:@selector(documentSyncManagerDidBeginSynchronizing:)];
     
-    [self moveUnsynchronizedSyncChangesToMergeLocation];
+    NSArray *journalSegmentPaths = [self sealUnsynchronizedSyncChanges];
+    if( !journalSegmentPaths ) {
+        return;
+    }
     
     TICDSSynchronizationOperation *operation = [self synchronizationOperation];
     
@@ -775,18 +791,43 @@
     [operation setShouldUseEncryption:[self shouldUseEncryption]];
     [operation setClientIdentifier:[self clientIdentifier]];
     [operation setIntegrityKey:[self integrityKey]];
-    // Set location of sync changes to merge file
+    [operation setSyncPartitions:[self syncPartitions]];
+    [operation setSubscribedSyncPartitionNames:[self subscribedSyncPartitionNames]];
+    
+    if( [self syncChangeSetsPerApplyCheckpoint] > 0 ) {
+        [operation setSyncChangeSetsPerCheckpoint:[self syncChangeSetsPerApplyCheckpoint]];
+    }
+    
+    if( [self changedObjectsPerApplyCheckpoint] > 0 ) {
+        [operation setChangedObjectsPerCheckpoint:[self changedObjectsPerApplyCheckpoint]];
+    }
+    
+    if( [self maximumConcurrentSyncChangeApplications] > 0 ) {
+        [operation setMaximumConcurrentSyncChangeApplications:[self maximumConcurrentSyncChangeApplications]];
+    }
+    
+    [operation setChangedAttributesEncodingVersion:[self changedAttributesEncodingVersion]];
+    
+    // Set location of sync changes to merge file, and the sealed journal segments to import into it
     NSURL *syncChangesToMergeLocation = nil;
-    if( [[self fileManager] fileExistsAtPath:[self syncChangesBeingSynchronizedStorePath]] ) {
+    if( [journalSegmentPaths count] > 0 || [[self fileManager] fileExistsAtPath:[self syncChangesBeingSynchronizedStorePath]] ) {
         syncChangesToMergeLocation = [NSURL fileURLWithPath:[self syncChangesBeingSynchronizedStorePath]];
     }
     [operation setLocalSyncChangesToMergeLocation:syncChangesToMergeLocation];
     
+    NSMutableArray *journalSegmentLocations = [NSMutableArray arrayWithCapacity:[journalSegmentPaths count]];
+    for( NSString *eachPath in journalSegmentPaths ) {
+        [journalSegmentLocations addObject:[NSURL fileURLWithPath:eachPath]];
+    }
+    [operation setLocalSyncChangesJournalSegmentLocations:journalSegmentLocations];
+    
     // Set locations of files
     [operation setAppliedSyncChangeSetsFileLocation:[NSURL fileURLWithPath:[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSAppliedSyncChangeSetsFilename]]];
     [operation setUnappliedSyncChangesDirectoryLocation:[NSURL fileURLWithPath:[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSUnappliedSyncChangesDirectoryName]]];
     [operation setUnappliedSyncChangeSetsFileLocation:[NSURL fileURLWithPath:[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSUnappliedChangeSetsFilename]]];
+    [operation setSynchronizationStateFileLocation:[NSURL fileURLWithPath:[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSSynchronizationStateFilename]]];
     [operation setLocalRecentSyncFileLocation:[NSURL fileURLWithPath:[[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:[self clientIdentifier]] stringByAppendingPathExtension:TICDSRecentSyncFileExtension]]];
+    [operation setSyncChangeSetSequenceNumbersFileLocation:[NSURL fileURLWithPath:[[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSSyncChangeSetSequenceNumbersFilename]]];
     
     // Set background context
     [operation configureBackgroundApplicationContextForPersistentStoreCoordinator:[[self primaryDocumentMOC] persistentStoreCoordinator]];
@@ -794,52 +835,37 @@
     [[self synchronizationQueue] addOperation:operation];
 }
 
-- (void)moveUnsynchronizedSyncChangesToMergeLocation
+- (NSArray *)sealUnsynchronizedSyncChanges
 {
-    // check whether there's an existing set of sync changes to merge left over from a previous error
-    if( [[self fileManager] fileExistsAtPath:[self syncChangesBeingSynchronizedStorePath]] ) {
-        TICDSLog(TICDSLogVerbosityEveryStep, @"A SyncChangesBeingSynchronized.syncchg file already exists from a previous failed sync, so using it for this synchronization process. The most recent local sync changes won't be synchronized.");
-        return;
-    }
-    
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Checking if there are local sync changes to merge and push");
     NSError *anyError = nil;
-    NSArray *syncChanges = [TICDSSyncChange ti_allObjectsInManagedObjectContext:[self syncChangesMocForDocumentMoc:[self primaryDocumentMOC]] error:&anyError];
-    
-    if( !syncChanges ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to fetch local sync changes");
-        [self bailFromSynchronizationProcessWithError:[TICDSError errorWithCode:TICDSErrorCodeCoreDataFetchError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-        return;
-    }
     
-    if( [syncChanges count] < 1 ) {
-        TICDSLog(TICDSLogVerbosityEveryStep, @"No local sync changes need to be pushed for this sync operation");
-        return;
+    // an UnsynchronizedSyncChanges.syncchg store written before the journal existed can be synchronized as-is
+    if( [[self fileManager] fileExistsAtPath:[self unsynchronizedSyncChangesStorePath]] && ![[self fileManager] fileExistsAtPath:[self syncChangesBeingSynchronizedStorePath]] ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Moving legacy UnsynchronizedSyncChanges.syncchg to SyncChangesBeingSynchronized.syncchg");
+        
+        if( ![[self fileManager] moveItemAtPath:[self unsynchronizedSyncChangesStorePath] toPath:[self syncChangesBeingSynchronizedStorePath] error:&anyError] ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to move UnsynchronizedSyncChanges.syncchg to SyncChangesBeingSynchronized.syncchg");
+            [self bailFromSynchronizationProcessWithError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+            return nil;
+        }
     }
     
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Moving UnsynchronizedSyncChanges to SyncChangesBeingSynchronized");
-    
-    [self setCoreDataFactory:nil];
-    [[self syncChangesMOCs] setValue:nil forKey:[self keyForContext:[self primaryDocumentMOC]]];
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Sealing the current segment of the UnsynchronizedSyncChanges journal");
+    NSArray *journalSegmentPaths = [[self syncChangesWriter] sealJournalSegment:&anyError];
     
-    // move UnsynchronizedSyncChanges file to SyncChangesBeingSynchronized
-    BOOL success = [[self fileManager] moveItemAtPath:[self unsynchronizedSyncChangesStorePath] toPath:[self syncChangesBeingSynchronizedStorePath] error:&anyError];
-    
-    if( !success ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to move UnsynchronizedSyncChanges.syncchg to SyncChangesBeingSynchronized.syncchg");
+    if( !journalSegmentPaths ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to seal the UnsynchronizedSyncChanges journal");
         [self bailFromSynchronizationProcessWithError:[TICDSError errorWithCode:TICDSErrorCodeFileManagerError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
-        return;
+        return nil;
     }
     
-    // setup the syncChangesMOC
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Re-Creating SyncChangesMOC");
-    [self addSyncChangesMocForDocumentMoc:[self primaryDocumentMOC]];
-    if( ![self syncChangesMocForDocumentMoc:[self primaryDocumentMOC]] ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to create sync changes MOC");
-        [self bailFromSynchronizationProcessWithError:[TICDSError errorWithCode:TICDSErrorCodeFailedToCreateSyncChangesMOC classAndMethod:__PRETTY_FUNCTION__]];
-        return;
+    if( [journalSegmentPaths count] < 1 ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"No new local sync changes need to be pushed for this sync operation");
+    } else {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"%lu journal segments of local sync changes will be merged and pushed", (unsigned long)[journalSegmentPaths count]);
     }
-    TICDSLog(TICDSLogVerbosityEveryStep, @"Finished creating SyncChangesMOC");
+    
+    return journalSegmentPaths;
 }
 
 - (void)synchronizationOperation:(TICDSSynchronizationOperation *)anOperation willSaveSyncChangesWithCount:(NSNumber *)numberOfChanges
@@ -946,6 +972,8 @@
     }
     
     [operation setShouldUseEncryption:[self shouldUseEncryption]];
+    [operation setClientIdentifier:[self clientIdentifier]];
+    [operation setSyncPartitions:[self syncPartitions]];
     
     [[self otherTasksQueue] addOperation:operation];
 }
@@ -1189,23 +1217,38 @@
     TICDSLog(TICDSLogVerbosityStartAndEndOfMainPhase, @"MOC saved, so beginning post-save processing");
     [self ti_alertDelegateWithSelector:@selector(documentSyncManager:didBeginProcessingSyncChangesAfterManagedObjectContextDidSave:), aMoc];
     
-    NSError *anyError = nil;
+    NSManagedObjectContext *syncChangesMoc = [self syncChangesMocForDocumentMoc:aMoc];
     
-    TICDSLog(TICDSLogVerbosityStartAndEndOfEachPhase, @"Sync Manager will save Sync Changes context");
+    NSMutableArray *syncChangeRepresentations = [NSMutableArray arrayWithCapacity:[[syncChangesMoc insertedObjects] count]];
+    for( NSManagedObject *eachObject in [syncChangesMoc insertedObjects] ) {
+        if( ![eachObject isKindOfClass:[TICDSSyncChange class]] ) {
+            continue;
+        }
+        
+        [syncChangeRepresentations addObject:[(TICDSSyncChange *)eachObject dictionaryRepresentation]];
+    }
     
-    BOOL success = [[self syncChangesMocForDocumentMoc:aMoc] save:&anyError];
+    // the writer owns these changes now, and keeps any it fails to write until a later write succeeds, so don't keep them around in the sync changes context
+    [syncChangesMoc reset];
     
-    if( !success ) {
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Sync Manager failed to save Sync Changes context with error: %@", anyError);
-        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Sync Manager cannot continue processing any further, so bailing");
-        [self ti_alertDelegateWithSelector:@selector(documentSyncManager:didFailToProcessSyncChangesAfterManagedObjectContextDidSave:withError:), aMoc, [TICDSError errorWithCode:TICDSErrorCodeFailedToSaveSyncChangesMOC underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__]];
+    if( [syncChangeRepresentations count] < 1 ) {
+        TICDSLog(TICDSLogVerbosityStartAndEndOfEachPhase, @"No Sync Changes were created by this save");
+        [self ti_alertDelegateWithSelector:@selector(documentSyncManager:didFinishProcessingSyncChangesAfterManagedObjectContextDidSave:), aMoc];
+    } else {
+        TICDSLog(TICDSLogVerbosityStartAndEndOfEachPhase, @"Sync Manager will save %lu Sync Changes in the background", (unsigned long)[syncChangeRepresentations count]);
         
-        return;
+        [[self syncChangesWriter] writeSyncChangeRepresentations:syncChangeRepresentations completionBlock:^(BOOL success, NSError *anError) {
+            if( !success ) {
+                TICDSLog(TICDSLogVerbosityErrorsOnly, @"Sync Manager failed to save Sync Changes with error: %@", anError);
+                [self ti_alertDelegateWithSelector:@selector(documentSyncManager:didFailToProcessSyncChangesAfterManagedObjectContextDidSave:withError:), aMoc, [TICDSError errorWithCode:TICDSErrorCodeFailedToSaveSyncChangesMOC underlyingError:anError classAndMethod:__PRETTY_FUNCTION__]];
+                return;
+            }
+            
+            TICDSLog(TICDSLogVerbosityStartAndEndOfEachPhase, @"Sync Manager saved Sync Changes successfully");
+            [self ti_alertDelegateWithSelector:@selector(documentSyncManager:didFinishProcessingSyncChangesAfterManagedObjectContextDidSave:), aMoc];
+        }];
     }
     
-    TICDSLog(TICDSLogVerbosityStartAndEndOfEachPhase, @"Sync Manager saved Sync Changes context successfully");
-    [self ti_alertDelegateWithSelector:@selector(documentSyncManager:didFinishProcessingSyncChangesAfterManagedObjectContextDidSave:), aMoc];
-    
     TICDSLog(TICDSLogVerbosityEveryStep, @"Asking delegate if we should sync after saving");
     BOOL shouldSync = [self ti_boolFromDelegateWithSelector:@selector(documentSyncManager:shouldBeginSynchronizingAfterManagedObjectContextDidSave:), aMoc];
     if( !shouldSync ) {
@@ -1363,11 +1406,14 @@
     [_helperFileDirectoryLocation release], _helperFileDirectoryLocation = nil;
     [_primaryDocumentMOC release], _primaryDocumentMOC = nil;
     [_syncChangesMOCs release], _syncChangesMOCs = nil;
+    [_syncChangesWriter release], _syncChangesWriter = nil;
     [_coreDataFactory release], _coreDataFactory = nil;
     [_registrationQueue release], _registrationQueue = nil;
     [_synchronizationQueue release], _synchronizationQueue = nil;
     [_otherTasksQueue release], _otherTasksQueue = nil;
     [_integrityKey release], _integrityKey = nil;
+    [_syncPartitions release], _syncPartitions = nil;
+    [_subscribedSyncPartitionNames release], _subscribedSyncPartitionNames = nil;
 
     [super dealloc];
 }
@@ -1388,14 +1434,25 @@
     if( _coreDataFactory ) return _coreDataFactory;
     
     TICDSLog(TICDSLogVerbosityEveryStep, @"Creating Core Data Factory (TICoreDataFactory)");
+    // sync changes are only created in memory during a save; the journal is what gets written to disk
     _coreDataFactory = [[TICoreDataFactory alloc] initWithMomdName:TICDSSyncChangeDataModelName];
     [_coreDataFactory setDelegate:self];
-    [_coreDataFactory setPersistentStoreType:TICDSSyncChangesCoreDataPersistentStoreType];
-    [_coreDataFactory setPersistentStoreDataPath:[self unsynchronizedSyncChangesStorePath]];
+    [_coreDataFactory setPersistentStoreType:NSInMemoryStoreType];
+    [_coreDataFactory setPersistentStoreDataPath:[self unsynchronizedSyncChangesJournalDirectoryPath]];
     
     return _coreDataFactory;
 }
 
+- (TICDSSyncChangesWriter *)syncChangesWriter
+{
+    if( _syncChangesWriter ) return _syncChangesWriter;
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Creating Sync Changes writer");
+    _syncChangesWriter = [[TICDSSyncChangesWriter alloc] initWithJournalDirectoryPath:[self unsynchronizedSyncChangesJournalDirectoryPath]];
+    
+    return _syncChangesWriter;
+}
+
 #pragma mark -
 #pragma mark Paths
 - (NSString *)relativePathToClientDevicesDirectory
@@ -1413,6 +1470,16 @@
     return [[self relativePathToInformationDirectory] stringByAppendingPathComponent:TICDSDeletedDocumentsDirectoryName];
 }
 
+- (NSString *)relativePathToInformationDocumentCatalogFile
+{
+    return [[self relativePathToInformationDirectory] stringByAppendingPathComponent:TICDSDocumentCatalogFilename];
+}
+
+- (NSString *)relativePathToInformationClientRegistryFile
+{
+    return [[self relativePathToInformationDirectory] stringByAppendingPathComponent:TICDSClientRegistryFilename];
+}
+
 - (NSString *)relativePathToDeletedDocumentsThisDocumentIdentifierPlistFile
 {
     return [[self relativePathToInformationDeletedDocumentsDirectory] stringByAppendingPathComponent:[[self documentIdentifier] stringByAppendingPathExtension:TICDSDocumentInfoPlistExtension]];
@@ -1528,10 +1595,22 @@
     return [[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSUnsynchronizedSyncChangesStoreName];
 }
 
+- (NSString *)unsynchronizedSyncChangesJournalDirectoryPath
+{
+    return [[[self helperFileDirectoryLocation] path] stringByAppendingPathComponent:TICDSUnsynchronizedSyncChangesJournalDirectoryName];
+}
+
 #pragma mark -
 #pragma mark Properties
 @synthesize delegate = _delegate;
 @synthesize shouldUseEncryption = _shouldUseEncryption;
+@synthesize syncPartitions = _syncPartitions;
+@synthesize subscribedSyncPartitionNames = _subscribedSyncPartitionNames;
+@synthesize syncChangeSetsPerApplyCheckpoint = _syncChangeSetsPerApplyCheckpoint;
+@synthesize changedObjectsPerApplyCheckpoint = _changedObjectsPerApplyCheckpoint;
+@synthesize maximumConcurrentSyncChangeApplications = _maximumConcurrentSyncChangeApplications;
+@synthesize changedAttributesEncodingVersion = _changedAttributesEncodingVersion;
+@synthesize carriesRelationshipsInInsertionSyncChanges = _carriesRelationshipsInInsertionSyncChanges;
 @synthesize mustUploadStoreAfterRegistration = _mustUploadStoreAfterRegistration;
 @synthesize state = _state;
 @synthesize applicationSyncManager = _applicationSyncManager;
@@ -1543,6 +1622,7 @@
 @synthesize helperFileDirectoryLocation = _helperFileDirectoryLocation;
 @synthesize primaryDocumentMOC = _primaryDocumentMOC;
 @synthesize coreDataFactory = _coreDataFactory;
+@synthesize syncChangesWriter = _syncChangesWriter;
 @synthesize syncChangesMOCs = _syncChangesMOCs;
 @synthesize registrationQueue = _registrationQueue;
 @synthesize synchronizationQueue = _synchronizationQueue;
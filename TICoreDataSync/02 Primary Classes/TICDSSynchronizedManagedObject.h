@@ -25,6 +25,12 @@
 // If there are keys that you wish to exclude from synchronization they can be detailed in this set.
 + (NSSet *)keysForWhichSyncChangesWillNotBeCreated;
 
+// Large string or binary attributes that are edited a little at a time can be detailed in this set, so their changes carry a delta
+// against the previous value rather than the whole new value. Deltas are only used when the document sync manager's
+// changedAttributesEncodingVersion is 2 or later; a client whose value has changed since (e.g. a conflict resolved in favour of
+// the remote change) can't apply the delta, and keeps its value until the next full value is synchronized.
++ (NSSet *)keysForWhichSyncChangesWillCarryDeltas;
+
 @property (nonatomic, readonly) NSManagedObjectContext *syncChangesMOC;
 @property (nonatomic, readwrite, assign) BOOL excludeFromSync;
 
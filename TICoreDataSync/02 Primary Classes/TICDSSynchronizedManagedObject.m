@@ -16,6 +16,8 @@
 - (void)createToOneRelationshipSyncChange:(NSRelationshipDescription *)aRelationship;
 - (void)createToManyRelationshipSyncChanges:(NSRelationshipDescription *)aRelationship;
 - (NSDictionary *)dictionaryOfAllAttributes;
+- (NSDictionary *)dictionaryOfAllRelationships;
+- (TICDSEntitySyncDescriptor *)syncDescriptor;
 
 @end
 
@@ -31,17 +33,34 @@
     return nil;
 }
 
++ (NSSet *)keysForWhichSyncChangesWillCarryDeltas
+{
+    return nil;
+}
+
 - (void)createSyncChangeForInsertion
 {
     // changedAttributes = a dictionary containing the values of _all_ the object's attributes at time it was saved
-    // this method also creates extra sync changes for _all_ the object's relationships 
+    // if the document sync manager carries relationships in insertion sync changes,
+    // changedRelationships = a dictionary containing the sync IDs of the related objects for _all_ the object's synchronized relationships,
+    // which are set once every object in the change set has been inserted, rather than needing a separate sync change per related object;
+    // otherwise this method also creates extra sync changes for _all_ the object's relationships
     
     TICDSSyncChange *syncChange = [self createSyncChangeForChangeType:TICDSSyncChangeTypeObjectInserted];
     
     TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", syncChange.objectSyncID, [self class]);
     
     [syncChange setChangedAttributes:[self dictionaryOfAllAttributes]];
-    [self createSyncChangesForAllRelationships];
+    
+    if( ![[(TICDSSynchronizedManagedObjectContext *)[self managedObjectContext] documentSyncManager] carriesRelationshipsInInsertionSyncChanges] ) {
+        [self createSyncChangesForAllRelationships];
+        return;
+    }
+    
+    NSDictionary *relationships = [self dictionaryOfAllRelationships];
+    if( [relationships count] > 0 ) {
+        [syncChange setChangedRelationships:relationships];
+    }
 }
 
 - (void)createSyncChangeForDeletion
@@ -61,30 +80,35 @@
     // separate sync changes are created for each property change, whether it be relationship or attribute
     NSDictionary *changedValues = [self changedValues];
     
-    NSSet *propertyNamesToBeIgnored = [[self class] keysForWhichSyncChangesWillNotBeCreated];
-    NSDictionary *relationshipsByName = [[NSDictionary alloc] initWithDictionary:[[self entity] relationshipsByName]];
-    NSDictionary *attributesByName = [[NSDictionary alloc] initWithDictionary:[[self entity] attributesByName]];
+    TICDSEntitySyncDescriptor *syncDescriptor = [self syncDescriptor];
+    NSSet *propertyNamesToBeIgnored = [syncDescriptor ignoredPropertyNames];
+    NSDictionary *relationshipsByName = [syncDescriptor relationshipsByName];
     for( NSString *eachPropertyName in changedValues ) {
-        if (propertyNamesToBeIgnored != nil && [propertyNamesToBeIgnored containsObject:eachPropertyName]) {
+        if ([propertyNamesToBeIgnored containsObject:eachPropertyName]) {
             TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Not creating a change for %@.%@", [self class], eachPropertyName);
             continue;
         }
         
         NSRelationshipDescription *relationship = [relationshipsByName objectForKey:eachPropertyName];
-        NSAttributeDescription *attribute = [attributesByName objectForKey:eachPropertyName];
         if ( relationship && !relationship.isTransient ) {
             [self createSyncChangeIfApplicableForRelationship:relationship];
         }
-        else if ( attribute && !attribute.isTransient ) {
+        else if ( [syncDescriptor isSyncedAttributeNamed:eachPropertyName] ) {
             TICDSSyncChange *syncChange = [self createSyncChangeForChangeType:TICDSSyncChangeTypeAttributeChanged];
             TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", syncChange.objectSyncID, [self class]);
             [syncChange setRelevantKey:eachPropertyName];
             id eachValue = [self transformedValueOfAttribute:eachPropertyName];
             [syncChange setChangedAttributes:eachValue];
+            
+            // the previous value is kept so a delta can be created when the change is saved into a sync change set
+            if( [[syncDescriptor deltaAttributeNames] containsObject:eachPropertyName] ) {
+                id committedValue = [[self committedValuesForKeys:[NSArray arrayWithObject:eachPropertyName]] objectForKey:eachPropertyName];
+                if( committedValue && committedValue != [NSNull null] ) {
+                    [syncChange setChangedAttributesBase:[syncDescriptor transformedValue:committedValue forAttributeNamed:eachPropertyName]];
+                }
+            }
         }
     }
-    [relationshipsByName release];
-    [attributesByName release];
 }
 
 #pragma mark -
@@ -105,43 +129,20 @@
 
 - (void)createSyncChangesForAllRelationships
 {
-    NSDictionary *objectRelationshipsByName = [[self entity] relationshipsByName];
+    NSDictionary *syncedRelationshipsByName = [[self syncDescriptor] syncedRelationshipsByName];
     
-    for( NSString *eachRelationshipName in objectRelationshipsByName ) {
-        [self createSyncChangeIfApplicableForRelationship:[objectRelationshipsByName valueForKey:eachRelationshipName]];
+    for( NSString *eachRelationshipName in syncedRelationshipsByName ) {
+        [self createSyncChangeIfApplicableForRelationship:[syncedRelationshipsByName objectForKey:eachRelationshipName]];
     }
 }
 
 - (void)createSyncChangeIfApplicableForRelationship:(NSRelationshipDescription *)aRelationship
 {
-    NSRelationshipDescription *inverseRelationship = [aRelationship inverseRelationship];
-    
-    // Each check makes sure there _is_ an inverse relationship before checking its type, to allow for relationships with no inverse set
-    
-    // Check if this is a many-to-one relationship (only sync the -to-one side)
-    if( ([aRelationship isToMany]) && inverseRelationship && (![inverseRelationship isToMany]) ) {
-        return;
-    }
-    
-    // Check if this is a many to many relationship, and only sync the first relationship name alphabetically
-    if( ([aRelationship isToMany]) && inverseRelationship && ([inverseRelationship isToMany]) && ([[aRelationship name] caseInsensitiveCompare:[inverseRelationship name]] == NSOrderedDescending) ) {
+    // only one end of each relationship is synchronized; see -[TICDSEntitySyncDescriptor syncedRelationshipsByName]
+    if( ![[[self syncDescriptor] syncedRelationshipsByName] objectForKey:[aRelationship name]] ) {
         return;
     }
     
-    // Check if this is a one to one relationship, and only sync the first relationship name alphabetically
-    if( (![aRelationship isToMany]) && inverseRelationship && (![inverseRelationship isToMany]) && ([[aRelationship name] caseInsensitiveCompare:[inverseRelationship name]] == NSOrderedDescending) ) {
-        return;
-    }
-    
-    // Check if this is a self-referential relationship, and only sync one side, somehow!!!
-    
-    // If we get here, this is:
-    // a) a one-to-many relationship
-    // b) the alphabetically lower end of a many-to-many relationship
-    // c) the alphabetically lower end of a one-to-one relationship
-    // d) edge-case 1: a many-to-many relationship with the same relationship name at both ends (will currently create 2 sync changes)
-    // e) edge-case 2: a one-to-one relationship with the same relationship name at both ends (will currently create 2 sync changes)
-    
     if( ![aRelationship isToMany] ) {
         [self createToOneRelationshipSyncChange:aRelationship];
     } else {
@@ -222,38 +223,65 @@
 #pragma mark Attributes
 - (id)transformedValueOfAttribute:(NSString *)key
 {
-    NSAttributeDescription *attribute = [self.entity.attributesByName valueForKey:key];
-    NSString *transformerName = [attribute valueTransformerName];
-    NSValueTransformer *valueTransformer = ( transformerName ? [NSValueTransformer valueTransformerForName:transformerName] : nil );
-    id transformedValue = [self valueForKey:key];
-    if ( valueTransformer ) transformedValue = [valueTransformer transformedValue:transformedValue];
-    return transformedValue;
+    return [[self syncDescriptor] transformedValue:[self valueForKey:key] forAttributeNamed:key];
 }
 
 - (id)reverseTransformedValueOfAttribute:(NSString *)key withValue:(id)value
 {
-    NSAttributeDescription *attribute = [self.entity.attributesByName valueForKey:key];
-    NSString *transformerName = [attribute valueTransformerName];
-    NSValueTransformer *valueTransformer = ( transformerName ? [NSValueTransformer valueTransformerForName:transformerName] : nil );
-    if ( valueTransformer ) value = [valueTransformer reverseTransformedValue:value];
-    return value;
+    return [[self syncDescriptor] reverseTransformedValue:value forAttributeNamed:key];
 }
 
 - (NSDictionary *)dictionaryOfAllAttributes
 {
-    NSDictionary *objectAttributeNames = [[self entity] attributesByName];
+    TICDSEntitySyncDescriptor *syncDescriptor = [self syncDescriptor];
+    NSArray *attributeNames = [syncDescriptor attributeNames];
     
-    NSMutableDictionary *attributeValues = [NSMutableDictionary dictionaryWithCapacity:[objectAttributeNames count]];
-    for( NSString *eachAttributeName in [objectAttributeNames allKeys] ) {
-        NSAttributeDescription *attribute = [objectAttributeNames valueForKey:eachAttributeName];
-        if ( [attribute isTransient] ) continue;
-        id value = [self transformedValueOfAttribute:eachAttributeName];
+    NSMutableDictionary *attributeValues = [NSMutableDictionary dictionaryWithCapacity:[attributeNames count]];
+    for( NSString *eachAttributeName in attributeNames ) {
+        id value = [syncDescriptor transformedValue:[self valueForKey:eachAttributeName] forAttributeNamed:eachAttributeName];
         [attributeValues setValue:value forKey:eachAttributeName];
     }
     
     return attributeValues;
 }
 
+#pragma mark -
+#pragma mark Relationships
+- (NSDictionary *)dictionaryOfAllRelationships
+{
+    // to-one relationships map to the related object's sync ID, to-many relationships to an array of sync IDs
+    NSDictionary *syncedRelationshipsByName = [[self syncDescriptor] syncedRelationshipsByName];
+    
+    NSMutableDictionary *relationshipValues = [NSMutableDictionary dictionaryWithCapacity:[syncedRelationshipsByName count]];
+    for( NSString *eachRelationshipName in syncedRelationshipsByName ) {
+        NSRelationshipDescription *relationship = [syncedRelationshipsByName objectForKey:eachRelationshipName];
+        
+        if( ![relationship isToMany] ) {
+            NSManagedObject *relatedObject = [self valueForKey:eachRelationshipName];
+            if( [relatedObject isKindOfClass:[TICDSSynchronizedManagedObject class]] ) {
+                [relationshipValues setValue:[relatedObject valueForKey:TICDSSyncIDAttributeName] forKey:eachRelationshipName];
+            }
+            continue;
+        }
+        
+        NSSet *relatedObjects = [self valueForKey:eachRelationshipName];
+        NSMutableArray *relatedSyncIDs = [NSMutableArray arrayWithCapacity:[relatedObjects count]];
+        for( NSManagedObject *eachObject in relatedObjects ) {
+            if( ![eachObject isKindOfClass:[TICDSSynchronizedManagedObject class]] ) {
+                continue;
+            }
+            
+            [relatedSyncIDs addObject:[eachObject valueForKey:TICDSSyncIDAttributeName]];
+        }
+        
+        if( [relatedSyncIDs count] > 0 ) {
+            [relationshipValues setValue:relatedSyncIDs forKey:eachRelationshipName];
+        }
+    }
+    
+    return relationshipValues;
+}
+
 #pragma mark -
 #pragma mark Save Notification
 - (void)willSave
@@ -300,6 +328,11 @@
 
 #pragma mark -
 #pragma mark Properties
+- (TICDSEntitySyncDescriptor *)syncDescriptor
+{
+    return [TICDSEntitySyncDescriptor syncDescriptorForEntity:[self entity]];
+}
+
 - (NSManagedObjectContext *)syncChangesMOC
 {
     if( ![[self managedObjectContext] isKindOfClass:[TICDSSynchronizedManagedObjectContext class]] ) return nil;
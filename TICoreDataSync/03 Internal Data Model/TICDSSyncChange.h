@@ -13,6 +13,7 @@
 @interface TICDSSyncChange : NSManagedObject {
 @private
     NSManagedObject *_relevantManagedObject;
+    id _changedAttributesBase;
 }
 
 /** @name Class Factory Method */
@@ -26,6 +27,93 @@
  */
 + (id)syncChangeOfType:(TICDSSyncChangeType)aType inManagedObjectContext:(NSManagedObjectContext *)aMoc;
 
+/** Create a sync change from a dictionary representation previously returned by `dictionaryRepresentation`.
+ 
+ @param aDictionary The dictionary representation of the sync change.
+ @param aMoc The managed object context in which to create the sync change.
+ 
+ @return A sync change with the persistent properties described by the dictionary.
+ */
++ (id)syncChangeWithDictionaryRepresentation:(NSDictionary *)aDictionary inManagedObjectContext:(NSManagedObjectContext *)aMoc;
+
+/** @name Dictionary Representation */
+
+/** An immutable dictionary containing the persistent properties of this sync change, and its `changedAttributesBase` if it has one, which can safely be handed to another thread. */
+- (NSDictionary *)dictionaryRepresentation;
+
+/** @name Changed Attribute Digests */
+
+/** A digest of a `changedAttributes` value, such that two values with the same digest are equal.
+ 
+ Strings, data, numbers and dates are digested from their contents; other values from their keyed archive, so equal values of other classes may have different digests. The digest of a `TICDSAttributeValueDelta` is the digest of the value it produces.
+ 
+ @param aValue The value, or `nil`.
+ 
+ @return A SHA-1 digest of the value. */
++ (NSData *)digestOfChangedAttributes:(id)aValue;
+
+/** Record the digests of the `changedAttributes` of attribute changes in the metadata of the persistent store in which they will be saved, so that conflict checking can compare values without unarchiving them (see `changedAttributesDigest`).
+ 
+ Sync change set files have no room for a digest in the `TICDSSyncChange` entity without breaking clients that open them with the original model, so digests are kept in the store's metadata, keyed by object ID, under `kTICDSChangedAttributesDigests`. This method must be called before the sync changes' context is saved.
+ 
+ @param someSyncChanges The newly-inserted sync changes, all in the same managed object context.
+ @param outError If permanent object IDs could not be obtained, upon return contains an error describing the problem.
+ 
+ @return `YES` if the digests were recorded, otherwise `NO`. */
++ (BOOL)recordChangedAttributesDigestsOfSyncChanges:(NSArray *)someSyncChanges error:(NSError **)outError;
+
+/** The digest of this attribute change's `changedAttributes` recorded in its store's metadata, or `nil` if there is none (e.g., if the sync change set was written by an older client).
+ 
+ Reading the digest doesn't fire the sync change's fault, or unarchive its value. */
+- (NSData *)changedAttributesDigest;
+
+/** @name Encoding Changed Attributes */
+
+/** The version of `TICDSChangedAttributesCodec` with which the sync changes in a persistent store were encoded, or `0` if their `changedAttributes` are keyed archives.
+ 
+ @param aStore The persistent store.
+ 
+ @return The version recorded in the store's metadata under `kTICDSChangedAttributesEncodingVersion`, or `0`. */
++ (NSUInteger)changedAttributesEncodingVersionOfPersistentStore:(NSPersistentStore *)aStore;
+
+/** Encode the `changedAttributes` of newly-inserted insertion and attribute changes with `TICDSChangedAttributesCodec`, and record the version in the metadata of the persistent store in which they will be saved.
+ 
+ With version `2` or later, an attribute change with a `changedAttributesBase`, for an attribute whose changes carry deltas (see `+[TICDSSynchronizedManagedObject keysForWhichSyncChangesWillCarryDeltas]`), is encoded as a `TICDSAttributeValueDelta` if one is worth carrying. The version recorded is the oldest that can decode every change in the store, so a store without deltas can still be read by clients that only support version `1`.
+ 
+ Once a store's version is recorded, `changedAttributes` decodes the values of its saved sync changes. Every sync change in a store must use the same encoding, so this method must only be called for a new store, or one that already uses `aVersion`, and before any new sync change has a permanent object ID.
+ 
+ @param someSyncChanges The newly-inserted sync changes.
+ @param aVersion The version of the encoding, or `0` to leave the values as keyed archives.
+ @param aStore The persistent store in which the sync changes will be saved.
+ @param aModel The application's managed object model, used to look up the type of each attribute. */
++ (void)encodeChangedAttributesOfSyncChanges:(NSArray *)someSyncChanges withVersion:(NSUInteger)aVersion inPersistentStore:(NSPersistentStore *)aStore managedObjectModel:(NSManagedObjectModel *)aModel;
+
+/** Replace the `TICDSAttributeValueDelta` carried by a saved attribute change with the full value it produces, e.g. once the change has won a conflict, so other clients can apply it whatever value they have.
+ 
+ The digest recorded for the change is still valid, as a delta's digest is that of the value it produces.
+ 
+ @param aValue The (transformed) value the delta produces.
+ @param aModel The application's managed object model, used to look up the type of the attribute. */
+- (void)replaceChangedAttributesDeltaWithValue:(id)aValue managedObjectModel:(NSManagedObjectModel *)aModel;
+
+/** @name Inline Relationships */
+
+/** The newest form of relationships carried by insertion changes that this class can apply. */
++ (NSUInteger)currentInsertionRelationshipsVersion;
+
+/** The form of the relationships carried by the insertion changes in a persistent store.
+ 
+ @param aStore The persistent store.
+ 
+ @return The version recorded in the store's metadata under `kTICDSInsertionRelationshipsVersion`, or `0` if no insertion change in the store carries relationships. */
++ (NSUInteger)insertionRelationshipsVersionOfPersistentStore:(NSPersistentStore *)aStore;
+
+/** Record in the metadata of the persistent store in which they will be saved whether any of the given insertion changes carry relationships (see `-[TICDSDocumentSyncManager carriesRelationshipsInInsertionSyncChanges]`).
+ 
+ @param someSyncChanges The newly-inserted sync changes.
+ @param aStore The persistent store in which the sync changes will be saved. */
++ (void)recordInsertionRelationshipsOfSyncChanges:(NSArray *)someSyncChanges inPersistentStore:(NSPersistentStore *)aStore;
+
 /** @name Persistent Properties */
 
 /** The type of the change.
@@ -42,7 +130,9 @@
 /** The relevant key that was changed if this is sync change represents an attribute change. */
 @property (nonatomic, retain) NSString * relevantKey;
 
-/** The changed values of the attributes (used for attribute change, and insertion). */
+/** The changed values of the attributes (used for attribute change, and insertion).
+ 
+ Values saved in a store that records a `TICDSChangedAttributesCodec` version are decoded each time they are read. */
 @property (nonatomic, retain) id changedAttributes;
 
 /** The changed relationships for a relationship sync change. */
@@ -59,4 +149,9 @@
 /** The managed object instance to which this sync change refers. */
 @property (nonatomic, assign) NSManagedObject *relevantManagedObject;
 
+/** The (transformed) value of the attribute before an attribute change, kept for attributes whose changes carry deltas, so that a delta can be created when the change is saved into a sync change set.
+ 
+ The base is carried in the `dictionaryRepresentation`, but isn't saved in a sync change set. */
+@property (nonatomic, retain) id changedAttributesBase;
+
 @end
@@ -8,6 +8,8 @@
 
 #import "TICoreDataSync.h"
 
+#import <CommonCrypto/CommonDigest.h>
+
 @implementation TICDSSyncChange
 
 static NSString *bigDataDirectory = nil;
@@ -54,6 +56,289 @@ static NSString *bigDataDirectory = nil;
     return syncChange;
 }
 
++ (id)syncChangeWithDictionaryRepresentation:(NSDictionary *)aDictionary inManagedObjectContext:(NSManagedObjectContext *)aMoc
+{
+    TICDSSyncChange *syncChange = [self ti_objectInManagedObjectContext:aMoc];
+    
+    [syncChange setValuesForKeysWithDictionary:aDictionary];
+    
+    return syncChange;
+}
+
+#pragma mark -
+#pragma mark Dictionary Representation
++ (NSArray *)persistentPropertyKeys
+{
+    static NSArray *persistentPropertyKeys = nil;
+    
+    if( !persistentPropertyKeys ) {
+        persistentPropertyKeys = [[NSArray alloc] initWithObjects:@"changeType", @"objectEntityName", @"objectSyncID", @"relevantKey", @"changedAttributes", @"changedRelationships", @"relatedObjectEntityName", @"localTimeStamp", nil];
+    }
+    
+    return persistentPropertyKeys;
+}
+
+- (NSDictionary *)dictionaryRepresentation
+{
+    // nil values are represented by NSNull, which setValuesForKeysWithDictionary: turns back into nil
+    NSDictionary *representation = [self dictionaryWithValuesForKeys:[[self class] persistentPropertyKeys]];
+    if( ![self changedAttributesBase] ) {
+        return representation;
+    }
+    
+    NSMutableDictionary *representationWithBase = [NSMutableDictionary dictionaryWithDictionary:representation];
+    [representationWithBase setObject:[self changedAttributesBase] forKey:@"changedAttributesBase"];
+    
+    return [NSDictionary dictionaryWithDictionary:representationWithBase];
+}
+
+#pragma mark -
+#pragma mark Changed Attribute Digests
+static void TICDSUpdateDigestWithTaggedBytes( CC_SHA1_CTX *aContext, char aTag, const void *someBytes, NSUInteger aLength )
+{
+    // the tag keeps e.g. a string and data with the same bytes from sharing a digest
+    CC_SHA1_Update(aContext, &aTag, 1);
+    CC_SHA1_Update(aContext, someBytes, (CC_LONG)aLength);
+}
+
++ (NSData *)digestOfChangedAttributes:(id)aValue
+{
+    if( [aValue isKindOfClass:[TICDSAttributeValueDelta class]] ) {
+        return [aValue valueDigest];
+    }
+    
+    CC_SHA1_CTX context;
+    CC_SHA1_Init(&context);
+    
+    if( !aValue || aValue == [NSNull null] ) {
+        TICDSUpdateDigestWithTaggedBytes(&context, '0', NULL, 0);
+    } else if( [aValue isKindOfClass:[NSString class]] ) {
+        NSData *data = [aValue dataUsingEncoding:NSUTF8StringEncoding];
+        TICDSUpdateDigestWithTaggedBytes(&context, 's', [data bytes], [data length]);
+    } else if( [aValue isKindOfClass:[NSData class]] ) {
+        TICDSUpdateDigestWithTaggedBytes(&context, 'd', [aValue bytes], [aValue length]);
+    } else if( [aValue isKindOfClass:[NSNumber class]] ) {
+        // equal numbers of different types (e.g., @1 and @1.0) have the same string value
+        NSData *data = [[aValue stringValue] dataUsingEncoding:NSUTF8StringEncoding];
+        TICDSUpdateDigestWithTaggedBytes(&context, 'n', [data bytes], [data length]);
+    } else if( [aValue isKindOfClass:[NSDate class]] ) {
+        CFSwappedFloat64 interval = CFConvertDoubleHostToSwapped([aValue timeIntervalSinceReferenceDate]);
+        TICDSUpdateDigestWithTaggedBytes(&context, 't', &interval, sizeof(interval));
+    } else {
+        NSData *data = [NSKeyedArchiver archivedDataWithRootObject:aValue];
+        TICDSUpdateDigestWithTaggedBytes(&context, 'a', [data bytes], [data length]);
+    }
+    
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1_Final(digest, &context);
+    
+    return [NSData dataWithBytes:digest length:CC_SHA1_DIGEST_LENGTH];
+}
+
++ (NSString *)digestKeyForObjectID:(NSManagedObjectID *)anObjectID
+{
+    // e.g. p42, from x-coredata://<store UUID>/TICDSSyncChange/p42; the store is known, and there's only one entity
+    return [[anObjectID URIRepresentation] lastPathComponent];
+}
+
++ (BOOL)recordChangedAttributesDigestsOfSyncChanges:(NSArray *)someSyncChanges error:(NSError **)outError
+{
+    NSMutableArray *attributeChanges = [NSMutableArray arrayWithCapacity:[someSyncChanges count]];
+    for( TICDSSyncChange *eachChange in someSyncChanges ) {
+        if( [[eachChange changeType] unsignedIntegerValue] == TICDSSyncChangeTypeAttributeChanged ) {
+            [attributeChanges addObject:eachChange];
+        }
+    }
+    
+    if( [attributeChanges count] < 1 ) {
+        return YES;
+    }
+    
+    // digest the values before the changes have permanent IDs, when they're still the values that were set, rather than encoded ones
+    NSMutableArray *changeDigests = [NSMutableArray arrayWithCapacity:[attributeChanges count]];
+    for( TICDSSyncChange *eachChange in attributeChanges ) {
+        [changeDigests addObject:[self digestOfChangedAttributes:[eachChange changedAttributes]]];
+    }
+    
+    NSManagedObjectContext *context = [[attributeChanges lastObject] managedObjectContext];
+    NSError *anyError = nil;
+    if( ![context obtainPermanentIDsForObjects:attributeChanges error:&anyError] ) {
+        if( outError ) {
+            *outError = [TICDSError errorWithCode:TICDSErrorCodeCoreDataSaveError underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__];
+        }
+        return NO;
+    }
+    
+    NSPersistentStoreCoordinator *coordinator = [context persistentStoreCoordinator];
+    NSMutableDictionary *digestsByStore = [NSMutableDictionary dictionary];
+    [attributeChanges enumerateObjectsUsingBlock:^(id eachChange, NSUInteger index, BOOL *stop) {
+        NSPersistentStore *store = [[eachChange objectID] persistentStore];
+        NSValue *storeKey = [NSValue valueWithNonretainedObject:store];
+        
+        NSMutableDictionary *digests = [digestsByStore objectForKey:storeKey];
+        if( !digests ) {
+            // digests of changes saved to the store previously are kept
+            digests = [NSMutableDictionary dictionaryWithDictionary:[[coordinator metadataForPersistentStore:store] objectForKey:kTICDSChangedAttributesDigests]];
+            [digestsByStore setObject:digests forKey:storeKey];
+        }
+        
+        [digests setObject:[changeDigests objectAtIndex:index] forKey:[self digestKeyForObjectID:[eachChange objectID]]];
+    }];
+    
+    for( NSValue *eachStoreKey in digestsByStore ) {
+        NSPersistentStore *store = [eachStoreKey nonretainedObjectValue];
+        NSMutableDictionary *metadata = [NSMutableDictionary dictionaryWithDictionary:[coordinator metadataForPersistentStore:store]];
+        [metadata setObject:[digestsByStore objectForKey:eachStoreKey] forKey:kTICDSChangedAttributesDigests];
+        [coordinator setMetadata:metadata forPersistentStore:store];
+    }
+    
+    return YES;
+}
+
+- (NSData *)changedAttributesDigest
+{
+    NSManagedObjectID *objectID = [self objectID];
+    if( [objectID isTemporaryID] ) {
+        return nil;
+    }
+    
+    NSDictionary *digests = [[[objectID persistentStore] metadata] objectForKey:kTICDSChangedAttributesDigests];
+    
+    return [digests objectForKey:[[self class] digestKeyForObjectID:objectID]];
+}
+
+#pragma mark -
+#pragma mark Encoding Changed Attributes
++ (NSUInteger)changedAttributesEncodingVersionOfPersistentStore:(NSPersistentStore *)aStore
+{
+    return [[[aStore metadata] objectForKey:kTICDSChangedAttributesEncodingVersion] unsignedIntegerValue];
+}
+
++ (void)encodeChangedAttributesOfSyncChanges:(NSArray *)someSyncChanges withVersion:(NSUInteger)aVersion inPersistentStore:(NSPersistentStore *)aStore managedObjectModel:(NSManagedObjectModel *)aModel
+{
+    if( aVersion < 1 ) {
+        return;
+    }
+    
+    NSDictionary *entitiesByName = [aModel entitiesByName];
+    NSUInteger versionNeeded = 1;
+    
+    for( TICDSSyncChange *eachChange in someSyncChanges ) {
+        TICDSSyncChangeType changeType = [[eachChange changeType] unsignedIntValue];
+        if( changeType != TICDSSyncChangeTypeObjectInserted && changeType != TICDSSyncChangeTypeAttributeChanged ) {
+            continue;
+        }
+        
+        // the primitive value is read directly, as the value that was set whatever the store's version
+        [eachChange willAccessValueForKey:@"changedAttributes"];
+        id value = [eachChange primitiveValueForKey:@"changedAttributes"];
+        [eachChange didAccessValueForKey:@"changedAttributes"];
+        
+        // nil values are left as nil
+        if( !value ) {
+            continue;
+        }
+        
+        NSEntityDescription *entity = [entitiesByName objectForKey:[eachChange objectEntityName]];
+        NSData *encodedValue = nil;
+        if( changeType == TICDSSyncChangeTypeObjectInserted ) {
+            encodedValue = [TICDSChangedAttributesCodec dataWithValuesByAttributeName:value inEntity:entity];
+        } else {
+            id baseValue = [eachChange changedAttributesBase];
+            if( aVersion >= 2 && baseValue && baseValue != [NSNull null] && [[[TICDSEntitySyncDescriptor syncDescriptorForEntity:entity] deltaAttributeNames] containsObject:[eachChange relevantKey]] ) {
+                value = [TICDSAttributeValueDelta deltaFromValue:baseValue toValue:value] ? : value;
+            }
+            
+            encodedValue = [TICDSChangedAttributesCodec dataWithValue:value ofAttributeNamed:[eachChange relevantKey] inEntity:entity];
+        }
+        versionNeeded = MAX(versionNeeded, [TICDSChangedAttributesCodec versionOfData:encodedValue]);
+        
+        [eachChange willChangeValueForKey:@"changedAttributes"];
+        [eachChange setPrimitiveValue:encodedValue forKey:@"changedAttributes"];
+        [eachChange didChangeValueForKey:@"changedAttributes"];
+    }
+    
+    NSPersistentStoreCoordinator *coordinator = [[[someSyncChanges lastObject] managedObjectContext] persistentStoreCoordinator];
+    if( !coordinator || [self changedAttributesEncodingVersionOfPersistentStore:aStore] >= versionNeeded ) {
+        return;
+    }
+    
+    NSMutableDictionary *metadata = [NSMutableDictionary dictionaryWithDictionary:[coordinator metadataForPersistentStore:aStore]];
+    [metadata setObject:[NSNumber numberWithUnsignedInteger:versionNeeded] forKey:kTICDSChangedAttributesEncodingVersion];
+    [coordinator setMetadata:metadata forPersistentStore:aStore];
+}
+
+- (void)replaceChangedAttributesDeltaWithValue:(id)aValue managedObjectModel:(NSManagedObjectModel *)aModel
+{
+    // deltas are only carried by stores encoded with version 2 or later, so the value is encoded too
+    NSEntityDescription *entity = [[aModel entitiesByName] objectForKey:[self objectEntityName]];
+    NSData *encodedValue = [TICDSChangedAttributesCodec dataWithValue:aValue ofAttributeNamed:[self relevantKey] inEntity:entity];
+    
+    [self willChangeValueForKey:@"changedAttributes"];
+    [self setPrimitiveValue:encodedValue forKey:@"changedAttributes"];
+    [self didChangeValueForKey:@"changedAttributes"];
+}
+
+#pragma mark -
+#pragma mark Inline Relationships
++ (NSUInteger)currentInsertionRelationshipsVersion
+{
+    return 1;
+}
+
++ (NSUInteger)insertionRelationshipsVersionOfPersistentStore:(NSPersistentStore *)aStore
+{
+    return [[[aStore metadata] objectForKey:kTICDSInsertionRelationshipsVersion] unsignedIntegerValue];
+}
+
++ (void)recordInsertionRelationshipsOfSyncChanges:(NSArray *)someSyncChanges inPersistentStore:(NSPersistentStore *)aStore
+{
+    if( [self insertionRelationshipsVersionOfPersistentStore:aStore] >= [self currentInsertionRelationshipsVersion] ) {
+        return;
+    }
+    
+    // relationship changes carry a single sync ID, while insertions carry a dictionary of every relationship
+    BOOL carriesRelationships = NO;
+    for( TICDSSyncChange *eachChange in someSyncChanges ) {
+        if( [[eachChange changeType] unsignedIntegerValue] == TICDSSyncChangeTypeObjectInserted && [[eachChange changedRelationships] isKindOfClass:[NSDictionary class]] ) {
+            carriesRelationships = YES;
+            break;
+        }
+    }
+    
+    NSPersistentStoreCoordinator *coordinator = [[[someSyncChanges lastObject] managedObjectContext] persistentStoreCoordinator];
+    if( !carriesRelationships || !coordinator ) {
+        return;
+    }
+    
+    NSMutableDictionary *metadata = [NSMutableDictionary dictionaryWithDictionary:[coordinator metadataForPersistentStore:aStore]];
+    [metadata setObject:[NSNumber numberWithUnsignedInteger:[self currentInsertionRelationshipsVersion]] forKey:kTICDSInsertionRelationshipsVersion];
+    [coordinator setMetadata:metadata forPersistentStore:aStore];
+}
+
+#pragma mark -
+#pragma mark Decoding Changed Attributes
+- (id)decodedChangedAttributes:(id)someChangedAttributes
+{
+    if( ![someChangedAttributes isKindOfClass:[NSData class]] ) {
+        return someChangedAttributes;
+    }
+    
+    // new sync changes hold the values that were set until they are encoded, and given permanent IDs, before being saved
+    NSManagedObjectID *objectID = [self objectID];
+    if( [objectID isTemporaryID] || [[self class] changedAttributesEncodingVersionOfPersistentStore:[objectID persistentStore]] < 1 ) {
+        return someChangedAttributes;
+    }
+    
+    NSError *anyError = nil;
+    id result = [TICDSChangedAttributesCodec changedAttributesWithData:someChangedAttributes error:&anyError];
+    if( !result ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to decode changed attributes of %@ sync change for %@: %@", [self objectEntityName], [self objectSyncID], anyError);
+    }
+    
+    return result;
+}
+
 #pragma mark -
 #pragma mark Inspection
 - (NSString *)shortDescription
@@ -66,6 +351,15 @@ static NSString *bigDataDirectory = nil;
     return [NSString stringWithFormat:@"\n%@\nCHANGED ATTRIBUTES\n%@\nCHANGED RELATIONSHIPS\n%@", [super description], [self changedAttributes], [self changedRelationships]];
 }
 
+#pragma mark -
+#pragma mark Faulting
+- (void)didTurnIntoFault
+{
+    [_changedAttributesBase release], _changedAttributesBase = nil;
+    
+    [super didTurnIntoFault];
+}
+
 #pragma mark -
 #pragma mark TIManagedObjectExtensions
 + (NSString *)ti_entityName
@@ -120,6 +414,7 @@ static NSString *bigDataDirectory = nil;
 {
     [self willAccessValueForKey:@"changedAttributes"];
     id result = [self primitiveValueForKey:@"changedAttributes"];
+    result = [self decodedChangedAttributes:result];
     result = [self lowMemoryChangedAttributesFromAttributes:result];
     [self didAccessValueForKey:@"changedAttributes"];
     return result;
@@ -127,6 +422,7 @@ static NSString *bigDataDirectory = nil;
 
 @dynamic changeType;
 @synthesize relevantManagedObject = _relevantManagedObject;
+@synthesize changedAttributesBase = _changedAttributesBase;
 @dynamic objectEntityName;
 @dynamic objectSyncID;
 @dynamic changedAttributes;
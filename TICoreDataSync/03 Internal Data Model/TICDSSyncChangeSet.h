@@ -45,6 +45,15 @@
  @return The sync change set object, if it already exists, otherwise `nil`. */
 + (TICDSSyncChangeSet *)changeSetWithIdentifier:(NSString *)anIdentifier inManagedObjectContext:(NSManagedObjectContext *)aMoc;
 
+/** Return the sequence number embedded in a sync change set identifier.
+ 
+ Identifiers have the form `<creation time>-<sequence number>-<UUID>`, where the sequence number is ten decimal digits. Each client numbers the sync change sets it uploads to each sync partition 1, 2, 3 and so on, without gaps. Identifiers created by earlier versions of the framework have no sequence number.
+ 
+ @param anIdentifier The unique identifier for the sync change set.
+ 
+ @return The sequence number, or `NSNotFound` if the identifier doesn't contain one. */
++ (NSUInteger)sequenceNumberOfSyncChangeSetWithIdentifier:(NSString *)anIdentifier;
+
 @property (nonatomic, retain) NSDate * creationDate;
 @property (nonatomic, retain) NSString * fileName;
 @property (nonatomic, retain) NSString * syncChangeSetIdentifier;
@@ -30,6 +30,22 @@
     return matchingChangeSet;
 }
 
++ (NSUInteger)sequenceNumberOfSyncChangeSetWithIdentifier:(NSString *)anIdentifier
+{
+    // a UUID's first group has eight hex digits, so can't be mistaken for the ten-digit sequence number
+    NSArray *components = [anIdentifier componentsSeparatedByString:@"-"];
+    if( [components count] < 3 ) {
+        return NSNotFound;
+    }
+    
+    NSString *sequenceComponent = [components objectAtIndex:1];
+    if( [sequenceComponent length] != 10 || [sequenceComponent rangeOfCharacterFromSet:[[NSCharacterSet characterSetWithCharactersInString:@"0123456789"] invertedSet]].location != NSNotFound ) {
+        return NSNotFound;
+    }
+    
+    return (NSUInteger)[sequenceComponent longLongValue];
+}
+
 #pragma mark -
 #pragma mark Initialization and Deallocation
 + (id)syncChangeSetWithIdentifier:(NSString *)anIdentifier fromClient:(NSString *)aClientIdentifier creationDate:(NSDate *)aDate inManagedObjectContext:(NSManagedObjectContext *)aMoc
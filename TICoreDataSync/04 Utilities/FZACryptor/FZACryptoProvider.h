@@ -0,0 +1,144 @@
+//
+// FZACryptoProvider.h
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+/** The AES block size, which is also the length of an IV. */
+#define FZACryptoBlockLength 16
+
+/** The length of the AES-256 key used for file content. */
+#define FZACryptoFileKeyLength 32
+
+/** The length of a SHA-256 digest or HMAC. */
+#define FZACryptoDigestLength 32
+
+/** Platforms without CommonCrypto use OpenSSL. Define `FZA_USE_OPENSSL` to `1` to use OpenSSL on Apple platforms too. */
+#if !defined(FZA_USE_OPENSSL)
+#if defined(__linux__)
+#define FZA_USE_OPENSSL 1
+#else
+#define FZA_USE_OPENSSL 0
+#endif
+#endif
+
+/** An AES-CBC encryption or decryption in progress, created by `FZACryptoProvider`. */
+@protocol FZACipherContext <NSObject>
+
+/** Process some more input.
+ 
+ @param bytes The input bytes.
+ @param length The number of input bytes.
+ @param output A buffer for the output, which must have room for at least `length + FZACryptoBlockLength` bytes (or `length` bytes, if the context doesn't pad).
+ @param capacity The size of the output buffer.
+ @param outLength Upon return, the number of bytes written to `output`.
+ @param error Upon failure, an error in `FZACryptorErrorDomain`.
+ 
+ @return `YES` if the input was processed, otherwise `NO`. */
+- (BOOL)updateWithBytes:(const void *)bytes length:(size_t)length output:(void *)output capacity:(size_t)capacity outputLength:(size_t *)outLength error:(NSError **)error;
+
+/** Finish the operation, writing out any buffered block and checking or adding padding.
+ 
+ @param output A buffer for the output, which must have room for at least `FZACryptoBlockLength` bytes.
+ @param capacity The size of the output buffer.
+ @param outLength Upon return, the number of bytes written to `output`.
+ @param error Upon failure, an error in `FZACryptorErrorDomain`.
+ 
+ @return `YES` if the operation finished, otherwise `NO`. */
+- (BOOL)finishWithOutput:(void *)output capacity:(size_t)capacity outputLength:(size_t *)outLength error:(NSError **)error;
+
+@end
+
+/** A SHA-256 HMAC calculation in progress, created by `FZACryptoProvider`. */
+@protocol FZAHMACContext <NSObject>
+
+/** Add some more bytes to the HMAC.
+ 
+ @param bytes The bytes to add.
+ @param length The number of bytes. */
+- (void)updateWithBytes:(const void *)bytes length:(size_t)length;
+
+/** Finish the calculation.
+ 
+ @param digest A buffer of `FZACryptoDigestLength` bytes to hold the HMAC. */
+- (void)finishWithDigest:(uint8_t *)digest;
+
+@end
+
+/** `FZACryptoProvider` is an abstract class giving `FZACryptor` and `FZAKeyManager` access to the AES, HMAC and digest primitives of whichever crypto library is available.
+ 
+ `FZACryptoProviderCommonCrypto` is used on Apple platforms and `FZACryptoProviderOpenSSL` elsewhere; both produce byte-identical output, so files encrypted by either can be decrypted by the other. */
+@interface FZACryptoProvider : NSObject {
+@private
+    
+}
+
+/** Create a context for encrypting or decrypting with AES in CBC mode.
+ 
+ @param encrypt `YES` to encrypt, `NO` to decrypt.
+ @param key The key, which must be 16, 24 or 32 bytes long.
+ @param keyLength The length of the key.
+ @param iv The `FZACryptoBlockLength`-byte initialization vector.
+ @param usePadding `YES` to use PKCS#7 padding, `NO` if the input is always a whole number of blocks.
+ @param error Upon failure, an error in `FZACryptorErrorDomain`.
+ 
+ @return A new, retained context, or `nil` if the context could not be created.
+ 
+ @warning This method must be overridden by subclasses. */
+- (id <FZACipherContext>)newCipherContextForEncryption:(BOOL)encrypt key:(const void *)key keyLength:(size_t)keyLength iv:(const void *)iv padding:(BOOL)usePadding error:(NSError **)error;
+
+/** Create a context for calculating a SHA-256 HMAC.
+ 
+ @param key The HMAC key.
+ @param keyLength The length of the key.
+ @param error Upon failure, an error in `FZACryptorErrorDomain`.
+ 
+ @return A new, retained context, or `nil` if the context could not be created.
+ 
+ @warning This method must be overridden by subclasses. */
+- (id <FZAHMACContext>)newHMACContextWithKey:(const void *)key keyLength:(size_t)keyLength error:(NSError **)error;
+
+/** Calculate a SHA-256 digest.
+ 
+ @param bytes The bytes to digest.
+ @param length The number of bytes.
+ @param digest A buffer of `FZACryptoDigestLength` bytes to hold the digest. It may overlap `bytes`.
+ 
+ @warning This method must be overridden by subclasses. */
+- (void)digestBytes:(const void *)bytes length:(size_t)length into:(uint8_t *)digest;
+
+/** Encrypt or decrypt a whole number of blocks in one go, without padding.
+ 
+ @param encrypt `YES` to encrypt, `NO` to decrypt.
+ @param key The key, which must be 16, 24 or 32 bytes long.
+ @param keyLength The length of the key.
+ @param iv The `FZACryptoBlockLength`-byte initialization vector.
+ @param bytes The input, which must be a multiple of `FZACryptoBlockLength` bytes long.
+ @param length The length of the input.
+ @param output A buffer of at least `length` bytes for the output.
+ @param error Upon failure, an error in `FZACryptorErrorDomain`.
+ 
+ @return `YES` if the input was processed, otherwise `NO`. */
+- (BOOL)cryptBlocksEncrypting:(BOOL)encrypt key:(const void *)key keyLength:(size_t)keyLength iv:(const void *)iv bytes:(const void *)bytes length:(size_t)length output:(void *)output error:(NSError **)error;
+
+/** Return a new subclass of this class, appropriate to the current platform. */
++ (FZACryptoProvider *)newCryptoProvider;
+
+@end
@@ -0,0 +1,73 @@
+//
+// FZACryptoProvider.m
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "TICoreDataSync.h"
+
+@implementation FZACryptoProvider
+
+- (id <FZACipherContext>)newCipherContextForEncryption:(BOOL)encrypt key:(const void *)key keyLength:(size_t)keyLength iv:(const void *)iv padding:(BOOL)usePadding error:(NSError **)error {
+    [[NSException exceptionWithName: @"FZACryptoProviderAbstractClassException"
+                             reason: @"Use +[FZACryptoProvider newCryptoProvider] to get an appropriate subclass"
+                           userInfo: nil] raise];
+    //never reached
+    return nil;
+}
+
+- (id <FZAHMACContext>)newHMACContextWithKey:(const void *)key keyLength:(size_t)keyLength error:(NSError **)error {
+    [[NSException exceptionWithName: @"FZACryptoProviderAbstractClassException"
+                             reason: @"Use +[FZACryptoProvider newCryptoProvider] to get an appropriate subclass"
+                           userInfo: nil] raise];
+    //never reached
+    return nil;
+}
+
+- (void)digestBytes:(const void *)bytes length:(size_t)length into:(uint8_t *)digest {
+    [[NSException exceptionWithName: @"FZACryptoProviderAbstractClassException"
+                             reason: @"Use +[FZACryptoProvider newCryptoProvider] to get an appropriate subclass"
+                           userInfo: nil] raise];
+}
+
+- (BOOL)cryptBlocksEncrypting:(BOOL)encrypt key:(const void *)key keyLength:(size_t)keyLength iv:(const void *)iv bytes:(const void *)bytes length:(size_t)length output:(void *)output error:(NSError **)error {
+    id <FZACipherContext> context = [self newCipherContextForEncryption: encrypt key: key keyLength: keyLength iv: iv padding: NO error: error];
+    if (context == nil) {
+        return NO;
+    }
+    
+    size_t updateLength = 0;
+    size_t finalLength = 0;
+    BOOL success = [context updateWithBytes: bytes length: length output: output capacity: length outputLength: &updateLength error: error] &&
+                   [context finishWithOutput: (uint8_t *)output + updateLength capacity: length - updateLength outputLength: &finalLength error: error];
+    [context release];
+    
+    return success;
+}
+
++ (FZACryptoProvider *)newCryptoProvider {
+    id cryptoProvider = nil;
+#if FZA_USE_OPENSSL
+    cryptoProvider = [[FZACryptoProviderOpenSSL alloc] init];
+#else
+    cryptoProvider = [[FZACryptoProviderCommonCrypto alloc] init];
+#endif
+    return cryptoProvider;
+}
+
+@end
@@ -0,0 +1,167 @@
+//
+// FZACryptoProviderCommonCrypto.m
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "TICoreDataSync.h"
+
+#if !FZA_USE_OPENSSL
+
+#import <CommonCrypto/CommonCryptor.h>
+#import <CommonCrypto/CommonDigest.h>
+#import <CommonCrypto/CommonHMAC.h>
+
+@interface FZACommonCryptoCipherContext : NSObject <FZACipherContext> {
+@private
+    CCCryptorRef cryptor;
+}
+
+- (id)initWithCryptor:(CCCryptorRef)aCryptor;
+
+@end
+
+@implementation FZACommonCryptoCipherContext
+
+- (id)initWithCryptor:(CCCryptorRef)aCryptor {
+    self = [super init];
+    if (self) {
+        cryptor = aCryptor;
+    }
+    
+    return self;
+}
+
+- (BOOL)updateWithBytes:(const void *)bytes length:(size_t)length output:(void *)output capacity:(size_t)capacity outputLength:(size_t *)outLength error:(NSError **)error {
+    CCCryptorStatus status = CCCryptorUpdate(cryptor, bytes, length, output, capacity, outLength);
+    if (status != kCCSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain: FZACryptorErrorDomain code: status userInfo: nil];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)finishWithOutput:(void *)output capacity:(size_t)capacity outputLength:(size_t *)outLength error:(NSError **)error {
+    CCCryptorStatus status = CCCryptorFinal(cryptor, output, capacity, outLength);
+    if (status != kCCSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain: FZACryptorErrorDomain code: status userInfo: nil];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (void)dealloc {
+    CCCryptorRelease(cryptor);
+    [super dealloc];
+}
+
+@end
+
+@interface FZACommonCryptoHMACContext : NSObject <FZAHMACContext> {
+@private
+    CCHmacContext hmacContext;
+}
+
+- (id)initWithKey:(const void *)key keyLength:(size_t)keyLength;
+
+@end
+
+@implementation FZACommonCryptoHMACContext
+
+- (id)initWithKey:(const void *)key keyLength:(size_t)keyLength {
+    self = [super init];
+    if (self) {
+        CCHmacInit(&hmacContext, kCCHmacAlgSHA256, key, keyLength);
+    }
+    
+    return self;
+}
+
+- (void)updateWithBytes:(const void *)bytes length:(size_t)length {
+    CCHmacUpdate(&hmacContext, bytes, length);
+}
+
+- (void)finishWithDigest:(uint8_t *)digest {
+    CCHmacFinal(&hmacContext, digest);
+}
+
+- (void)dealloc {
+    memset(&hmacContext, 0, sizeof(hmacContext));
+    [super dealloc];
+}
+
+@end
+
+@implementation FZACryptoProviderCommonCrypto
+
+- (id <FZACipherContext>)newCipherContextForEncryption:(BOOL)encrypt key:(const void *)key keyLength:(size_t)keyLength iv:(const void *)iv padding:(BOOL)usePadding error:(NSError **)error {
+    CCCryptorRef cryptor = NULL;
+    CCCryptorStatus status = CCCryptorCreate(encrypt ? kCCEncrypt : kCCDecrypt,
+                                             kCCAlgorithmAES128,
+                                             usePadding ? kCCOptionPKCS7Padding : 0,
+                                             key,
+                                             keyLength,
+                                             iv,
+                                             &cryptor);
+    if (status != kCCSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain: FZACryptorErrorDomain code: status userInfo: nil];
+        }
+        return nil;
+    }
+    
+    return [[FZACommonCryptoCipherContext alloc] initWithCryptor: cryptor];
+}
+
+- (id <FZAHMACContext>)newHMACContextWithKey:(const void *)key keyLength:(size_t)keyLength error:(NSError **)error {
+    return [[FZACommonCryptoHMACContext alloc] initWithKey: key keyLength: keyLength];
+}
+
+- (void)digestBytes:(const void *)bytes length:(size_t)length into:(uint8_t *)digest {
+    CC_SHA256(bytes, (CC_LONG)length, digest);
+}
+
+- (BOOL)cryptBlocksEncrypting:(BOOL)encrypt key:(const void *)key keyLength:(size_t)keyLength iv:(const void *)iv bytes:(const void *)bytes length:(size_t)length output:(void *)output error:(NSError **)error {
+    size_t outLength = 0;
+    CCCryptorStatus status = CCCrypt(encrypt ? kCCEncrypt : kCCDecrypt,
+                                     kCCAlgorithmAES128,
+                                     0,
+                                     key,
+                                     keyLength,
+                                     iv,
+                                     bytes,
+                                     length,
+                                     output,
+                                     length,
+                                     &outLength);
+    if (status != kCCSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain: FZACryptorErrorDomain code: status userInfo: nil];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+@end
+
+#endif
@@ -0,0 +1,199 @@
+//
+// FZACryptoProviderOpenSSL.m
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "TICoreDataSync.h"
+
+#if FZA_USE_OPENSSL
+
+#import <limits.h>
+#import <openssl/err.h>
+#import <openssl/evp.h>
+
+static NSError *FZAOpenSSLError(void) {
+    char description[256] = {0};
+    unsigned long errorCode = ERR_get_error();
+    ERR_clear_error();
+    if (errorCode == 0) {
+        return [NSError errorWithDomain: FZACryptorErrorDomain code: FZACryptorErrorCodeProviderFailure userInfo: nil];
+    }
+    
+    ERR_error_string_n(errorCode, description, sizeof(description));
+    return [NSError errorWithDomain: FZACryptorErrorDomain
+                               code: FZACryptorErrorCodeProviderFailure
+                           userInfo: [NSDictionary dictionaryWithObject: [NSString stringWithUTF8String: description] forKey: NSLocalizedDescriptionKey]];
+}
+
+static const EVP_CIPHER *FZAOpenSSLCipherForKeyLength(size_t keyLength) {
+    switch (keyLength) {
+        case 16:
+            return EVP_aes_128_cbc();
+        case 24:
+            return EVP_aes_192_cbc();
+        case 32:
+            return EVP_aes_256_cbc();
+        default:
+            return NULL;
+    }
+}
+
+@interface FZAOpenSSLCipherContext : NSObject <FZACipherContext> {
+@private
+    EVP_CIPHER_CTX *cipherContext;
+}
+
+- (id)initWithCipherContext:(EVP_CIPHER_CTX *)aCipherContext;
+
+@end
+
+@implementation FZAOpenSSLCipherContext
+
+- (id)initWithCipherContext:(EVP_CIPHER_CTX *)aCipherContext {
+    self = [super init];
+    if (self) {
+        cipherContext = aCipherContext;
+    }
+    
+    return self;
+}
+
+- (BOOL)updateWithBytes:(const void *)bytes length:(size_t)length output:(void *)output capacity:(size_t)capacity outputLength:(size_t *)outLength error:(NSError **)error {
+    int bytesOut = 0;
+    // EVP doesn't take the capacity, so callers must size output as FZACipherContext documents
+    if (length > INT_MAX - FZACryptoBlockLength ||
+        EVP_CipherUpdate(cipherContext, output, &bytesOut, bytes, (int)length) != 1) {
+        if (error) {
+            *error = FZAOpenSSLError();
+        }
+        return NO;
+    }
+    *outLength = bytesOut;
+    return YES;
+}
+
+- (BOOL)finishWithOutput:(void *)output capacity:(size_t)capacity outputLength:(size_t *)outLength error:(NSError **)error {
+    int bytesOut = 0;
+    if (EVP_CipherFinal_ex(cipherContext, output, &bytesOut) != 1) {
+        if (error) {
+            *error = FZAOpenSSLError();
+        }
+        return NO;
+    }
+    *outLength = bytesOut;
+    return YES;
+}
+
+- (void)dealloc {
+    EVP_CIPHER_CTX_free(cipherContext);
+    [super dealloc];
+}
+
+@end
+
+@interface FZAOpenSSLHMACContext : NSObject <FZAHMACContext> {
+@private
+    EVP_MD_CTX *digestContext;
+}
+
+- (id)initWithDigestContext:(EVP_MD_CTX *)aDigestContext;
+
+@end
+
+@implementation FZAOpenSSLHMACContext
+
+- (id)initWithDigestContext:(EVP_MD_CTX *)aDigestContext {
+    self = [super init];
+    if (self) {
+        digestContext = aDigestContext;
+    }
+    
+    return self;
+}
+
+- (void)updateWithBytes:(const void *)bytes length:(size_t)length {
+    EVP_DigestSignUpdate(digestContext, bytes, length);
+}
+
+- (void)finishWithDigest:(uint8_t *)digest {
+    size_t digestLength = FZACryptoDigestLength;
+    EVP_DigestSignFinal(digestContext, digest, &digestLength);
+}
+
+- (void)dealloc {
+    EVP_MD_CTX_free(digestContext);
+    [super dealloc];
+}
+
+@end
+
+@implementation FZACryptoProviderOpenSSL
+
+- (id <FZACipherContext>)newCipherContextForEncryption:(BOOL)encrypt key:(const void *)key keyLength:(size_t)keyLength iv:(const void *)iv padding:(BOOL)usePadding error:(NSError **)error {
+    const EVP_CIPHER *cipher = FZAOpenSSLCipherForKeyLength(keyLength);
+    if (cipher == NULL) {
+        if (error) {
+            *error = [NSError errorWithDomain: FZACryptorErrorDomain code: FZACryptorErrorCodeProviderFailure userInfo: nil];
+        }
+        return nil;
+    }
+    
+    EVP_CIPHER_CTX *cipherContext = EVP_CIPHER_CTX_new();
+    if (!cipherContext ||
+        EVP_CipherInit_ex(cipherContext, cipher, NULL, key, iv, encrypt ? 1 : 0) != 1 ||
+        EVP_CIPHER_CTX_set_padding(cipherContext, usePadding ? 1 : 0) != 1) {
+        if (error) {
+            *error = FZAOpenSSLError();
+        }
+        EVP_CIPHER_CTX_free(cipherContext);
+        return nil;
+    }
+    
+    return [[FZAOpenSSLCipherContext alloc] initWithCipherContext: cipherContext];
+}
+
+- (id <FZAHMACContext>)newHMACContextWithKey:(const void *)key keyLength:(size_t)keyLength error:(NSError **)error {
+    EVP_PKEY *hmacKey = EVP_PKEY_new_raw_private_key(EVP_PKEY_HMAC, NULL, key, keyLength);
+    EVP_MD_CTX *digestContext = EVP_MD_CTX_new();
+    if (!hmacKey || !digestContext ||
+        EVP_DigestSignInit(digestContext, NULL, EVP_sha256(), NULL, hmacKey) != 1) {
+        if (error) {
+            *error = FZAOpenSSLError();
+        }
+        EVP_MD_CTX_free(digestContext);
+        EVP_PKEY_free(hmacKey);
+        return nil;
+    }
+    // the context holds its own reference to the key
+    EVP_PKEY_free(hmacKey);
+    
+    return [[FZAOpenSSLHMACContext alloc] initWithDigestContext: digestContext];
+}
+
+- (void)digestBytes:(const void *)bytes length:(size_t)length into:(uint8_t *)digest {
+    // EVP_Digest doesn't promise that the digest may overlap the input
+    uint8_t digestBuffer[EVP_MAX_MD_SIZE];
+    EVP_Digest(bytes, length, digestBuffer, NULL, EVP_sha256(), NULL);
+    memcpy(digest, digestBuffer, FZACryptoDigestLength);
+    memset(digestBuffer, 0, sizeof(digestBuffer));
+}
+
+@end
+
+#endif
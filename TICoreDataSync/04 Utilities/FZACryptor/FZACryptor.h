@@ -25,13 +25,22 @@
 #import <Foundation/Foundation.h>
 
 @class FZAKeyManager;
+@class FZACryptoProvider;
 
 /** `FZACryptor` is the public interface to the `TICoreDataSync` encryption module. */
 @interface FZACryptor : NSObject {
 @private
     FZAKeyManager *keyManager;
+    FZACryptoProvider *cryptoProvider;
 }
 
+/** @name Crypto Provider */
+
+/** The provider of the AES and HMAC primitives, by default the one returned by `+[FZACryptoProvider newCryptoProvider]`.
+ 
+ Every provider produces the same file format, so this only needs changing to use a different crypto library. */
+@property (nonatomic, retain) FZACryptoProvider *cryptoProvider;
+
 /** @name Configuration */
 
 /** Reports whether this object has already got a key and can be used for crypto operations.
@@ -69,8 +78,8 @@
      (end-32)-end   A SHA-256 HMAC derived using the sync key.
  
  @param plainTextURL The URL of the file to be encrypted.
- @param cipherTextURL The URL of the file to write the encrypted file. Any existing content will be blindly truncated.
- @param error Possible errors include no password being configured or the keychain item being corrupted, or not being able to read from the source or  write to the destination. The error codes come from `CommonCrypto/CommonCryptor.h`.
+ @param cipherTextURL The URL of the file to write the encrypted file. The encrypted data is written to a hidden file in the same directory, which replaces any existing file at this location only once encryption succeeds.
+ @param error Possible errors include no password being configured or the keychain item being corrupted, or not being able to read from the source or  write to the destination. The error codes come from the crypto provider (e.g., `CommonCrypto/CommonCryptor.h`).
  
  @return `YES` if the encryption succeeds, otherwise `NO` and the error is set.
  
@@ -80,11 +89,37 @@
 /** Decrypt the content of a file, storing the clear-text data in another file.
  
  @param cipherTextURL The file to be decrypted.
- @param plainTextURL The location to write the decrypted file. Any existing content will be blindly truncated.
- @param error Possible errors include no password being configured or the keychain item being corrupted, not being able to read from the source or write to the destination, or the cipher text file not being in the expected format. Errors come either from `CommonCrypto/CommonCryptor.h` or from the enumeration at the end of `TICDSTypesAndEnums.h`.
+ @param plainTextURL The location to write the decrypted file. The clear text is written to a hidden file in the same directory, which replaces any existing file at this location only once the HMAC has been verified and decryption succeeds.
+ @param error Possible errors include no password being configured or the keychain item being corrupted, not being able to read from the source or write to the destination, or the cipher text file not being in the expected format. Errors come either from the crypto provider (e.g., `CommonCrypto/CommonCryptor.h`) or from the enumeration at the end of `TICDSTypesAndEnums.h`.
  
  @return `YES` if the decryption succeeds, otherwise `NO` and the error is set.
  
  @warning Any exceptions encountered in dealing with the filesystem will be propagated to the calling code. It is therefore up to the calling code to make sure it's working with a reliable filesystem, or to handle exceptions occurring in here. */
 - (BOOL)decryptFileAtLocation: (NSURL *)cipherTextURL writingToLocation: (NSURL *)plainTextURL error: (NSError **)error;
+
+/** @name Stream Encryption and Decryption */
+
+/** Encrypt the content of a stream, writing the encrypted data to another stream in the same format as `encryptFileAtLocation:writingToLocation:error:`.
+ 
+ This lets callers encrypt straight into a remote destination, rather than staging the cipher text in a temporary file.
+ 
+ @param plainTextStream An open stream to read the clear text from. It is read until it ends.
+ @param cipherTextStream An open stream to write the encrypted data to.
+ @param error Possible errors include failing to read from or write to either stream, or errors from the crypto provider.
+ 
+ @return `YES` if the encryption succeeds, otherwise `NO` and the error is set. Neither stream is closed. */
+- (BOOL)encryptStream: (NSInputStream *)plainTextStream toStream: (NSOutputStream *)cipherTextStream error: (NSError **)error;
+
+/** Decrypt the content of a stream, writing the clear text to another stream.
+ 
+ The cipher text is read only once: the HMAC is calculated as the content is decrypted, and checked once the stream ends.
+ 
+ @param cipherTextStream An open stream to read the encrypted data from. It is read until it ends.
+ @param plainTextStream An open stream to write the clear text to.
+ @param error Possible errors include failing to read from or write to either stream, the cipher text not being in the expected format, or errors from the crypto provider.
+ 
+ @return `YES` if the decryption succeeds and the HMAC matches, otherwise `NO` and the error is set. Neither stream is closed.
+ 
+ @warning Clear text is written to `plainTextStream` before the HMAC can be checked. If this method returns `NO`, anything written to the stream must be discarded. */
+- (BOOL)decryptStream: (NSInputStream *)cipherTextStream toStream: (NSOutputStream *)plainTextStream error: (NSError **)error;
 @end
\ No newline at end of file
@@ -23,11 +23,12 @@
 // THE SOFTWARE.
 
 #import "TICoreDataSync.h"
-#import <CommonCrypto/CommonCryptor.h>
-#import <CommonCrypto/CommonHMAC.h>
+#import <errno.h>
+#import <unistd.h>
+#import <stdio.h>
 
 const NSInteger FZASaltLength = 16;
-const NSInteger FZAFileBlockLength = 4096;
+const NSInteger FZAFileBlockLength = 65536;
 
 @implementation FZACryptor
 
@@ -61,340 +62,397 @@ const NSInteger FZAFileBlockLength = 4096;
     return salt;
 }
 
+#pragma mark Stream helpers
+
+static NSError *FZACryptorStreamError(NSStream *stream) {
+    NSError *streamError = [stream streamError];
+    if (streamError) {
+        return streamError;
+    }
+    return [NSError errorWithDomain: NSPOSIXErrorDomain code: EIO userInfo: nil];
+}
+
+/* Reads until the buffer is full or the stream ends. Returns the number of bytes
+ * read, or -1 on error.
+ */
+static NSInteger FZACryptorReadFully(NSInputStream *stream, uint8_t *buffer, NSUInteger length) {
+    NSUInteger totalRead = 0;
+    while (totalRead < length) {
+        NSInteger bytesRead = [stream read: buffer + totalRead maxLength: length - totalRead];
+        if (bytesRead < 0) {
+            return -1;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        totalRead += bytesRead;
+    }
+    return totalRead;
+}
+
+static BOOL FZACryptorWriteFully(NSOutputStream *stream, const uint8_t *buffer, NSUInteger length) {
+    NSUInteger totalWritten = 0;
+    while (totalWritten < length) {
+        NSInteger bytesWritten = [stream write: buffer + totalWritten maxLength: length - totalWritten];
+        if (bytesWritten <= 0) {
+            return NO;
+        }
+        totalWritten += bytesWritten;
+    }
+    return YES;
+}
+
 #pragma mark Crypto
 
-- (BOOL)encryptFileAtLocation:(NSURL *)plainTextURL writingToLocation:(NSURL *)cipherTextURL error:(NSError **)error {
-    NSParameterAssert([plainTextURL isFileURL]);
-    NSParameterAssert([cipherTextURL isFileURL]);
+- (BOOL)encryptStream:(NSInputStream *)plainTextStream toStream:(NSOutputStream *)cipherTextStream error:(NSError **)error {
+    NSParameterAssert(plainTextStream != nil);
+    NSParameterAssert(cipherTextStream != nil);
     NSAssert([self isConfigured], @"can't encrypt without a key");
 
-    //set up the files
-	NSFileHandle *readHandle = [NSFileHandle fileHandleForReadingAtPath:[plainTextURL path]];
-    if (!readHandle) {
-        return NO;
-    }
-    //unilaterally destroy anything already at the target location
-    NSFileManager *mgr = [[NSFileManager alloc] init];
-    BOOL fileCreated = [mgr createFileAtPath: [cipherTextURL path]
-                                    contents: nil
-                                  attributes: nil];
-    NSDictionary *inputFileAttributes = [mgr attributesOfItemAtPath: [plainTextURL path]
-                                                              error: error];
-    [mgr release];
-    if (inputFileAttributes == nil) {
+    uint8_t *bytesRead = malloc(FZAFileBlockLength);
+    uint8_t *bytesToWrite = malloc(FZAFileBlockLength + FZACryptoBlockLength);
+    if (!bytesRead || !bytesToWrite) {
+        if (error) {
+            *error = [NSError errorWithDomain: NSPOSIXErrorDomain code: ENOMEM userInfo: nil];
+        }
+        free(bytesRead);
+        free(bytesToWrite);
         return NO;
     }
-    unsigned long long inputFileLength = [inputFileAttributes fileSize];
     
-    if (!fileCreated) {
-        return NO;
-    }
-    NSFileHandle *writeHandle = [NSFileHandle fileHandleForWritingAtPath: [cipherTextURL path]];
-    if (!writeHandle) {
+    //set up the crypto
+    NSData *syncKey = [keyManager key];
+    NSData *topLevelIV = [keyManager randomDataOfLength: FZACryptoBlockLength];
+    id <FZAHMACContext> hmacContext = [cryptoProvider newHMACContextWithKey: [syncKey bytes] keyLength: [syncKey length] error: error];
+    if (hmacContext == nil) {
+        free(bytesRead);
+        free(bytesToWrite);
         return NO;
     }
-    uint8_t *bytesToWrite = malloc(FZAFileBlockLength);
-    if (!bytesToWrite) {
-        if (error) {
-            *error = [NSError errorWithDomain: NSPOSIXErrorDomain code: errno userInfo: nil];
-        }
+    [hmacContext updateWithBytes: [topLevelIV bytes] length: [topLevelIV length]];
+    NSData *fileKeyAndIV = [keyManager randomDataOfLength: FZACryptoFileKeyLength + FZACryptoBlockLength];
+    uint8_t cryptedKeyIV[FZACryptoFileKeyLength + FZACryptoBlockLength] = {0};
+    if (![cryptoProvider cryptBlocksEncrypting: YES
+                                           key: [syncKey bytes]
+                                     keyLength: [syncKey length]
+                                            iv: [topLevelIV bytes]
+                                         bytes: [fileKeyAndIV bytes]
+                                        length: [fileKeyAndIV length]
+                                        output: cryptedKeyIV
+                                         error: error]) {
+        [hmacContext release];
+        free(bytesRead);
+        free(bytesToWrite);
         return NO;
     }
+    [hmacContext updateWithBytes: cryptedKeyIV length: sizeof(cryptedKeyIV)];
     
-    //set up the crypto
-    NSData *syncKey = [keyManager key];
-    NSData *topLevelIV = [keyManager randomDataOfLength: kCCBlockSizeAES128];
-    CCHmacContext hmacContext;
-    CCHmacInit(&hmacContext, kCCHmacAlgSHA256, [syncKey bytes], [syncKey length]);
-    CCHmacUpdate(&hmacContext, [topLevelIV bytes], [topLevelIV length]);
-    [writeHandle writeData: topLevelIV];
-    NSData *fileKeyAndIV = [keyManager randomDataOfLength: kCCKeySizeAES256 + kCCBlockSizeAES128];
-    uint8_t cryptedKeyIV[kCCKeySizeAES256 + kCCBlockSizeAES128] = {0};
-    size_t cryptedLength = 0;
-    CCCryptorStatus status = CCCrypt(kCCEncrypt,
-                                     kCCAlgorithmAES128,
-                                     0,
-                                     [syncKey bytes],
-                                     [syncKey length],
-                                     [topLevelIV bytes],
-                                     [fileKeyAndIV bytes],
-                                     [fileKeyAndIV length],
-                                     cryptedKeyIV, 
-                                     kCCKeySizeAES256 + kCCBlockSizeAES128, 
-                                     &cryptedLength);
-    if (status != kCCSuccess) {
+    if (!FZACryptorWriteFully(cipherTextStream, [topLevelIV bytes], [topLevelIV length]) ||
+        !FZACryptorWriteFully(cipherTextStream, cryptedKeyIV, sizeof(cryptedKeyIV))) {
         if (error) {
-            *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                         code: status
-                                     userInfo: nil];
+            *error = FZACryptorStreamError(cipherTextStream);
         }
+        [hmacContext release];
+        free(bytesRead);
         free(bytesToWrite);
         return NO;
     }
-    NSData *outgoingData = [NSData dataWithBytesNoCopy: cryptedKeyIV
-                                                length: cryptedLength
-                                          freeWhenDone: NO];
-    [writeHandle writeData: outgoingData];
     
-    CCHmacUpdate(&hmacContext, [outgoingData bytes], [outgoingData length]);
-    
-    NSData *key = [NSData dataWithBytes: [fileKeyAndIV bytes] length: kCCKeySizeAES256];
-    NSData *iv = [NSData dataWithBytes: [fileKeyAndIV bytes] + kCCKeySizeAES256
-                                length: kCCBlockSizeAES128];
-    CCCryptorRef cryptor = NULL;
-    status = CCCryptorCreate(kCCEncrypt,
-                             kCCAlgorithmAES128,
-                             kCCOptionPKCS7Padding,
-                             [key bytes],
-                             [key length],
-                             [iv bytes],
-                             &cryptor);
-    if (status != kCCSuccess) {
-        if (error) {
-            *error = [NSError errorWithDomain: FZACryptorErrorDomain code: status userInfo: nil];
-        }
+    id <FZACipherContext> cryptor = [cryptoProvider newCipherContextForEncryption: YES
+                                                                              key: [fileKeyAndIV bytes]
+                                                                        keyLength: FZACryptoFileKeyLength
+                                                                               iv: [fileKeyAndIV bytes] + FZACryptoFileKeyLength
+                                                                          padding: YES
+                                                                            error: error];
+    if (cryptor == nil) {
+        [hmacContext release];
+        free(bytesRead);
         free(bytesToWrite);
         return NO;
     }
     
     //do it!
-    do {
-        NSAutoreleasePool *inLoopPool = [[NSAutoreleasePool alloc] init];
-        NSData *dataRead = [readHandle readDataOfLength: FZAFileBlockLength];
+    BOOL success = YES;
+    while (success) {
+        NSInteger lengthRead = FZACryptorReadFully(plainTextStream, bytesRead, FZAFileBlockLength);
+        if (lengthRead < 0) {
+            if (error) {
+                *error = FZACryptorStreamError(plainTextStream);
+            }
+            success = NO;
+            break;
+        }
+        
         size_t bytesOut = 0;
-        status = CCCryptorUpdate(cryptor,
-                                 [dataRead bytes],
-                                 [dataRead length],
-                                 bytesToWrite,
-                                 FZAFileBlockLength,
-                                 &bytesOut);
-        if (status != kCCSuccess) {
+        if (lengthRead > 0) {
+            success = [cryptor updateWithBytes: bytesRead
+                                        length: lengthRead
+                                        output: bytesToWrite
+                                      capacity: FZAFileBlockLength + FZACryptoBlockLength
+                                  outputLength: &bytesOut
+                                         error: error];
+        } else {
+            success = [cryptor finishWithOutput: bytesToWrite
+                                       capacity: FZAFileBlockLength + FZACryptoBlockLength
+                                   outputLength: &bytesOut
+                                          error: error];
+        }
+        if (!success) {
+            break;
+        }
+        
+        if (!FZACryptorWriteFully(cipherTextStream, bytesToWrite, bytesOut)) {
             if (error) {
-                *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                             code: status
-                                         userInfo: nil];
+                *error = FZACryptorStreamError(cipherTextStream);
             }
-            free(bytesToWrite);
-            [inLoopPool drain];
-            return NO;
+            success = NO;
+            break;
         }
-        NSData *outData = [NSData dataWithBytesNoCopy: bytesToWrite
-                                               length: bytesOut
-                                         freeWhenDone: NO];
-        [writeHandle writeData: outData];
-        CCHmacUpdate(&hmacContext, [outData bytes], [outData length]);
+        [hmacContext updateWithBytes: bytesToWrite length: bytesOut];
         
-        [inLoopPool drain];
-    } while ([readHandle offsetInFile] < inputFileLength);
-
-    size_t finalBlockSize = 0;
-    status = CCCryptorFinal(cryptor,
-                            bytesToWrite,
-                            FZAFileBlockLength,
-                            &finalBlockSize);
-    if (status != kCCSuccess) {
-        if (error) {
-            *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                         code: status
-                                     userInfo: nil];
+        if (lengthRead == 0) {
+            break;
         }
-        free(bytesToWrite);
-        return NO;
     }
-    CCCryptorRelease(cryptor);
-    
-    NSData *finalBlock = [NSData dataWithBytesNoCopy: bytesToWrite
-                                              length: finalBlockSize
-                                        freeWhenDone: NO];
-    [writeHandle writeData: finalBlock];
-    
-    CCHmacUpdate(&hmacContext, [finalBlock bytes], [finalBlock length]);
-    uint8_t hmac[CC_SHA256_DIGEST_LENGTH];
-    CCHmacFinal(&hmacContext, hmac);
-    NSData *hmacData = [NSData dataWithBytesNoCopy: hmac
-                                            length: CC_SHA256_DIGEST_LENGTH
-                                      freeWhenDone: NO];
-    [writeHandle writeData: hmacData];
-    
-
+    [cryptor release];
+    free(bytesRead);
     free(bytesToWrite);
-    [writeHandle closeFile];
     
-    return YES;
-}
-
-- (BOOL)decryptFileAtLocation:(NSURL *)cipherTextURL writingToLocation:(NSURL *)plainTextURL error:(NSError **)error {
-    NSParameterAssert([cipherTextURL isFileURL]);
-    NSParameterAssert([plainTextURL isFileURL]);
-
-        //set up the files
-    NSFileManager *fileManager = [[NSFileManager alloc] init];
-    NSFileHandle *readHandle = [NSFileHandle fileHandleForReadingAtPath: [cipherTextURL path]];
-    if (!readHandle) {
-        [fileManager release];
-        return NO;
-    }
-    NSDictionary *cipherFileAttributes = [fileManager attributesOfItemAtPath: [cipherTextURL path]
-                                                                       error: error];
-    if (cipherFileAttributes == nil) {
-        [fileManager release];
-        return NO;
-    }
-    unsigned long long cipherSize = [cipherFileAttributes fileSize];
+    uint8_t hmac[FZACryptoDigestLength];
+    [hmacContext finishWithDigest: hmac];
+    [hmacContext release];
     
-    //unilaterally destroy anything already at the target location
-    BOOL fileCreated = [fileManager createFileAtPath: [plainTextURL path]
-                                    contents: nil
-                                  attributes: nil];
-    [fileManager release];
-    if (!fileCreated) {
+    if (!success) {
         return NO;
     }
-    NSFileHandle *writeHandle = [NSFileHandle fileHandleForWritingAtPath: [plainTextURL path]];
-    if (!writeHandle) {
+    
+    if (!FZACryptorWriteFully(cipherTextStream, hmac, FZACryptoDigestLength)) {
+        if (error) {
+            *error = FZACryptorStreamError(cipherTextStream);
+        }
         return NO;
     }
     
-    /* first things first - we verify the HMAC. If that doesn't work, the file is
-     * corrupt or has been tampered with: either way we can't use it. Note this means
-     * we're going to have to read in the file's contents twice: that's just the way
-     * it goes.
+    return YES;
+}
+
+- (BOOL)decryptStream:(NSInputStream *)cipherTextStream toStream:(NSOutputStream *)plainTextStream error:(NSError **)error {
+    NSParameterAssert(cipherTextStream != nil);
+    NSParameterAssert(plainTextStream != nil);
+
+    /* The HMAC is verified as the content is decrypted, so the cipher text only
+     * has to be read once. The last FZACryptoDigestLength bytes read are always
+     * held back, because until the stream ends we can't tell whether they're the
+     * stored HMAC or more cipher text.
      */
     NSData *syncKey = [keyManager key];
-    CCHmacContext hmacContext;
-    CCHmacInit(&hmacContext, kCCHmacAlgSHA256, [syncKey bytes], [syncKey length]);
-    do {
-        NSAutoreleasePool *inLoopPool = [[NSAutoreleasePool alloc] init];
-        unsigned long long bytesRemaining = cipherSize - CC_SHA256_DIGEST_LENGTH - [readHandle offsetInFile];
-        size_t bytesToRead = (bytesRemaining > FZAFileBlockLength) ?
-            FZAFileBlockLength : (size_t)bytesRemaining;
-        NSData *readData = [readHandle readDataOfLength: bytesToRead];
-        CCHmacUpdate(&hmacContext, [readData bytes], [readData length]);
-        [inLoopPool drain];
-    } while ([readHandle offsetInFile] < cipherSize - CC_SHA256_DIGEST_LENGTH);
 
-    uint8_t hmac[CC_SHA256_DIGEST_LENGTH];
-    CCHmacFinal(&hmacContext, hmac);
-    NSData *calculatedHmac = [NSData dataWithBytesNoCopy: hmac
-                                                  length: CC_SHA256_DIGEST_LENGTH 
-                                            freeWhenDone: NO];
-    
-    [readHandle seekToFileOffset: cipherSize - CC_SHA256_DIGEST_LENGTH];
-    NSData *storedHmac = [readHandle readDataToEndOfFile];
-    
-    if (![storedHmac isEqualToData: calculatedHmac]) {
+    //decrypt the file key and IV
+    uint8_t header[FZACryptoBlockLength + FZACryptoFileKeyLength + FZACryptoBlockLength] = {0};
+    NSInteger headerLength = FZACryptorReadFully(cipherTextStream, header, sizeof(header));
+    if (headerLength < 0) {
         if (error) {
-            *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                         code: FZACryptorErrorCodeFailedIntegrityCheck
-                                     userInfo: nil];
+            *error = FZACryptorStreamError(cipherTextStream);
         }
         return NO;
     }
-
-    //decrypt the file key and IV
-    [readHandle seekToFileOffset: 0];
-    NSData *topLevelIV = [readHandle readDataOfLength: kCCBlockSizeAES128];
-    NSData *fileKeyAndIV = [readHandle readDataOfLength: kCCKeySizeAES256 + kCCBlockSizeAES128];
-    uint8_t decryptedKeyAndIV[kCCKeySizeAES256 + kCCBlockSizeAES128] = {0};
-    size_t plainLength = 0;
-    CCCryptorStatus cryptResult = CCCrypt(kCCDecrypt,
-                                          kCCAlgorithmAES128,
-                                          0,
-                                          [syncKey bytes],
-                                          [syncKey length],
-                                          [topLevelIV bytes],
-                                          [fileKeyAndIV bytes],
-                                          [fileKeyAndIV length],
-                                          decryptedKeyAndIV,
-                                          kCCKeySizeAES256 + kCCBlockSizeAES128,
-                                          &plainLength);
-    if (cryptResult != kCCSuccess) {
+    if (headerLength < (NSInteger)sizeof(header)) {
         if (error) {
             *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                         code: cryptResult
+                                         code: FZACryptorErrorCodeFailedIntegrityCheck
                                      userInfo: nil];
         }
         return NO;
     }
     
-    NSData *key = [NSData dataWithBytesNoCopy: decryptedKeyAndIV
-                                       length: kCCKeySizeAES256
-                                 freeWhenDone: NO];
-    NSData *iv = [NSData dataWithBytesNoCopy: decryptedKeyAndIV + kCCKeySizeAES256
-                                      length: kCCBlockSizeAES128
-                                freeWhenDone: NO];
+    uint8_t decryptedKeyAndIV[FZACryptoFileKeyLength + FZACryptoBlockLength] = {0};
+    if (![cryptoProvider cryptBlocksEncrypting: NO
+                                           key: [syncKey bytes]
+                                     keyLength: [syncKey length]
+                                            iv: header
+                                         bytes: header + FZACryptoBlockLength
+                                        length: FZACryptoFileKeyLength + FZACryptoBlockLength
+                                        output: decryptedKeyAndIV
+                                         error: error]) {
+        return NO;
+    }
     
     //decrypt the file content.
-    uint8_t *bytesToWrite = malloc(FZAFileBlockLength);
-    CCCryptorRef cryptor = NULL;
-    cryptResult = CCCryptorCreate(kCCDecrypt,
-                                  kCCAlgorithmAES128,
-                                  kCCOptionPKCS7Padding,
-                                  [key bytes],
-                                  [key length],
-                                  [iv bytes],
-                                  &cryptor);
-    if (cryptResult != kCCSuccess) {
+    id <FZACipherContext> cryptor = [cryptoProvider newCipherContextForEncryption: NO
+                                                                              key: decryptedKeyAndIV
+                                                                        keyLength: FZACryptoFileKeyLength
+                                                                               iv: decryptedKeyAndIV + FZACryptoFileKeyLength
+                                                                          padding: YES
+                                                                            error: error];
+    memset(decryptedKeyAndIV, 0, sizeof(decryptedKeyAndIV));
+    if (cryptor == nil) {
+        return NO;
+    }
+    
+    // bytesRead holds the held-back tail followed by the newly read block
+    uint8_t *bytesRead = malloc(FZACryptoDigestLength + FZAFileBlockLength);
+    uint8_t *bytesToWrite = malloc(FZACryptoDigestLength + FZAFileBlockLength + FZACryptoBlockLength);
+    if (!bytesRead || !bytesToWrite) {
         if (error) {
-            *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                         code: cryptResult
-                                     userInfo: nil];
+            *error = [NSError errorWithDomain: NSPOSIXErrorDomain code: ENOMEM userInfo: nil];
         }
+        free(bytesRead);
+        free(bytesToWrite);
+        [cryptor release];
+        return NO;
+    }
+    
+    id <FZAHMACContext> hmacContext = [cryptoProvider newHMACContextWithKey: [syncKey bytes] keyLength: [syncKey length] error: error];
+    if (hmacContext == nil) {
+        free(bytesRead);
         free(bytesToWrite);
+        [cryptor release];
         return NO;
     }
+    [hmacContext updateWithBytes: header length: sizeof(header)];
     
-    do {
-        NSAutoreleasePool *inLoopPool = [[NSAutoreleasePool alloc] init];
-        unsigned long long bytesRemaining = cipherSize - CC_SHA256_DIGEST_LENGTH - [readHandle offsetInFile];
-        size_t bytesToRead = (bytesRemaining > FZAFileBlockLength) ?
-        FZAFileBlockLength : (size_t)bytesRemaining;
+    NSUInteger heldBackLength = 0;
+    BOOL success = YES;
+    BOOL finished = NO;
+    while (success && !finished) {
+        NSInteger lengthRead = FZACryptorReadFully(cipherTextStream, bytesRead + heldBackLength, FZAFileBlockLength);
+        if (lengthRead < 0) {
+            if (error) {
+                *error = FZACryptorStreamError(cipherTextStream);
+            }
+            success = NO;
+            break;
+        }
+        finished = (lengthRead == 0);
+        
+        NSUInteger available = heldBackLength + lengthRead;
+        NSUInteger contentLength = (available > FZACryptoDigestLength) ? available - FZACryptoDigestLength : 0;
+        
         size_t sizeToWrite = 0;
-        NSData *readData = [readHandle readDataOfLength: bytesToRead];
-        cryptResult = CCCryptorUpdate(cryptor,
-                                      [readData bytes],
-                                      [readData length],
-                                      bytesToWrite,
-                                      FZAFileBlockLength,
-                                      &sizeToWrite);
-        if (cryptResult != kCCSuccess) {
+        if (contentLength > 0) {
+            [hmacContext updateWithBytes: bytesRead length: contentLength];
+            if (![cryptor updateWithBytes: bytesRead
+                                   length: contentLength
+                                   output: bytesToWrite
+                                 capacity: FZACryptoDigestLength + FZAFileBlockLength + FZACryptoBlockLength
+                             outputLength: &sizeToWrite
+                                    error: error]) {
+                success = NO;
+                break;
+            }
+            if (!FZACryptorWriteFully(plainTextStream, bytesToWrite, sizeToWrite)) {
+                if (error) {
+                    *error = FZACryptorStreamError(plainTextStream);
+                }
+                success = NO;
+                break;
+            }
+        }
+        
+        heldBackLength = available - contentLength;
+        memmove(bytesRead, bytesRead + contentLength, heldBackLength);
+    }
+    
+    uint8_t hmac[FZACryptoDigestLength];
+    [hmacContext finishWithDigest: hmac];
+    [hmacContext release];
+    
+    if (success) {
+        // first things first - if the HMAC doesn't match, the file is corrupt or has been tampered with
+        if (heldBackLength != FZACryptoDigestLength || memcmp(hmac, bytesRead, FZACryptoDigestLength) != 0) {
             if (error) {
                 *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                             code: cryptResult
+                                             code: FZACryptorErrorCodeFailedIntegrityCheck
                                          userInfo: nil];
             }
-            free(bytesToWrite);
-            return NO;
+            success = NO;
         }
-        NSData *plainData = [NSData dataWithBytesNoCopy: bytesToWrite
-                                                 length: sizeToWrite
-                                           freeWhenDone: NO];
-        [writeHandle writeData: plainData];
-        [inLoopPool drain];
-    } while ([readHandle offsetInFile] < cipherSize - CC_SHA256_DIGEST_LENGTH);
+    }
     
-    size_t finalBlockSize = 0;
-    cryptResult = CCCryptorFinal(cryptor,
-                                 bytesToWrite,
-                                 FZAFileBlockLength,
-                                 &finalBlockSize);
-    if (cryptResult != kCCSuccess) {
-        if (error) {
-            *error = [NSError errorWithDomain: FZACryptorErrorDomain
-                                         code: cryptResult
-                                     userInfo: nil];
+    if (success) {
+        size_t finalBlockSize = 0;
+        if (![cryptor finishWithOutput: bytesToWrite
+                              capacity: FZACryptoDigestLength + FZAFileBlockLength + FZACryptoBlockLength
+                          outputLength: &finalBlockSize
+                                 error: error]) {
+            success = NO;
+        } else if (!FZACryptorWriteFully(plainTextStream, bytesToWrite, finalBlockSize)) {
+            if (error) {
+                *error = FZACryptorStreamError(plainTextStream);
+            }
+            success = NO;
         }
-        free(bytesToWrite);
-        return NO;
     }
-    NSData *finalData = [NSData dataWithBytesNoCopy: bytesToWrite
-                                             length: finalBlockSize
-                                       freeWhenDone: NO];
+    
+    [cryptor release];
+    free(bytesRead);
     free(bytesToWrite);
-    [writeHandle writeData: finalData];
-    [writeHandle closeFile];
 
-    return YES;
+    return success;
+}
+
+#pragma mark Files
+
+/* Writes to a hidden file alongside the destination, and only renames it into place
+ * once the block succeeds, so the destination never holds a partial or unverified file.
+ */
+- (BOOL)writeAtomicallyToLocation:(NSURL *)destinationURL readingFromLocation:(NSURL *)sourceURL error:(NSError **)error usingBlock:(BOOL (^)(NSInputStream *inputStream, NSOutputStream *outputStream, NSError **blockError))block {
+    NSString *destinationPath = [destinationURL path];
+    NSString *temporaryName = [NSString stringWithFormat: @".%@.%@.fzacryptor", [destinationPath lastPathComponent], [[NSProcessInfo processInfo] globallyUniqueString]];
+    NSString *temporaryPath = [[destinationPath stringByDeletingLastPathComponent] stringByAppendingPathComponent: temporaryName];
+    
+    NSInputStream *inputStream = [NSInputStream inputStreamWithFileAtPath: [sourceURL path]];
+    NSOutputStream *outputStream = [NSOutputStream outputStreamToFileAtPath: temporaryPath append: NO];
+    [inputStream open];
+    [outputStream open];
+    
+    BOOL success = YES;
+    if ([inputStream streamStatus] != NSStreamStatusOpen) {
+        if (error) {
+            *error = FZACryptorStreamError(inputStream);
+        }
+        success = NO;
+    } else if ([outputStream streamStatus] != NSStreamStatusOpen) {
+        if (error) {
+            *error = FZACryptorStreamError(outputStream);
+        }
+        success = NO;
+    } else {
+        success = block(inputStream, outputStream, error);
+    }
+    
+    [inputStream close];
+    [outputStream close];
+    
+    if (success && rename([temporaryPath fileSystemRepresentation], [destinationPath fileSystemRepresentation]) != 0) {
+        if (error) {
+            *error = [NSError errorWithDomain: NSPOSIXErrorDomain code: errno userInfo: nil];
+        }
+        success = NO;
+    }
+    if (!success) {
+        unlink([temporaryPath fileSystemRepresentation]);
+    }
+    
+    return success;
+}
+
+- (BOOL)encryptFileAtLocation:(NSURL *)plainTextURL writingToLocation:(NSURL *)cipherTextURL error:(NSError **)error {
+    NSParameterAssert([plainTextURL isFileURL]);
+    NSParameterAssert([cipherTextURL isFileURL]);
+    
+    return [self writeAtomicallyToLocation: cipherTextURL readingFromLocation: plainTextURL error: error usingBlock: ^BOOL(NSInputStream *inputStream, NSOutputStream *outputStream, NSError **blockError) {
+        return [self encryptStream: inputStream toStream: outputStream error: blockError];
+    }];
+}
+
+- (BOOL)decryptFileAtLocation:(NSURL *)cipherTextURL writingToLocation:(NSURL *)plainTextURL error:(NSError **)error {
+    NSParameterAssert([cipherTextURL isFileURL]);
+    NSParameterAssert([plainTextURL isFileURL]);
+    
+    return [self writeAtomicallyToLocation: plainTextURL readingFromLocation: cipherTextURL error: error usingBlock: ^BOOL(NSInputStream *inputStream, NSOutputStream *outputStream, NSError **blockError) {
+        return [self decryptStream: inputStream toStream: outputStream error: blockError];
+    }];
 }
 
 #pragma mark Memory management
@@ -403,6 +461,7 @@ const NSInteger FZAFileBlockLength = 4096;
     self = [super init];
     if (self) {
         keyManager = [FZAKeyManager newKeyManager];
+        cryptoProvider = [FZACryptoProvider newCryptoProvider];
     }
     
     return self;
@@ -411,7 +470,11 @@ const NSInteger FZAFileBlockLength = 4096;
 - (void)dealloc
 {
     [keyManager release];
+    [cryptoProvider release];
     [super dealloc];
 }
 
+#pragma mark Properties
+@synthesize cryptoProvider;
+
 @end
\ No newline at end of file
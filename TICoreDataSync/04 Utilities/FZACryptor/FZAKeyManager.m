@@ -25,21 +25,21 @@
 #import "FZAKeyManager.h"
 #import "TICoreDataSync.h"
 
-#import <CommonCrypto/CommonDigest.h>
-
 @implementation FZAKeyManager
 
 - (NSData *)keyFromPassword:(NSString *)password salt: (NSData *)salt {
     NSData *passwordBytes = [password dataUsingEncoding: NSUTF16LittleEndianStringEncoding];
     NSMutableData *saltedPW = [passwordBytes mutableCopy];
     [saltedPW appendData: salt];
-    uint8_t hashBuffer[CC_SHA256_DIGEST_LENGTH] = {0};
-    CC_SHA256([saltedPW bytes], (CC_LONG)[saltedPW length], hashBuffer);
+    FZACryptoProvider *cryptoProvider = [FZACryptoProvider newCryptoProvider];
+    uint8_t hashBuffer[FZACryptoDigestLength] = {0};
+    [cryptoProvider digestBytes: [saltedPW bytes] length: [saltedPW length] into: hashBuffer];
     [saltedPW release];
     for (int i = 0; i < 7499; i++) {
-        CC_SHA256(hashBuffer, CC_SHA256_DIGEST_LENGTH, hashBuffer);
+        [cryptoProvider digestBytes: hashBuffer length: FZACryptoDigestLength into: hashBuffer];
     }
-    return [NSData dataWithBytes: hashBuffer length: CC_SHA256_DIGEST_LENGTH];
+    [cryptoProvider release];
+    return [NSData dataWithBytes: hashBuffer length: FZACryptoDigestLength];
 }
 
 - (BOOL)hasKey {
@@ -0,0 +1,79 @@
+//
+//  TICDSAttributeValueDelta.h
+//  TICoreDataSync
+//
+
+#import <Foundation/Foundation.h>
+
+/** `TICDSAttributeValueDelta` describes a change to a large string or binary attribute value as an edit of the previous value, so an attribute change needn't carry the whole new value.
+
+ A delta keeps the bytes its base and new values have in common at the start and end, and replaces the bytes in between; strings are compared as UTF-8. Typing into a long rich-text body, or touching up part of an embedded image, produces a delta of a few bytes.
+
+ A delta records the digests (see `+[TICDSSyncChange digestOfChangedAttributes:]`) of its base and new values. It is only applied to a value with the base digest, so a client whose value has changed since the delta was created (for example, because it resolved a conflict in favour of the remote change) doesn't end up with a corrupt value.
+
+ Deltas aren't handed to the application. Conflicts and warnings carry the values that deltas produce, or `nil` where a delta can't be decoded, and a local change that wins a conflict is re-encoded with its full value, as other clients may no longer have its base value.
+
+ Deltas are immutable, and safe to hand to another thread.
+ */
+@interface TICDSAttributeValueDelta : NSObject {
+@private
+    NSData *_baseDigest;
+    NSData *_valueDigest;
+    NSUInteger _prefixLength;
+    NSUInteger _suffixLength;
+    NSData *_replacementBytes;
+    BOOL _valueIsString;
+}
+
+/** @name Creating Deltas */
+
+/** Create a delta from one value to another, if it would be worth carrying instead of the new value.
+
+ @param aBaseValue The previous (transformed) value of the attribute.
+ @param aValue The new (transformed) value of the attribute.
+
+ @return A delta, or `nil` if the values aren't both strings or both data, the new value is too small to benefit, or the delta would be more than half its size. */
++ (TICDSAttributeValueDelta *)deltaFromValue:(id)aBaseValue toValue:(id)aValue;
+
+/** Initialize a delta from its parts, e.g. when decoding one.
+
+ @param aBaseDigest The digest of the base value.
+ @param aValueDigest The digest of the new value.
+ @param aPrefixLength The number of bytes kept from the start of the base value.
+ @param aSuffixLength The number of bytes kept from the end of the base value.
+ @param someReplacementBytes The bytes that replace the rest of the base value.
+ @param valueIsString `YES` if the values are strings, `NO` if they are data.
+
+ @return A delta. */
+- (id)initWithBaseDigest:(NSData *)aBaseDigest valueDigest:(NSData *)aValueDigest prefixLength:(NSUInteger)aPrefixLength suffixLength:(NSUInteger)aSuffixLength replacementBytes:(NSData *)someReplacementBytes valueIsString:(BOOL)valueIsString;
+
+/** @name Applying Deltas */
+
+/** Reconstruct the new value from the base value.
+
+ @param aBaseValue The current (transformed) value of the attribute.
+
+ @return The new value, or `nil` if `aBaseValue` isn't the value the delta was created from. */
+- (id)valueByApplyingToBaseValue:(id)aBaseValue;
+
+/** @name Properties */
+
+/** The digest of the value the delta was created from. */
+@property (nonatomic, readonly) NSData *baseDigest;
+
+/** The digest of the value the delta produces. */
+@property (nonatomic, readonly) NSData *valueDigest;
+
+/** The number of bytes kept from the start of the base value. */
+@property (nonatomic, readonly) NSUInteger prefixLength;
+
+/** The number of bytes kept from the end of the base value. */
+@property (nonatomic, readonly) NSUInteger suffixLength;
+
+/** The bytes that replace the rest of the base value. */
+@property (nonatomic, readonly) NSData *replacementBytes;
+
+/** `YES` if the values are strings, compared as UTF-8, or `NO` if they are data. */
+@property (nonatomic, readonly) BOOL valueIsString;
+
+@end
@@ -0,0 +1,136 @@
+//
+//  TICDSAttributeValueDelta.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+// Smaller values are cheap enough to carry whole
+static NSUInteger const kTICDSMinimumValueLengthForDelta = 4096;
+
+@implementation TICDSAttributeValueDelta
+
+#pragma mark -
+#pragma mark Creating Deltas
+static NSData *TICDSBytesOfDeltaValue( id aValue )
+{
+    if( [aValue isKindOfClass:[NSString class]] ) {
+        return [aValue dataUsingEncoding:NSUTF8StringEncoding];
+    }
+
+    if( [aValue isKindOfClass:[NSData class]] ) {
+        return aValue;
+    }
+
+    return nil;
+}
+
++ (TICDSAttributeValueDelta *)deltaFromValue:(id)aBaseValue toValue:(id)aValue
+{
+    BOOL valueIsString = [aValue isKindOfClass:[NSString class]];
+    if( valueIsString != [aBaseValue isKindOfClass:[NSString class]] ) {
+        return nil;
+    }
+
+    NSData *baseBytes = TICDSBytesOfDeltaValue(aBaseValue);
+    NSData *valueBytes = TICDSBytesOfDeltaValue(aValue);
+    if( !baseBytes || !valueBytes || [valueBytes length] < kTICDSMinimumValueLengthForDelta ) {
+        return nil;
+    }
+
+    const uint8_t *base = [baseBytes bytes];
+    const uint8_t *value = [valueBytes bytes];
+    NSUInteger baseLength = [baseBytes length];
+    NSUInteger valueLength = [valueBytes length];
+
+    NSUInteger prefixLength = 0;
+    NSUInteger maximumLength = MIN(baseLength, valueLength);
+    while( prefixLength < maximumLength && base[prefixLength] == value[prefixLength] ) {
+        prefixLength++;
+    }
+
+    // the suffix can't overlap the prefix in either value
+    NSUInteger suffixLength = 0;
+    maximumLength -= prefixLength;
+    while( suffixLength < maximumLength && base[baseLength - suffixLength - 1] == value[valueLength - suffixLength - 1] ) {
+        suffixLength++;
+    }
+
+    NSUInteger replacementLength = valueLength - prefixLength - suffixLength;
+    if( replacementLength > valueLength / 2 ) {
+        return nil;
+    }
+
+    NSData *replacementBytes = [valueBytes subdataWithRange:NSMakeRange(prefixLength, replacementLength)];
+
+    return [[[self alloc] initWithBaseDigest:[TICDSSyncChange digestOfChangedAttributes:aBaseValue] valueDigest:[TICDSSyncChange digestOfChangedAttributes:aValue] prefixLength:prefixLength suffixLength:suffixLength replacementBytes:replacementBytes valueIsString:valueIsString] autorelease];
+}
+
+#pragma mark -
+#pragma mark Applying Deltas
+- (id)valueByApplyingToBaseValue:(id)aBaseValue
+{
+    if( [aBaseValue isKindOfClass:[NSString class]] != [self valueIsString] || ![[TICDSSyncChange digestOfChangedAttributes:aBaseValue] isEqualToData:[self baseDigest]] ) {
+        return nil;
+    }
+
+    NSData *baseBytes = TICDSBytesOfDeltaValue(aBaseValue);
+    if( !baseBytes || [baseBytes length] < [self prefixLength] + [self suffixLength] ) {
+        return nil;
+    }
+
+    NSMutableData *valueBytes = [NSMutableData dataWithCapacity:[self prefixLength] + [[self replacementBytes] length] + [self suffixLength]];
+    [valueBytes appendBytes:[baseBytes bytes] length:[self prefixLength]];
+    [valueBytes appendData:[self replacementBytes]];
+    [valueBytes appendBytes:(const uint8_t *)[baseBytes bytes] + [baseBytes length] - [self suffixLength] length:[self suffixLength]];
+
+    if( ![self valueIsString] ) {
+        return valueBytes;
+    }
+
+    return [[[NSString alloc] initWithData:valueBytes encoding:NSUTF8StringEncoding] autorelease];
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)initWithBaseDigest:(NSData *)aBaseDigest valueDigest:(NSData *)aValueDigest prefixLength:(NSUInteger)aPrefixLength suffixLength:(NSUInteger)aSuffixLength replacementBytes:(NSData *)someReplacementBytes valueIsString:(BOOL)valueIsString
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+
+    _baseDigest = [aBaseDigest copy];
+    _valueDigest = [aValueDigest copy];
+    _prefixLength = aPrefixLength;
+    _suffixLength = aSuffixLength;
+    _replacementBytes = [someReplacementBytes copy];
+    _valueIsString = valueIsString;
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [_baseDigest release], _baseDigest = nil;
+    [_valueDigest release], _valueDigest = nil;
+    [_replacementBytes release], _replacementBytes = nil;
+
+    [super dealloc];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"%@ keeping %lu + %lu bytes, replacing the rest with %lu bytes", [super description], (unsigned long)_prefixLength, (unsigned long)_suffixLength, (unsigned long)[_replacementBytes length]];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize baseDigest = _baseDigest;
+@synthesize valueDigest = _valueDigest;
+@synthesize prefixLength = _prefixLength;
+@synthesize suffixLength = _suffixLength;
+@synthesize replacementBytes = _replacementBytes;
+@synthesize valueIsString = _valueIsString;
+
+@end
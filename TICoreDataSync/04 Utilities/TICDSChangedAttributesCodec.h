@@ -0,0 +1,63 @@
+//
+//  TICDSChangedAttributesCodec.h
+//  TICoreDataSync
+//
+
+#import <CoreData/CoreData.h>
+
+/** `TICDSChangedAttributesCodec` encodes the `changedAttributes` of sync changes in a compact binary form, instead of the keyed archive Core Data creates for a transformable attribute.
+
+ Each value is encoded according to the `NSAttributeType` of its attribute: integers as variable-length integers, booleans as a single tag byte, floating point numbers as IEEE doubles, strings as UTF-8 (sharing any long prefix with the previous string in the same insertion), binary data as raw bytes, and dates as a 64-bit count of microseconds (or a double, if the date isn't a whole number of microseconds). Values whose class doesn't suit their attribute's type fall back to a keyed archive.
+
+ An insertion's dictionary of attribute values is encoded as the sorted attribute names, each sharing its prefix with the previous name, followed by a bitmap of the attributes with `nil` values, and the values of the rest.
+
+ Version 2 adds attribute changes carried as a `TICDSAttributeValueDelta`, which are decoded as the delta; data without a delta is still written as version 1.
+
+ Encoded data starts with the codec version, and is self-describing, so it can be decoded without the entity. Sync change set files record the version their sync changes were encoded with in their store metadata (see `+[TICDSSyncChange encodeChangedAttributesOfSyncChanges:withVersion:inPersistentStore:managedObjectModel:]`), so clients can tell whether they can read each set.
+ */
+@interface TICDSChangedAttributesCodec : NSObject {
+@private
+}
+
+/** @name Versions */
+
+/** The newest version of the encoding that this class can decode. */
++ (NSUInteger)currentVersion;
+
+/** The version with which some data was encoded; the oldest version that supports every value in it.
+
+ @param someData Data created by this class.
+
+ @return The version. */
++ (NSUInteger)versionOfData:(NSData *)someData;
+
+/** @name Encoding */
+
+/** Encode the value of an attribute, as carried by an attribute change.
+
+ @param aValue The (transformed) value of the attribute, or a `TICDSAttributeValueDelta`.
+ @param aName The name of the attribute.
+ @param anEntity The entity, or `nil` to choose the encoding from the class of the value alone.
+
+ @return The encoded value. */
++ (NSData *)dataWithValue:(id)aValue ofAttributeNamed:(NSString *)aName inEntity:(NSEntityDescription *)anEntity;
+
+/** Encode the values of every attribute of an object, as carried by an insertion.
+
+ @param someValues The (transformed) values of the attributes, by attribute name; missing attributes are `nil`.
+ @param anEntity The entity, or `nil` to choose each encoding from the class of the value alone.
+
+ @return The encoded values. */
++ (NSData *)dataWithValuesByAttributeName:(NSDictionary *)someValues inEntity:(NSEntityDescription *)anEntity;
+
+/** @name Decoding */
+
+/** Decode data created by `dataWithValue:ofAttributeNamed:inEntity:` or `dataWithValuesByAttributeName:inEntity:`.
+
+ @param someData The encoded data.
+ @param outError If the data could not be decoded, upon return contains an error describing the problem.
+
+ @return The value of the attribute, or a `TICDSAttributeValueDelta`, or the dictionary of attribute values, or `nil` if the data could not be decoded. */
++ (id)changedAttributesWithData:(NSData *)someData error:(NSError **)outError;
+
+@end
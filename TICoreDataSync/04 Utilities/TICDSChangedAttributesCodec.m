@@ -0,0 +1,575 @@
+//
+//  TICDSChangedAttributesCodec.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+#pragma mark -
+#pragma mark Format
+// Data starts with the version, then the form: a single attribute value, or a dictionary of attribute values
+enum {
+    TICDSChangedAttributesFormSingleValue = 'v',
+    TICDSChangedAttributesFormDictionary = 'd',
+};
+
+// Each value starts with a tag
+enum {
+    TICDSChangedAttributesTagNo = '0',
+    TICDSChangedAttributesTagYes = '1',
+    TICDSChangedAttributesTagInteger = 'i',
+    TICDSChangedAttributesTagDouble = 'f',
+    TICDSChangedAttributesTagDecimal = 'm',
+    TICDSChangedAttributesTagString = 's',
+    TICDSChangedAttributesTagStringWithPrefix = 'p',
+    TICDSChangedAttributesTagDateInMicroseconds = 't',
+    TICDSChangedAttributesTagDate = 'T',
+    TICDSChangedAttributesTagData = 'r',
+    TICDSChangedAttributesTagArchive = 'a',
+    TICDSChangedAttributesTagDelta = 'x',
+};
+
+// Deltas were added in version 2; data without one is written as version 1, so older clients can still read it
+static NSUInteger const kTICDSChangedAttributesVersionWithoutDeltas = 1;
+
+// Strings only share a prefix with the previous string if it saves more than the prefix length costs
+static NSUInteger const kTICDSMinimumSharedStringPrefixLength = 4;
+
+typedef struct {
+    const uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger offset;
+} TICDSChangedAttributesReader;
+
+@interface TICDSChangedAttributesCodec ()
+
++ (NSError *)decodingErrorWithDescription:(NSString *)aDescription;
+
+@end
+
+@implementation TICDSChangedAttributesCodec
+
+#pragma mark -
+#pragma mark Primitives
+static void TICDSAppendByte( NSMutableData *someData, uint8_t aByte )
+{
+    [someData appendBytes:&aByte length:1];
+}
+
+static void TICDSAppendVarint( NSMutableData *someData, uint64_t aValue )
+{
+    uint8_t buffer[10];
+    NSUInteger length = 0;
+
+    while( aValue >= 0x80 ) {
+        buffer[length++] = (uint8_t)(aValue & 0x7f) | 0x80;
+        aValue >>= 7;
+    }
+    buffer[length++] = (uint8_t)aValue;
+
+    [someData appendBytes:buffer length:length];
+}
+
+static void TICDSAppendSignedVarint( NSMutableData *someData, int64_t aValue )
+{
+    // zig-zag, so small negative numbers are short too
+    TICDSAppendVarint(someData, ((uint64_t)aValue << 1) ^ (uint64_t)(aValue >> 63));
+}
+
+static void TICDSAppendDouble( NSMutableData *someData, double aValue )
+{
+    CFSwappedFloat64 swappedValue = CFConvertDoubleHostToSwapped(aValue);
+    [someData appendBytes:&swappedValue length:sizeof(swappedValue)];
+}
+
+static void TICDSAppendLengthAndBytes( NSMutableData *someData, const void *someBytes, NSUInteger aLength )
+{
+    TICDSAppendVarint(someData, aLength);
+    [someData appendBytes:someBytes length:aLength];
+}
+
+static NSUInteger TICDSSharedPrefixLength( NSData *aData, NSData *anotherData )
+{
+    const uint8_t *bytes = [aData bytes];
+    const uint8_t *otherBytes = [anotherData bytes];
+    NSUInteger maximumLength = MIN([aData length], [anotherData length]);
+
+    NSUInteger length = 0;
+    while( length < maximumLength && bytes[length] == otherBytes[length] ) {
+        length++;
+    }
+
+    return length;
+}
+
+static BOOL TICDSReadVarint( TICDSChangedAttributesReader *aReader, uint64_t *outValue )
+{
+    uint64_t value = 0;
+    NSUInteger shift = 0;
+
+    while( aReader->offset < aReader->length && shift < 64 ) {
+        uint8_t byte = aReader->bytes[aReader->offset++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+
+        if( !(byte & 0x80) ) {
+            *outValue = value;
+            return YES;
+        }
+
+        shift += 7;
+    }
+
+    return NO;
+}
+
+static BOOL TICDSReadSignedVarint( TICDSChangedAttributesReader *aReader, int64_t *outValue )
+{
+    uint64_t value = 0;
+    if( !TICDSReadVarint(aReader, &value) ) {
+        return NO;
+    }
+
+    *outValue = (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    return YES;
+}
+
+static const uint8_t *TICDSReadBytes( TICDSChangedAttributesReader *aReader, NSUInteger aLength )
+{
+    if( aReader->length - aReader->offset < aLength ) {
+        return NULL;
+    }
+
+    const uint8_t *bytes = aReader->bytes + aReader->offset;
+    aReader->offset += aLength;
+
+    return bytes;
+}
+
+static BOOL TICDSReadDouble( TICDSChangedAttributesReader *aReader, double *outValue )
+{
+    const uint8_t *bytes = TICDSReadBytes(aReader, sizeof(CFSwappedFloat64));
+    if( !bytes ) {
+        return NO;
+    }
+
+    CFSwappedFloat64 swappedValue;
+    memcpy(&swappedValue, bytes, sizeof(swappedValue));
+    *outValue = CFConvertDoubleSwappedToHost(swappedValue);
+
+    return YES;
+}
+
+static NSData *TICDSReadLengthAndBytes( TICDSChangedAttributesReader *aReader )
+{
+    uint64_t length = 0;
+    if( !TICDSReadVarint(aReader, &length) || length > aReader->length ) {
+        return nil;
+    }
+
+    const uint8_t *bytes = TICDSReadBytes(aReader, (NSUInteger)length);
+    if( !bytes ) {
+        return nil;
+    }
+
+    return [NSData dataWithBytes:bytes length:(NSUInteger)length];
+}
+
+// Read a prefix length and suffix, sharing the prefix of the previous bytes
+static NSData *TICDSReadPrefixedBytes( TICDSChangedAttributesReader *aReader, NSData *somePreviousBytes )
+{
+    uint64_t prefixLength = 0;
+    if( !TICDSReadVarint(aReader, &prefixLength) || prefixLength > [somePreviousBytes length] ) {
+        return nil;
+    }
+
+    NSData *suffix = TICDSReadLengthAndBytes(aReader);
+    if( !suffix ) {
+        return nil;
+    }
+
+    NSMutableData *bytes = [NSMutableData dataWithBytes:[somePreviousBytes bytes] length:(NSUInteger)prefixLength];
+    [bytes appendData:suffix];
+
+    return bytes;
+}
+
+#pragma mark -
+#pragma mark Encoding Values
+static BOOL TICDSIsIntegerAttributeType( NSAttributeType aType )
+{
+    return aType == NSInteger16AttributeType || aType == NSInteger32AttributeType || aType == NSInteger64AttributeType;
+}
+
+static void TICDSAppendString( NSMutableData *someData, NSString *aString, NSData **ioPreviousStringBytes )
+{
+    NSData *stringBytes = [aString dataUsingEncoding:NSUTF8StringEncoding];
+    NSUInteger prefixLength = ( *ioPreviousStringBytes ? TICDSSharedPrefixLength(stringBytes, *ioPreviousStringBytes) : 0 );
+
+    if( prefixLength >= kTICDSMinimumSharedStringPrefixLength ) {
+        TICDSAppendByte(someData, TICDSChangedAttributesTagStringWithPrefix);
+        TICDSAppendVarint(someData, prefixLength);
+        TICDSAppendLengthAndBytes(someData, (const uint8_t *)[stringBytes bytes] + prefixLength, [stringBytes length] - prefixLength);
+    } else {
+        TICDSAppendByte(someData, TICDSChangedAttributesTagString);
+        TICDSAppendLengthAndBytes(someData, [stringBytes bytes], [stringBytes length]);
+    }
+
+    *ioPreviousStringBytes = stringBytes;
+}
+
+static void TICDSAppendDate( NSMutableData *someData, NSDate *aDate )
+{
+    NSTimeInterval interval = [aDate timeIntervalSinceReferenceDate];
+    double microseconds = interval * 1000000.0;
+
+    // only dates that survive the round trip through whole microseconds are stored that way
+    if( microseconds == floor(microseconds) && fabs(microseconds) < 9.0e15 && (double)(int64_t)microseconds / 1000000.0 == interval ) {
+        TICDSAppendByte(someData, TICDSChangedAttributesTagDateInMicroseconds);
+        TICDSAppendSignedVarint(someData, (int64_t)microseconds);
+    } else {
+        TICDSAppendByte(someData, TICDSChangedAttributesTagDate);
+        TICDSAppendDouble(someData, interval);
+    }
+}
+
+static void TICDSAppendDelta( NSMutableData *someData, TICDSAttributeValueDelta *aDelta )
+{
+    TICDSAppendByte(someData, TICDSChangedAttributesTagDelta);
+    TICDSAppendLengthAndBytes(someData, [[aDelta baseDigest] bytes], [[aDelta baseDigest] length]);
+    TICDSAppendLengthAndBytes(someData, [[aDelta valueDigest] bytes], [[aDelta valueDigest] length]);
+    TICDSAppendByte(someData, [aDelta valueIsString] ? 1 : 0);
+    TICDSAppendVarint(someData, [aDelta prefixLength]);
+    TICDSAppendVarint(someData, [aDelta suffixLength]);
+    TICDSAppendLengthAndBytes(someData, [[aDelta replacementBytes] bytes], [[aDelta replacementBytes] length]);
+}
+
+static void TICDSAppendValue( NSMutableData *someData, id aValue, NSAttributeType aType, NSData **ioPreviousStringBytes )
+{
+    if( [aValue isKindOfClass:[TICDSAttributeValueDelta class]] ) {
+        TICDSAppendDelta(someData, aValue);
+        return;
+    }
+    
+    if( [aValue isKindOfClass:[NSNumber class]] && ![aValue isKindOfClass:[NSDecimalNumber class]] ) {
+        if( TICDSIsIntegerAttributeType(aType) ) {
+            TICDSAppendByte(someData, TICDSChangedAttributesTagInteger);
+            TICDSAppendSignedVarint(someData, [aValue longLongValue]);
+            return;
+        }
+
+        if( aType == NSBooleanAttributeType ) {
+            TICDSAppendByte(someData, [aValue boolValue] ? TICDSChangedAttributesTagYes : TICDSChangedAttributesTagNo);
+            return;
+        }
+
+        if( aType == NSDoubleAttributeType || aType == NSFloatAttributeType ) {
+            TICDSAppendByte(someData, TICDSChangedAttributesTagDouble);
+            TICDSAppendDouble(someData, [aValue doubleValue]);
+            return;
+        }
+    }
+
+    if( [aValue isKindOfClass:[NSDecimalNumber class]] && aType == NSDecimalAttributeType ) {
+        NSData *stringBytes = [[aValue description] dataUsingEncoding:NSUTF8StringEncoding];
+        TICDSAppendByte(someData, TICDSChangedAttributesTagDecimal);
+        TICDSAppendLengthAndBytes(someData, [stringBytes bytes], [stringBytes length]);
+        return;
+    }
+
+    // strings, dates and data are recognized whatever their attribute type, e.g. the transformed value of a transformable attribute
+    if( [aValue isKindOfClass:[NSString class]] ) {
+        TICDSAppendString(someData, aValue, ioPreviousStringBytes);
+        return;
+    }
+
+    if( [aValue isKindOfClass:[NSDate class]] ) {
+        TICDSAppendDate(someData, aValue);
+        return;
+    }
+
+    if( [aValue isKindOfClass:[NSData class]] ) {
+        TICDSAppendByte(someData, TICDSChangedAttributesTagData);
+        TICDSAppendLengthAndBytes(someData, [aValue bytes], [aValue length]);
+        return;
+    }
+
+    NSData *archivedValue = [NSKeyedArchiver archivedDataWithRootObject:aValue];
+    TICDSAppendByte(someData, TICDSChangedAttributesTagArchive);
+    TICDSAppendLengthAndBytes(someData, [archivedValue bytes], [archivedValue length]);
+}
+
+#pragma mark -
+#pragma mark Decoding Values
+static TICDSAttributeValueDelta *TICDSReadDelta( TICDSChangedAttributesReader *aReader )
+{
+    NSData *baseDigest = TICDSReadLengthAndBytes(aReader);
+    NSData *valueDigest = TICDSReadLengthAndBytes(aReader);
+    const uint8_t *valueIsString = TICDSReadBytes(aReader, 1);
+    uint64_t prefixLength = 0;
+    uint64_t suffixLength = 0;
+    if( !baseDigest || !valueDigest || !valueIsString || !TICDSReadVarint(aReader, &prefixLength) || !TICDSReadVarint(aReader, &suffixLength) ) {
+        return nil;
+    }
+
+    NSData *replacementBytes = TICDSReadLengthAndBytes(aReader);
+    if( !replacementBytes ) {
+        return nil;
+    }
+
+    return [[[TICDSAttributeValueDelta alloc] initWithBaseDigest:baseDigest valueDigest:valueDigest prefixLength:(NSUInteger)prefixLength suffixLength:(NSUInteger)suffixLength replacementBytes:replacementBytes valueIsString:(*valueIsString != 0)] autorelease];
+}
+
+static id TICDSReadValue( TICDSChangedAttributesReader *aReader, NSData **ioPreviousStringBytes )
+{
+    const uint8_t *tag = TICDSReadBytes(aReader, 1);
+    if( !tag ) {
+        return nil;
+    }
+
+    switch( *tag ) {
+        case TICDSChangedAttributesTagNo:
+            return [NSNumber numberWithBool:NO];
+
+        case TICDSChangedAttributesTagYes:
+            return [NSNumber numberWithBool:YES];
+
+        case TICDSChangedAttributesTagInteger: {
+            int64_t value = 0;
+            return TICDSReadSignedVarint(aReader, &value) ? [NSNumber numberWithLongLong:value] : nil;
+        }
+
+        case TICDSChangedAttributesTagDouble: {
+            double value = 0;
+            return TICDSReadDouble(aReader, &value) ? [NSNumber numberWithDouble:value] : nil;
+        }
+
+        case TICDSChangedAttributesTagDecimal: {
+            NSData *stringBytes = TICDSReadLengthAndBytes(aReader);
+            NSString *string = ( stringBytes ? [[[NSString alloc] initWithData:stringBytes encoding:NSUTF8StringEncoding] autorelease] : nil );
+            return string ? [NSDecimalNumber decimalNumberWithString:string] : nil;
+        }
+
+        case TICDSChangedAttributesTagString:
+        case TICDSChangedAttributesTagStringWithPrefix: {
+            NSData *stringBytes = ( *tag == TICDSChangedAttributesTagString ? TICDSReadLengthAndBytes(aReader) : TICDSReadPrefixedBytes(aReader, *ioPreviousStringBytes) );
+            if( !stringBytes ) {
+                return nil;
+            }
+
+            *ioPreviousStringBytes = stringBytes;
+            return [[[NSString alloc] initWithData:stringBytes encoding:NSUTF8StringEncoding] autorelease];
+        }
+
+        case TICDSChangedAttributesTagDateInMicroseconds: {
+            int64_t microseconds = 0;
+            return TICDSReadSignedVarint(aReader, &microseconds) ? [NSDate dateWithTimeIntervalSinceReferenceDate:(double)microseconds / 1000000.0] : nil;
+        }
+
+        case TICDSChangedAttributesTagDate: {
+            double interval = 0;
+            return TICDSReadDouble(aReader, &interval) ? [NSDate dateWithTimeIntervalSinceReferenceDate:interval] : nil;
+        }
+
+        case TICDSChangedAttributesTagData:
+            return TICDSReadLengthAndBytes(aReader);
+
+        case TICDSChangedAttributesTagArchive: {
+            NSData *archivedValue = TICDSReadLengthAndBytes(aReader);
+            if( !archivedValue ) {
+                return nil;
+            }
+
+            id value = nil;
+            @try {
+                value = [NSKeyedUnarchiver unarchiveObjectWithData:archivedValue];
+            }
+            @catch (NSException *exception) {
+                TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to unarchive a changed attribute value: %@", exception);
+            }
+            return value;
+        }
+
+        case TICDSChangedAttributesTagDelta:
+            return TICDSReadDelta(aReader);
+    }
+
+    return nil;
+}
+
+#pragma mark -
+#pragma mark Versions
++ (NSUInteger)currentVersion
+{
+    return 2;
+}
+
++ (NSUInteger)versionOfData:(NSData *)someData
+{
+    return ( [someData length] > 0 ? *(const uint8_t *)[someData bytes] : 0 );
+}
+
+#pragma mark -
+#pragma mark Encoding
++ (NSData *)dataWithValue:(id)aValue ofAttributeNamed:(NSString *)aName inEntity:(NSEntityDescription *)anEntity
+{
+    NSAttributeDescription *attribute = [[anEntity attributesByName] objectForKey:aName];
+    NSAttributeType attributeType = ( attribute ? [attribute attributeType] : NSUndefinedAttributeType );
+
+    BOOL isDelta = [aValue isKindOfClass:[TICDSAttributeValueDelta class]];
+
+    NSMutableData *data = [NSMutableData data];
+    TICDSAppendByte(data, (uint8_t)( isDelta ? [self currentVersion] : kTICDSChangedAttributesVersionWithoutDeltas ));
+    TICDSAppendByte(data, TICDSChangedAttributesFormSingleValue);
+
+    NSData *previousStringBytes = nil;
+    TICDSAppendValue(data, aValue, attributeType, &previousStringBytes);
+
+    return data;
+}
+
++ (NSData *)dataWithValuesByAttributeName:(NSDictionary *)someValues inEntity:(NSEntityDescription *)anEntity
+{
+    // every attribute of the entity is listed, so the bitmap can mark which are nil without the dictionary needing a key for them
+    NSDictionary *attributesByName = [anEntity attributesByName];
+    NSMutableSet *nameSet = [NSMutableSet setWithArray:[someValues allKeys]];
+    if( anEntity ) {
+        [nameSet addObjectsFromArray:[[TICDSEntitySyncDescriptor syncDescriptorForEntity:anEntity] attributeNames]];
+    }
+    NSArray *names = [[nameSet allObjects] sortedArrayUsingSelector:@selector(compare:)];
+
+    NSMutableData *data = [NSMutableData data];
+    TICDSAppendByte(data, (uint8_t)kTICDSChangedAttributesVersionWithoutDeltas);
+    TICDSAppendByte(data, TICDSChangedAttributesFormDictionary);
+    TICDSAppendVarint(data, [names count]);
+
+    NSData *previousNameBytes = nil;
+    for( NSString *eachName in names ) {
+        NSData *nameBytes = [eachName dataUsingEncoding:NSUTF8StringEncoding];
+        NSUInteger prefixLength = ( previousNameBytes ? TICDSSharedPrefixLength(nameBytes, previousNameBytes) : 0 );
+
+        TICDSAppendVarint(data, prefixLength);
+        TICDSAppendLengthAndBytes(data, (const uint8_t *)[nameBytes bytes] + prefixLength, [nameBytes length] - prefixLength);
+
+        previousNameBytes = nameBytes;
+    }
+
+    NSMutableData *nilBitmap = [NSMutableData dataWithLength:([names count] + 7) / 8];
+    uint8_t *nilBits = [nilBitmap mutableBytes];
+    [names enumerateObjectsUsingBlock:^(id eachName, NSUInteger index, BOOL *stop) {
+        id value = [someValues objectForKey:eachName];
+        if( !value || value == [NSNull null] ) {
+            nilBits[index / 8] |= (uint8_t)(1 << (index % 8));
+        }
+    }];
+    [data appendData:nilBitmap];
+
+    NSData *previousStringBytes = nil;
+    for( NSUInteger index = 0; index < [names count]; index++ ) {
+        if( nilBits[index / 8] & (1 << (index % 8)) ) {
+            continue;
+        }
+
+        NSString *name = [names objectAtIndex:index];
+        NSAttributeDescription *attribute = [attributesByName objectForKey:name];
+        TICDSAppendValue(data, [someValues objectForKey:name], ( attribute ? [attribute attributeType] : NSUndefinedAttributeType ), &previousStringBytes);
+    }
+
+    return data;
+}
+
+#pragma mark -
+#pragma mark Decoding
++ (id)changedAttributesWithData:(NSData *)someData error:(NSError **)outError
+{
+    TICDSChangedAttributesReader reader = { [someData bytes], [someData length], 0 };
+
+    const uint8_t *header = TICDSReadBytes(&reader, 2);
+    if( !header ) {
+        if( outError ) {
+            *outError = [self decodingErrorWithDescription:@"Encoded changed attributes are too short"];
+        }
+        return nil;
+    }
+
+    if( header[0] < 1 || header[0] > [self currentVersion] ) {
+        if( outError ) {
+            *outError = [self decodingErrorWithDescription:[NSString stringWithFormat:@"Changed attributes were encoded with unsupported version %u", (unsigned)header[0]]];
+        }
+        return nil;
+    }
+
+    NSData *previousStringBytes = nil;
+
+    if( header[1] == TICDSChangedAttributesFormSingleValue ) {
+        id value = TICDSReadValue(&reader, &previousStringBytes);
+        if( !value && outError ) {
+            *outError = [self decodingErrorWithDescription:@"Encoded changed attribute value is corrupt"];
+        }
+        return value;
+    }
+
+    if( header[1] != TICDSChangedAttributesFormDictionary ) {
+        if( outError ) {
+            *outError = [self decodingErrorWithDescription:[NSString stringWithFormat:@"Encoded changed attributes have unknown form %u", (unsigned)header[1]]];
+        }
+        return nil;
+    }
+
+    uint64_t count = 0;
+    if( !TICDSReadVarint(&reader, &count) || count > reader.length ) {
+        if( outError ) {
+            *outError = [self decodingErrorWithDescription:@"Encoded changed attributes have a corrupt attribute count"];
+        }
+        return nil;
+    }
+
+    NSMutableArray *names = [NSMutableArray arrayWithCapacity:(NSUInteger)count];
+    NSData *previousNameBytes = nil;
+    for( uint64_t index = 0; index < count; index++ ) {
+        NSData *nameBytes = TICDSReadPrefixedBytes(&reader, previousNameBytes);
+        NSString *name = ( nameBytes ? [[[NSString alloc] initWithData:nameBytes encoding:NSUTF8StringEncoding] autorelease] : nil );
+        if( !name ) {
+            if( outError ) {
+                *outError = [self decodingErrorWithDescription:@"Encoded changed attributes have a corrupt attribute name"];
+            }
+            return nil;
+        }
+
+        [names addObject:name];
+        previousNameBytes = nameBytes;
+    }
+
+    const uint8_t *nilBits = TICDSReadBytes(&reader, ((NSUInteger)count + 7) / 8);
+    if( !nilBits ) {
+        if( outError ) {
+            *outError = [self decodingErrorWithDescription:@"Encoded changed attributes are missing their nil bitmap"];
+        }
+        return nil;
+    }
+
+    NSMutableDictionary *values = [NSMutableDictionary dictionaryWithCapacity:(NSUInteger)count];
+    for( NSUInteger index = 0; index < count; index++ ) {
+        if( nilBits[index / 8] & (1 << (index % 8)) ) {
+            continue;
+        }
+
+        id value = TICDSReadValue(&reader, &previousStringBytes);
+        if( !value ) {
+            if( outError ) {
+                *outError = [self decodingErrorWithDescription:[NSString stringWithFormat:@"Encoded value of %@ is corrupt", [names objectAtIndex:index]]];
+            }
+            return nil;
+        }
+
+        [values setObject:value forKey:[names objectAtIndex:index]];
+    }
+
+    return values;
+}
+
++ (NSError *)decodingErrorWithDescription:(NSString *)aDescription
+{
+    return [TICDSError errorWithCode:TICDSErrorCodeUnsupportedChangedAttributesEncoding underlyingError:nil userInfo:aDescription classAndMethod:__PRETTY_FUNCTION__];
+}
+
+@end
@@ -0,0 +1,81 @@
+//
+//  TICDSEntitySyncDescriptor.h
+//  TICoreDataSync
+//
+
+#import <CoreData/CoreData.h>
+
+/** `TICDSEntitySyncDescriptor` holds everything about an entity that is needed to record or apply its sync changes, so that it is worked out once rather than for every object on every save.
+ 
+ A descriptor is immutable, and is built the first time it is requested for an entity, then kept with that entity for as long as its managed object model exists. It is safe to use from any thread.
+ */
+@interface TICDSEntitySyncDescriptor : NSObject {
+@private
+    NSString *_entityName;
+    NSArray *_attributeNames;
+    NSSet *_attributeNameSet;
+    NSDictionary *_valueTransformersByAttributeName;
+    NSSet *_ignoredPropertyNames;
+    NSSet *_deltaAttributeNames;
+    NSDictionary *_relationshipsByName;
+    NSDictionary *_syncedRelationshipsByName;
+}
+
+/** @name Obtaining a Descriptor */
+
+/** The descriptor for an entity, built and cached on first use.
+ 
+ @param anEntity The entity.
+ 
+ @return The sync descriptor for the entity. */
++ (TICDSEntitySyncDescriptor *)syncDescriptorForEntity:(NSEntityDescription *)anEntity;
+
+/** @name Attributes */
+
+/** The names of the entity's non-transient attributes, sorted by name. */
+@property (nonatomic, readonly) NSArray *attributeNames;
+
+/** Whether an attribute is one of the entity's non-transient attributes.
+ 
+ @param aName The name of the attribute.
+ 
+ @return `YES` if the attribute is non-transient and part of the entity, otherwise `NO`. */
+- (BOOL)isSyncedAttributeNamed:(NSString *)aName;
+
+/** Apply an attribute's value transformer, if it has one.
+ 
+ @param aValue The value of the attribute.
+ @param aName The name of the attribute.
+ 
+ @return The transformed value, or `aValue` if the attribute has no value transformer. */
+- (id)transformedValue:(id)aValue forAttributeNamed:(NSString *)aName;
+
+/** Reverse an attribute's value transformer, if it has one.
+ 
+ @param aValue The transformed value.
+ @param aName The name of the attribute.
+ 
+ @return The reverse-transformed value, or `aValue` if the attribute has no value transformer. */
+- (id)reverseTransformedValue:(id)aValue forAttributeNamed:(NSString *)aName;
+
+/** @name Ignored Properties */
+
+/** The property names returned by `+keysForWhichSyncChangesWillNotBeCreated` for the entity's managed object class. */
+@property (nonatomic, readonly) NSSet *ignoredPropertyNames;
+
+/** @name Delta Attributes */
+
+/** The attribute names returned by `+keysForWhichSyncChangesWillCarryDeltas` for the entity's managed object class. */
+@property (nonatomic, readonly) NSSet *deltaAttributeNames;
+
+/** @name Relationships */
+
+/** All the entity's relationships, by name. */
+@property (nonatomic, readonly) NSDictionary *relationshipsByName;
+
+/** The relationships for which this end creates sync changes, by name.
+ 
+ Only one end of each relationship is synchronized: the to-one end of a one-to-many relationship, and the alphabetically lower end of a one-to-one or many-to-many relationship. */
+@property (nonatomic, readonly) NSDictionary *syncedRelationshipsByName;
+
+@end
@@ -0,0 +1,189 @@
+//
+//  TICDSEntitySyncDescriptor.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+#import <objc/runtime.h>
+
+@interface TICDSEntitySyncDescriptor ()
+
+- (id)initWithEntity:(NSEntityDescription *)anEntity;
++ (BOOL)shouldCreateSyncChangesForRelationship:(NSRelationshipDescription *)aRelationship;
+
+@end
+
+static char TICDSEntitySyncDescriptorKey;
+
+@implementation TICDSEntitySyncDescriptor
+
+#pragma mark -
+#pragma mark Obtaining a Descriptor
++ (TICDSEntitySyncDescriptor *)syncDescriptorForEntity:(NSEntityDescription *)anEntity
+{
+    TICDSEntitySyncDescriptor *descriptor = objc_getAssociatedObject(anEntity, &TICDSEntitySyncDescriptorKey);
+    if( descriptor ) {
+        return descriptor;
+    }
+    
+    @synchronized(anEntity) {
+        descriptor = objc_getAssociatedObject(anEntity, &TICDSEntitySyncDescriptorKey);
+        if( !descriptor ) {
+            descriptor = [[[TICDSEntitySyncDescriptor alloc] initWithEntity:anEntity] autorelease];
+            objc_setAssociatedObject(anEntity, &TICDSEntitySyncDescriptorKey, descriptor, OBJC_ASSOCIATION_RETAIN);
+        }
+    }
+    
+    return descriptor;
+}
+
+#pragma mark -
+#pragma mark Attributes
+- (BOOL)isSyncedAttributeNamed:(NSString *)aName
+{
+    return [_attributeNameSet containsObject:aName];
+}
+
+- (id)transformedValue:(id)aValue forAttributeNamed:(NSString *)aName
+{
+    NSValueTransformer *valueTransformer = [_valueTransformersByAttributeName objectForKey:aName];
+    if( !valueTransformer ) {
+        return aValue;
+    }
+    
+    return [valueTransformer transformedValue:aValue];
+}
+
+- (id)reverseTransformedValue:(id)aValue forAttributeNamed:(NSString *)aName
+{
+    NSValueTransformer *valueTransformer = [_valueTransformersByAttributeName objectForKey:aName];
+    if( !valueTransformer ) {
+        return aValue;
+    }
+    
+    return [valueTransformer reverseTransformedValue:aValue];
+}
+
+#pragma mark -
+#pragma mark Relationships
++ (BOOL)shouldCreateSyncChangesForRelationship:(NSRelationshipDescription *)aRelationship
+{
+    NSRelationshipDescription *inverseRelationship = [aRelationship inverseRelationship];
+    
+    // Each check makes sure there _is_ an inverse relationship before checking its type, to allow for relationships with no inverse set
+    
+    // Check if this is a many-to-one relationship (only sync the -to-one side)
+    if( ([aRelationship isToMany]) && inverseRelationship && (![inverseRelationship isToMany]) ) {
+        return NO;
+    }
+    
+    // Check if this is a many to many relationship, and only sync the first relationship name alphabetically
+    if( ([aRelationship isToMany]) && inverseRelationship && ([inverseRelationship isToMany]) && ([[aRelationship name] caseInsensitiveCompare:[inverseRelationship name]] == NSOrderedDescending) ) {
+        return NO;
+    }
+    
+    // Check if this is a one to one relationship, and only sync the first relationship name alphabetically
+    if( (![aRelationship isToMany]) && inverseRelationship && (![inverseRelationship isToMany]) && ([[aRelationship name] caseInsensitiveCompare:[inverseRelationship name]] == NSOrderedDescending) ) {
+        return NO;
+    }
+    
+    // Check if this is a self-referential relationship, and only sync one side, somehow!!!
+    
+    // If we get here, this is:
+    // a) a one-to-many relationship
+    // b) the alphabetically lower end of a many-to-many relationship
+    // c) the alphabetically lower end of a one-to-one relationship
+    // d) edge-case 1: a many-to-many relationship with the same relationship name at both ends (will currently create 2 sync changes)
+    // e) edge-case 2: a one-to-one relationship with the same relationship name at both ends (will currently create 2 sync changes)
+    
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)initWithEntity:(NSEntityDescription *)anEntity
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+    
+    _entityName = [[anEntity name] copy];
+    
+    NSDictionary *attributesByName = [anEntity attributesByName];
+    NSMutableArray *attributeNames = [NSMutableArray arrayWithCapacity:[attributesByName count]];
+    NSMutableDictionary *valueTransformers = [NSMutableDictionary dictionary];
+    for( NSString *eachAttributeName in attributesByName ) {
+        NSAttributeDescription *attribute = [attributesByName objectForKey:eachAttributeName];
+        if( [attribute isTransient] ) {
+            continue;
+        }
+        
+        [attributeNames addObject:eachAttributeName];
+        
+        NSString *transformerName = [attribute valueTransformerName];
+        NSValueTransformer *valueTransformer = ( transformerName ? [NSValueTransformer valueTransformerForName:transformerName] : nil );
+        if( valueTransformer ) {
+            [valueTransformers setObject:valueTransformer forKey:eachAttributeName];
+        }
+    }
+    [attributeNames sortUsingSelector:@selector(compare:)];
+    _attributeNames = [attributeNames copy];
+    _attributeNameSet = [[NSSet alloc] initWithArray:attributeNames];
+    _valueTransformersByAttributeName = [valueTransformers copy];
+    
+    Class managedObjectClass = NSClassFromString([anEntity managedObjectClassName]);
+    NSSet *ignoredPropertyNames = nil;
+    if( [managedObjectClass respondsToSelector:@selector(keysForWhichSyncChangesWillNotBeCreated)] ) {
+        ignoredPropertyNames = [managedObjectClass keysForWhichSyncChangesWillNotBeCreated];
+    }
+    _ignoredPropertyNames = [ignoredPropertyNames copy] ? : [[NSSet alloc] init];
+    
+    NSSet *deltaAttributeNames = nil;
+    if( [managedObjectClass respondsToSelector:@selector(keysForWhichSyncChangesWillCarryDeltas)] ) {
+        deltaAttributeNames = [managedObjectClass keysForWhichSyncChangesWillCarryDeltas];
+    }
+    _deltaAttributeNames = [deltaAttributeNames copy] ? : [[NSSet alloc] init];
+    
+    _relationshipsByName = [[anEntity relationshipsByName] copy];
+    NSMutableDictionary *syncedRelationships = [NSMutableDictionary dictionaryWithCapacity:[_relationshipsByName count]];
+    for( NSString *eachRelationshipName in _relationshipsByName ) {
+        NSRelationshipDescription *relationship = [_relationshipsByName objectForKey:eachRelationshipName];
+        if( [[self class] shouldCreateSyncChangesForRelationship:relationship] ) {
+            [syncedRelationships setObject:relationship forKey:eachRelationshipName];
+        }
+    }
+    _syncedRelationshipsByName = [syncedRelationships copy];
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    [_entityName release], _entityName = nil;
+    [_attributeNames release], _attributeNames = nil;
+    [_attributeNameSet release], _attributeNameSet = nil;
+    [_valueTransformersByAttributeName release], _valueTransformersByAttributeName = nil;
+    [_ignoredPropertyNames release], _ignoredPropertyNames = nil;
+    [_deltaAttributeNames release], _deltaAttributeNames = nil;
+    [_relationshipsByName release], _relationshipsByName = nil;
+    [_syncedRelationshipsByName release], _syncedRelationshipsByName = nil;
+    
+    [super dealloc];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"%@ %@: attributes %@, synced relationships %@", [super description], _entityName, _attributeNames, [_syncedRelationshipsByName allKeys]];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize attributeNames = _attributeNames;
+@synthesize ignoredPropertyNames = _ignoredPropertyNames;
+@synthesize deltaAttributeNames = _deltaAttributeNames;
+@synthesize relationshipsByName = _relationshipsByName;
+@synthesize syncedRelationshipsByName = _syncedRelationshipsByName;
+
+@end
@@ -30,6 +30,11 @@ NSString *gTICDSErrorStrings[] = {
     @"FZACryptor returned salt data when asked, but responded that it wasn't correctly configured to encrypt",
     @"Synchronization failed because integrity keys do not match",
     @"Synchronization failed because remote integrity key directory is missing; was the entire remote directory removed?",
+    @"The document catalog was modified by another client each time this client tried to update it",
+    @"The client registry was modified by another client each time this client tried to update it",
+    @"Sync changes were encoded in a version this client does not support, or are corrupt",
+    @"Insertion sync changes carry relationships in a form this client does not support",
+    @"An exception was raised while applying sync changes",
 };
 
 #include <execinfo.h>
@@ -0,0 +1,47 @@
+//
+//  TICDSFileTransfer.h
+//  TICoreDataSync
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TICDSTypesAndEnums.h"
+
+/** `TICDSFileTransfer` copies files and directories between local paths as cheaply as the file systems involved allow.
+
+ For each regular file, the following methods are tried in turn:
+
+ 1. A hard link, if the caller has said the file is immutable (e.g., a sync change set that is never modified once written).
+ 2. A copy-on-write clone (`FICLONE`, on Linux).
+ 3. An in-kernel copy (`copy_file_range()`, on Linux).
+ 4. A buffered copy (on Linux), or an `NSFileManager` copy (elsewhere, where the file manager already clones when it can).
+
+ Whether a method works is probed the first time it is used between a pair of directories; methods that are not supported for that pair are remembered and not tried again.
+ */
+@interface TICDSFileTransfer : NSObject {
+@private
+    
+}
+
+/** Transfer a file or directory to a new location.
+
+ Directories are transferred recursively, file by file. The destination must not already exist.
+
+ @param fromPath The path to the item to transfer.
+ @param toPath The path for the new item.
+ @param allowHardLink `YES` if the item will never be modified in place, in which case files may be hard linked rather than copied.
+ @param outMethod Upon return, the most expensive method used to transfer any file. May be `NULL`.
+ @param outBytesCopied Upon return, the number of bytes copied (cloned and hard linked files count as zero). May be `NULL`.
+ @param outError If the item could not be transferred, upon return contains an error describing the problem.
+
+ @return `YES` if the item was transferred, otherwise `NO`. */
++ (BOOL)transferItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath allowingHardLink:(BOOL)allowHardLink method:(TICDSFileTransferMethod *)outMethod bytesCopied:(unsigned long long *)outBytesCopied error:(NSError **)outError;
+
+/** A human-readable name for a transfer method, used for logging.
+
+ @param aMethod The transfer method.
+
+ @return The name of the method. */
++ (NSString *)nameOfTransferMethod:(TICDSFileTransferMethod)aMethod;
+
+@end
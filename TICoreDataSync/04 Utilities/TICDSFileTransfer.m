@@ -0,0 +1,373 @@
+//
+//  TICDSFileTransfer.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+#import <fcntl.h>
+#import <errno.h>
+#import <unistd.h>
+#import <sys/stat.h>
+
+#if defined(__linux__)
+#import <sys/ioctl.h>
+#import <linux/fs.h>
+#endif
+
+// methods found not to work between a pair of directories
+enum {
+    TICDSFileTransferUnsupportedHardLink = 1 << 0,
+    TICDSFileTransferUnsupportedClone = 1 << 1,
+    TICDSFileTransferUnsupportedCopyFileRange = 1 << 2,
+};
+
+static const size_t TICDSFileTransferBufferSize = 1024 * 1024;
+
+@interface TICDSFileTransfer ()
+
++ (BOOL)transferFileAtPath:(NSString *)fromPath toPath:(NSString *)toPath status:(struct stat *)fromStatus allowingHardLink:(BOOL)allowHardLink method:(TICDSFileTransferMethod *)outMethod bytesCopied:(unsigned long long *)outBytesCopied error:(NSError **)outError;
++ (NSUInteger)unsupportedMethodsFromPath:(NSString *)fromPath toPath:(NSString *)toPath;
++ (void)markMethods:(NSUInteger)someMethods unsupportedFromPath:(NSString *)fromPath toPath:(NSString *)toPath;
+
+@end
+
+#pragma mark -
+#pragma mark Function Declarations
+static NSError *TICDSFileTransferPOSIXError( NSString *aPath );
+static BOOL TICDSFileTransferErrorMeansUnsupported( int anErrorNumber );
+static BOOL TICDSFileTransferBufferedCopy( int fromFileDescriptor, int toFileDescriptor, unsigned long long *outBytesCopied );
+
+@implementation TICDSFileTransfer
+
+#pragma mark -
+#pragma mark Transfers
++ (BOOL)transferItemAtPath:(NSString *)fromPath toPath:(NSString *)toPath allowingHardLink:(BOOL)allowHardLink method:(TICDSFileTransferMethod *)outMethod bytesCopied:(unsigned long long *)outBytesCopied error:(NSError **)outError
+{
+    TICDSFileTransferMethod method = TICDSFileTransferMethodUnknown;
+    unsigned long long bytesCopied = 0;
+
+    struct stat fromStatus;
+    if( lstat([fromPath fileSystemRepresentation], &fromStatus) == -1 ) {
+        if( outError ) {
+            *outError = TICDSFileTransferPOSIXError(fromPath);
+        }
+        return NO;
+    }
+
+    BOOL success = NO;
+
+    if( S_ISREG(fromStatus.st_mode) ) {
+        success = [self transferFileAtPath:fromPath toPath:toPath status:&fromStatus allowingHardLink:allowHardLink method:&method bytesCopied:&bytesCopied error:outError];
+    } else if( S_ISDIR(fromStatus.st_mode) ) {
+        if( mkdir([toPath fileSystemRepresentation], fromStatus.st_mode & 0777) == -1 ) {
+            if( outError ) {
+                *outError = TICDSFileTransferPOSIXError(toPath);
+            }
+            return NO;
+        }
+
+        NSFileManager *fileManager = [[NSFileManager alloc] init];
+        NSArray *contents = [fileManager contentsOfDirectoryAtPath:fromPath error:outError];
+        [fileManager release];
+
+        success = contents != nil;
+
+        for( NSString *eachName in contents ) {
+            TICDSFileTransferMethod eachMethod = TICDSFileTransferMethodUnknown;
+            unsigned long long eachBytesCopied = 0;
+
+            success = [self transferItemAtPath:[fromPath stringByAppendingPathComponent:eachName] toPath:[toPath stringByAppendingPathComponent:eachName] allowingHardLink:allowHardLink method:&eachMethod bytesCopied:&eachBytesCopied error:outError];
+            if( !success ) {
+                break;
+            }
+
+            method = MAX(method, eachMethod);
+            bytesCopied += eachBytesCopied;
+        }
+    } else {
+        // symbolic links and anything else are left to the file manager
+        NSFileManager *fileManager = [[NSFileManager alloc] init];
+        success = [fileManager copyItemAtPath:fromPath toPath:toPath error:outError];
+        [fileManager release];
+
+        method = TICDSFileTransferMethodFileManagerCopy;
+    }
+
+    if( outMethod ) {
+        *outMethod = method;
+    }
+    if( outBytesCopied ) {
+        *outBytesCopied = bytesCopied;
+    }
+
+    return success;
+}
+
++ (BOOL)transferFileAtPath:(NSString *)fromPath toPath:(NSString *)toPath status:(struct stat *)fromStatus allowingHardLink:(BOOL)allowHardLink method:(TICDSFileTransferMethod *)outMethod bytesCopied:(unsigned long long *)outBytesCopied error:(NSError **)outError
+{
+    NSUInteger unsupportedMethods = [self unsupportedMethodsFromPath:fromPath toPath:toPath];
+
+    if( allowHardLink && !(unsupportedMethods & TICDSFileTransferUnsupportedHardLink) ) {
+        if( link([fromPath fileSystemRepresentation], [toPath fileSystemRepresentation]) == 0 ) {
+            *outMethod = TICDSFileTransferMethodHardLink;
+            return YES;
+        }
+
+        if( errno == EEXIST ) {
+            if( outError ) {
+                *outError = TICDSFileTransferPOSIXError(toPath);
+            }
+            return NO;
+        }
+
+        [self markMethods:TICDSFileTransferUnsupportedHardLink unsupportedFromPath:fromPath toPath:toPath];
+    }
+
+#if defined(__linux__)
+    int fromFileDescriptor = open([fromPath fileSystemRepresentation], O_RDONLY);
+    if( fromFileDescriptor == -1 ) {
+        if( outError ) {
+            *outError = TICDSFileTransferPOSIXError(fromPath);
+        }
+        return NO;
+    }
+
+    int toFileDescriptor = open([toPath fileSystemRepresentation], O_WRONLY | O_CREAT | O_EXCL, fromStatus->st_mode & 0777);
+    if( toFileDescriptor == -1 ) {
+        if( outError ) {
+            *outError = TICDSFileTransferPOSIXError(toPath);
+        }
+        close(fromFileDescriptor);
+        return NO;
+    }
+
+    BOOL success = NO;
+
+    if( !(unsupportedMethods & TICDSFileTransferUnsupportedClone) ) {
+        if( ioctl(toFileDescriptor, FICLONE, fromFileDescriptor) == 0 ) {
+            *outMethod = TICDSFileTransferMethodClone;
+            success = YES;
+        } else if( TICDSFileTransferErrorMeansUnsupported(errno) ) {
+            [self markMethods:TICDSFileTransferUnsupportedClone unsupportedFromPath:fromPath toPath:toPath];
+        }
+    }
+
+    if( !success && !(unsupportedMethods & TICDSFileTransferUnsupportedCopyFileRange) ) {
+        unsigned long long bytesCopied = 0;
+        BOOL unsupported = NO;
+
+        while( 1 ) {
+            ssize_t copied = copy_file_range(fromFileDescriptor, NULL, toFileDescriptor, NULL, TICDSFileTransferBufferSize * 16, 0);
+
+            if( copied == -1 ) {
+                if( errno == EINTR ) {
+                    continue;
+                }
+                // only fall back if nothing has been copied yet; otherwise the destination is part-written
+                unsupported = bytesCopied == 0 && TICDSFileTransferErrorMeansUnsupported(errno);
+                break;
+            }
+
+            if( copied == 0 ) {
+                success = YES;
+                break;
+            }
+
+            bytesCopied += copied;
+        }
+
+        if( success ) {
+            *outMethod = TICDSFileTransferMethodCopyFileRange;
+            *outBytesCopied = bytesCopied;
+        } else if( unsupported ) {
+            [self markMethods:TICDSFileTransferUnsupportedCopyFileRange unsupportedFromPath:fromPath toPath:toPath];
+        } else {
+            if( outError ) {
+                *outError = TICDSFileTransferPOSIXError(toPath);
+            }
+            close(fromFileDescriptor);
+            close(toFileDescriptor);
+            unlink([toPath fileSystemRepresentation]);
+            return NO;
+        }
+    }
+
+    if( !success ) {
+        success = TICDSFileTransferBufferedCopy(fromFileDescriptor, toFileDescriptor, outBytesCopied);
+        *outMethod = TICDSFileTransferMethodBufferedCopy;
+
+        if( !success && outError ) {
+            *outError = TICDSFileTransferPOSIXError(toPath);
+        }
+    }
+
+    close(fromFileDescriptor);
+    if( close(toFileDescriptor) == -1 && success ) {
+        success = NO;
+        if( outError ) {
+            *outError = TICDSFileTransferPOSIXError(toPath);
+        }
+    }
+
+    if( !success ) {
+        unlink([toPath fileSystemRepresentation]);
+    }
+
+    return success;
+#else
+    // the file manager already clones on file systems that support it
+    NSFileManager *fileManager = [[NSFileManager alloc] init];
+    BOOL success = [fileManager copyItemAtPath:fromPath toPath:toPath error:outError];
+    [fileManager release];
+
+    *outMethod = TICDSFileTransferMethodFileManagerCopy;
+    *outBytesCopied = success ? (unsigned long long)fromStatus->st_size : 0;
+
+    return success;
+#endif
+}
+
+#pragma mark -
+#pragma mark Capability Probes
++ (NSMutableDictionary *)unsupportedMethodsByDirectoryPair
+{
+    static NSMutableDictionary *unsupportedMethods = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        unsupportedMethods = [[NSMutableDictionary alloc] init];
+    });
+    return unsupportedMethods;
+}
+
++ (NSUInteger)unsupportedMethodsFromPath:(NSString *)fromPath toPath:(NSString *)toPath
+{
+    NSString *fromDirectoryPath = [fromPath stringByDeletingLastPathComponent];
+    NSString *toDirectoryPath = [toPath stringByDeletingLastPathComponent];
+    NSString *pairKey = [NSString stringWithFormat:@"%@\n%@", fromDirectoryPath, toDirectoryPath];
+
+    @synchronized(self) {
+        NSNumber *unsupportedMethods = [[self unsupportedMethodsByDirectoryPair] objectForKey:pairKey];
+        if( unsupportedMethods ) {
+            return [unsupportedMethods unsignedIntegerValue];
+        }
+    }
+
+    // neither links nor clones can cross a file system boundary, so don't bother trying
+    NSUInteger unsupportedMethods = 0;
+    struct stat fromDirectoryStatus;
+    struct stat toDirectoryStatus;
+    if( stat([fromDirectoryPath fileSystemRepresentation], &fromDirectoryStatus) == 0 && stat([toDirectoryPath fileSystemRepresentation], &toDirectoryStatus) == 0 && fromDirectoryStatus.st_dev != toDirectoryStatus.st_dev ) {
+        unsupportedMethods = TICDSFileTransferUnsupportedHardLink | TICDSFileTransferUnsupportedClone;
+    }
+
+    @synchronized(self) {
+        [[self unsupportedMethodsByDirectoryPair] setObject:[NSNumber numberWithUnsignedInteger:unsupportedMethods] forKey:pairKey];
+    }
+
+    return unsupportedMethods;
+}
+
++ (void)markMethods:(NSUInteger)someMethods unsupportedFromPath:(NSString *)fromPath toPath:(NSString *)toPath
+{
+    NSString *pairKey = [NSString stringWithFormat:@"%@\n%@", [fromPath stringByDeletingLastPathComponent], [toPath stringByDeletingLastPathComponent]];
+
+    @synchronized(self) {
+        NSUInteger unsupportedMethods = [[[self unsupportedMethodsByDirectoryPair] objectForKey:pairKey] unsignedIntegerValue];
+        [[self unsupportedMethodsByDirectoryPair] setObject:[NSNumber numberWithUnsignedInteger:unsupportedMethods | someMethods] forKey:pairKey];
+    }
+
+    TICDSLog(TICDSLogVerbosityEveryStep, @"File transfer method(s) %lu not supported from %@ to %@", (unsigned long)someMethods, [fromPath stringByDeletingLastPathComponent], [toPath stringByDeletingLastPathComponent]);
+}
+
+#pragma mark -
+#pragma mark Logging
++ (NSString *)nameOfTransferMethod:(TICDSFileTransferMethod)aMethod
+{
+    switch( aMethod ) {
+        case TICDSFileTransferMethodHardLink:
+            return @"hard link";
+        case TICDSFileTransferMethodClone:
+            return @"clone";
+        case TICDSFileTransferMethodCopyFileRange:
+            return @"copy_file_range";
+        case TICDSFileTransferMethodBufferedCopy:
+            return @"buffered copy";
+        case TICDSFileTransferMethodFileManagerCopy:
+            return @"file manager copy";
+        default:
+            return @"unknown";
+    }
+}
+
+#pragma mark -
+#pragma mark Functions
+static NSError *TICDSFileTransferPOSIXError( NSString *aPath )
+{
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:[NSDictionary dictionaryWithObject:aPath forKey:NSFilePathErrorKey]];
+}
+
+static BOOL TICDSFileTransferErrorMeansUnsupported( int anErrorNumber )
+{
+    switch( anErrorNumber ) {
+        case EXDEV:
+        case EINVAL:
+        case ENOSYS:
+        case ENOTTY:
+        case EPERM:
+        case EMLINK:
+        case EOPNOTSUPP:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+static BOOL TICDSFileTransferBufferedCopy( int fromFileDescriptor, int toFileDescriptor, unsigned long long *outBytesCopied )
+{
+    char *buffer = malloc(TICDSFileTransferBufferSize);
+    if( !buffer ) {
+        return NO;
+    }
+
+    unsigned long long bytesCopied = 0;
+    BOOL success = YES;
+
+    while( success ) {
+        ssize_t bytesRead = read(fromFileDescriptor, buffer, TICDSFileTransferBufferSize);
+        if( bytesRead == -1 ) {
+            if( errno == EINTR ) {
+                continue;
+            }
+            success = NO;
+            break;
+        }
+
+        if( bytesRead == 0 ) {
+            break;
+        }
+
+        ssize_t offset = 0;
+        while( offset < bytesRead ) {
+            ssize_t written = write(toFileDescriptor, buffer + offset, bytesRead - offset);
+            if( written == -1 ) {
+                if( errno == EINTR ) {
+                    continue;
+                }
+                success = NO;
+                break;
+            }
+            offset += written;
+        }
+
+        bytesCopied += offset;
+    }
+
+    free(buffer);
+
+    *outBytesCopied = bytesCopied;
+
+    return success;
+}
+
+@end
@@ -0,0 +1,100 @@
+//
+//  TICDSSyncChangeApplier.h
+//  TICoreDataSync
+//
+
+#import <CoreData/CoreData.h>
+
+/** `TICDSSyncChangeApplier` applies sync changes to the objects in an application managed object context.
+
+ An applier caches the objects it looks up, by entity and sync ID, so each entity is only fetched once; the cache is only valid until the context is reset (see `forgetCachedObjects`). Any problems that don't stop the changes being applied, such as an object that no longer exists locally, are added to `synchronizationWarnings`.
+
+ A relationship change whose object, or related object, doesn't exist yet is deferred rather than dropped, as is each relationship carried by an insertion change whose related object doesn't exist yet: it waits for the insertion of the missing object, perhaps in a later sync change set, and is applied straight after that object's insertion and relationships have been applied. Changes still waiting at the end of a synchronization are turned into warnings by `finishDeferredSyncChanges`.
+
+ The sync changes may be `TICDSSyncChange` objects, or their dictionary representations (see `-[TICDSSyncChange dictionaryRepresentation]`), which can be handed to another thread. A synchronization operation uses one applier for its background application context, and, when applying sync changes concurrently, one for each of the sibling contexts on which independent groups of changes are applied (see `independentGroupsOfSyncChanges:maximumGroupCount:`).
+
+ An applier is not thread-safe; it must only be used on one thread at a time, like its managed object context.
+ */
+@interface TICDSSyncChangeApplier : NSObject {
+@private
+    NSManagedObjectContext *_managedObjectContext;
+    NSMutableDictionary *_objectsBySyncIDByEntity;
+    NSMutableArray *_synchronizationWarnings;
+
+    NSMutableArray *_deferredSyncChanges;
+    NSMutableDictionary *_deferredSyncChangesByMissingSyncID;
+}
+
+/** @name Creation */
+
+/** Initialize an applier for the given managed object context.
+
+ @param aContext The application managed object context in which to apply sync changes.
+
+ @return An applier. */
+- (id)initWithManagedObjectContext:(NSManagedObjectContext *)aContext;
+
+/** @name Applying Sync Changes */
+
+/** Apply an array of sync changes, sorted by change type.
+
+ Relationships carried by insertion changes are set in bulk once every object inserted by consecutive insertion changes exists.
+
+ Consecutive to-many relationship changes are gathered by object and relationship, and each relationship is changed once. Where the relationship's inverse is to-one, the inverse is set on each related object instead, so Core Data updates the to-many side without firing its fault; otherwise the primitive set is changed with one change notification for all the added objects, and one for all the removed objects.
+
+ @param syncChanges The sync changes, or their dictionary representations, sorted by change type.
+ @param aBlock A block called after each change has been applied, with the number of changes applied so far, or `nil`. */
+- (void)applySyncChanges:(NSArray *)syncChanges progressBlock:(void (^)(NSUInteger changeNumber))aBlock;
+
+/** Find the object in the managed object context with the given entity name and sync ID, fetching every object of that entity the first time it's needed.
+
+ @param anEntityName The name of the entity.
+ @param aSyncIdentifier The sync ID of the object.
+
+ @return The object, or `nil` if there is no such object. */
+- (NSManagedObject *)objectForEntityName:(NSString *)anEntityName syncIdentifier:(NSString *)aSyncIdentifier;
+
+/** Forget the cached objects, e.g. after resetting the managed object context. */
+- (void)forgetCachedObjects;
+
+/** @name Deferred Relationship Changes */
+
+/** Apply the deferred relationship changes waiting for any of the given objects, e.g. once they have been inserted on another context and saved.
+
+ @param someSyncIDs The sync IDs of the inserted objects. */
+- (void)retryDeferredSyncChangesWaitingForSyncIDs:(NSArray *)someSyncIDs;
+
+/** Apply relationship changes previously returned by `deferredSyncChanges`, e.g. by an interrupted synchronization, deferring any that are still waiting for objects to be inserted.
+
+ @param someChanges The deferred relationship changes. */
+- (void)restoreDeferredSyncChanges:(NSArray *)someChanges;
+
+/** Give up on the relationship changes still waiting for objects to be inserted, adding a warning for each. */
+- (void)finishDeferredSyncChanges;
+
+/** The relationship changes waiting for objects to be inserted, in the order they were deferred, as property list dictionaries. */
+@property (nonatomic, readonly) NSArray *deferredSyncChanges;
+
+/** @name Partitioning Sync Changes */
+
+/** Split an array of sync changes into groups that can be applied on separate managed object contexts at the same time.
+
+ Changes are connected if they refer to the same object, or if one sets a relationship to the other's object; each group contains whole connected components, so no object is changed in more than one group. The components are spread over at most `aCount` groups, largest first, into whichever group has fewest changes so far, and each group keeps the changes in their original order. The result only depends on the order and content of the changes, so applying and saving the groups in the returned order is repeatable.
+
+ Only insertion and attribute changes should be partitioned; relationship changes on existing objects and deletions also affect the objects' previous related objects, which aren't named by the changes.
+
+ @param syncChanges The sync changes, or their dictionary representations.
+ @param aCount The maximum number of groups.
+
+ @return An array of arrays of sync changes, one per group. */
++ (NSArray *)independentGroupsOfSyncChanges:(NSArray *)syncChanges maximumGroupCount:(NSUInteger)aCount;
+
+/** @name Properties */
+
+/** The managed object context in which sync changes are applied. */
+@property (nonatomic, readonly) NSManagedObjectContext *managedObjectContext;
+
+/** The warnings generated while applying sync changes. */
+@property (nonatomic, readonly) NSMutableArray *synchronizationWarnings;
+
+@end
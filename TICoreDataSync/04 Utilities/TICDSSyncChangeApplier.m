@@ -0,0 +1,748 @@
+//
+//  TICDSSyncChangeApplier.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+@interface TICDSSyncChangeApplier ()
+
+- (void)applyObjectInsertedSyncChange:(id)aSyncChange;
+- (void)applyRelationshipsOfInsertedObjects:(NSArray *)insertionRelationships;
+- (void)finishInsertingObjectsWithSyncIDs:(NSMutableArray *)insertedSyncIDs relationships:(NSMutableArray *)insertionRelationships;
+- (void)applyAttributeChangeSyncChange:(id)aSyncChange;
+- (void)applyToOneRelationshipSyncChange:(id)aSyncChange;
+- (void)applyToManyRelationshipSyncChanges:(NSArray *)syncChanges;
+- (void)applyObjectDeletedSyncChange:(id)aSyncChange;
+- (void)applyRelationshipSyncChanges:(NSArray *)syncChanges;
+- (void)deferSyncChange:(id)aSyncChange untilInsertionOfObjectWithSyncID:(NSString *)aSyncID;
+- (void)deferRelationship:(NSRelationshipDescription *)aRelationship ofInsertion:(NSDictionary *)anInsertion untilInsertionOfObjectWithSyncID:(NSString *)aSyncID;
+- (void)addWarningForUnresolvedRelationshipSyncChange:(id)aSyncChange;
+
+@end
+
+#pragma mark -
+#pragma mark Sync Change Values
+// Dictionary representations use NSNull for nil values
+static id TICDSSyncChangeValue(id aSyncChange, NSString *aKey)
+{
+    id value = [aSyncChange valueForKey:aKey];
+
+    return value == [NSNull null] ? nil : value;
+}
+
+// Warnings carry the changed value, but not a delta, which means nothing without the value it was created from
+static id TICDSWarningAttributesOfSyncChange(id aSyncChange)
+{
+    id changedAttributes = TICDSSyncChangeValue(aSyncChange, @"changedAttributes");
+
+    return [changedAttributes isKindOfClass:[TICDSAttributeValueDelta class]] ? nil : changedAttributes;
+}
+
+// The sync IDs of the objects a change sets relationships to; insertion changes carry a dictionary of sync IDs, or collections of sync IDs, keyed by relationship name
+static NSArray *TICDSRelatedSyncIDsOfSyncChange(id aSyncChange)
+{
+    id changedRelationships = TICDSSyncChangeValue(aSyncChange, @"changedRelationships");
+
+    if( [changedRelationships isKindOfClass:[NSString class]] ) {
+        return [NSArray arrayWithObject:changedRelationships];
+    }
+
+    if( ![changedRelationships isKindOfClass:[NSDictionary class]] ) {
+        return nil;
+    }
+
+    NSMutableArray *syncIDs = [NSMutableArray array];
+    for( id eachValue in [changedRelationships allValues] ) {
+        if( [eachValue isKindOfClass:[NSString class]] ) {
+            [syncIDs addObject:eachValue];
+            continue;
+        }
+
+        if( ![eachValue conformsToProtocol:@protocol(NSFastEnumeration)] ) {
+            continue;
+        }
+
+        for( id eachSyncID in eachValue ) {
+            if( [eachSyncID isKindOfClass:[NSString class]] ) {
+                [syncIDs addObject:eachSyncID];
+            }
+        }
+    }
+
+    return syncIDs;
+}
+
+// Find the root of a sync ID's component, compressing the path on the way
+static NSString *TICDSRootSyncID(NSMutableDictionary *parentSyncIDs, NSString *aSyncID)
+{
+    NSString *root = aSyncID;
+    NSString *parent = nil;
+    while( (parent = [parentSyncIDs objectForKey:root]) && ![parent isEqualToString:root] ) {
+        root = parent;
+    }
+
+    if( !parent ) {
+        [parentSyncIDs setObject:root forKey:root];
+    }
+
+    NSString *eachSyncID = aSyncID;
+    while( ![eachSyncID isEqualToString:root] ) {
+        NSString *nextSyncID = [[[parentSyncIDs objectForKey:eachSyncID] retain] autorelease];
+        [parentSyncIDs setObject:root forKey:eachSyncID];
+        eachSyncID = nextSyncID;
+    }
+
+    return root;
+}
+
+@implementation TICDSSyncChangeApplier
+
+#pragma mark -
+#pragma mark Applying Sync Changes
+- (void)applySyncChanges:(NSArray *)syncChanges progressBlock:(void (^)(NSUInteger changeNumber))aBlock
+{
+    NSMutableArray *insertionRelationships = [NSMutableArray array];
+    NSMutableArray *insertedSyncIDs = [NSMutableArray array];
+    NSMutableArray *toManyRelationshipChanges = [NSMutableArray array];
+
+    NSUInteger changeCount = 1;
+    for( id eachChange in syncChanges ) {
+        @autoreleasepool {
+            NSUInteger changeType = [TICDSSyncChangeValue(eachChange, @"changeType") unsignedIntegerValue];
+
+            if( [insertedSyncIDs count] > 0 && changeType != TICDSSyncChangeTypeObjectInserted ) {
+                [self finishInsertingObjectsWithSyncIDs:insertedSyncIDs relationships:insertionRelationships];
+            }
+
+            if( [toManyRelationshipChanges count] > 0 && changeType != TICDSSyncChangeTypeToManyRelationshipChangedByAddingObject && changeType != TICDSSyncChangeTypeToManyRelationshipChangedByRemovingObject ) {
+                [self applyToManyRelationshipSyncChanges:toManyRelationshipChanges];
+                [toManyRelationshipChanges removeAllObjects];
+            }
+
+            switch( changeType ) {
+                case TICDSSyncChangeTypeObjectInserted:
+                    [self applyObjectInsertedSyncChange:eachChange];
+                    [[self managedObjectContext] processPendingChanges];
+                    if( TICDSSyncChangeValue(eachChange, @"objectSyncID") ) {
+                        [insertedSyncIDs addObject:TICDSSyncChangeValue(eachChange, @"objectSyncID")];
+                    }
+                    if( [TICDSSyncChangeValue(eachChange, @"changedRelationships") isKindOfClass:[NSDictionary class]] ) {
+                        [insertionRelationships addObject:[NSDictionary dictionaryWithObjectsAndKeys:TICDSSyncChangeValue(eachChange, @"objectEntityName"), @"objectEntityName", TICDSSyncChangeValue(eachChange, @"objectSyncID"), @"objectSyncID", TICDSSyncChangeValue(eachChange, @"changedRelationships"), @"changedRelationships", nil]];
+                    }
+                    break;
+
+                case TICDSSyncChangeTypeAttributeChanged:
+                    [self applyAttributeChangeSyncChange:eachChange];
+                    break;
+
+                case TICDSSyncChangeTypeToOneRelationshipChanged:
+                    [self applyToOneRelationshipSyncChange:eachChange];
+                    break;
+
+                case TICDSSyncChangeTypeToManyRelationshipChangedByAddingObject:
+                case TICDSSyncChangeTypeToManyRelationshipChangedByRemovingObject:
+                    // Applied together, once every consecutive to-many change has been read
+                    [toManyRelationshipChanges addObject:eachChange];
+                    break;
+
+                case TICDSSyncChangeTypeObjectDeleted:
+                    [self applyObjectDeletedSyncChange:eachChange];
+                    break;
+            }
+
+            if( [eachChange isKindOfClass:[NSManagedObject class]] && [toManyRelationshipChanges lastObject] != eachChange ) {
+                [[eachChange managedObjectContext] refreshObject:eachChange mergeChanges:NO]; // Keep memory low
+            }
+
+            if( aBlock ) {
+                aBlock(changeCount);
+            }
+            changeCount++;
+        }
+    }
+
+    if( [insertedSyncIDs count] > 0 ) {
+        [self finishInsertingObjectsWithSyncIDs:insertedSyncIDs relationships:insertionRelationships];
+    }
+
+    if( [toManyRelationshipChanges count] > 0 ) {
+        [self applyToManyRelationshipSyncChanges:toManyRelationshipChanges];
+    }
+
+    [[self managedObjectContext] processPendingChanges];
+}
+
+- (void)finishInsertingObjectsWithSyncIDs:(NSMutableArray *)insertedSyncIDs relationships:(NSMutableArray *)insertionRelationships
+{
+    if( [insertionRelationships count] > 0 ) {
+        [self applyRelationshipsOfInsertedObjects:insertionRelationships];
+        [insertionRelationships removeAllObjects];
+    }
+
+    [self retryDeferredSyncChangesWaitingForSyncIDs:insertedSyncIDs];
+    [insertedSyncIDs removeAllObjects];
+}
+
+#pragma mark Fetching Affected Objects
+- (NSManagedObject *)objectForEntityName:(NSString *)anEntityName syncIdentifier:(NSString *)aSyncIdentifier
+{
+    NSDictionary *objectsBySyncID = [_objectsBySyncIDByEntity objectForKey:anEntityName];
+    if ( !objectsBySyncID ) {
+        NSError *anyError = nil;
+        NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+        [fetchRequest setEntity:[NSEntityDescription entityForName:anEntityName inManagedObjectContext:[self managedObjectContext]]];
+        [fetchRequest setPropertiesToFetch:[NSArray arrayWithObject:TICDSSyncIDAttributeName]];
+        NSArray *objects = [[self managedObjectContext] executeFetchRequest:fetchRequest error:&anyError];
+        if( !objects ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Error fetching objects: %@", anyError);
+        }
+        else {
+            objectsBySyncID = [NSMutableDictionary dictionaryWithObjects:objects forKeys:[objects valueForKeyPath:TICDSSyncIDAttributeName]];
+            [_objectsBySyncIDByEntity setObject:objectsBySyncID forKey:anEntityName];
+        }
+        [fetchRequest release];
+    }
+
+    return [objectsBySyncID objectForKey:aSyncIdentifier];
+}
+
+- (void)forgetCachedObjects
+{
+    [_objectsBySyncIDByEntity removeAllObjects];
+}
+
+#pragma mark Applying Changes
+- (void)applyObjectInsertedSyncChange:(id)aSyncChange
+{
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Insertion sync change");
+
+    NSString *entityName = TICDSSyncChangeValue(aSyncChange, @"objectEntityName");
+    NSString *ticdsSyncID = TICDSSyncChangeValue(aSyncChange, @"objectSyncID");
+    TICDSSynchronizedManagedObject *object = (id)[self objectForEntityName:entityName syncIdentifier:ticdsSyncID];
+
+    if ( !object ) {
+        object = [NSEntityDescription insertNewObjectForEntityForName:entityName inManagedObjectContext:[self managedObjectContext]];
+        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Inserted object: %@", object);
+
+        // Add to object cache
+        NSMutableDictionary *objectsBySyncID = [_objectsBySyncIDByEntity objectForKey:entityName];
+        [objectsBySyncID setObject:object forKey:ticdsSyncID];
+    } else {
+        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Attempted to insert an object that already existed, updating existing object instead.: %@", object);
+    }
+
+    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, entityName);
+
+    TICDSEntitySyncDescriptor *syncDescriptor = [TICDSEntitySyncDescriptor syncDescriptorForEntity:[object entity]];
+    NSDictionary *changedAttributes = TICDSSyncChangeValue(aSyncChange, @"changedAttributes");
+    for (id key in [changedAttributes allKeys]) {
+        [object willChangeValueForKey:key];
+        id transformedValue = [changedAttributes valueForKey:key];
+        transformedValue = [syncDescriptor reverseTransformedValue:transformedValue forAttributeNamed:key];
+        [object setPrimitiveValue:transformedValue forKey:key];
+        [object didChangeValueForKey:key];
+    }
+
+    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Updated object: %@", object);
+}
+
+- (void)applyRelationshipsOfInsertedObjects:(NSArray *)insertionRelationships
+{
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying relationships of %lu inserted objects", (unsigned long)[insertionRelationships count]);
+
+    for( NSDictionary *eachInsertion in insertionRelationships ) {
+        NSString *entityName = [eachInsertion valueForKey:@"objectEntityName"];
+        NSManagedObject *object = [self objectForEntityName:entityName syncIdentifier:[eachInsertion valueForKey:@"objectSyncID"]];
+        if( !object ) {
+            continue;
+        }
+
+        NSDictionary *relationshipsByName = [[TICDSEntitySyncDescriptor syncDescriptorForEntity:[object entity]] relationshipsByName];
+        NSDictionary *changedRelationships = [eachInsertion valueForKey:@"changedRelationships"];
+        for( NSString *eachRelationshipName in changedRelationships ) {
+            NSRelationshipDescription *relationship = [relationshipsByName objectForKey:eachRelationshipName];
+            if( !relationship ) {
+                TICDSLog(TICDSLogVerbosityErrorsOnly, @"Relationship %@ not found on %@ for insertion change", eachRelationshipName, entityName);
+                continue;
+            }
+
+            NSString *relatedEntityName = [[relationship destinationEntity] name];
+            id relatedSyncIDs = [changedRelationships objectForKey:eachRelationshipName];
+
+            if( ![relationship isToMany] ) {
+                NSManagedObject *relatedObject = [self objectForEntityName:relatedEntityName syncIdentifier:relatedSyncIDs];
+                if( !relatedObject ) {
+                    [self deferRelationship:relationship ofInsertion:eachInsertion untilInsertionOfObjectWithSyncID:relatedSyncIDs];
+                    continue;
+                }
+
+                [object willChangeValueForKey:eachRelationshipName];
+                [object setPrimitiveValue:relatedObject forKey:eachRelationshipName];
+                [object didChangeValueForKey:eachRelationshipName];
+                continue;
+            }
+
+            NSMutableSet *relatedObjects = [NSMutableSet setWithCapacity:[relatedSyncIDs count]];
+            for( NSString *eachSyncID in relatedSyncIDs ) {
+                NSManagedObject *relatedObject = [self objectForEntityName:relatedEntityName syncIdentifier:eachSyncID];
+                if( !relatedObject ) {
+                    [self deferRelationship:relationship ofInsertion:eachInsertion untilInsertionOfObjectWithSyncID:eachSyncID];
+                    continue;
+                }
+
+                [relatedObjects addObject:relatedObject];
+            }
+
+            [[object mutableSetValueForKey:eachRelationshipName] unionSet:relatedObjects];
+        }
+
+        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Set relationships on inserted object: %@", object);
+    }
+}
+
+- (void)applyAttributeChangeSyncChange:(id)aSyncChange
+{
+    NSString *entityName = TICDSSyncChangeValue(aSyncChange, @"objectEntityName");
+    NSString *relevantKey = TICDSSyncChangeValue(aSyncChange, @"relevantKey");
+
+    @try {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Attribute Change sync change");
+
+        TICDSSynchronizedManagedObject *object = (id)[self objectForEntityName:entityName syncIdentifier:TICDSSyncChangeValue(aSyncChange, @"objectSyncID")];
+
+        if( !object || object.managedObjectContext == nil || object.isDeleted ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Object not found locally for attribute change [%@] %@", aSyncChange, entityName);
+            [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectNotFoundLocallyForRemoteAttributeSyncChange entityName:entityName relatedObjectEntityName:nil attributes:TICDSWarningAttributesOfSyncChange(aSyncChange)]];
+            return;
+        }
+
+        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, entityName);
+
+        id transformedValue = TICDSSyncChangeValue(aSyncChange, @"changedAttributes");
+        if( [transformedValue isKindOfClass:[TICDSAttributeValueDelta class]] ) {
+            // the delta was created against the value the other client had before the change, which this client should have now
+            id newValue = [transformedValue valueByApplyingToBaseValue:[object transformedValueOfAttribute:relevantKey]];
+            if( !newValue ) {
+                TICDSLog(TICDSLogVerbosityErrorsOnly, @"Local value of %@ has changed since remote delta attribute change [%@] %@ was created", relevantKey, aSyncChange, entityName);
+                [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeLocalValueChangedSinceRemoteDeltaAttributeSyncChange entityName:entityName relatedObjectEntityName:nil attributes:[NSDictionary dictionaryWithObject:relevantKey forKey:kTICDSSyncWarningRelevantKey]]];
+                return;
+            }
+            transformedValue = newValue;
+        }
+
+        [object willChangeValueForKey:relevantKey];
+        transformedValue = [object reverseTransformedValueOfAttribute:relevantKey withValue:transformedValue];
+        [object setPrimitiveValue:transformedValue forKey:relevantKey];
+        [object didChangeValueForKey:relevantKey];
+
+        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Changed attribute on object: %@", object);
+    }
+    @catch ( NSException *exception ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Exception thrown while applying attribute change [%@] %@: %@", aSyncChange, entityName, exception);
+        [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectExceptionAroseWhileApplyingAttributeSyncChange entityName:entityName relatedObjectEntityName:nil attributes:TICDSWarningAttributesOfSyncChange(aSyncChange)]];
+    }
+}
+
+- (void)applyRelationshipSyncChanges:(NSArray *)syncChanges
+{
+    NSMutableArray *toManyRelationshipChanges = [NSMutableArray arrayWithCapacity:[syncChanges count]];
+
+    for( id eachChange in syncChanges ) {
+        if( [TICDSSyncChangeValue(eachChange, @"changeType") unsignedIntegerValue] == TICDSSyncChangeTypeToOneRelationshipChanged ) {
+            [self applyToOneRelationshipSyncChange:eachChange];
+        } else {
+            [toManyRelationshipChanges addObject:eachChange];
+        }
+    }
+
+    if( [toManyRelationshipChanges count] > 0 ) {
+        [self applyToManyRelationshipSyncChanges:toManyRelationshipChanges];
+    }
+}
+
+- (void)applyToOneRelationshipSyncChange:(id)aSyncChange
+{
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Relationship Change sync change");
+
+    NSString *entityName = TICDSSyncChangeValue(aSyncChange, @"objectEntityName");
+    NSString *syncID = TICDSSyncChangeValue(aSyncChange, @"objectSyncID");
+    NSString *relatedSyncID = TICDSSyncChangeValue(aSyncChange, @"changedRelationships");
+    NSString *relevantKey = TICDSSyncChangeValue(aSyncChange, @"relevantKey");
+    NSManagedObject *object = [self objectForEntityName:entityName syncIdentifier:syncID];
+
+    if( !object ) {
+        [self deferSyncChange:aSyncChange untilInsertionOfObjectWithSyncID:syncID];
+        return;
+    }
+
+    // A to-one change without a related sync ID clears the relationship
+    NSManagedObject *relatedObject = nil;
+    if( relatedSyncID ) {
+        relatedObject = [self objectForEntityName:TICDSSyncChangeValue(aSyncChange, @"relatedObjectEntityName") syncIdentifier:relatedSyncID];
+
+        if( !relatedObject ) {
+            [self deferSyncChange:aSyncChange untilInsertionOfObjectWithSyncID:relatedSyncID];
+            return;
+        }
+    }
+
+    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, entityName);
+    [object willChangeValueForKey:relevantKey];
+    [object setPrimitiveValue:relatedObject forKey:relevantKey];
+    [object didChangeValueForKey:relevantKey];
+
+    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Changed to-one relationship on object: %@", object);
+}
+
+- (void)applyToManyRelationshipSyncChanges:(NSArray *)syncChanges
+{
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying %lu to-many relationship sync changes", (unsigned long)[syncChanges count]);
+
+    // Gather the objects added and removed for each object's relationship, so each relationship is only changed once
+    NSMutableArray *mutations = [NSMutableArray array];
+    NSMutableDictionary *mutationsByKey = [NSMutableDictionary dictionary];
+
+    for( id eachChange in syncChanges ) {
+        NSString *entityName = TICDSSyncChangeValue(eachChange, @"objectEntityName");
+        NSString *syncID = TICDSSyncChangeValue(eachChange, @"objectSyncID");
+        NSString *relatedSyncID = TICDSSyncChangeValue(eachChange, @"changedRelationships");
+        NSString *relevantKey = TICDSSyncChangeValue(eachChange, @"relevantKey");
+        NSManagedObject *object = [self objectForEntityName:entityName syncIdentifier:syncID];
+
+        if( !object ) {
+            [self deferSyncChange:eachChange untilInsertionOfObjectWithSyncID:syncID];
+            continue;
+        }
+
+        NSManagedObject *relatedObject = [self objectForEntityName:TICDSSyncChangeValue(eachChange, @"relatedObjectEntityName") syncIdentifier:relatedSyncID];
+        if( !relatedObject ) {
+            [self deferSyncChange:eachChange untilInsertionOfObjectWithSyncID:relatedSyncID];
+            continue;
+        }
+
+        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", eachChange, entityName);
+
+        NSString *mutationKey = [NSString stringWithFormat:@"%@ %@ %@", entityName, syncID, relevantKey];
+        NSMutableDictionary *mutation = [mutationsByKey objectForKey:mutationKey];
+        if( !mutation ) {
+            mutation = [NSMutableDictionary dictionaryWithObjectsAndKeys:object, @"object", relevantKey, @"relationshipName", [NSMutableSet set], @"addedObjects", [NSMutableSet set], @"removedObjects", nil];
+            [mutationsByKey setObject:mutation forKey:mutationKey];
+            [mutations addObject:mutation];
+        }
+
+        // Additions are applied before removals, so an object added after being removed must no longer be removed
+        if( [TICDSSyncChangeValue(eachChange, @"changeType") unsignedIntegerValue] == TICDSSyncChangeTypeToManyRelationshipChangedByAddingObject ) {
+            [[mutation objectForKey:@"addedObjects"] addObject:relatedObject];
+            [[mutation objectForKey:@"removedObjects"] removeObject:relatedObject];
+        } else {
+            [[mutation objectForKey:@"removedObjects"] addObject:relatedObject];
+        }
+    }
+
+    for( NSDictionary *eachMutation in mutations ) {
+        NSManagedObject *object = [eachMutation objectForKey:@"object"];
+        NSString *relationshipName = [eachMutation objectForKey:@"relationshipName"];
+        NSSet *addedObjects = [eachMutation objectForKey:@"addedObjects"];
+        NSSet *removedObjects = [eachMutation objectForKey:@"removedObjects"];
+
+        NSRelationshipDescription *relationship = [[[object entity] relationshipsByName] objectForKey:relationshipName];
+        if( !relationship ) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Relationship %@ not found on %@ for to-many relationship change", relationshipName, [[object entity] name]);
+            continue;
+        }
+
+        NSRelationshipDescription *inverseRelationship = [relationship inverseRelationship];
+
+        if( inverseRelationship && ![inverseRelationship isToMany] ) {
+            // Setting the to-one side of each related object lets Core Data update this side without firing its fault
+            NSString *inverseName = [inverseRelationship name];
+
+            for( NSManagedObject *eachRelatedObject in addedObjects ) {
+                [eachRelatedObject willChangeValueForKey:inverseName];
+                [eachRelatedObject setPrimitiveValue:object forKey:inverseName];
+                [eachRelatedObject didChangeValueForKey:inverseName];
+            }
+
+            for( NSManagedObject *eachRelatedObject in removedObjects ) {
+                // A related object that has since moved to another object isn't this object's to remove
+                if( [eachRelatedObject valueForKey:inverseName] != object ) {
+                    continue;
+                }
+
+                [eachRelatedObject willChangeValueForKey:inverseName];
+                [eachRelatedObject setPrimitiveValue:nil forKey:inverseName];
+                [eachRelatedObject didChangeValueForKey:inverseName];
+            }
+        } else {
+            // Change the primitive set once for each kind of mutation, posting a single change notification, as a generated accessor would
+            if( [addedObjects count] > 0 ) {
+                [object willChangeValueForKey:relationshipName withSetMutation:NSKeyValueUnionSetMutation usingObjects:addedObjects];
+                [[object primitiveValueForKey:relationshipName] unionSet:addedObjects];
+                [object didChangeValueForKey:relationshipName withSetMutation:NSKeyValueUnionSetMutation usingObjects:addedObjects];
+            }
+
+            if( [removedObjects count] > 0 ) {
+                [object willChangeValueForKey:relationshipName withSetMutation:NSKeyValueMinusSetMutation usingObjects:removedObjects];
+                [[object primitiveValueForKey:relationshipName] minusSet:removedObjects];
+                [object didChangeValueForKey:relationshipName withSetMutation:NSKeyValueMinusSetMutation usingObjects:removedObjects];
+            }
+        }
+
+        TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"Changed to-many relationships on object: %@", object);
+    }
+
+    // The changes were kept from being turned back into faults until now
+    for( id eachChange in syncChanges ) {
+        if( [eachChange isKindOfClass:[NSManagedObject class]] ) {
+            [[eachChange managedObjectContext] refreshObject:eachChange mergeChanges:NO];
+        }
+    }
+}
+
+- (void)applyObjectDeletedSyncChange:(id)aSyncChange
+{
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying Deletion sync change");
+
+    NSString *entityName = TICDSSyncChangeValue(aSyncChange, @"objectEntityName");
+    NSString *syncID = TICDSSyncChangeValue(aSyncChange, @"objectSyncID");
+    NSManagedObject *object = [self objectForEntityName:entityName syncIdentifier:syncID];
+
+    if( !object ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Object not found locally for deletion sync change [%@] %@", aSyncChange, entityName);
+        [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectNotFoundLocallyForRemoteDeletionSyncChange entityName:entityName relatedObjectEntityName:nil attributes:nil]];
+        return;
+    }
+
+    TICDSLog(TICDSLogVerbosityManagedObjectOutput, @"[%@] %@", aSyncChange, entityName);
+
+    [[self managedObjectContext] deleteObject:object];
+
+    // Remove from object cache
+    NSMutableDictionary *objectsBySyncID = [_objectsBySyncIDByEntity objectForKey:entityName];
+    [objectsBySyncID removeObjectForKey:syncID ? : [NSNull null]];
+}
+
+#pragma mark -
+#pragma mark Deferred Relationship Changes
+- (void)deferSyncChange:(id)aSyncChange untilInsertionOfObjectWithSyncID:(NSString *)aSyncID
+{
+    if( !aSyncID ) {
+        [self addWarningForUnresolvedRelationshipSyncChange:aSyncChange];
+        return;
+    }
+
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Deferring relationship change on %@ until object %@ has been inserted", TICDSSyncChangeValue(aSyncChange, @"objectEntityName"), aSyncID);
+
+    // Only the properties a relationship change uses are kept, so the deferred change can be written to a property list
+    NSMutableDictionary *deferredChange = [NSMutableDictionary dictionaryWithCapacity:6];
+    for( NSString *eachKey in [NSArray arrayWithObjects:@"changeType", @"objectEntityName", @"objectSyncID", @"relevantKey", @"relatedObjectEntityName", @"changedRelationships", nil] ) {
+        [deferredChange setValue:TICDSSyncChangeValue(aSyncChange, eachKey) forKey:eachKey];
+    }
+
+    [_deferredSyncChanges addObject:deferredChange];
+
+    NSMutableArray *waitingChanges = [_deferredSyncChangesByMissingSyncID objectForKey:aSyncID];
+    if( !waitingChanges ) {
+        waitingChanges = [NSMutableArray arrayWithCapacity:1];
+        [_deferredSyncChangesByMissingSyncID setObject:waitingChanges forKey:aSyncID];
+    }
+    [waitingChanges addObject:deferredChange];
+}
+
+// The related object may be inserted by a later change set, so the relationship is deferred as the equivalent relationship change
+- (void)deferRelationship:(NSRelationshipDescription *)aRelationship ofInsertion:(NSDictionary *)anInsertion untilInsertionOfObjectWithSyncID:(NSString *)aSyncID
+{
+    TICDSSyncChangeType changeType = [aRelationship isToMany] ? TICDSSyncChangeTypeToManyRelationshipChangedByAddingObject : TICDSSyncChangeTypeToOneRelationshipChanged;
+
+    NSMutableDictionary *relationshipChange = [NSMutableDictionary dictionaryWithCapacity:6];
+    [relationshipChange setValue:[NSNumber numberWithUnsignedInteger:changeType] forKey:@"changeType"];
+    [relationshipChange setValue:[anInsertion valueForKey:@"objectEntityName"] forKey:@"objectEntityName"];
+    [relationshipChange setValue:[anInsertion valueForKey:@"objectSyncID"] forKey:@"objectSyncID"];
+    [relationshipChange setValue:[aRelationship name] forKey:@"relevantKey"];
+    [relationshipChange setValue:[[aRelationship destinationEntity] name] forKey:@"relatedObjectEntityName"];
+    [relationshipChange setValue:aSyncID forKey:@"changedRelationships"];
+
+    [self deferSyncChange:relationshipChange untilInsertionOfObjectWithSyncID:aSyncID];
+}
+
+- (void)retryDeferredSyncChangesWaitingForSyncIDs:(NSArray *)someSyncIDs
+{
+    if( [_deferredSyncChanges count] < 1 ) {
+        return;
+    }
+
+    NSMutableSet *changesToRetry = [NSMutableSet set];
+    for( NSString *eachSyncID in someSyncIDs ) {
+        NSArray *waitingChanges = [_deferredSyncChangesByMissingSyncID objectForKey:eachSyncID];
+        if( !waitingChanges ) {
+            continue;
+        }
+
+        [changesToRetry addObjectsFromArray:waitingChanges];
+        [_deferredSyncChangesByMissingSyncID removeObjectForKey:eachSyncID];
+    }
+
+    if( [changesToRetry count] < 1 ) {
+        return;
+    }
+
+    // Apply the changes in the order they were deferred; any still missing an object are deferred again
+    NSIndexSet *indexes = [_deferredSyncChanges indexesOfObjectsPassingTest:^BOOL(id eachChange, NSUInteger index, BOOL *stop) {
+        return [changesToRetry containsObject:eachChange];
+    }];
+
+    NSArray *changes = [_deferredSyncChanges objectsAtIndexes:indexes];
+    [_deferredSyncChanges removeObjectsAtIndexes:indexes];
+
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Applying %lu deferred relationship changes", (unsigned long)[changes count]);
+
+    [self applyRelationshipSyncChanges:changes];
+}
+
+- (void)restoreDeferredSyncChanges:(NSArray *)someChanges
+{
+    [self applyRelationshipSyncChanges:someChanges];
+}
+
+- (void)finishDeferredSyncChanges
+{
+    for( NSDictionary *eachChange in _deferredSyncChanges ) {
+        [self addWarningForUnresolvedRelationshipSyncChange:eachChange];
+    }
+
+    [_deferredSyncChanges removeAllObjects];
+    [_deferredSyncChangesByMissingSyncID removeAllObjects];
+}
+
+- (void)addWarningForUnresolvedRelationshipSyncChange:(id)aSyncChange
+{
+    TICDSLog(TICDSLogVerbosityErrorsOnly, @"Object not found locally for relationship change [%@] %@", aSyncChange, TICDSSyncChangeValue(aSyncChange, @"objectEntityName"));
+    [[self synchronizationWarnings] addObject:[TICDSUtilities syncWarningOfType:TICDSSyncWarningTypeObjectNotFoundLocallyForRemoteRelationshipSyncChange entityName:TICDSSyncChangeValue(aSyncChange, @"objectEntityName") relatedObjectEntityName:TICDSSyncChangeValue(aSyncChange, @"relatedObjectEntityName") attributes:nil]];
+}
+
+- (NSArray *)deferredSyncChanges
+{
+    return [[_deferredSyncChanges copy] autorelease];
+}
+
+#pragma mark -
+#pragma mark Partitioning Sync Changes
++ (NSArray *)independentGroupsOfSyncChanges:(NSArray *)syncChanges maximumGroupCount:(NSUInteger)aCount
+{
+    // Union-find over sync IDs: each sync ID maps to its parent, and each component's root to itself
+    NSMutableDictionary *parentSyncIDs = [NSMutableDictionary dictionaryWithCapacity:[syncChanges count]];
+
+    for( id eachChange in syncChanges ) {
+        NSString *root = TICDSRootSyncID(parentSyncIDs, TICDSSyncChangeValue(eachChange, @"objectSyncID") ? : @"");
+
+        for( NSString *eachRelatedSyncID in TICDSRelatedSyncIDsOfSyncChange(eachChange) ) {
+            NSString *relatedRoot = TICDSRootSyncID(parentSyncIDs, eachRelatedSyncID);
+            if( ![relatedRoot isEqualToString:root] ) {
+                [parentSyncIDs setObject:root forKey:relatedRoot];
+            }
+        }
+    }
+
+    // Number the components in the order their first change appears
+    NSMutableDictionary *componentIndexesByRoot = [NSMutableDictionary dictionary];
+    NSMutableArray *componentIndexesOfChanges = [NSMutableArray arrayWithCapacity:[syncChanges count]];
+    NSMutableArray *componentSizes = [NSMutableArray array];
+
+    for( id eachChange in syncChanges ) {
+        NSString *root = TICDSRootSyncID(parentSyncIDs, TICDSSyncChangeValue(eachChange, @"objectSyncID") ? : @"");
+
+        NSNumber *componentIndex = [componentIndexesByRoot objectForKey:root];
+        if( !componentIndex ) {
+            componentIndex = [NSNumber numberWithUnsignedInteger:[componentSizes count]];
+            [componentIndexesByRoot setObject:componentIndex forKey:root];
+            [componentSizes addObject:[NSNumber numberWithUnsignedInteger:0]];
+        }
+
+        NSUInteger index = [componentIndex unsignedIntegerValue];
+        [componentSizes replaceObjectAtIndex:index withObject:[NSNumber numberWithUnsignedInteger:[[componentSizes objectAtIndex:index] unsignedIntegerValue] + 1]];
+        [componentIndexesOfChanges addObject:componentIndex];
+    }
+
+    NSUInteger groupCount = MIN(aCount, [componentSizes count]);
+    if( groupCount < 2 ) {
+        return [NSArray arrayWithObject:syncChanges];
+    }
+
+    // Put each component, largest first, into the group with the fewest changes so far
+    NSMutableArray *componentIndexes = [NSMutableArray arrayWithCapacity:[componentSizes count]];
+    for( NSUInteger index = 0; index < [componentSizes count]; index++ ) {
+        [componentIndexes addObject:[NSNumber numberWithUnsignedInteger:index]];
+    }
+
+    [componentIndexes sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(NSNumber *index1, NSNumber *index2) {
+        return [[componentSizes objectAtIndex:[index2 unsignedIntegerValue]] compare:[componentSizes objectAtIndex:[index1 unsignedIntegerValue]]];
+    }];
+
+    NSUInteger *groupSizes = calloc(groupCount, sizeof(NSUInteger));
+    NSMutableArray *groupIndexesOfComponents = [NSMutableArray arrayWithArray:componentSizes];
+
+    for( NSNumber *eachComponentIndex in componentIndexes ) {
+        NSUInteger smallestGroup = 0;
+        for( NSUInteger groupIndex = 1; groupIndex < groupCount; groupIndex++ ) {
+            if( groupSizes[groupIndex] < groupSizes[smallestGroup] ) {
+                smallestGroup = groupIndex;
+            }
+        }
+
+        groupSizes[smallestGroup] += [[componentSizes objectAtIndex:[eachComponentIndex unsignedIntegerValue]] unsignedIntegerValue];
+        [groupIndexesOfComponents replaceObjectAtIndex:[eachComponentIndex unsignedIntegerValue] withObject:[NSNumber numberWithUnsignedInteger:smallestGroup]];
+    }
+
+    free(groupSizes);
+
+    NSMutableArray *groups = [NSMutableArray arrayWithCapacity:groupCount];
+    for( NSUInteger groupIndex = 0; groupIndex < groupCount; groupIndex++ ) {
+        [groups addObject:[NSMutableArray array]];
+    }
+
+    [syncChanges enumerateObjectsUsingBlock:^(id eachChange, NSUInteger changeIndex, BOOL *stop) {
+        NSNumber *componentIndex = [componentIndexesOfChanges objectAtIndex:changeIndex];
+        NSUInteger groupIndex = [[groupIndexesOfComponents objectAtIndex:[componentIndex unsignedIntegerValue]] unsignedIntegerValue];
+        [[groups objectAtIndex:groupIndex] addObject:eachChange];
+    }];
+
+    return groups;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)initWithManagedObjectContext:(NSManagedObjectContext *)aContext
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+
+    _managedObjectContext = [aContext retain];
+    _objectsBySyncIDByEntity = [[NSMutableDictionary alloc] init];
+    _synchronizationWarnings = [[NSMutableArray alloc] init];
+
+    _deferredSyncChanges = [[NSMutableArray alloc] init];
+    _deferredSyncChangesByMissingSyncID = [[NSMutableDictionary alloc] init];
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [_managedObjectContext release], _managedObjectContext = nil;
+    [_objectsBySyncIDByEntity release], _objectsBySyncIDByEntity = nil;
+    [_synchronizationWarnings release], _synchronizationWarnings = nil;
+    [_deferredSyncChanges release], _deferredSyncChanges = nil;
+    [_deferredSyncChangesByMissingSyncID release], _deferredSyncChangesByMissingSyncID = nil;
+
+    [super dealloc];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize managedObjectContext = _managedObjectContext;
+@synthesize synchronizationWarnings = _synchronizationWarnings;
+
+@end
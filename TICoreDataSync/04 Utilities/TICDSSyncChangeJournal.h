@@ -0,0 +1,74 @@
+//
+//  TICDSSyncChangeJournal.h
+//  TICoreDataSync
+//
+
+#import <Foundation/Foundation.h>
+
+/** `TICDSSyncChangeJournal` is an append-only journal of local sync changes, replacing the `UnsynchronizedSyncChanges.syncchg` Core Data store.
+ 
+ The journal lives in a directory of numbered segment files. Records (dictionary representations of sync changes, see `-[TICDSSyncChange dictionaryRepresentation]`) are appended to the current segment, with a single `fsync()` per batch. Starting a synchronization seals the current segment; the next append opens a new one.
+ 
+ Sealed segments are handed to the synchronization operation, which imports them into the `SyncChangesBeingSynchronized.syncchg` store and then deletes them. A sealed segment is returned by every call to `sealCurrentSegment:` until it has been deleted, so segments handed to a synchronization that failed before importing them are picked up by the next one. Any segments left over from a previous launch are sealed when the journal is created.
+ 
+ A journal is not thread-safe; the `TICDSSyncChangesWriter` only ever uses it from its own serial queue.
+ */
+@interface TICDSSyncChangeJournal : NSObject {
+@private
+    NSString *_directoryPath;
+    NSFileManager *_fileManager;
+    
+    int _currentSegmentFileDescriptor;
+    NSString *_currentSegmentPath;
+    NSUInteger _nextSegmentNumber;
+    
+    NSMutableArray *_sealedSegmentPaths;
+}
+
+/** @name Creation */
+
+/** Initialize a journal in the given directory, creating the directory if necessary.
+ 
+ @param aPath The path to the journal directory.
+ 
+ @return A journal, or `nil` if the directory could not be created. */
+- (id)initWithDirectoryPath:(NSString *)aPath;
+
+/** @name Writing */
+
+/** Append sync change records to the current segment, and `fsync()` the segment once all records are written.
+ 
+ @param someRepresentations An array of dictionary representations of sync changes.
+ @param outError If the records could not be written, upon return contains an error describing the problem.
+ 
+ @return `YES` if the records were written and synchronized to disk, otherwise `NO`. */
+- (BOOL)appendSyncChangeRepresentations:(NSArray *)someRepresentations error:(NSError **)outError;
+
+/** Seal the current segment, so the next append opens a new one.
+ 
+ @param outError If the segment could not be sealed, upon return contains an error describing the problem.
+ 
+ @return The paths of every sealed segment that hasn't yet been deleted after importing it, in the order they were written, or `nil` if an error occurred. */
+- (NSArray *)sealCurrentSegment:(NSError **)outError;
+
+/** @name Reading */
+
+/** Read the sync change records from a sealed segment.
+ 
+ A truncated record at the end of a segment (e.g., from a crash during an append) is ignored.
+ 
+ @param aPath The path to the segment.
+ @param outError If the segment could not be read, upon return contains an error describing the problem.
+ 
+ @return An array of dictionary representations of sync changes, or `nil` if the segment could not be read. */
++ (NSArray *)syncChangeRepresentationsInSegmentAtPath:(NSString *)aPath error:(NSError **)outError;
+
+/** @name Properties */
+
+/** The path to the journal directory. */
+@property (nonatomic, readonly) NSString *directoryPath;
+
+/** `YES` if the journal contains records in the current segment, or in sealed segments that haven't yet been deleted after importing them. */
+@property (nonatomic, readonly) BOOL hasUnsealedOrUnclaimedSyncChanges;
+
+@end
@@ -0,0 +1,270 @@
+//
+//  TICDSSyncChangeJournal.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+#import <fcntl.h>
+#import <errno.h>
+#import <unistd.h>
+
+@interface TICDSSyncChangeJournal ()
+
+- (BOOL)sealSegmentAtPath:(NSString *)aPath error:(NSError **)outError;
+- (void)forgetRemovedSealedSegments;
+- (NSString *)pathForSegmentNumber:(NSUInteger)aNumber extension:(NSString *)anExtension;
+- (BOOL)openCurrentSegment:(NSError **)outError;
+
+@end
+
+#pragma mark -
+#pragma mark Function Declarations
+static NSError *TICDSSyncChangeJournalPOSIXError( NSString *aPath );
+
+@implementation TICDSSyncChangeJournal
+
+#pragma mark -
+#pragma mark Writing
+- (BOOL)appendSyncChangeRepresentations:(NSArray *)someRepresentations error:(NSError **)outError
+{
+    if( [someRepresentations count] < 1 ) {
+        return YES;
+    }
+    
+    if( _currentSegmentFileDescriptor == -1 && ![self openCurrentSegment:outError] ) {
+        return NO;
+    }
+    
+    // each record is a big-endian length followed by a keyed archive of the sync change's dictionary representation
+    NSMutableData *batch = [NSMutableData data];
+    for( NSDictionary *eachRepresentation in someRepresentations ) {
+        NSData *recordData = [NSKeyedArchiver archivedDataWithRootObject:eachRepresentation];
+        uint32_t recordLength = CFSwapInt32HostToBig((uint32_t)[recordData length]);
+        [batch appendBytes:&recordLength length:sizeof(recordLength)];
+        [batch appendData:recordData];
+    }
+    
+    off_t previousLength = lseek(_currentSegmentFileDescriptor, 0, SEEK_END);
+    
+    const uint8_t *bytes = [batch bytes];
+    NSUInteger remaining = [batch length];
+    while( remaining > 0 ) {
+        ssize_t written = write(_currentSegmentFileDescriptor, bytes, remaining);
+        if( written == -1 ) {
+            if( errno == EINTR ) {
+                continue;
+            }
+            
+            if( outError ) {
+                *outError = TICDSSyncChangeJournalPOSIXError(_currentSegmentPath);
+            }
+            // drop the partial batch so the segment still ends on a record boundary
+            ftruncate(_currentSegmentFileDescriptor, previousLength);
+            return NO;
+        }
+        
+        bytes += written;
+        remaining -= written;
+    }
+    
+    if( fsync(_currentSegmentFileDescriptor) == -1 ) {
+        if( outError ) {
+            *outError = TICDSSyncChangeJournalPOSIXError(_currentSegmentPath);
+        }
+        // the caller will append this batch again, so don't leave a copy of it behind
+        ftruncate(_currentSegmentFileDescriptor, previousLength);
+        return NO;
+    }
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Appended %lu sync changes to %@", (unsigned long)[someRepresentations count], [_currentSegmentPath lastPathComponent]);
+    
+    return YES;
+}
+
+- (NSArray *)sealCurrentSegment:(NSError **)outError
+{
+    if( _currentSegmentFileDescriptor != -1 ) {
+        close(_currentSegmentFileDescriptor);
+        _currentSegmentFileDescriptor = -1;
+        
+        if( ![self sealSegmentAtPath:_currentSegmentPath error:outError] ) {
+            return nil;
+        }
+        
+        [_currentSegmentPath release], _currentSegmentPath = nil;
+    }
+    
+    // segments stay claimable until a synchronization has imported and deleted them
+    [self forgetRemovedSealedSegments];
+    
+    return [[_sealedSegmentPaths copy] autorelease];
+}
+
+- (void)forgetRemovedSealedSegments
+{
+    for( NSString *eachPath in [[_sealedSegmentPaths copy] autorelease] ) {
+        if( ![_fileManager fileExistsAtPath:eachPath] ) {
+            [_sealedSegmentPaths removeObject:eachPath];
+        }
+    }
+}
+
+- (BOOL)sealSegmentAtPath:(NSString *)aPath error:(NSError **)outError
+{
+    NSString *sealedPath = [[aPath stringByDeletingPathExtension] stringByAppendingPathExtension:TICDSSyncChangesJournalSealedSegmentExtension];
+    
+    if( ![_fileManager moveItemAtPath:aPath toPath:sealedPath error:outError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to seal sync change journal segment %@", [aPath lastPathComponent]);
+        return NO;
+    }
+    
+    [_sealedSegmentPaths addObject:sealedPath];
+    
+    return YES;
+}
+
+- (BOOL)openCurrentSegment:(NSError **)outError
+{
+    [_currentSegmentPath release];
+    _currentSegmentPath = [[self pathForSegmentNumber:_nextSegmentNumber++ extension:TICDSSyncChangesJournalSegmentExtension] retain];
+    
+    _currentSegmentFileDescriptor = open([_currentSegmentPath fileSystemRepresentation], O_WRONLY | O_CREAT | O_APPEND, 0644);
+    
+    if( _currentSegmentFileDescriptor == -1 ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Could not open sync change journal segment %@. Error %d (%s)", _currentSegmentPath, errno, strerror(errno));
+        if( outError ) {
+            *outError = TICDSSyncChangeJournalPOSIXError(_currentSegmentPath);
+        }
+        return NO;
+    }
+    
+    return YES;
+}
+
+- (NSString *)pathForSegmentNumber:(NSUInteger)aNumber extension:(NSString *)anExtension
+{
+    return [[[self directoryPath] stringByAppendingPathComponent:[NSString stringWithFormat:@"%010lu", (unsigned long)aNumber]] stringByAppendingPathExtension:anExtension];
+}
+
+#pragma mark -
+#pragma mark Reading
++ (NSArray *)syncChangeRepresentationsInSegmentAtPath:(NSString *)aPath error:(NSError **)outError
+{
+    NSData *segmentData = [NSData dataWithContentsOfFile:aPath options:NSDataReadingMappedIfSafe error:outError];
+    if( !segmentData ) {
+        return nil;
+    }
+    
+    NSMutableArray *representations = [NSMutableArray array];
+    const uint8_t *bytes = [segmentData bytes];
+    NSUInteger length = [segmentData length];
+    NSUInteger offset = 0;
+    
+    while( offset + sizeof(uint32_t) <= length ) {
+        uint32_t recordLength = 0;
+        memcpy(&recordLength, bytes + offset, sizeof(recordLength));
+        recordLength = CFSwapInt32BigToHost(recordLength);
+        offset += sizeof(recordLength);
+        
+        if( offset + recordLength > length ) {
+            break;
+        }
+        
+        NSDictionary *eachRepresentation = nil;
+        @try {
+            eachRepresentation = [NSKeyedUnarchiver unarchiveObjectWithData:[segmentData subdataWithRange:NSMakeRange(offset, recordLength)]];
+        }
+        @catch (NSException *exception) {
+            TICDSLog(TICDSLogVerbosityErrorsOnly, @"Unreadable record in sync change journal segment %@: %@", [aPath lastPathComponent], exception);
+            break;
+        }
+        
+        if( eachRepresentation ) {
+            [representations addObject:eachRepresentation];
+        }
+        offset += recordLength;
+    }
+    
+    if( offset < length ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Ignoring %lu bytes of incomplete records at the end of sync change journal segment %@", (unsigned long)(length - offset), [aPath lastPathComponent]);
+    }
+    
+    return representations;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)initWithDirectoryPath:(NSString *)aPath
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+    
+    _directoryPath = [aPath copy];
+    _fileManager = [[NSFileManager alloc] init];
+    _currentSegmentFileDescriptor = -1;
+    _sealedSegmentPaths = [[NSMutableArray alloc] init];
+    
+    NSError *anyError = nil;
+    if( ![_fileManager fileExistsAtPath:_directoryPath] && ![_fileManager createDirectoryAtPath:_directoryPath withIntermediateDirectories:YES attributes:nil error:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to create sync change journal directory: %@", anyError);
+        [self release];
+        return nil;
+    }
+    
+    // segments are named by number, so sorting the names puts them in the order they were written
+    NSArray *contents = [[_fileManager contentsOfDirectoryAtPath:_directoryPath error:&anyError] sortedArrayUsingSelector:@selector(compare:)];
+    for( NSString *eachFileName in contents ) {
+        NSString *eachPath = [_directoryPath stringByAppendingPathComponent:eachFileName];
+        
+        if( [[eachFileName pathExtension] isEqualToString:TICDSSyncChangesJournalSealedSegmentExtension] ) {
+            [_sealedSegmentPaths addObject:eachPath];
+        } else if( [[eachFileName pathExtension] isEqualToString:TICDSSyncChangesJournalSegmentExtension] ) {
+            // left open by a previous launch
+            [self sealSegmentAtPath:eachPath error:&anyError];
+        } else {
+            continue;
+        }
+        
+        _nextSegmentNumber = MAX(_nextSegmentNumber, (NSUInteger)[[eachFileName stringByDeletingPathExtension] integerValue] + 1);
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    if( _currentSegmentFileDescriptor != -1 ) {
+        close(_currentSegmentFileDescriptor);
+    }
+    _currentSegmentFileDescriptor = -1;
+    
+    [_directoryPath release], _directoryPath = nil;
+    [_fileManager release], _fileManager = nil;
+    [_currentSegmentPath release], _currentSegmentPath = nil;
+    [_sealedSegmentPaths release], _sealedSegmentPaths = nil;
+    
+    [super dealloc];
+}
+
+#pragma mark -
+#pragma mark Errors
+static NSError *TICDSSyncChangeJournalPOSIXError( NSString *aPath )
+{
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:[NSDictionary dictionaryWithObject:aPath forKey:NSFilePathErrorKey]];
+}
+
+#pragma mark -
+#pragma mark Properties
+- (BOOL)hasUnsealedOrUnclaimedSyncChanges
+{
+    [self forgetRemovedSealedSegments];
+    
+    return _currentSegmentFileDescriptor != -1 || [_sealedSegmentPaths count] > 0;
+}
+
+@synthesize directoryPath = _directoryPath;
+
+@end
@@ -0,0 +1,42 @@
+//
+//  TICDSSyncChangeSetReader.h
+//  TICoreDataSync
+//
+
+#import <CoreData/CoreData.h>
+
+/** `TICDSSyncChangeSetReader` opens `SyncChangeSet` files one after another through a single persistent store coordinator and managed object context.
+
+ Creating a `TICoreDataFactory` for each sync change set means loading the `TICDSSyncChange` model, creating a coordinator and context, and opening the SQLite file with journaling enabled; when applying thousands of small sync change sets, that setup takes longer than the changes themselves. A reader uses the shared model (see `+[TICoreDataFactory sharedManagedObjectModelWithMomdName:]`), and swaps each file's store in on the same coordinator, opened read-only with the SQLite journal turned off.
+
+ The objects from one sync change set are invalid once the next is opened. A reader is not thread-safe; it must only be used on the thread on which it was first used.
+ */
+@interface TICDSSyncChangeSetReader : NSObject {
+@private
+    NSPersistentStoreCoordinator *_persistentStoreCoordinator;
+    NSManagedObjectContext *_managedObjectContext;
+    NSPersistentStore *_persistentStore;
+}
+
+/** @name Reading Sync Change Sets */
+
+/** Open a `SyncChangeSet` file, closing any file opened previously.
+
+ @param aLocation The location of the `SyncChangeSet` file.
+ @param outError If the file could not be opened, upon return contains an error describing the problem.
+
+ @return The reader's managed object context, containing the sync changes from the file, or `nil` if the file could not be opened. */
+- (NSManagedObjectContext *)managedObjectContextForSyncChangeSetAtLocation:(NSURL *)aLocation error:(NSError **)outError;
+
+/** Close the currently-open `SyncChangeSet` file, if any, resetting the managed object context. */
+- (void)closeSyncChangeSet;
+
+/** @name Properties */
+
+/** The managed object context through which the open `SyncChangeSet` file is read. */
+@property (nonatomic, readonly) NSManagedObjectContext *managedObjectContext;
+
+/** The options used to open each `SyncChangeSet` file: read-only, with SQLite journaling turned off. */
++ (NSDictionary *)persistentStoreOptions;
+
+@end
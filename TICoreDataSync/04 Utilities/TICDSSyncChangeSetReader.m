@@ -0,0 +1,88 @@
+//
+//  TICDSSyncChangeSetReader.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+@implementation TICDSSyncChangeSetReader
+
+#pragma mark -
+#pragma mark Reading Sync Change Sets
+- (NSManagedObjectContext *)managedObjectContextForSyncChangeSetAtLocation:(NSURL *)aLocation error:(NSError **)outError
+{
+    [self closeSyncChangeSet];
+
+    NSError *anyError = nil;
+    _persistentStore = [[[self managedObjectContext] persistentStoreCoordinator] addPersistentStoreWithType:TICDSSyncChangesCoreDataPersistentStoreType configuration:nil URL:aLocation options:[[self class] persistentStoreOptions] error:&anyError];
+
+    if( !_persistentStore ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to open sync change set at %@: %@", [aLocation path], anyError);
+
+        if( outError ) {
+            *outError = [TICDSError errorWithCode:TICDSErrorCodeFailedToCreateSyncChangesMOC underlyingError:anyError classAndMethod:__PRETTY_FUNCTION__];
+        }
+        return nil;
+    }
+
+    [_persistentStore retain];
+
+    return [self managedObjectContext];
+}
+
+- (void)closeSyncChangeSet
+{
+    if( !_persistentStore ) {
+        return;
+    }
+
+    [[self managedObjectContext] reset];
+
+    NSError *anyError = nil;
+    if( ![_persistentStoreCoordinator removePersistentStore:_persistentStore error:&anyError] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Failed to close sync change set: %@", anyError);
+    }
+
+    [_persistentStore release], _persistentStore = nil;
+}
+
++ (NSDictionary *)persistentStoreOptions
+{
+    // Sync change set files are never modified once written, so there's no need for a rollback journal or write-ahead log
+    NSDictionary *pragmas = [NSDictionary dictionaryWithObject:@"OFF" forKey:@"journal_mode"];
+
+    return [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:YES], NSReadOnlyPersistentStoreOption, pragmas, NSSQLitePragmasOption, nil];
+}
+
+#pragma mark -
+#pragma mark Lazy Accessors
+- (NSManagedObjectContext *)managedObjectContext
+{
+    if( _managedObjectContext ) return _managedObjectContext;
+
+    _persistentStoreCoordinator = [[NSPersistentStoreCoordinator alloc] initWithManagedObjectModel:[TICoreDataFactory sharedManagedObjectModelWithMomdName:TICDSSyncChangeDataModelName]];
+
+    _managedObjectContext = [[NSManagedObjectContext alloc] init];
+    [_managedObjectContext setPersistentStoreCoordinator:_persistentStoreCoordinator];
+    [_managedObjectContext setUndoManager:nil];
+
+    return _managedObjectContext;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (void)dealloc
+{
+    [self closeSyncChangeSet];
+
+    [_managedObjectContext release], _managedObjectContext = nil;
+    [_persistentStoreCoordinator release], _persistentStoreCoordinator = nil;
+
+    [super dealloc];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize managedObjectContext = _managedObjectContext;
+
+@end
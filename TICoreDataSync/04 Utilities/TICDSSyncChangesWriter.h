@@ -0,0 +1,53 @@
+//
+//  TICDSSyncChangesWriter.h
+//  TICoreDataSync
+//
+
+#import <Foundation/Foundation.h>
+
+/** `TICDSSyncChangesWriter` persists sync changes on a dedicated serial queue, so writing them to disk doesn't happen on the thread that saved the application context.
+ 
+ The document sync manager hands the writer immutable dictionary representations of the sync changes created during a save (see `-[TICDSSyncChange dictionaryRepresentation]`). The writer appends them to its `TICDSSyncChangeJournal`. If an append fails, the writer keeps the changes and writes them ahead of the next batch, so a failed write never loses sync changes.
+ 
+ Call `flush` before doing anything that depends on previously-written changes; it blocks until every enqueued write has finished.
+ */
+@interface TICDSSyncChangesWriter : NSObject {
+@private
+    TICDSSyncChangeJournal *_journal;
+    dispatch_queue_t _writerQueue;
+    NSMutableArray *_unwrittenSyncChangeRepresentations;
+}
+
+/** @name Creation */
+
+/** Initialize a writer that appends to a journal in the given directory.
+ 
+ @param aPath The path to the `UnsynchronizedSyncChanges` journal directory.
+ 
+ @return A writer ready to accept sync changes, or `nil` if the journal could not be created. */
+- (id)initWithJournalDirectoryPath:(NSString *)aPath;
+
+/** @name Writing */
+
+/** Enqueue sync changes to be appended to the journal on the writer's queue.
+ 
+ @param someRepresentations An array of dictionary representations of sync changes.
+ @param aBlock A block called on the main thread once the changes have been written (or failed to write); may be `nil`. Changes that fail to write are retried ahead of the next batch. */
+- (void)writeSyncChangeRepresentations:(NSArray *)someRepresentations completionBlock:(void (^)(BOOL success, NSError *anError))aBlock;
+
+/** Block until every previously-enqueued write has finished. */
+- (void)flush;
+
+/** @name Synchronization */
+
+/** Wait for every previously-enqueued write to finish, retry any changes that failed to write, then seal the journal's current segment.
+ 
+ @param outError If the segment could not be sealed, upon return contains an error describing the problem.
+ 
+ @return The paths of the sealed segments that are ready to be synchronized, including any handed to an earlier synchronization that didn't import them, or `nil` if an error occurred. */
+- (NSArray *)sealJournalSegment:(NSError **)outError;
+
+/** `YES` if the journal contains sync changes that haven't yet been handed to a synchronization, or if some changes haven't been written yet. Waits for enqueued writes to finish first. */
+@property (nonatomic, readonly) BOOL hasUnsynchronizedSyncChanges;
+
+@end
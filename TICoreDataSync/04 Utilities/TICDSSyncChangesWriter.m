@@ -0,0 +1,153 @@
+//
+//  TICDSSyncChangesWriter.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+@interface TICDSSyncChangesWriter ()
+
+- (BOOL)appendSyncChangeRepresentations:(NSArray *)someRepresentations error:(NSError **)outError;
+
+@end
+
+@implementation TICDSSyncChangesWriter
+
+#pragma mark -
+#pragma mark Writing
+- (void)writeSyncChangeRepresentations:(NSArray *)someRepresentations completionBlock:(void (^)(BOOL success, NSError *anError))aBlock
+{
+    NSArray *representations = [someRepresentations copy];
+    void (^completionBlock)(BOOL, NSError *) = [aBlock copy];
+    
+    // __block so the queued block doesn't retain the writer; dealloc flushes the queue instead
+    __block TICDSSyncChangesWriter *writer = self;
+    dispatch_async(_writerQueue, ^{
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        NSError *anyError = nil;
+        BOOL success = [writer appendSyncChangeRepresentations:representations error:&anyError];
+        
+        if( completionBlock ) {
+            [anyError retain];
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completionBlock(success, anyError);
+                [anyError release];
+            });
+        }
+        
+        [pool drain];
+    });
+    
+    [representations release];
+    [completionBlock release];
+}
+
+// must be called on the writer queue
+- (BOOL)appendSyncChangeRepresentations:(NSArray *)someRepresentations error:(NSError **)outError
+{
+    // changes that failed to write earlier go first, so the journal keeps them in the order they were made
+    [_unwrittenSyncChangeRepresentations addObjectsFromArray:someRepresentations];
+    
+    if( [_unwrittenSyncChangeRepresentations count] < 1 ) {
+        return YES;
+    }
+    
+    NSError *anyError = nil;
+    BOOL success = [_journal appendSyncChangeRepresentations:_unwrittenSyncChangeRepresentations error:&anyError];
+    
+    if( !success ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Sync changes writer failed to write %lu sync changes, so will retry them with the next write: %@", (unsigned long)[_unwrittenSyncChangeRepresentations count], anyError);
+        
+        if( outError ) {
+            *outError = anyError;
+        }
+        return NO;
+    }
+    
+    [_unwrittenSyncChangeRepresentations removeAllObjects];
+    
+    return YES;
+}
+
+- (void)flush
+{
+    dispatch_sync(_writerQueue, ^{ });
+}
+
+#pragma mark -
+#pragma mark Synchronization
+- (NSArray *)sealJournalSegment:(NSError **)outError
+{
+    __block NSArray *sealedSegmentPaths = nil;
+    __block NSError *anyError = nil;
+    
+    dispatch_sync(_writerQueue, ^{
+        // any changes still unwritten after this are written to the next segment, after those being sealed
+        [self appendSyncChangeRepresentations:nil error:nil];
+        
+        sealedSegmentPaths = [[_journal sealCurrentSegment:&anyError] retain];
+        [anyError retain];
+    });
+    
+    if( outError ) {
+        *outError = [anyError autorelease];
+    } else {
+        [anyError release];
+    }
+    
+    return [sealedSegmentPaths autorelease];
+}
+
+- (BOOL)hasUnsynchronizedSyncChanges
+{
+    __block BOOL hasUnsynchronizedSyncChanges = NO;
+    
+    dispatch_sync(_writerQueue, ^{
+        hasUnsynchronizedSyncChanges = [_unwrittenSyncChangeRepresentations count] > 0 || [_journal hasUnsealedOrUnclaimedSyncChanges];
+    });
+    
+    return hasUnsynchronizedSyncChanges;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)initWithJournalDirectoryPath:(NSString *)aPath
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+    
+    _journal = [[TICDSSyncChangeJournal alloc] initWithDirectoryPath:aPath];
+    if( !_journal ) {
+        [self release];
+        return nil;
+    }
+    
+    _writerQueue = dispatch_queue_create("ticdssyncchangeswriterqueue", DISPATCH_QUEUE_SERIAL);
+    _unwrittenSyncChangeRepresentations = [[NSMutableArray alloc] init];
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    // let any outstanding writes finish before the journal goes away
+    if( _writerQueue ) {
+        [self flush];
+        dispatch_release(_writerQueue), _writerQueue = NULL;
+    }
+    
+    // one last attempt for changes that failed to write
+    if( [_unwrittenSyncChangeRepresentations count] > 0 && ![self appendSyncChangeRepresentations:nil error:nil] ) {
+        TICDSLog(TICDSLogVerbosityErrorsOnly, @"Sync changes writer is being deallocated with %lu sync changes that could not be written", (unsigned long)[_unwrittenSyncChangeRepresentations count]);
+    }
+    
+    [_unwrittenSyncChangeRepresentations release], _unwrittenSyncChangeRepresentations = nil;
+    [_journal release], _journal = nil;
+    
+    [super dealloc];
+}
+
+@end
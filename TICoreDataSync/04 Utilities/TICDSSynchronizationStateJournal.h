@@ -0,0 +1,105 @@
+//
+//  TICDSSynchronizationStateJournal.h
+//  TICoreDataSync
+//
+
+#import <Foundation/Foundation.h>
+
+/** `TICDSSynchronizationStateJournal` records the durable progress of a synchronization operation in a small property list in the document's helper file directory, so that a synchronization interrupted by a crash can resume where it left off.
+
+ The journal records:
+
+ 1. The sync change set identifiers listed for each client, and the sync partition each belongs to.
+ 2. Each sync change set fetched into the `UnappliedSyncChanges` directory, along with the size and modification date of the fetched file, so it can be reused if it is still intact.
+ 3. The identifier of the last sync change set saved at an apply checkpoint.
+ 4. The relationship sync changes from sync change sets saved at an apply checkpoint that are still waiting for their objects to be inserted.
+
+ The journal is only valid for the integrity key and sync partitions it was created for; if either has changed, it starts again from scratch. It is removed once a synchronization completes.
+
+ A journal is not thread-safe; it is only used from the synchronization operation's thread.
+ */
+@interface TICDSSynchronizationStateJournal : NSObject {
+@private
+    NSString *_path;
+    NSMutableDictionary *_state;
+    BOOL _hasUnsavedChanges;
+}
+
+/** @name Creation */
+
+/** Initialize a journal at the given path, loading any state left by an interrupted synchronization.
+
+ @param aPath The path to the journal file.
+ @param anIntegrityKey The document's integrity key.
+ @param someSyncPartitionNames The names of the sync partitions being fetched.
+
+ @return A journal, containing the previous state only if it was recorded for the same integrity key and sync partitions. */
+- (id)initWithPath:(NSString *)aPath integrityKey:(NSString *)anIntegrityKey syncPartitionNames:(NSSet *)someSyncPartitionNames;
+
+/** @name Saving */
+
+/** Atomically write the journal to disk, if anything has changed since it was last saved.
+
+ @param outError If the journal could not be written, upon return contains an error describing the problem.
+
+ @return `YES` if the journal was saved, otherwise `NO`. */
+- (BOOL)save:(NSError **)outError;
+
+/** Remove the journal from disk, and forget its state.
+
+ @param outError If the journal could not be removed, upon return contains an error describing the problem.
+
+ @return `YES` if the journal was removed or did not exist, otherwise `NO`. */
+- (BOOL)removeJournal:(NSError **)outError;
+
+/** @name Listing */
+
+/** Record the sync change set identifiers listed for each client.
+
+ @param someIdentifiers A dictionary of arrays of sync change set identifiers, keyed by client identifier.
+ @param somePartitionNames A dictionary of sync partition names, keyed by sync change set identifier, for those sync change sets not in the default partition. */
+- (void)recordListedSyncChangeSetIdentifiers:(NSDictionary *)someIdentifiers syncPartitionNames:(NSDictionary *)somePartitionNames;
+
+/** The listed sync change set identifiers, keyed by client identifier, or `nil` if the listing didn't complete. */
+@property (nonatomic, readonly) NSDictionary *listedSyncChangeSetIdentifiers;
+
+/** The sync partition names of the listed sync change sets, keyed by sync change set identifier. */
+@property (nonatomic, readonly) NSDictionary *listedSyncPartitionNames;
+
+/** @name Fetching */
+
+/** Record that a sync change set has been fetched and written in full.
+
+ @param anIdentifier The identifier of the sync change set.
+ @param aClientIdentifier The identifier of the client who uploaded the sync change set.
+ @param aDate The modification date of the remote sync change set.
+ @param aPath The path to the fetched file. */
+- (void)recordFetchedSyncChangeSetWithIdentifier:(NSString *)anIdentifier clientIdentifier:(NSString *)aClientIdentifier modificationDate:(NSDate *)aDate atPath:(NSString *)aPath;
+
+/** Determine whether a previously fetched sync change set file is still intact.
+
+ @param anIdentifier The identifier of the sync change set.
+ @param aPath The path to the fetched file.
+
+ @return The modification date of the remote sync change set if the file still has the size and modification date recorded when it was fetched, otherwise `nil`. */
+- (NSDate *)modificationDateOfVerifiedSyncChangeSetWithIdentifier:(NSString *)anIdentifier atPath:(NSString *)aPath;
+
+/** Forget a fetched sync change set, e.g. once it has been applied.
+
+ @param anIdentifier The identifier of the sync change set. */
+- (void)forgetFetchedSyncChangeSetWithIdentifier:(NSString *)anIdentifier;
+
+/** @name Applying */
+
+/** The identifier of the last sync change set saved at an apply checkpoint. */
+@property (nonatomic, retain) NSString *lastAppliedSyncChangeSetIdentifier;
+
+/** The deferred relationship sync changes at the last apply checkpoint, as property list dictionaries (see `-[TICDSSyncChangeApplier deferredSyncChanges]`). */
+@property (nonatomic, retain) NSArray *deferredSyncChanges;
+
+/** @name Properties */
+
+/** The path to the journal file. */
+@property (nonatomic, readonly) NSString *path;
+
+@end
@@ -0,0 +1,234 @@
+//
+//  TICDSSynchronizationStateJournal.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+@interface TICDSSynchronizationStateJournal ()
+
+- (void)resetStateForIntegrityKey:(NSString *)anIntegrityKey syncPartitionNames:(NSArray *)somePartitionNames;
+- (NSMutableDictionary *)fetchedSyncChangeSets;
+
+@end
+
+#pragma mark -
+#pragma mark Journal Keys
+static NSString * const kTICDSSyncStateIntegrityKey = @"integrityKey";
+static NSString * const kTICDSSyncStateSyncPartitionNames = @"syncPartitionNames";
+static NSString * const kTICDSSyncStateListedIdentifiers = @"listedSyncChangeSetIdentifiers";
+static NSString * const kTICDSSyncStateListedSyncPartitionNames = @"listedSyncPartitionNames";
+static NSString * const kTICDSSyncStateFetchedSyncChangeSets = @"fetchedSyncChangeSets";
+static NSString * const kTICDSSyncStateLastAppliedIdentifier = @"lastAppliedSyncChangeSetIdentifier";
+static NSString * const kTICDSSyncStateDeferredSyncChanges = @"deferredSyncChanges";
+
+static NSString * const kTICDSSyncStateClientIdentifier = @"clientIdentifier";
+static NSString * const kTICDSSyncStateRemoteModificationDate = @"remoteModificationDate";
+static NSString * const kTICDSSyncStateFileSize = @"fileSize";
+static NSString * const kTICDSSyncStateFileModificationDate = @"fileModificationDate";
+
+@implementation TICDSSynchronizationStateJournal
+
+#pragma mark -
+#pragma mark Saving
+- (BOOL)save:(NSError **)outError
+{
+    if( !_hasUnsavedChanges ) {
+        return YES;
+    }
+
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:_state format:NSPropertyListBinaryFormat_v1_0 options:0 error:outError];
+
+    if( !data || ![data writeToFile:[self path] options:NSDataWritingAtomic error:outError] ) {
+        return NO;
+    }
+
+    _hasUnsavedChanges = NO;
+
+    return YES;
+}
+
+- (BOOL)removeJournal:(NSError **)outError
+{
+    [self resetStateForIntegrityKey:[_state valueForKey:kTICDSSyncStateIntegrityKey] syncPartitionNames:[_state valueForKey:kTICDSSyncStateSyncPartitionNames]];
+    _hasUnsavedChanges = NO;
+
+    NSFileManager *fileManager = [[NSFileManager alloc] init];
+    BOOL success = ![fileManager fileExistsAtPath:[self path]] || [fileManager removeItemAtPath:[self path] error:outError];
+    [fileManager release];
+
+    return success;
+}
+
+- (void)resetStateForIntegrityKey:(NSString *)anIntegrityKey syncPartitionNames:(NSArray *)somePartitionNames
+{
+    [_state release];
+    _state = [[NSMutableDictionary alloc] init];
+
+    [_state setValue:anIntegrityKey forKey:kTICDSSyncStateIntegrityKey];
+    [_state setValue:somePartitionNames forKey:kTICDSSyncStateSyncPartitionNames];
+
+    _hasUnsavedChanges = YES;
+}
+
+#pragma mark -
+#pragma mark Listing
+- (void)recordListedSyncChangeSetIdentifiers:(NSDictionary *)someIdentifiers syncPartitionNames:(NSDictionary *)somePartitionNames
+{
+    [_state setValue:someIdentifiers forKey:kTICDSSyncStateListedIdentifiers];
+    [_state setValue:somePartitionNames forKey:kTICDSSyncStateListedSyncPartitionNames];
+
+    _hasUnsavedChanges = YES;
+}
+
+- (NSDictionary *)listedSyncChangeSetIdentifiers
+{
+    return [_state valueForKey:kTICDSSyncStateListedIdentifiers];
+}
+
+- (NSDictionary *)listedSyncPartitionNames
+{
+    return [_state valueForKey:kTICDSSyncStateListedSyncPartitionNames];
+}
+
+#pragma mark -
+#pragma mark Fetching
+- (void)recordFetchedSyncChangeSetWithIdentifier:(NSString *)anIdentifier clientIdentifier:(NSString *)aClientIdentifier modificationDate:(NSDate *)aDate atPath:(NSString *)aPath
+{
+    NSFileManager *fileManager = [[NSFileManager alloc] init];
+    NSDictionary *attributes = [fileManager attributesOfItemAtPath:aPath error:NULL];
+    [fileManager release];
+
+    if( !attributes || !aDate ) {
+        return;
+    }
+
+    NSMutableDictionary *entry = [NSMutableDictionary dictionaryWithCapacity:4];
+    [entry setValue:aClientIdentifier forKey:kTICDSSyncStateClientIdentifier];
+    [entry setValue:aDate forKey:kTICDSSyncStateRemoteModificationDate];
+    [entry setValue:[attributes valueForKey:NSFileSize] forKey:kTICDSSyncStateFileSize];
+    [entry setValue:[attributes valueForKey:NSFileModificationDate] forKey:kTICDSSyncStateFileModificationDate];
+
+    [[self fetchedSyncChangeSets] setValue:entry forKey:anIdentifier];
+
+    _hasUnsavedChanges = YES;
+}
+
+- (NSDate *)modificationDateOfVerifiedSyncChangeSetWithIdentifier:(NSString *)anIdentifier atPath:(NSString *)aPath
+{
+    NSDictionary *entry = [[self fetchedSyncChangeSets] valueForKey:anIdentifier];
+
+    if( !entry ) {
+        return nil;
+    }
+
+    NSFileManager *fileManager = [[NSFileManager alloc] init];
+    NSDictionary *attributes = [fileManager attributesOfItemAtPath:aPath error:NULL];
+    [fileManager release];
+
+    if( ![[attributes valueForKey:NSFileSize] isEqual:[entry valueForKey:kTICDSSyncStateFileSize]] || ![[attributes valueForKey:NSFileModificationDate] isEqual:[entry valueForKey:kTICDSSyncStateFileModificationDate]] ) {
+        return nil;
+    }
+
+    return [entry valueForKey:kTICDSSyncStateRemoteModificationDate];
+}
+
+- (void)forgetFetchedSyncChangeSetWithIdentifier:(NSString *)anIdentifier
+{
+    if( ![[self fetchedSyncChangeSets] valueForKey:anIdentifier] ) {
+        return;
+    }
+
+    [[self fetchedSyncChangeSets] removeObjectForKey:anIdentifier];
+
+    _hasUnsavedChanges = YES;
+}
+
+- (NSMutableDictionary *)fetchedSyncChangeSets
+{
+    NSMutableDictionary *fetchedSyncChangeSets = [_state valueForKey:kTICDSSyncStateFetchedSyncChangeSets];
+
+    if( !fetchedSyncChangeSets ) {
+        fetchedSyncChangeSets = [NSMutableDictionary dictionary];
+        [_state setValue:fetchedSyncChangeSets forKey:kTICDSSyncStateFetchedSyncChangeSets];
+    }
+
+    return fetchedSyncChangeSets;
+}
+
+#pragma mark -
+#pragma mark Applying
+- (NSString *)lastAppliedSyncChangeSetIdentifier
+{
+    return [_state valueForKey:kTICDSSyncStateLastAppliedIdentifier];
+}
+
+- (void)setLastAppliedSyncChangeSetIdentifier:(NSString *)anIdentifier
+{
+    [_state setValue:anIdentifier forKey:kTICDSSyncStateLastAppliedIdentifier];
+
+    _hasUnsavedChanges = YES;
+}
+
+- (NSArray *)deferredSyncChanges
+{
+    return [_state valueForKey:kTICDSSyncStateDeferredSyncChanges];
+}
+
+- (void)setDeferredSyncChanges:(NSArray *)someChanges
+{
+    if( [someChanges count] < 1 && ![self deferredSyncChanges] ) {
+        return;
+    }
+
+    [_state setValue:([someChanges count] > 0 ? someChanges : nil) forKey:kTICDSSyncStateDeferredSyncChanges];
+
+    _hasUnsavedChanges = YES;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)initWithPath:(NSString *)aPath integrityKey:(NSString *)anIntegrityKey syncPartitionNames:(NSSet *)someSyncPartitionNames
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+
+    _path = [aPath copy];
+
+    NSArray *partitionNames = [[someSyncPartitionNames allObjects] sortedArrayUsingSelector:@selector(compare:)];
+
+    NSData *data = [NSData dataWithContentsOfFile:aPath];
+    if( data ) {
+        _state = [[NSPropertyListSerialization propertyListWithData:data options:NSPropertyListMutableContainers format:NULL error:NULL] retain];
+    }
+
+    BOOL stateIsValid = [_state isKindOfClass:[NSMutableDictionary class]];
+    stateIsValid = stateIsValid && (!anIntegrityKey || [[_state valueForKey:kTICDSSyncStateIntegrityKey] isEqualToString:anIntegrityKey]);
+    stateIsValid = stateIsValid && [([_state valueForKey:kTICDSSyncStateSyncPartitionNames] ? : [NSArray array]) isEqualToArray:partitionNames];
+
+    if( !stateIsValid ) {
+        if( data ) {
+            TICDSLog(TICDSLogVerbosityEveryStep, @"Discarding synchronization state journal left by a synchronization with a different integrity key or sync partitions");
+        }
+
+        [self resetStateForIntegrityKey:anIntegrityKey syncPartitionNames:partitionNames];
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [_path release], _path = nil;
+    [_state release], _state = nil;
+
+    [super dealloc];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize path = _path;
+
+@end
@@ -0,0 +1,100 @@
+//
+//  TICDSTransferWindow.h
+//  TICoreDataSync
+//
+
+#import <Foundation/Foundation.h>
+
+@protocol TICDSTransferWindowDelegate;
+
+/** `TICDSTransferWindow` schedules remote transfers, such as downloads of sync change sets, so that only a limited number are in flight at once.
+
+ Transfers waiting to start are ordered by priority date, earliest first, so that e.g. the oldest sync change sets arrive first. When a transfer fails with an error that is worth retrying (see `isRetryableError:`), it is started again after an exponential backoff delay with random jitter; a rate-limiting error also holds back every other transfer until that delay has passed.
+
+ A transfer window is not thread-safe; it must be used from a single thread with a run loop, which is the thread on which the delegate is asked to start transfers.
+ */
+@interface TICDSTransferWindow : NSObject {
+@private
+    NSObject<TICDSTransferWindowDelegate> *_delegate;
+
+    NSMutableArray *_pendingTransfers;
+    NSMutableDictionary *_activeTransfers;
+    NSMutableDictionary *_attemptsByIdentifier;
+    NSUInteger _numberOfTransfersWaitingToRetry;
+    NSDate *_backOffUntilDate;
+
+    NSUInteger _maximumConcurrentTransfers;
+    NSUInteger _maximumAttempts;
+    NSTimeInterval _initialRetryDelay;
+    NSTimeInterval _maximumRetryDelay;
+    BOOL _suspended;
+}
+
+/** @name Scheduling Transfers */
+
+/** Add a transfer to the window, starting it straight away if there is room.
+
+ @param anIdentifier A unique identifier for the transfer, e.g. the remote path.
+ @param aDate The priority date of the transfer; transfers with earlier dates are started first, and those without a date last.
+ @param someUserInfo Information passed back to the delegate when the transfer is started. */
+- (void)enqueueTransferWithIdentifier:(NSString *)anIdentifier priorityDate:(NSDate *)aDate userInfo:(NSDictionary *)someUserInfo;
+
+/** Indicate that a transfer has finished, whether successfully or not, making room for the next.
+
+ @param anIdentifier The identifier of the transfer. */
+- (void)transferDidFinishWithIdentifier:(NSString *)anIdentifier;
+
+/** Schedule a failed transfer to be started again, if the error is worth retrying and the transfer hasn't used up its attempts.
+
+ @param anIdentifier The identifier of the transfer.
+ @param anError The error with which the transfer failed.
+
+ @return `YES` if the transfer will be retried, or `NO` if it has failed for good, in which case it has been removed from the window. */
+- (BOOL)retryTransferWithIdentifier:(NSString *)anIdentifier afterError:(NSError *)anError;
+
+/** Forget every pending transfer and any scheduled retries. Transfers already in flight are not affected. */
+- (void)cancelAllTransfers;
+
+/** Determine whether an error is worth retrying: HTTP 429 and 5xx responses reported by the Dropbox SDK, and transient network errors.
+
+ @param anError The error.
+
+ @return `YES` if the transfer should be retried. */
++ (BOOL)isRetryableError:(NSError *)anError;
+
+/** @name Properties */
+
+/** The delegate asked to start each transfer. */
+@property (nonatomic, assign) NSObject<TICDSTransferWindowDelegate> *delegate;
+
+/** The maximum number of transfers in flight at once. Defaults to `4`. */
+@property (nonatomic, assign) NSUInteger maximumConcurrentTransfers;
+
+/** The maximum number of times a transfer is started before it fails for good. Defaults to `5`. */
+@property (nonatomic, assign) NSUInteger maximumAttempts;
+
+/** The upper bound of the delay before the first retry; each later retry doubles it. Defaults to `1` second. */
+@property (nonatomic, assign) NSTimeInterval initialRetryDelay;
+
+/** The largest delay before any retry. Defaults to `60` seconds. */
+@property (nonatomic, assign) NSTimeInterval maximumRetryDelay;
+
+/** While `YES`, no new transfers are started; setting it back to `NO` starts as many as there is room for. */
+@property (nonatomic, assign, getter = isSuspended) BOOL suspended;
+
+/** `YES` if any transfers are in flight, waiting to start, or waiting to be retried. */
+@property (nonatomic, readonly) BOOL hasUnfinishedTransfers;
+
+@end
+
+/** The `TICDSTransferWindowDelegate` protocol is used by a `TICDSTransferWindow` to start each transfer. */
+@protocol TICDSTransferWindowDelegate
+
+/** Start a transfer; call `transferDidFinishWithIdentifier:` or `retryTransferWithIdentifier:afterError:` once it has finished.
+
+ @param aWindow The transfer window.
+ @param anIdentifier The identifier of the transfer.
+ @param someUserInfo The information supplied when the transfer was enqueued. */
+- (void)transferWindow:(TICDSTransferWindow *)aWindow startTransferWithIdentifier:(NSString *)anIdentifier userInfo:(NSDictionary *)someUserInfo;
+
+@end
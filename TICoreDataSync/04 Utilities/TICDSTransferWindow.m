@@ -0,0 +1,262 @@
+//
+//  TICDSTransferWindow.m
+//  TICoreDataSync
+//
+
+#import "TICoreDataSync.h"
+
+@interface TICDSTransferWindow ()
+
+- (void)startTransfersIfPossible;
+- (void)insertPendingTransfer:(NSDictionary *)aTransfer;
+- (void)startTransferAfterRetryDelay:(NSDictionary *)aTransfer;
+- (void)backOffEnded;
+- (NSTimeInterval)retryDelayForAttempt:(NSUInteger)anAttempt;
++ (BOOL)isRateLimitingError:(NSError *)anError;
+
+@end
+
+#pragma mark -
+#pragma mark Transfer Keys
+static NSString * const kTICDSTransferIdentifier = @"identifier";
+static NSString * const kTICDSTransferPriorityDate = @"priorityDate";
+static NSString * const kTICDSTransferUserInfo = @"userInfo";
+
+@implementation TICDSTransferWindow
+
+#pragma mark -
+#pragma mark Scheduling Transfers
+- (void)enqueueTransferWithIdentifier:(NSString *)anIdentifier priorityDate:(NSDate *)aDate userInfo:(NSDictionary *)someUserInfo
+{
+    NSMutableDictionary *transfer = [NSMutableDictionary dictionaryWithCapacity:3];
+    [transfer setValue:anIdentifier forKey:kTICDSTransferIdentifier];
+    [transfer setValue:aDate forKey:kTICDSTransferPriorityDate];
+    [transfer setValue:someUserInfo forKey:kTICDSTransferUserInfo];
+
+    [self insertPendingTransfer:transfer];
+
+    [self startTransfersIfPossible];
+}
+
+- (void)insertPendingTransfer:(NSDictionary *)aTransfer
+{
+    NSDate *priorityDate = [aTransfer valueForKey:kTICDSTransferPriorityDate];
+    NSString *identifier = [aTransfer valueForKey:kTICDSTransferIdentifier];
+
+    NSUInteger index = 0;
+    for( NSDictionary *eachTransfer in _pendingTransfers ) {
+        NSDate *eachDate = [eachTransfer valueForKey:kTICDSTransferPriorityDate];
+
+        NSComparisonResult result = NSOrderedSame;
+        if( priorityDate && eachDate ) {
+            result = [priorityDate compare:eachDate];
+        } else if( priorityDate ) {
+            result = NSOrderedAscending;
+        } else if( eachDate ) {
+            result = NSOrderedDescending;
+        }
+
+        if( result == NSOrderedSame ) {
+            result = [identifier compare:[eachTransfer valueForKey:kTICDSTransferIdentifier]];
+        }
+
+        if( result == NSOrderedAscending ) {
+            break;
+        }
+
+        index++;
+    }
+
+    [_pendingTransfers insertObject:aTransfer atIndex:index];
+}
+
+- (void)startTransfersIfPossible
+{
+    if( [self isSuspended] || _backOffUntilDate ) {
+        return;
+    }
+
+    while( [_pendingTransfers count] > 0 && [_activeTransfers count] < [self maximumConcurrentTransfers] ) {
+        NSDictionary *transfer = [[_pendingTransfers objectAtIndex:0] retain];
+        [_pendingTransfers removeObjectAtIndex:0];
+
+        NSString *identifier = [transfer valueForKey:kTICDSTransferIdentifier];
+        [_activeTransfers setValue:transfer forKey:identifier];
+
+        NSUInteger attempts = [[_attemptsByIdentifier valueForKey:identifier] unsignedIntegerValue];
+        [_attemptsByIdentifier setValue:[NSNumber numberWithUnsignedInteger:attempts + 1] forKey:identifier];
+
+        [[self delegate] transferWindow:self startTransferWithIdentifier:identifier userInfo:[transfer valueForKey:kTICDSTransferUserInfo]];
+
+        [transfer release];
+    }
+}
+
+- (void)transferDidFinishWithIdentifier:(NSString *)anIdentifier
+{
+    [_activeTransfers removeObjectForKey:anIdentifier];
+    [_attemptsByIdentifier removeObjectForKey:anIdentifier];
+
+    [self startTransfersIfPossible];
+}
+
+#pragma mark -
+#pragma mark Retrying
+- (BOOL)retryTransferWithIdentifier:(NSString *)anIdentifier afterError:(NSError *)anError
+{
+    NSDictionary *transfer = [[[_activeTransfers valueForKey:anIdentifier] retain] autorelease];
+    NSUInteger attempts = [[_attemptsByIdentifier valueForKey:anIdentifier] unsignedIntegerValue];
+
+    if( !transfer || attempts >= [self maximumAttempts] || ![[self class] isRetryableError:anError] ) {
+        [self transferDidFinishWithIdentifier:anIdentifier];
+        return NO;
+    }
+
+    [_activeTransfers removeObjectForKey:anIdentifier];
+
+    NSTimeInterval delay = [self retryDelayForAttempt:attempts];
+
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Transfer %@ failed (attempt %lu), retrying in %.1f seconds: %@", anIdentifier, (unsigned long)attempts, delay, anError);
+
+    if( [[self class] isRateLimitingError:anError] ) {
+        // Rate limited, so hold back every other transfer too
+        NSDate *backOffUntilDate = [NSDate dateWithTimeIntervalSinceNow:delay];
+        if( !_backOffUntilDate || [_backOffUntilDate compare:backOffUntilDate] == NSOrderedAscending ) {
+            [_backOffUntilDate release];
+            _backOffUntilDate = [backOffUntilDate retain];
+
+            [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(backOffEnded) object:nil];
+            [self performSelector:@selector(backOffEnded) withObject:nil afterDelay:delay];
+        }
+    }
+
+    _numberOfTransfersWaitingToRetry++;
+    [self performSelector:@selector(startTransferAfterRetryDelay:) withObject:transfer afterDelay:delay];
+
+    [self startTransfersIfPossible];
+
+    return YES;
+}
+
+- (void)startTransferAfterRetryDelay:(NSDictionary *)aTransfer
+{
+    _numberOfTransfersWaitingToRetry--;
+
+    [self insertPendingTransfer:aTransfer];
+
+    [self startTransfersIfPossible];
+}
+
+- (void)backOffEnded
+{
+    [_backOffUntilDate release], _backOffUntilDate = nil;
+
+    [self startTransfersIfPossible];
+}
+
+- (NSTimeInterval)retryDelayForAttempt:(NSUInteger)anAttempt
+{
+    // Exponential backoff with full jitter: a random delay up to initialRetryDelay * 2^(attempt - 1), capped at maximumRetryDelay
+    NSTimeInterval ceiling = [self initialRetryDelay] * pow(2.0, (double)(anAttempt > 0 ? anAttempt - 1 : 0));
+    ceiling = MIN(ceiling, [self maximumRetryDelay]);
+
+    return ceiling * ((double)arc4random_uniform(1001) / 1000.0);
+}
+
++ (BOOL)isRetryableError:(NSError *)anError
+{
+    NSInteger code = [anError code];
+
+    if( [[anError domain] isEqualToString:NSURLErrorDomain] ) {
+        switch( code ) {
+            case NSURLErrorTimedOut:
+            case NSURLErrorCannotFindHost:
+            case NSURLErrorCannotConnectToHost:
+            case NSURLErrorNetworkConnectionLost:
+            case NSURLErrorDNSLookupFailed:
+            case NSURLErrorNotConnectedToInternet:
+                return YES;
+            default:
+                return NO;
+        }
+    }
+
+    // The Dropbox SDK uses the HTTP status code as the error code; other domains, e.g. Cocoa's, have unrelated codes in the same range
+    if( [[anError domain] isEqualToString:kTICDSDropboxSDKErrorDomain] ) {
+        return code == 429 || (code >= 500 && code <= 599);
+    }
+
+    return NO;
+}
+
++ (BOOL)isRateLimitingError:(NSError *)anError
+{
+    return [[anError domain] isEqualToString:kTICDSDropboxSDKErrorDomain] && [anError code] == 429;
+}
+
+- (void)cancelAllTransfers
+{
+    [NSObject cancelPreviousPerformRequestsWithTarget:self];
+
+    [_pendingTransfers removeAllObjects];
+    _numberOfTransfersWaitingToRetry = 0;
+    [_backOffUntilDate release], _backOffUntilDate = nil;
+}
+
+#pragma mark -
+#pragma mark Window State
+- (void)setSuspended:(BOOL)shouldSuspend
+{
+    _suspended = shouldSuspend;
+
+    [self startTransfersIfPossible];
+}
+
+- (BOOL)hasUnfinishedTransfers
+{
+    return [_activeTransfers count] > 0 || [_pendingTransfers count] > 0 || _numberOfTransfersWaitingToRetry > 0;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)init
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+
+    _pendingTransfers = [[NSMutableArray alloc] init];
+    _activeTransfers = [[NSMutableDictionary alloc] init];
+    _attemptsByIdentifier = [[NSMutableDictionary alloc] init];
+
+    _maximumConcurrentTransfers = 4;
+    _maximumAttempts = 5;
+    _initialRetryDelay = 1.0;
+    _maximumRetryDelay = 60.0;
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [NSObject cancelPreviousPerformRequestsWithTarget:self];
+
+    [_pendingTransfers release], _pendingTransfers = nil;
+    [_activeTransfers release], _activeTransfers = nil;
+    [_attemptsByIdentifier release], _attemptsByIdentifier = nil;
+    [_backOffUntilDate release], _backOffUntilDate = nil;
+
+    [super dealloc];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize delegate = _delegate;
+@synthesize maximumConcurrentTransfers = _maximumConcurrentTransfers;
+@synthesize maximumAttempts = _maximumAttempts;
+@synthesize initialRetryDelay = _initialRetryDelay;
+@synthesize maximumRetryDelay = _maximumRetryDelay;
+@synthesize suspended = _suspended;
+
+@end
@@ -47,6 +47,9 @@
 + (id)coreDataFactory;
 + (id)coreDataFactoryWithMomdName:(NSString *)aMomdName;
 
+// Models are loaded once per momd name and shared by every factory in the process
++ (NSManagedObjectModel *)sharedManagedObjectModelWithMomdName:(NSString *)aMomdName;
+
 - (NSManagedObjectContext *)secondaryManagedObjectContext;
 
 @property (nonatomic, assign) NSObject <TICoreDataFactoryDelegate> *delegate;
@@ -81,27 +81,47 @@
 {
     if( _managedObjectModel ) return _managedObjectModel;
     
-    NSURL *modelURL = nil;
-    
-    if( _momdName ) { // Try compiled data model bundle
-        NSString *fileURL = [[NSBundle mainBundle] pathForResource:_momdName ofType:@"momd"];
-        modelURL = fileURL ? [NSURL fileURLWithPath:fileURL] : nil;
-    }
-    
-    if( _momdName && !modelURL ) { // Try compiled single data model file
-        NSString *fileURL = [[NSBundle mainBundle] pathForResource:_momdName ofType:@"mom"];
-        modelURL = fileURL ? [NSURL fileURLWithPath:fileURL] : nil;
-    }
-    
-    if( modelURL ) {
-        _managedObjectModel = [[NSManagedObjectModel alloc] initWithContentsOfURL:modelURL];
-    } else {
-        _managedObjectModel = [[NSManagedObjectModel mergedModelFromBundles:nil] retain];
-    }
+    _managedObjectModel = [[[self class] sharedManagedObjectModelWithMomdName:_momdName] retain];
     
     return _managedObjectModel;
 }
 
++ (NSManagedObjectModel *)sharedManagedObjectModelWithMomdName:(NSString *)aMomdName
+{
+    static NSMutableDictionary *sharedModels = nil;
+    
+    id key = aMomdName ? : (id)[NSNull null];
+    
+    @synchronized( [TICoreDataFactory class] ) {
+        if( !sharedModels ) sharedModels = [[NSMutableDictionary alloc] init];
+        
+        NSManagedObjectModel *model = [sharedModels objectForKey:key];
+        if( model ) return [[model retain] autorelease];
+        
+        NSURL *modelURL = nil;
+        
+        if( aMomdName ) { // Try compiled data model bundle
+            NSString *fileURL = [[NSBundle mainBundle] pathForResource:aMomdName ofType:@"momd"];
+            modelURL = fileURL ? [NSURL fileURLWithPath:fileURL] : nil;
+        }
+        
+        if( aMomdName && !modelURL ) { // Try compiled single data model file
+            NSString *fileURL = [[NSBundle mainBundle] pathForResource:aMomdName ofType:@"mom"];
+            modelURL = fileURL ? [NSURL fileURLWithPath:fileURL] : nil;
+        }
+        
+        if( modelURL ) {
+            model = [[[NSManagedObjectModel alloc] initWithContentsOfURL:modelURL] autorelease];
+        } else {
+            model = [NSManagedObjectModel mergedModelFromBundles:nil];
+        }
+        
+        if( model ) [sharedModels setObject:model forKey:key];
+        
+        return model;
+    }
+}
+
 - (NSString *)persistentStoreDataPath
 {
     if( _persistentStoreDataPath ) return _persistentStoreDataPath;
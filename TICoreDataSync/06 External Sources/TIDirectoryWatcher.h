@@ -0,0 +1,63 @@
+// Copyright (c) 2010 Tim Isted
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+extern NSString * const kTIDirectoryWatcherObservedDirectoryActivityNotification;
+extern NSString * const kTIDirectoryWatcherDirectories;
+extern NSString * const kTIDirectoryWatcherExpandedDirectories;
+
+// Names used by TIKQDirectoryWatcher before the watcher backends were split out; kTIKQDirectory and kTIKQExpandedDirectory hold the first of the directories that changed
+#define kTIKQDirectoryWatcherObservedDirectoryActivityNotification kTIDirectoryWatcherObservedDirectoryActivityNotification
+extern NSString * const kTIKQDirectory;
+extern NSString * const kTIKQExpandedDirectory;
+
+/** `TIDirectoryWatcher` is the abstract base class for the platform directory watchers (`TIKQDirectoryWatcher` using kqueue, and `TIInotifyDirectoryWatcher` using inotify on Linux).
+
+ Backends call `notifyActivityOnPath:` whenever the kernel reports activity in a watched directory. The base class coalesces activity over `coalescingInterval` and posts a single `kTIDirectoryWatcherObservedDirectoryActivityNotification` on the main thread, whose `userInfo` contains the distinct directories that changed during that window.
+ */
+@interface TIDirectoryWatcher : NSObject {
+@private
+    NSMutableArray *_watchedDirectories;
+    NSMutableSet *_pendingActivityPaths;
+    NSTimeInterval _coalescingInterval;
+    BOOL _activityNotificationScheduled;
+}
+
+/** Returns a new, autoreleased directory watcher using the best backend for the current platform. */
++ (id)directoryWatcher;
+
+/** Start watching a directory. Subclasses must override this method, and call `super` once the directory is being watched. */
+- (BOOL)watchDirectory:(NSString *)aDirectoryName error:(NSError **)outError;
+
+/** Stop watching a directory. Subclasses must override this method, and call `super` once the watch has been removed. */
+- (BOOL)stopWatchingDirectory:(NSString *)aDirectoryName error:(NSError **)outError;
+
+/** Start delivering activity for the watched directories. Directories may be added or removed after the watcher has started. */
+- (BOOL)startWatching:(NSError **)outError;
+
+/** Called by subclasses (on any thread) to report activity in a watched directory. */
+- (void)notifyActivityOnPath:(NSString *)aPath;
+
+/** The directories currently being watched. */
+@property (nonatomic, readonly) NSMutableArray *watchedDirectories;
+
+/** The window over which directory activity is coalesced into a single notification; defaults to `0.5` seconds. */
+@property (nonatomic, assign) NSTimeInterval coalescingInterval;
+
+@end
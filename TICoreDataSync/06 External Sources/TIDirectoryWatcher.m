@@ -0,0 +1,187 @@
+// Copyright (c) 2010 Tim Isted
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "TIDirectoryWatcher.h"
+#import "TICoreDataSync.h"
+
+@interface TIDirectoryWatcher ()
+
+- (void)postCoalescedActivityNotification;
+
+@end
+
+#pragma mark -
+#pragma mark Notification Constants
+NSString * const kTIDirectoryWatcherObservedDirectoryActivityNotification = @"kTIDirectoryWatcherObservedDirectoryActivityNotification";
+NSString * const kTIDirectoryWatcherDirectories = @"kTIDirectoryWatcherDirectories";
+NSString * const kTIDirectoryWatcherExpandedDirectories = @"kTIDirectoryWatcherExpandedDirectories";
+NSString * const kTIKQDirectory = @"kTIKQDirectory";
+NSString * const kTIKQExpandedDirectory = @"kTIKQExpandedDirectory";
+
+#pragma mark -
+#pragma mark Primary Implementation
+@implementation TIDirectoryWatcher
+
+#pragma mark -
+#pragma mark Factory
++ (id)directoryWatcher
+{
+#if defined(__linux__)
+    return [[[TIInotifyDirectoryWatcher alloc] init] autorelease];
+#else
+    return [[[TIKQDirectoryWatcher alloc] init] autorelease];
+#endif
+}
+
+#pragma mark -
+#pragma mark Overridden Methods
+- (BOOL)watchDirectory:(NSString *)aDirectoryName error:(NSError **)outError
+{
+    @synchronized(self) {
+        if( ![[self watchedDirectories] containsObject:aDirectoryName] ) {
+            [[self watchedDirectories] addObject:aDirectoryName];
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)stopWatchingDirectory:(NSString *)aDirectoryName error:(NSError **)outError
+{
+    @synchronized(self) {
+        [[self watchedDirectories] removeObject:aDirectoryName];
+        [_pendingActivityPaths removeObject:aDirectoryName];
+    }
+
+    return YES;
+}
+
+- (BOOL)startWatching:(NSError **)outError
+{
+    TICDSLog(TICDSLogVerbosityErrorsOnly, @"%@ does not override startWatching:", [self class]);
+
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Coalescing Activity
+- (void)notifyActivityOnPath:(NSString *)aPath
+{
+    if( !aPath ) {
+        return;
+    }
+
+    BOOL shouldSchedule = NO;
+
+    @synchronized(self) {
+        [_pendingActivityPaths addObject:aPath];
+
+        if( !_activityNotificationScheduled ) {
+            _activityNotificationScheduled = YES;
+            shouldSchedule = YES;
+        }
+    }
+
+    if( !shouldSchedule ) {
+        return;
+    }
+
+    // retained by the block until the coalesced notification has been posted
+    [self retain];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)([self coalescingInterval] * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [self postCoalescedActivityNotification];
+        [self release];
+    });
+}
+
+- (void)postCoalescedActivityNotification
+{
+    NSArray *paths = nil;
+
+    @synchronized(self) {
+        paths = [[_pendingActivityPaths allObjects] retain];
+        [_pendingActivityPaths removeAllObjects];
+        _activityNotificationScheduled = NO;
+    }
+
+    if( [paths count] < 1 ) {
+        [paths release];
+        return;
+    }
+
+    NSMutableArray *directories = [NSMutableArray arrayWithCapacity:[paths count]];
+    NSMutableArray *expandedDirectories = [NSMutableArray arrayWithCapacity:[paths count]];
+    for( NSString *eachPath in paths ) {
+        [directories addObject:[eachPath stringByAbbreviatingWithTildeInPath]];
+        [expandedDirectories addObject:[eachPath stringByExpandingTildeInPath]];
+    }
+    [paths release];
+
+    [[NSNotificationCenter defaultCenter]
+     postNotificationName:kTIDirectoryWatcherObservedDirectoryActivityNotification
+     object:self userInfo:
+     [NSDictionary dictionaryWithObjectsAndKeys:
+      directories, kTIDirectoryWatcherDirectories,
+      expandedDirectories, kTIDirectoryWatcherExpandedDirectories,
+      [directories objectAtIndex:0], kTIKQDirectory,
+      [expandedDirectories objectAtIndex:0], kTIKQExpandedDirectory, nil]];
+}
+
+#pragma mark -
+#pragma mark Lazy Accessors
+- (NSMutableArray *)watchedDirectories
+{
+    if( _watchedDirectories ) {
+        return _watchedDirectories;
+    }
+
+    _watchedDirectories = [[NSMutableArray alloc] init];
+
+    return _watchedDirectories;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)init
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+
+    _pendingActivityPaths = [[NSMutableSet alloc] init];
+    _coalescingInterval = 0.5;
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [_watchedDirectories release], _watchedDirectories = nil;
+    [_pendingActivityPaths release], _pendingActivityPaths = nil;
+
+    [super dealloc];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize coalescingInterval = _coalescingInterval;
+
+@end
@@ -0,0 +1,41 @@
+// Copyright (c) 2010 Tim Isted
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "TIDirectoryWatcher.h"
+
+#if defined(__linux__)
+
+/** `TIInotifyDirectoryWatcher` is the inotify backend for `TIDirectoryWatcher`, used on Linux.
+
+ All watches share a single inotify descriptor, read by a dispatch source on a private serial queue rather than the main run loop. Watches can be added and removed at any time, and a watch whose directory is deleted or moved away is dropped automatically.
+ */
+@interface TIInotifyDirectoryWatcher : TIDirectoryWatcher {
+@private
+    int _inotifyFileDescriptor;
+    dispatch_queue_t _eventQueue;
+    dispatch_source_t _eventSource;
+    NSMutableDictionary *_watchedPathsByWatchDescriptor;
+}
+
+@property (nonatomic, readonly) int inotifyFileDescriptor;
+
+@end
+
+#endif
@@ -0,0 +1,243 @@
+// Copyright (c) 2010 Tim Isted
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "TIInotifyDirectoryWatcher.h"
+#import "TICoreDataSync.h"
+
+#if defined(__linux__)
+
+#import <errno.h>
+#import <string.h>
+#import <unistd.h>
+#import <sys/inotify.h>
+
+#define TIInotifyWatchMask (IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+@interface TIInotifyDirectoryWatcher ()
+
+- (void)readPendingEvents;
+- (void)cancelEventSource;
+
+@end
+
+#pragma mark -
+#pragma mark Primary Implementation
+@implementation TIInotifyDirectoryWatcher
+
+#pragma mark -
+#pragma mark Primary Methods
+- (BOOL)watchDirectory:(NSString *)aDirectoryName error:(NSError **)outError
+{
+    if( [self inotifyFileDescriptor] == -1 ) {
+        return NO;
+    }
+    
+    int watchDescriptor = inotify_add_watch( [self inotifyFileDescriptor], [aDirectoryName fileSystemRepresentation], TIInotifyWatchMask );
+    
+    if( watchDescriptor == -1 ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Could not add inotify watch for %@. Error %d (%s)", aDirectoryName, errno, strerror(errno));
+        return NO;
+    }
+    
+    // inotify returns the existing descriptor if this directory is already watched
+    @synchronized(self) {
+        [_watchedPathsByWatchDescriptor setObject:aDirectoryName forKey:[NSNumber numberWithInt:watchDescriptor]];
+    }
+    
+    return [super watchDirectory:aDirectoryName error:outError];
+}
+
+- (BOOL)stopWatchingDirectory:(NSString *)aDirectoryName error:(NSError **)outError
+{
+    @synchronized(self) {
+        for( NSNumber *eachWatchDescriptor in [_watchedPathsByWatchDescriptor allKeysForObject:aDirectoryName] ) {
+            inotify_rm_watch( _inotifyFileDescriptor, [eachWatchDescriptor intValue] );
+            [_watchedPathsByWatchDescriptor removeObjectForKey:eachWatchDescriptor];
+        }
+    }
+    
+    return [super stopWatchingDirectory:aDirectoryName error:outError];
+}
+
+- (BOOL)startWatching:(NSError **)outError
+{
+    if( _eventSource ) {
+        return YES;
+    }
+    
+    if( [self inotifyFileDescriptor] == -1 ) {
+        return NO;
+    }
+    
+    _eventQueue = dispatch_queue_create("com.timisted.ticoredatasync.inotifywatcher", DISPATCH_QUEUE_SERIAL);
+    _eventSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, [self inotifyFileDescriptor], 0, _eventQueue);
+    
+    if( !_eventSource ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Could not create a dispatch source for the inotify descriptor");
+        return NO;
+    }
+    
+    // __block so the handler doesn't retain the watcher; the source is cancelled before deallocating
+    __block TIInotifyDirectoryWatcher *watcher = self;
+    dispatch_source_set_event_handler(_eventSource, ^{
+        [watcher readPendingEvents];
+    });
+    
+    // the descriptor must stay open until the source's cancellation has finished, so the source closes it
+    int fileDescriptor = [self inotifyFileDescriptor];
+    dispatch_source_set_cancel_handler(_eventSource, ^{
+        close(fileDescriptor);
+    });
+    dispatch_resume(_eventSource);
+    
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Reading Events
+- (void)readPendingEvents
+{
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    
+    char buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    
+    while( YES ) {
+        ssize_t length = read( _inotifyFileDescriptor, buffer, sizeof(buffer) );
+        
+        if( length <= 0 ) {
+            if( length == -1 && errno != EAGAIN ) {
+                TICDSLog(TICDSLogVerbosityDirectoryWatcherPickUpEventIssue, @"TIInotifyDirectoryWatcher could not read events. Error %d (%s)", errno, strerror(errno));
+            }
+            break;
+        }
+        
+        const struct inotify_event *event = NULL;
+        for( char *pointer = buffer; pointer < buffer + length; pointer += sizeof(struct inotify_event) + event->len ) {
+            event = (const struct inotify_event *)pointer;
+            
+            if( event->mask & IN_Q_OVERFLOW ) {
+                // events were dropped, so report activity everywhere
+                NSArray *watchedDirectories = nil;
+                @synchronized(self) {
+                    watchedDirectories = [[[self watchedDirectories] copy] autorelease];
+                }
+                
+                for( NSString *eachPath in watchedDirectories ) {
+                    [self notifyActivityOnPath:eachPath];
+                }
+                continue;
+            }
+            
+            NSNumber *watchDescriptor = [NSNumber numberWithInt:event->wd];
+            NSString *path = nil;
+            @synchronized(self) {
+                path = [[[_watchedPathsByWatchDescriptor objectForKey:watchDescriptor] retain] autorelease];
+            }
+            
+            if( !path ) {
+                continue;
+            }
+            
+            // stopping the watch discards pending activity for the path, so it must happen before reporting this event
+            if( event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED) ) {
+                TICDSLog(TICDSLogVerbosityEveryStep, @"%@ went away, so no longer watching it", path);
+                [self stopWatchingDirectory:path error:nil];
+            }
+            
+            [self notifyActivityOnPath:path];
+        }
+    }
+    
+    [pool drain];
+}
+
+#pragma mark -
+#pragma mark Cancelling the Event Source
+- (void)cancelEventSource
+{
+    if( !_eventSource ) {
+        return;
+    }
+    
+    // the cancel handler closes the descriptor once the cancellation has finished
+    dispatch_source_cancel(_eventSource);
+    dispatch_release(_eventSource), _eventSource = NULL;
+    
+    // wait for any event handler that is still running, as it reads the descriptor
+    dispatch_sync(_eventQueue, ^{});
+    dispatch_release(_eventQueue), _eventQueue = NULL;
+    
+    _inotifyFileDescriptor = -1;
+}
+
+#pragma mark -
+#pragma mark Lazy Generators
+- (int)inotifyFileDescriptor
+{
+    // 0 is a valid descriptor, so -1 means it hasn't been created
+    if( _inotifyFileDescriptor >= 0 ) return _inotifyFileDescriptor;
+    
+    TICDSLog(TICDSLogVerbosityEveryStep, @"Creating the inotify file descriptor");
+    _inotifyFileDescriptor = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    
+    if( _inotifyFileDescriptor == -1 ) {
+        TICDSLog(TICDSLogVerbosityEveryStep, @"Could not create inotify instance. Error %d (%s)", errno, strerror(errno));
+    }
+    
+    return _inotifyFileDescriptor;
+}
+
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)init
+{
+    self = [super init];
+    if( !self ) {
+        return nil;
+    }
+    
+    _inotifyFileDescriptor = -1;
+    _watchedPathsByWatchDescriptor = [[NSMutableDictionary alloc] init];
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    [self cancelEventSource];
+    
+    // closing the descriptor removes every watch; if events were read, the event source has already closed it
+    if( _inotifyFileDescriptor >= 0 ) {
+        close(_inotifyFileDescriptor);
+    }
+    _inotifyFileDescriptor = -1;
+    
+    [_watchedPathsByWatchDescriptor release], _watchedPathsByWatchDescriptor = nil;
+    
+    [super dealloc];
+}
+
+#pragma mark -
+#pragma mark Properties
+@synthesize inotifyFileDescriptor = _inotifyFileDescriptor;
+
+@end
+
+#endif
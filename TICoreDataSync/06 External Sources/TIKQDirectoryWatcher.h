@@ -18,23 +18,23 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-extern NSString * const kTIKQDirectoryWatcherObservedDirectoryActivityNotification;
-extern NSString * const kTIKQDirectory;
-extern NSString * const kTIKQExpandedDirectory;
+#import "TIDirectoryWatcher.h"
 
-@interface TIKQDirectoryWatcher : NSObject {
+#if !defined(__linux__)
+
+/** `TIKQDirectoryWatcher` is the kqueue backend for `TIDirectoryWatcher`. Each watched directory holds an open file descriptor, which is closed when the directory is no longer watched. */
+@interface TIKQDirectoryWatcher : TIDirectoryWatcher {
 @private
     int _kqFileDescriptor;
     CFRunLoopSourceRef _runLoopSourceRef;
-    NSMutableArray *_watchedDirectories;
+    NSMutableDictionary *_watchedPathsByFileDescriptor;
 }
 
-- (void)notifyActivityOnPath:(NSString *)aPath;
-- (BOOL)watchDirectory:(NSString *)aDirectoryName error:(NSError **)outError;
 - (BOOL)scheduleWatcherOnMainRunLoop:(NSError **)outError;
 
 @property (nonatomic, readonly) int kqFileDescriptor;
 @property (nonatomic, readonly) CFRunLoopSourceRef runLoopSourceRef;
-@property (nonatomic, retain) NSMutableArray *watchedDirectories;
 
 @end
+
+#endif
@@ -21,6 +21,8 @@
 #import "TIKQDirectoryWatcher.h"
 #import "TICoreDataSync.h"
 
+#if !defined(__linux__)
+
 #import <fcntl.h>
 #import <errno.h>
 #import <strings.h>
@@ -32,12 +34,6 @@
 
 @end
 
-#pragma mark -
-#pragma mark Notification Constants
-NSString * const kTIKQDirectoryWatcherObservedDirectoryActivityNotification = @"kTIKQDirectoryWatcherObservedDirectoryActivityNotification";
-NSString * const kTIKQDirectory = @"kTIKQDirectory";
-NSString * const kTIKQExpandedDirectory = @"kTIKQExpandedDirectory";
-
 #pragma mark -
 #pragma mark Function Declarations
 void TIKQSocketCallback( CFSocketRef socketRef, CFSocketCallBackType type, CFDataRef address, const void *data, void *info );
@@ -53,24 +49,49 @@ void TIKQSocketCallback( CFSocketRef socketRef, CFSocketCallBackType type, CFDat
 #pragma mark Primary Methods
 - (BOOL)watchDirectory:(NSString *)aDirectoryName error:(NSError **)outError
 {
-    int directoryFileDescriptor = open( [aDirectoryName UTF8String], O_RDONLY );
+    if( [[_watchedPathsByFileDescriptor allKeysForObject:aDirectoryName] count] > 0 ) {
+        return YES;
+    }
+    
+    int directoryFileDescriptor = open( [aDirectoryName UTF8String], O_EVTONLY );
     
     if( directoryFileDescriptor == - 1) {
         TICDSLog(TICDSLogVerbosityEveryStep, @"Could not open file descriptor for %@. Error %d (%s)", aDirectoryName, errno, strerror(errno));
         return NO;
     }
     
-    [[self watchedDirectories] addObject:aDirectoryName];
-    
     struct kevent directoryEvent;
-    EV_SET( &directoryEvent, directoryFileDescriptor, EVFILT_VNODE, EV_ADD | EV_CLEAR | EV_ENABLE, NOTE_WRITE, 0, aDirectoryName);
+    EV_SET( &directoryEvent, directoryFileDescriptor, EVFILT_VNODE, EV_ADD | EV_CLEAR | EV_ENABLE, NOTE_WRITE, 0, NULL);
     
     if( kevent( [self kqFileDescriptor], &directoryEvent, 1, NULL, 0, NULL ) == -1 ) {
         TICDSLog(TICDSLogVerbosityEveryStep, @"Could not kevent watching %@. Error %d (%s)", aDirectoryName, errno, strerror(errno));
+        close(directoryFileDescriptor);
         return NO;
     }
     
-    return YES;
+    @synchronized(self) {
+        [_watchedPathsByFileDescriptor setObject:aDirectoryName forKey:[NSNumber numberWithInt:directoryFileDescriptor]];
+    }
+    
+    return [super watchDirectory:aDirectoryName error:outError];
+}
+
+- (BOOL)stopWatchingDirectory:(NSString *)aDirectoryName error:(NSError **)outError
+{
+    @synchronized(self) {
+        for( NSNumber *eachFileDescriptor in [_watchedPathsByFileDescriptor allKeysForObject:aDirectoryName] ) {
+            // closing the descriptor also removes its kevent from the queue
+            close([eachFileDescriptor intValue]);
+            [_watchedPathsByFileDescriptor removeObjectForKey:eachFileDescriptor];
+        }
+    }
+    
+    return [super stopWatchingDirectory:aDirectoryName error:outError];
+}
+
+- (BOOL)startWatching:(NSError **)outError
+{
+    return [self scheduleWatcherOnMainRunLoop:outError];
 }
 
 - (BOOL)scheduleWatcherOnMainRunLoop:(NSError **)outError
@@ -100,16 +121,6 @@ void TIKQSocketCallback( CFSocketRef socketRef, CFSocketCallBackType type, CFDat
     return YES;
 }
 
-- (void)notifyActivityOnPath:(NSString *)aPath
-{
-    [[NSNotificationCenter defaultCenter] 
-     postNotificationName:kTIKQDirectoryWatcherObservedDirectoryActivityNotification 
-     object:self userInfo:
-     [NSDictionary dictionaryWithObjectsAndKeys:
-      [aPath stringByAbbreviatingWithTildeInPath], kTIKQDirectory,
-      [aPath stringByExpandingTildeInPath], kTIKQExpandedDirectory, nil]];
-}
-
 #pragma mark -
 #pragma mark Removing the Run Loop
 - (void)cancelRunLoopSourceRef
@@ -133,7 +144,11 @@ void TIKQSocketCallback( CFSocketRef socketRef, CFSocketCallBackType type, CFDat
         // TODO: sort this out so the problem causing this message to appear 1000s of times doesn't occur
         TICDSLog(TICDSLogVerbosityDirectoryWatcherPickUpEventIssue, @"TIKQDirectoryWatcher could not pick up an event. Error %d (%s)", errno, strerror(errno));
     } else {
-        [watcher notifyActivityOnPath:(NSString *)event.udata];
+        NSString *path = nil;
+        @synchronized(watcher) {
+            path = [[[watcher->_watchedPathsByFileDescriptor objectForKey:[NSNumber numberWithInt:(int)event.ident]] retain] autorelease];
+        }
+        [watcher notifyActivityOnPath:path];
     }
 }
 
@@ -153,27 +168,32 @@ void TIKQSocketCallback( CFSocketRef socketRef, CFSocketCallBackType type, CFDat
     return _kqFileDescriptor;
 }
 
-- (NSMutableArray *)watchedDirectories
+#pragma mark -
+#pragma mark Initialization and Deallocation
+- (id)init
 {
-    if( _watchedDirectories ) {
-        return _watchedDirectories;
+    self = [super init];
+    if( !self ) {
+        return nil;
     }
     
-    _watchedDirectories = [[NSMutableArray alloc] init];
+    _watchedPathsByFileDescriptor = [[NSMutableDictionary alloc] init];
     
-    return _watchedDirectories;
+    return self;
 }
 
-#pragma mark -
-#pragma mark Initialization and Deallocation
 - (void)dealloc
 {
+    [self cancelRunLoopSourceRef];
+    
+    for( NSNumber *eachFileDescriptor in [_watchedPathsByFileDescriptor allKeys] ) {
+        close([eachFileDescriptor intValue]);
+    }
+    [_watchedPathsByFileDescriptor release], _watchedPathsByFileDescriptor = nil;
+    
     close(_kqFileDescriptor);
     _kqFileDescriptor = 0;
     
-    [self cancelRunLoopSourceRef];
-    [_watchedDirectories release], _watchedDirectories = nil;
-    
     [super dealloc];
 }
 
@@ -181,6 +201,7 @@ void TIKQSocketCallback( CFSocketRef socketRef, CFSocketCallBackType type, CFDat
 #pragma mark Properties
 @synthesize kqFileDescriptor = _kqFileDescriptor;
 @synthesize runLoopSourceRef = _runLoopSourceRef;
-@synthesize watchedDirectories = _watchedDirectories;
 
 @end
+
+#endif